@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -100,7 +100,11 @@ esp_err_t esp_event_loop_create_default(void)
         .task_name = "sys_evt",
         .task_stack_size = ESP_TASKD_EVENT_STACK,
         .task_priority = ESP_TASKD_EVENT_PRIO,
-        .task_core_id = 0
+        .task_core_id = 0,
+#if CONFIG_ESP_EVENT_DEFAULT_LOOP_PAYLOAD_SLOTS
+        .payload_slot_size = CONFIG_ESP_EVENT_DEFAULT_LOOP_PAYLOAD_SLOT_SIZE,
+        .payload_slots = CONFIG_ESP_EVENT_DEFAULT_LOOP_PAYLOAD_SLOTS,
+#endif
     };
 
     esp_err_t err;
@@ -28,6 +28,12 @@
 #define LOOP_DUMP_FORMAT              "LOOP @%p,%s rx:%" PRIu32 " dr:%" PRIu32 "\n"
 // handler @<address> ev:<base, id> inv:<times invoked> time:<runtime>
 #define HANDLER_DUMP_FORMAT           "  HANDLER @%p ev:%s,%s inv:%" PRIu32 " time:%lld us\n"
+// slab slots:<number of slots> size:<slot size> used:<slots in use> hwm:<most slots in use> fb:<heap fallbacks>
+#define SLAB_DUMP_FORMAT              "  SLAB slots:%u size:%u used:%u hwm:%u fb:%" PRIu32 "\n"
+// wait ev:<events dispatched> avg:<average time in the queue> max:<longest time in the queue>
+#define WAIT_DUMP_FORMAT              "  WAIT ev:%" PRIu32 " avg:%lld us max:%lld us\n"
+// worker <index> ev:<events dispatched> batches:<batches taken from the queue> busy:<dispatch time> util:<% of time dispatching>
+#define WORKER_DUMP_FORMAT            "  WORKER %u ev:%" PRIu32 " batches:%" PRIu32 " busy:%lld us util:%u%%\n"
 
 #define PRINT_DUMP_INFO(dst, sz, ...)  do { \
                                             int cb = snprintf(dst, sz, __VA_ARGS__); \
@@ -36,6 +42,11 @@
                                         } while(0);
 #endif
 
+// Initial number of buckets of the dispatch table of a loop, doubled when it has as many entries
+#define DISPATCH_TABLE_MIN_BUCKETS    8
+// Maximum number of entries of the dispatch table of a loop, the other events are dispatched without entry
+#define DISPATCH_TABLE_MAX_ENTRIES    256
+
 /* ------------------------- Static Variables ------------------------------- */
 
 static const char* TAG = "event";
@@ -73,7 +84,7 @@ static int esp_event_dump_prepare(void)
     esp_event_handler_node_t* handler_it;
 
     // Count the number of items to be printed. This is needed to compute how much memory to reserve.
-    int loops = 0, handlers = 0;
+    int loops = 0, handlers = 0, workers = 0;
 
     portENTER_CRITICAL(&s_event_loops_spinlock);
 
@@ -94,6 +105,11 @@ static int esp_event_dump_prepare(void)
                 }
             }
         }
+        if (loop_it->worker_count > 0) {
+            workers += loop_it->worker_count;
+        } else if (loop_it->task != NULL) {
+            workers++;
+        }
         loops++;
     }
 
@@ -102,10 +118,19 @@ static int esp_event_dump_prepare(void)
     // Reserve slightly more memory than computed
     int allowance = 3;
     int size = (((loops + allowance) * (sizeof(LOOP_DUMP_FORMAT) + 10 + 20 + 2 * 11)) +
+                ((loops + allowance) * (sizeof(SLAB_DUMP_FORMAT) + 5 * 11)) +
+                ((loops + allowance) * (sizeof(WAIT_DUMP_FORMAT) + 11 + 2 * 20)) +
+                ((workers + allowance) * (sizeof(WORKER_DUMP_FORMAT) + 3 * 11 + 20 + 4)) +
                 ((handlers + allowance) * (sizeof(HANDLER_DUMP_FORMAT) + 10 + 2 * 20 + 11 + 20)));
 
     return size;
 }
+
+// Percentage of the lifetime of a loop spent dispatching events
+static unsigned esp_event_dump_utilisation(const esp_event_loop_stats_t* stats, int64_t lifetime)
+{
+    return lifetime > 0 ? (unsigned)((stats->busy_time * 100) / lifetime) : 0;
+}
 #endif
 
 static void esp_event_loop_run_task(void* args)
@@ -154,8 +179,8 @@ static void handler_execute(esp_event_loop_instance_t* loop, esp_event_handler_n
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     diff = esp_timer_get_time() - start;
 
-    handler->invoked++;
-    handler->time += diff;
+    atomic_fetch_add(&handler->invoked, 1);
+    atomic_fetch_add(&handler->time, diff);
 #endif
 }
 
@@ -315,23 +340,38 @@ static esp_err_t loop_node_add_handler(esp_event_loop_node_t* loop_node,
     }
 }
 
-static esp_err_t handler_instances_remove(esp_event_handler_nodes_t* handlers, esp_event_handler_instance_context_t* handler_ctx, bool legacy)
+// Remove a handler from its list and free it. The workers of a loop run by several tasks execute handlers without
+// holding the loop mutex, so there the handler is retired instead, and freed once no worker can still execute it.
+static void handler_instance_delete(esp_event_loop_instance_t* loop, esp_event_handler_nodes_t* handlers, esp_event_handler_node_t* handler)
+{
+    SLIST_REMOVE(handlers, handler, esp_event_handler_node, next);
+
+    if (loop->worker_count > 0) {
+        handler->unregistered = true;
+        handler->retired_epoch = loop->epoch;
+        if (++loop->epoch == 0) {
+            loop->epoch = 1;
+        }
+        SLIST_INSERT_HEAD(&(loop->retired), handler, next);
+    } else {
+        free(handler->handler_ctx);
+        free(handler);
+    }
+}
+
+static esp_err_t handler_instances_remove(esp_event_loop_instance_t* loop, esp_event_handler_nodes_t* handlers, esp_event_handler_instance_context_t* handler_ctx, bool legacy)
 {
     esp_event_handler_node_t *it, *temp;
 
     SLIST_FOREACH_SAFE(it, handlers, next, temp) {
         if (legacy) {
             if (it->handler_ctx->handler == handler_ctx->handler) {
-                SLIST_REMOVE(handlers, it, esp_event_handler_node, next);
-                free(it->handler_ctx);
-                free(it);
+                handler_instance_delete(loop, handlers, it);
                 return ESP_OK;
             }
         } else {
             if (it->handler_ctx == handler_ctx) {
-                SLIST_REMOVE(handlers, it, esp_event_handler_node, next);
-                free(it->handler_ctx);
-                free(it);
+                handler_instance_delete(loop, handlers, it);
                 return ESP_OK;
             }
         }
@@ -340,15 +380,15 @@ static esp_err_t handler_instances_remove(esp_event_handler_nodes_t* handlers, e
     return ESP_ERR_NOT_FOUND;
 }
 
-static esp_err_t base_node_remove_handler(esp_event_base_node_t* base_node, int32_t id, esp_event_handler_instance_context_t* handler_ctx, bool legacy)
+static esp_err_t base_node_remove_handler(esp_event_loop_instance_t* loop, esp_event_base_node_t* base_node, int32_t id, esp_event_handler_instance_context_t* handler_ctx, bool legacy)
 {
     if (id == ESP_EVENT_ANY_ID) {
-        return handler_instances_remove(&(base_node->handlers), handler_ctx, legacy);
+        return handler_instances_remove(loop, &(base_node->handlers), handler_ctx, legacy);
     } else {
         esp_event_id_node_t *it, *temp;
         SLIST_FOREACH_SAFE(it, &(base_node->id_nodes), next, temp) {
             if (it->id == id) {
-                esp_err_t res = handler_instances_remove(&(it->handlers), handler_ctx, legacy);
+                esp_err_t res = handler_instances_remove(loop, &(it->handlers), handler_ctx, legacy);
 
                 if (res == ESP_OK) {
                     if (SLIST_EMPTY(&(it->handlers))) {
@@ -364,15 +404,15 @@ static esp_err_t base_node_remove_handler(esp_event_base_node_t* base_node, int3
     return ESP_ERR_NOT_FOUND;
 }
 
-static esp_err_t loop_node_remove_handler(esp_event_loop_node_t* loop_node, esp_event_base_t base, int32_t id, esp_event_handler_instance_context_t* handler_ctx, bool legacy)
+static esp_err_t loop_node_remove_handler(esp_event_loop_instance_t* loop, esp_event_loop_node_t* loop_node, esp_event_base_t base, int32_t id, esp_event_handler_instance_context_t* handler_ctx, bool legacy)
 {
     if (base == esp_event_any_base && id == ESP_EVENT_ANY_ID) {
-        return handler_instances_remove(&(loop_node->handlers), handler_ctx, legacy);
+        return handler_instances_remove(loop, &(loop_node->handlers), handler_ctx, legacy);
     } else {
         esp_event_base_node_t *it, *temp;
         SLIST_FOREACH_SAFE(it, &(loop_node->base_nodes), next, temp) {
             if (it->base == base) {
-                esp_err_t res = base_node_remove_handler(it, id, handler_ctx, legacy);
+                esp_err_t res = base_node_remove_handler(loop, it, id, handler_ctx, legacy);
 
                 if (res == ESP_OK) {
                     if (SLIST_EMPTY(&(it->handlers)) && SLIST_EMPTY(&(it->id_nodes))) {
@@ -388,13 +428,199 @@ static esp_err_t loop_node_remove_handler(esp_event_loop_node_t* loop_node, esp_
     return ESP_ERR_NOT_FOUND;
 }
 
+// Store the handler in 'handlers' if it isn't NULL, or execute it if 'post' isn't NULL
+static inline void handler_visit(esp_event_loop_instance_t* loop, esp_event_handler_node_t *handler,
+                                 esp_event_handler_node_t** handlers, esp_event_post_instance_t* post, size_t* count)
+{
+    if (handlers) {
+        handlers[(*count)++] = handler;
+    } else if (post) {
+        if (!handler->unregistered) {
+            handler_execute(loop, handler, *post);
+            (*count)++;
+        }
+    } else {
+        (*count)++;
+    }
+}
+
+// Walk the handlers of an event in execution order: for each loop node, the loop level handlers, then the
+// base level and id level handlers of the matching base nodes. The handlers are stored in 'handlers' if it
+// isn't NULL, or executed if 'post' isn't NULL. Returns the number of handlers stored or executed.
+static size_t loop_visit_handlers(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id,
+                                  esp_event_handler_node_t** handlers, esp_event_post_instance_t* post)
+{
+    size_t count = 0;
+    esp_event_handler_node_t *handler, *temp_handler;
+    esp_event_loop_node_t *loop_node, *temp_node;
+    esp_event_base_node_t *base_node, *temp_base;
+    esp_event_id_node_t *id_node, *temp_id_node;
+
+    SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
+        // Loop level handlers
+        SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
+            handler_visit(loop, handler, handlers, post, &count);
+        }
+
+        SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
+            if (base_node->base == base) {
+                // Base level handlers
+                SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
+                    handler_visit(loop, handler, handlers, post, &count);
+                }
+
+                SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
+                    if (id_node->id == id) {
+                        // Id level handlers
+                        SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
+                            handler_visit(loop, handler, handlers, post, &count);
+                        }
+                        // Skip to next base node
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+static inline size_t dispatch_hash(esp_event_base_t base, int32_t id, size_t bucket_count)
+{
+    // Fibonacci hashing of the base address mixed with the id
+    uint32_t key = ((uint32_t)(uintptr_t)base >> 2) ^ ((uint32_t)id * 0x9E3779B1U);
+    return (key * 0x9E3779B1U) & (bucket_count - 1);
+}
+
+static void dispatch_table_grow(esp_event_dispatch_table_t* table)
+{
+    size_t bucket_count = table->bucket_count ? table->bucket_count * 2 : DISPATCH_TABLE_MIN_BUCKETS;
+    esp_event_dispatch_entries_t* buckets = esp_event_calloc(bucket_count, sizeof(*buckets));
+    if (buckets == NULL) {
+        // keep the current buckets, the lookups are only slower
+        return;
+    }
+
+    for (size_t i = 0; i < bucket_count; i++) {
+        SLIST_INIT(&buckets[i]);
+    }
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        esp_event_dispatch_entry_t *it;
+        while ((it = SLIST_FIRST(&table->buckets[i])) != NULL) {
+            SLIST_REMOVE_HEAD(&table->buckets[i], next);
+            SLIST_INSERT_HEAD(&buckets[dispatch_hash(it->base, it->id, bucket_count)], it, next);
+        }
+    }
+    free(table->buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+}
+
+// Find the entry of an event, building it from the lists of nodes if the event wasn't dispatched since
+// the handlers of the event changed. Returns NULL if the event has no handlers, if the table is full or if
+// there isn't enough memory to build the entry: the handlers are then executed while walking the lists of
+// nodes. Events without handlers aren't cached, so that posting many distinct events doesn't grow the table.
+static esp_event_dispatch_entry_t* dispatch_table_get(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id)
+{
+    esp_event_dispatch_table_t* table = &loop->dispatch;
+    esp_event_dispatch_entry_t *entry;
+
+    if (table->bucket_count != 0) {
+        SLIST_FOREACH(entry, &table->buckets[dispatch_hash(base, id, table->bucket_count)], next) {
+            if (entry->base == base && entry->id == id) {
+                return entry;
+            }
+        }
+    }
+
+    if (table->entry_count >= DISPATCH_TABLE_MAX_ENTRIES) {
+        return NULL;
+    }
+
+    size_t count = loop_visit_handlers(loop, base, id, NULL, NULL);
+    if (count == 0) {
+        return NULL;
+    }
+
+    if (table->entry_count >= table->bucket_count) {
+        dispatch_table_grow(table);
+        if (table->bucket_count == 0) {
+            return NULL;
+        }
+    }
+
+    entry = esp_event_calloc(1, sizeof(*entry) + count * sizeof(entry->handlers[0]));
+    if (entry == NULL) {
+        return NULL;
+    }
+    entry->base = base;
+    entry->id = id;
+    entry->count = loop_visit_handlers(loop, base, id, entry->handlers, NULL);
+
+    SLIST_INSERT_HEAD(&table->buckets[dispatch_hash(base, id, table->bucket_count)], entry, next);
+    table->entry_count++;
+    return entry;
+}
+
+static void dispatch_table_remove(esp_event_dispatch_table_t* table, size_t bucket, esp_event_dispatch_entry_t* entry)
+{
+    SLIST_REMOVE(&table->buckets[bucket], entry, esp_event_dispatch_entry, next);
+    table->entry_count--;
+    if (entry->in_use) {
+        // a handler of the entry registered or unregistered a handler, the dispatch frees the entry
+        entry->stale = true;
+    } else {
+        free(entry);
+    }
+}
+
+// Remove the entries of the events whose handlers change when a handler is (un)registered for base and id
+static void dispatch_table_invalidate(esp_event_dispatch_table_t* table, esp_event_base_t base, int32_t id)
+{
+    if (table->bucket_count == 0) {
+        return;
+    }
+
+    if (base != esp_event_any_base && id != ESP_EVENT_ANY_ID) {
+        size_t bucket = dispatch_hash(base, id, table->bucket_count);
+        esp_event_dispatch_entry_t *it;
+        SLIST_FOREACH(it, &table->buckets[bucket], next) {
+            if (it->base == base && it->id == id) {
+                dispatch_table_remove(table, bucket, it);
+                return;
+            }
+        }
+        return;
+    }
+
+    // loop level handlers are executed for all events, base level handlers for all the events of the base
+    for (size_t bucket = 0; bucket < table->bucket_count; bucket++) {
+        esp_event_dispatch_entry_t *it, *temp;
+        SLIST_FOREACH_SAFE(it, &table->buckets[bucket], next, temp) {
+            if (base == esp_event_any_base || it->base == base) {
+                dispatch_table_remove(table, bucket, it);
+            }
+        }
+    }
+}
+
+static void dispatch_table_clear(esp_event_dispatch_table_t* table)
+{
+    dispatch_table_invalidate(table, esp_event_any_base, ESP_EVENT_ANY_ID);
+    free(table->buckets);
+    table->buckets = NULL;
+    table->bucket_count = 0;
+}
+
 static esp_err_t loop_remove_handler(esp_event_remove_handler_context_t* ctx)
 {
     esp_event_loop_node_t *it, *temp;
     SLIST_FOREACH_SAFE(it, &(ctx->loop->loop_nodes), next, temp) {
-        esp_err_t res = loop_node_remove_handler(it, ctx->event_base, ctx->event_id, ctx->handler_ctx, ctx->legacy);
+        esp_err_t res = loop_node_remove_handler(ctx->loop, it, ctx->event_base, ctx->event_id, ctx->handler_ctx, ctx->legacy);
 
         if (res == ESP_OK) {
+            dispatch_table_invalidate(&ctx->loop->dispatch, ctx->event_base, ctx->event_id);
             if (SLIST_EMPTY(&(it->base_nodes)) && SLIST_EMPTY(&(it->handlers))) {
                 SLIST_REMOVE(&(ctx->loop->loop_nodes), it, esp_event_loop_node, next);
                 free(it);
@@ -439,17 +665,294 @@ static void loop_node_remove_all_handler(esp_event_loop_node_t* loop_node)
     }
 }
 
-static void inline __attribute__((always_inline)) post_instance_delete(esp_event_post_instance_t* post)
+static esp_err_t payload_slab_init(esp_event_payload_slab_t* slab, size_t slot_size, size_t slot_count)
+{
+    slab->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    if (slot_count == 0 || slot_size == 0) {
+        return ESP_OK;
+    }
+
+    // each free slot holds the pointer to the next one, and slots are aligned like heap allocations
+    slot_size = (slot_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    slab->slots = esp_event_calloc(slot_count, slot_size);
+    if (slab->slots == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    slab->slot_size = slot_size;
+    slab->slot_count = slot_count;
+    for (size_t i = slot_count; i > 0; i--) {
+        void* slot = slab->slots + (i - 1) * slot_size;
+        *(void**)slot = slab->free_slots;
+        slab->free_slots = slot;
+    }
+    return ESP_OK;
+}
+
+// Take a free slot of the slab for event data of the given size, returns NULL if there is none
+static void* payload_slab_alloc(esp_event_payload_slab_t* slab, size_t size)
+{
+    void* slot = NULL;
+
+    if (slab->slots == NULL) {
+        return NULL;
+    }
+
+    portENTER_CRITICAL(&slab->lock);
+    if (size <= slab->slot_size && slab->free_slots != NULL) {
+        slot = slab->free_slots;
+        slab->free_slots = *(void**)slot;
+        slab->used++;
+        if (slab->used > slab->high_water) {
+            slab->high_water = slab->used;
+        }
+    } else {
+        slab->fallbacks++;
+    }
+    portEXIT_CRITICAL(&slab->lock);
+
+    return slot;
+}
+
+// Give back a slot of the slab, returns false if the event data isn't in the slab
+static bool payload_slab_free(esp_event_payload_slab_t* slab, void* ptr)
+{
+    uint8_t* p = (uint8_t*)ptr;
+    if (slab->slots == NULL || p < slab->slots || p >= slab->slots + slab->slot_count * slab->slot_size) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&slab->lock);
+    *(void**)p = slab->free_slots;
+    slab->free_slots = p;
+    slab->used--;
+    portEXIT_CRITICAL(&slab->lock);
+
+    return true;
+}
+
+// Allocate the memory for the data of an event, from the slab of the loop if possible
+static void* payload_alloc(esp_event_loop_instance_t* loop, size_t size)
+{
+    void* ptr = payload_slab_alloc(&loop->slab, size);
+    if (ptr == NULL) {
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+        ptr = calloc(1, size);
+#else
+        ptr = esp_event_calloc(1, size);
+#endif
+    }
+    return ptr;
+}
+
+static void payload_free(esp_event_loop_instance_t* loop, void* ptr)
+{
+    if (!payload_slab_free(&loop->slab, ptr)) {
+        free(ptr);
+    }
+}
+
+static void inline __attribute__((always_inline)) post_instance_delete(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post)
 {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
     if (post->data_allocated)
 #endif
     {
-        free(post->data.ptr);
+        payload_free(loop, post->data.ptr);
     }
     memset(post, 0, sizeof(*post));
 }
 
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+static void stats_add_wait(esp_event_loop_stats_t* stats, const esp_event_post_instance_t* post, int64_t now)
+{
+    int64_t wait = now - post->posted;
+
+    stats->events++;
+    stats->wait_time += wait;
+    if (wait > stats->max_wait_time) {
+        stats->max_wait_time = wait;
+    }
+}
+#endif
+
+// Worker dispatching the events of a base, the bases are spread over the workers by hashing their address
+FORCE_INLINE_ATTR esp_event_loop_worker_t* loop_worker_of(esp_event_loop_instance_t* loop, esp_event_base_t base)
+{
+    uint32_t hash = ((uint32_t)(uintptr_t)base >> 2) * 0x9E3779B1U;
+    return &loop->workers[((uint64_t)hash * loop->worker_count) >> 32];
+}
+
+// Queue to post the events of a base to
+FORCE_INLINE_ATTR QueueHandle_t loop_queue_of(esp_event_loop_instance_t* loop, esp_event_base_t base)
+{
+    return loop->worker_count > 0 ? loop_worker_of(loop, base)->queue : loop->queue;
+}
+
+static bool loop_is_worker(esp_event_loop_instance_t* loop)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+    for (size_t i = 0; i < loop->worker_count; i++) {
+        if (loop->workers[i].task == task) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether no worker can still execute the handlers retired at the given epoch: the workers which started their
+// batch of events before the handlers were retired are done with it. Called with the loop mutex taken.
+static bool loop_epoch_passed(esp_event_loop_instance_t* loop, uint32_t epoch)
+{
+    for (size_t i = 0; i < loop->worker_count; i++) {
+        uint32_t worker_epoch = loop->workers[i].epoch;
+        if (worker_epoch != 0 && worker_epoch <= epoch) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool loop_workers_busy(esp_event_loop_instance_t* loop)
+{
+    for (size_t i = 0; i < loop->worker_count; i++) {
+        if (loop->workers[i].epoch != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Free the retired handlers no worker can execute anymore, called with the loop mutex taken
+static void loop_reclaim_retired(esp_event_loop_instance_t* loop)
+{
+    esp_event_handler_node_t *it, *temp;
+
+    SLIST_FOREACH_SAFE(it, &(loop->retired), next, temp) {
+        if (loop_epoch_passed(loop, it->retired_epoch)) {
+            SLIST_REMOVE(&(loop->retired), it, esp_event_handler_node, next);
+            free(it->handler_ctx);
+            free(it);
+        }
+    }
+}
+
+// Drop existing posts on a queue of the loop
+static void loop_queue_drop_posts(esp_event_loop_instance_t* loop, QueueHandle_t queue)
+{
+    esp_event_post_instance_t post;
+    while (xQueueReceive(queue, &post, 0) == pdTRUE) {
+        if (post.base == esp_event_handler_cleanup) {
+            esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post.data.ptr;
+            if (ctx->legacy) {
+                free(ctx->handler_ctx);
+            }
+        }
+        post_instance_delete(loop, &post);
+    }
+}
+
+// Dispatch a batch of events taken from the queue of a worker. The events are only taken from the queue with the
+// loop mutex taken, so that esp_event_loop_delete() never deletes a worker holding events it has not dispatched. The
+// mutex is then only taken again to release the lookups of the handlers after running them, so that the workers run
+// handlers concurrently. The handlers found stay allocated until the batch is dispatched, see handler_instance_delete().
+static void loop_worker_dispatch(esp_event_loop_worker_t* worker)
+{
+    esp_event_loop_instance_t* loop = worker->loop;
+    esp_event_post_instance_t posts[CONFIG_ESP_EVENT_LOOP_BATCH_SIZE];
+    esp_event_dispatch_entry_t* entries[CONFIG_ESP_EVENT_LOOP_BATCH_SIZE];
+
+    xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+
+    if (atomic_load(&loop->state.deleting)) {
+        // The loop is being deleted, drop the events instead of dispatching them
+        loop_queue_drop_posts(loop, worker->queue);
+        xSemaphoreGiveRecursive(loop->mutex);
+        return;
+    }
+
+    size_t count = 0;
+    while (count < CONFIG_ESP_EVENT_LOOP_BATCH_SIZE && xQueueReceive(worker->queue, &posts[count], 0) == pdTRUE) {
+        count++;
+    }
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    int64_t start = esp_timer_get_time();
+    for (size_t i = 0; i < count; i++) {
+        stats_add_wait(&worker->stats, &posts[i], start);
+    }
+#endif
+
+    worker->epoch = loop->epoch;
+    for (size_t i = 0; i < count; i++) {
+        entries[i] = dispatch_table_get(loop, posts[i].base, posts[i].id);
+        if (entries[i] != NULL) {
+            entries[i]->in_use++;
+        }
+    }
+    xSemaphoreGiveRecursive(loop->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t executed = 0;
+
+        if (entries[i] != NULL) {
+            for (size_t j = 0; j < entries[i]->count; j++) {
+                esp_event_handler_node_t *handler = entries[i]->handlers[j];
+                if (!handler->unregistered) {
+                    handler_execute(loop, handler, posts[i]);
+                    executed++;
+                }
+            }
+        } else {
+            // No entry for the event, the lists of nodes are only walked with the loop mutex taken
+            xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+            executed = loop_visit_handlers(loop, posts[i].base, posts[i].id, NULL, &posts[i]);
+            xSemaphoreGiveRecursive(loop->mutex);
+        }
+
+        if (executed == 0) {
+            ESP_LOGD(TAG, "no handlers have been registered for event %s:%"PRIu32" posted to loop %p", posts[i].base, posts[i].id, loop);
+        }
+        post_instance_delete(loop, &posts[i]);
+    }
+
+    xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    for (size_t i = 0; i < count; i++) {
+        if (entries[i] != NULL) {
+            entries[i]->in_use--;
+            if (entries[i]->stale && entries[i]->in_use == 0) {
+                free(entries[i]);
+            }
+        }
+    }
+    worker->epoch = 0;
+    loop_reclaim_retired(loop);
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    if (count > 0) {
+        worker->stats.batches++;
+        worker->stats.busy_time += esp_timer_get_time() - start;
+    }
+#endif
+    xSemaphoreGiveRecursive(loop->mutex);
+}
+
+static void esp_event_loop_run_worker(void* args)
+{
+    esp_event_loop_worker_t* worker = (esp_event_loop_worker_t*) args;
+    esp_event_post_instance_t post;
+
+    ESP_LOGD(TAG, "running worker %p for loop %p", worker, worker->loop);
+
+    while (1) {
+        // Wait for an event without taking it, the batch is taken from the queue by loop_worker_dispatch()
+        if (xQueuePeek(worker->queue, &post, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        loop_worker_dispatch(worker);
+    }
+}
+
 static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t* ctx)
 {
     esp_event_handler_node_t *handler_to_unregister = NULL;
@@ -557,6 +1060,182 @@ static bool event_loop_has_posts_in_flight(esp_event_loop_instance_t* loop)
     return posts_in_flight;
 }
 
+// Let a post in unless the loop is being deleted, the loop isn't deleted until post_exit() is called
+static bool post_enter(esp_event_loop_instance_t* loop)
+{
+    portENTER_CRITICAL(&loop->state.lock);
+    if (atomic_load(&loop->state.deleting)) {
+        portEXIT_CRITICAL(&loop->state.lock);
+        return false;
+    }
+    loop->state.posts_in_flight++;
+    portEXIT_CRITICAL(&loop->state.lock);
+
+    return true;
+}
+
+static void post_exit(esp_event_loop_instance_t* loop)
+{
+    portENTER_CRITICAL(&loop->state.lock);
+    loop->state.posts_in_flight--;
+    portEXIT_CRITICAL(&loop->state.lock);
+}
+
+// Send a post to the queue of the loop, the post is deleted if it can't be sent
+static esp_err_t post_send(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post, TickType_t ticks_to_wait)
+{
+    BaseType_t result = pdFALSE;
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    post->posted = esp_timer_get_time();
+#endif
+
+    // Find the task that currently executes the loop. It is safe to query loop->task and loop->workers since
+    // they are not mutated since loop creation. ENSURE THIS REMAINS TRUE.
+    if (loop->worker_count > 0) {
+        // A worker posting to a full queue must not wait for the workers to take events from it
+        result = xQueueSendToBack(loop_queue_of(loop, post->base), post, loop_is_worker(loop) ? 0 : ticks_to_wait);
+    } else if (loop->task == NULL) {
+        // The loop has no dedicated task. Find out what task is currently running it.
+        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+
+        if (result == pdTRUE) {
+            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(loop->queue, post, ticks_to_wait);
+            } else {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(loop->queue, post, 0);
+            }
+        }
+    } else {
+        // The loop has a dedicated task.
+        if (loop->task != xTaskGetCurrentTaskHandle()) {
+            result = xQueueSendToBack(loop->queue, post, ticks_to_wait);
+        } else {
+            result = xQueueSendToBack(loop->queue, post, 0);
+        }
+    }
+
+    if (result != pdTRUE) {
+        post_instance_delete(loop, post);
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        atomic_fetch_add(&loop->events_dropped, 1);
+#endif
+        return ESP_ERR_TIMEOUT;
+    }
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    atomic_fetch_add(&loop->events_received, 1);
+#endif
+
+    return ESP_OK;
+}
+
+static QueueHandle_t loop_queue_create(int32_t queue_size)
+{
+#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+    return xQueueCreateWithCaps(queue_size, sizeof(esp_event_post_instance_t), MALLOC_CAP_SPIRAM);
+#else
+    return xQueueCreate(queue_size, sizeof(esp_event_post_instance_t));
+#endif // CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+}
+
+static void loop_queue_delete(QueueHandle_t queue)
+{
+#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+    vQueueDeleteWithCaps(queue);
+#else
+    vQueueDelete(queue);
+#endif
+}
+
+static BaseType_t loop_task_create(TaskFunction_t task_function, const esp_event_loop_args_t* event_loop_args, void* arg,
+                                   TaskHandle_t* task, BaseType_t core_id)
+{
+#if !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+    return xTaskCreatePinnedToCore(task_function,
+                                   event_loop_args->task_name,
+                                   event_loop_args->task_stack_size,
+                                   arg,
+                                   event_loop_args->task_priority,
+                                   task,
+                                   core_id);
+#else
+    return xTaskCreatePinnedToCoreWithCaps(task_function,
+                                           event_loop_args->task_name,
+                                           event_loop_args->task_stack_size,
+                                           arg,
+                                           event_loop_args->task_priority,
+                                           task,
+                                           core_id,
+                                           MALLOC_CAP_SPIRAM);
+#endif // !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+}
+
+static void loop_task_delete(TaskHandle_t task)
+{
+#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+    vTaskDeleteWithCaps(task);
+#else
+    vTaskDelete(task);
+#endif
+}
+
+// Create the tasks of a loop run by several tasks, each with its own queue. The first worker uses the queue of the loop.
+static esp_err_t loop_workers_create(esp_event_loop_instance_t* loop, const esp_event_loop_args_t* event_loop_args)
+{
+    loop->workers = esp_event_calloc(event_loop_args->task_count, sizeof(*loop->workers));
+    if (loop->workers == NULL) {
+        ESP_LOGE(TAG, "alloc for event loop workers failed");
+        return ESP_ERR_NO_MEM;
+    }
+    loop->worker_count = event_loop_args->task_count;
+
+    for (size_t i = 0; i < loop->worker_count; i++) {
+        esp_event_loop_worker_t* worker = &loop->workers[i];
+
+        worker->loop = loop;
+        worker->queue = (i == 0) ? loop->queue : loop_queue_create(event_loop_args->queue_size);
+        if (worker->queue == NULL) {
+            ESP_LOGE(TAG, "create event loop queue failed");
+            return ESP_ERR_NO_MEM;
+        }
+
+        BaseType_t core_id = event_loop_args->task_core_id;
+        if (core_id != tskNO_AFFINITY) {
+            core_id = (core_id + i) % portNUM_PROCESSORS;
+        }
+        if (loop_task_create(esp_event_loop_run_worker, event_loop_args, worker, &worker->task, core_id) != pdPASS) {
+            ESP_LOGE(TAG, "create task for loop failed");
+            return ESP_FAIL;
+        }
+    }
+
+    ESP_LOGD(TAG, "created %u tasks for loop %p", (unsigned)loop->worker_count, loop);
+
+    return ESP_OK;
+}
+
+// Delete the tasks of a loop run by several tasks and their queues, except the queue of the loop
+static void loop_workers_delete(esp_event_loop_instance_t* loop)
+{
+    for (size_t i = 0; i < loop->worker_count; i++) {
+        esp_event_loop_worker_t* worker = &loop->workers[i];
+
+        if (worker->task != NULL) {
+            loop_task_delete(worker->task);
+        }
+        if (i != 0 && worker->queue != NULL) {
+            loop_queue_delete(worker->queue);
+        }
+    }
+    free(loop->workers);
+    loop->workers = NULL;
+    loop->worker_count = 0;
+}
+
 /* ---------------------------- Public API --------------------------------- */
 
 esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, esp_event_loop_handle_t* event_loop)
@@ -580,11 +1259,7 @@ esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, es
         return err;
     }
 
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-    loop->queue = xQueueCreateWithCaps(event_loop_args->queue_size, sizeof(esp_event_post_instance_t), MALLOC_CAP_SPIRAM);
-#else
-    loop->queue = xQueueCreate(event_loop_args->queue_size, sizeof(esp_event_post_instance_t));
-#endif // CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
+    loop->queue = loop_queue_create(event_loop_args->queue_size);
     if (loop->queue == NULL) {
         ESP_LOGE(TAG, "create event loop queue failed");
         goto on_err;
@@ -596,32 +1271,36 @@ esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, es
         goto on_err;
     }
 
+    err = payload_slab_init(&loop->slab, event_loop_args->payload_slot_size, event_loop_args->payload_slots);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "alloc for payload slab failed");
+        goto on_err;
+    }
+    err = ESP_ERR_NO_MEM;
+
     loop->state.lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
     atomic_init(&loop->state.deleting, false);
     loop->state.posts_in_flight = 0;
 
     SLIST_INIT(&(loop->loop_nodes));
+    SLIST_INIT(&(loop->retired));
+    loop->epoch = 1;
 
-    // Create the loop task if requested
-    if (event_loop_args->task_name != NULL) {
-#if !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
-        BaseType_t task_created = xTaskCreatePinnedToCore(esp_event_loop_run_task,
-                                                          event_loop_args->task_name,
-                                                          event_loop_args->task_stack_size,
-                                                          (void*) loop,
-                                                          event_loop_args->task_priority,
-                                                          &(loop->task),
-                                                          event_loop_args->task_core_id);
-#else
-        BaseType_t task_created = xTaskCreatePinnedToCoreWithCaps(esp_event_loop_run_task,
-                                                                  event_loop_args->task_name,
-                                                                  event_loop_args->task_stack_size,
-                                                                  (void*) loop,
-                                                                  event_loop_args->task_priority,
-                                                                  &(loop->task),
-                                                                  event_loop_args->task_core_id,
-                                                                  MALLOC_CAP_SPIRAM);
-#endif // !CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    loop->created = esp_timer_get_time();
+#endif
+
+    // Create the loop tasks if requested
+    if (event_loop_args->task_name != NULL && event_loop_args->task_count > 1) {
+        err = loop_workers_create(loop, event_loop_args);
+        if (err != ESP_OK) {
+            goto on_err;
+        }
+
+        loop->name = event_loop_args->task_name;
+    } else if (event_loop_args->task_name != NULL) {
+        BaseType_t task_created = loop_task_create(esp_event_loop_run_task, event_loop_args, (void*) loop,
+                                                   &(loop->task), event_loop_args->task_core_id);
 
         if (task_created != pdPASS) {
             ESP_LOGE(TAG, "create task for loop failed");
@@ -652,29 +1331,27 @@ esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, es
     return ESP_OK;
 
 on_err:
+    loop_workers_delete(loop);
+
     if (loop->queue != NULL) {
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-        vQueueDeleteWithCaps(loop->queue);
-#else
-        vQueueDelete(loop->queue);
-#endif
+        loop_queue_delete(loop->queue);
     }
 
     if (loop->mutex != NULL) {
         vSemaphoreDelete(loop->mutex);
     }
 
+    free(loop->slab.slots);
     free(loop);
 
     return err;
 }
 
-// On event lookup performance: The library implements the event list as a linked list, which results to O(n)
-// lookup time. The test comparing this implementation to the O(lg n) performance of rbtrees
-// (https://github.com/freebsd/freebsd/blob/master/sys/sys/tree.h)
-// indicate that the difference is not that substantial, especially considering the additional
-// pointers per node of rbtrees. Code for the rbtree implementation of the event loop library is archived
-// in feature/esp_event_loop_library_rbtrees if needed.
+// On event lookup performance: The handlers are registered in linked lists of loop, base and id nodes, which
+// define the order of execution. Walking these lists for each post is O(n) in the number of registrations, so
+// the handlers of each posted event are kept in the dispatch table of the loop: a hash table of flat arrays of
+// handlers, built on the first post of the event and invalidated when a handler of the event is registered or
+// unregistered. Dispatching a post is then O(1) in the number of handlers of other events.
 esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t ticks_to_run)
 {
     assert(event_loop);
@@ -694,6 +1371,11 @@ esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t tick
         // The event has already been unqueued, so ensure it gets executed.
         xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
 
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        int64_t start = esp_timer_get_time();
+        stats_add_wait(&loop->stats, &post, start);
+#endif
+
         bool exec = false;
 
         // check if the event retrieve from the queue is the internal event that is
@@ -712,52 +1394,37 @@ esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t tick
         } else {
             loop->running_task = xTaskGetCurrentTaskHandle();
 
-            esp_event_handler_node_t *handler, *temp_handler;
-            esp_event_loop_node_t *loop_node, *temp_node;
-            esp_event_base_node_t *base_node, *temp_base;
-            esp_event_id_node_t *id_node, *temp_id_node;
+            esp_event_dispatch_entry_t* entry = dispatch_table_get(loop, post.base, post.id);
 
-            SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
-                // Execute loop level handlers
-                SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
+            if (entry != NULL) {
+                // The entry stays valid while its handlers run, even if they (un)register handlers
+                entry->in_use++;
+                for (size_t i = 0; i < entry->count; i++) {
+                    esp_event_handler_node_t *handler = entry->handlers[i];
                     if (!handler->unregistered) {
                         handler_execute(loop, handler, post);
                         exec |= true;
                     }
                 }
-
-                SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
-                    if (base_node->base == post.base) {
-                        // Execute base level handlers
-                        SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
-                            if (!handler->unregistered) {
-                                handler_execute(loop, handler, post);
-                                exec |= true;
-                            }
-                        }
-
-                        SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
-                            if (id_node->id == post.id) {
-                                // Execute id level handlers
-                                SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
-                                    if (!handler->unregistered) {
-                                        handler_execute(loop, handler, post);
-                                        exec |= true;
-                                    }
-                                }
-                                // Skip to next base node
-                                break;
-                            }
-                        }
-                    }
+                entry->in_use--;
+                if (entry->stale && entry->in_use == 0) {
+                    free(entry);
                 }
+            } else {
+                // No entry for the event, execute the handlers while walking the lists of nodes
+                exec |= loop_visit_handlers(loop, post.base, post.id, NULL, &post) > 0;
             }
         }
 
         esp_event_base_t base = post.base;
         int32_t id = post.id;
 
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        loop->stats.batches++;
+        loop->stats.busy_time += esp_timer_get_time() - start;
+#endif
 
         if (ticks_to_run != portMAX_DELAY) {
             end = xTaskGetTickCount();
@@ -796,9 +1463,9 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
     xSemaphoreTakeRecursive(loop_mutex, portMAX_DELAY);
 
     atomic_store(&loop->state.deleting, true);
-    while (event_loop_has_posts_in_flight(loop)) {
+    while (event_loop_has_posts_in_flight(loop) || loop_workers_busy(loop)) {
         xSemaphoreGiveRecursive(loop_mutex);
-        // Wait for the posts in flight to finish
+        // Wait for the posts in flight and the batches being dispatched to finish
         vTaskDelay(1);
         xSemaphoreTakeRecursive(loop_mutex, portMAX_DELAY);
     }
@@ -809,15 +1476,15 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
     portEXIT_CRITICAL(&s_event_loops_spinlock);
 #endif
 
-    // Delete the task if it was created
+    // Delete the tasks if they were created
     if (loop->task != NULL) {
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM
-        vTaskDeleteWithCaps(loop->task);
-#else
-        vTaskDelete(loop->task);
-#endif
+        loop_task_delete(loop->task);
         loop->task = NULL;
     }
+    for (size_t i = 0; i < loop->worker_count; i++) {
+        loop_task_delete(loop->workers[i].task);
+        loop->workers[i].task = NULL;
+    }
 
     // Remove all registered events and handlers in the loop
     esp_event_loop_node_t *it, *temp;
@@ -826,25 +1493,19 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
         SLIST_REMOVE(&(loop->loop_nodes), it, esp_event_loop_node, next);
         free(it);
     }
+    handler_instances_remove_all(&(loop->retired));
+    dispatch_table_clear(&loop->dispatch);
 
-    // Drop existing posts on the queue
-    esp_event_post_instance_t post;
-    while (xQueueReceive(loop->queue, &post, 0) == pdTRUE) {
-        if (post.base == esp_event_handler_cleanup) {
-            esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post.data.ptr;
-            if (ctx->legacy) {
-                free(ctx->handler_ctx);
-            }
-        }
-        post_instance_delete(&post);
+    // Drop existing posts on the queues
+    for (size_t i = 1; i < loop->worker_count; i++) {
+        loop_queue_drop_posts(loop, loop->workers[i].queue);
     }
+    loop_queue_drop_posts(loop, loop->queue);
 
     // Cleanup loop
-#if CONFIG_ESP_EVENT_LOOP_IN_EXT_RAM && !CONFIG_ESP_EVENT_POST_FROM_IRAM_ISR
-    vQueueDeleteWithCaps(loop->queue);
-#else
-    vQueueDelete(loop->queue);
-#endif
+    loop_workers_delete(loop);
+    loop_queue_delete(loop->queue);
+    free(loop->slab.slots);
     free(loop);
     // Free loop mutex before deleting
     xSemaphoreGiveRecursive(loop_mutex);
@@ -911,6 +1572,10 @@ esp_err_t esp_event_handler_register_with_internal(esp_event_loop_handle_t event
         err = loop_node_add_handler(last_loop_node, event_base, event_id, event_handler, event_handler_arg, handler_ctx_arg, legacy);
     }
 
+    if (err == ESP_OK) {
+        dispatch_table_invalidate(&loop->dispatch, event_base, event_id);
+    }
+
 on_err:
     xSemaphoreGiveRecursive(loop->mutex);
     return err;
@@ -947,6 +1612,26 @@ esp_err_t esp_event_handler_unregister_with_internal(esp_event_loop_handle_t eve
     esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
     esp_event_remove_handler_context_t remove_handler_ctx = {loop, event_base, event_id, handler_ctx, legacy};
 
+    if (loop->worker_count > 0) {
+        /* The workers of the loop execute handlers without holding the mutex, the handler is retired and
+         * only freed once no worker can execute it anymore. Unless called from a handler of the loop, wait
+         * until then, so that the handler is not running anymore when this function returns, as for loops
+         * run by a single task. */
+        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+        uint32_t epoch = loop->epoch;
+        esp_err_t res = loop_remove_handler(&remove_handler_ctx);
+        if (res == ESP_OK && !loop_is_worker(loop)) {
+            while (!loop_epoch_passed(loop, epoch)) {
+                xSemaphoreGiveRecursive(loop->mutex);
+                vTaskDelay(1);
+                xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+            }
+            loop_reclaim_retired(loop);
+        }
+        xSemaphoreGiveRecursive(loop->mutex);
+        return res;
+    }
+
     /* remove the handler if the mutex is taken successfully.
      * otherwise it will be removed from the list later */
     esp_err_t res = ESP_FAIL;
@@ -1007,13 +1692,9 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
 
     esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
 
-    portENTER_CRITICAL(&loop->state.lock);
-    if (atomic_load(&loop->state.deleting)) {
-        portEXIT_CRITICAL(&loop->state.lock);
+    if (!post_enter(loop)) {
         return ESP_ERR_INVALID_STATE;
     }
-    loop->state.posts_in_flight++;
-    portEXIT_CRITICAL(&loop->state.lock);
 
     esp_event_post_instance_t post;
     memset((void*)(&post), 0, sizeof(post));
@@ -1022,7 +1703,7 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     if (event_data != NULL && event_data_size != 0) {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
         if (event_data_size > sizeof(post.data.val)) {
-            post.data.ptr = calloc(1, event_data_size);
+            post.data.ptr = payload_alloc(loop, event_data_size);
             if (post.data.ptr == NULL) {
                 err = ESP_ERR_NO_MEM;
                 goto on_err;
@@ -1034,8 +1715,8 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
         }
         post.data_set = true;
 #else // !CONFIG_ESP_EVENT_POST_FROM_ISR
-        // Make persistent copy of event data on heap.
-        void* event_data_copy = esp_event_calloc(1, event_data_size);
+        // Make persistent copy of event data, in the slab of the loop or on heap.
+        void* event_data_copy = payload_alloc(loop, event_data_size);
 
         if (event_data_copy == NULL) {
             err = ESP_ERR_NO_MEM;
@@ -1049,54 +1730,89 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     post.base = event_base;
     post.id = event_id;
 
-    BaseType_t result = pdFALSE;
+    err = post_send(loop, &post, ticks_to_wait);
 
-    // Find the task that currently executes the loop. It is safe to query loop->task since it is
-    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
-    if (loop->task == NULL) {
-        // The loop has no dedicated task. Find out what task is currently running it.
-        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+on_err:
+    post_exit(loop);
 
-        if (result == pdTRUE) {
-            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-            } else {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, 0);
-            }
-        }
-    } else {
-        // The loop has a dedicated task.
-        if (loop->task != xTaskGetCurrentTaskHandle()) {
-            result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-        } else {
-            result = xQueueSendToBack(loop->queue, &post, 0);
-        }
+    return err;
+}
+
+esp_err_t esp_event_post_acquire(esp_event_loop_handle_t event_loop, size_t event_data_size, void** event_data)
+{
+    assert(event_loop);
+
+    if (event_data == NULL || event_data_size == 0) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (result != pdTRUE) {
-        post_instance_delete(&post);
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-        atomic_fetch_add(&loop->events_dropped, 1);
-#endif
-        err = ESP_ERR_TIMEOUT;
-        goto on_err;
+    // The buffer counts as a post in flight until it is committed or cancelled, so that the loop and its slab
+    // are not deleted meanwhile
+    if (!post_enter(loop)) {
+        return ESP_ERR_INVALID_STATE;
     }
 
-#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    atomic_fetch_add(&loop->events_received, 1);
+    *event_data = payload_alloc(loop, event_data_size);
+    if (*event_data == NULL) {
+        post_exit(loop);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post_commit(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id,
+                                void* event_data, TickType_t ticks_to_wait)
+{
+    assert(event_loop);
+
+    if (event_data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+    esp_err_t err;
+
+    if (event_base == ESP_EVENT_ANY_BASE || event_id == ESP_EVENT_ANY_ID) {
+        payload_free(loop, event_data);
+        err = ESP_ERR_INVALID_ARG;
+    } else {
+        esp_event_post_instance_t post;
+        memset((void*)(&post), 0, sizeof(post));
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+        post.data_allocated = true;
+        post.data_set = true;
 #endif
+        post.data.ptr = event_data;
+        post.base = event_base;
+        post.id = event_id;
 
-on_err:
-    portENTER_CRITICAL(&loop->state.lock);
-    loop->state.posts_in_flight--;
-    portEXIT_CRITICAL(&loop->state.lock);
+        err = post_send(loop, &post, ticks_to_wait);
+    }
+
+    post_exit(loop);
 
     return err;
 }
 
+esp_err_t esp_event_post_cancel(esp_event_loop_handle_t event_loop, void* event_data)
+{
+    assert(event_loop);
+
+    if (event_data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    payload_free(loop, event_data);
+    post_exit(loop);
+
+    return ESP_OK;
+}
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id,
                                 const void* event_data, size_t event_data_size, BaseType_t* task_unblocked)
@@ -1130,11 +1846,15 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop, esp_event_ba
 
     BaseType_t result = pdFALSE;
 
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    post.posted = esp_timer_get_time();
+#endif
+
     // Post the event from an ISR,
-    result = xQueueSendToBackFromISR(loop->queue, &post, task_unblocked);
+    result = xQueueSendToBackFromISR(loop_queue_of(loop, post.base), &post, task_unblocked);
 
     if (result != pdTRUE) {
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
         atomic_fetch_add(&loop->events_dropped, 1);
@@ -1177,21 +1897,51 @@ esp_err_t esp_event_dump(FILE* file)
         events_received = atomic_load(&loop_it->events_received);
         events_dropped = atomic_load(&loop_it->events_dropped);
 
-        PRINT_DUMP_INFO(dst, sz, LOOP_DUMP_FORMAT, loop_it, loop_it->task != NULL ? loop_it->name : "none",
+        PRINT_DUMP_INFO(dst, sz, LOOP_DUMP_FORMAT, loop_it, (loop_it->task != NULL || loop_it->worker_count > 0) ? loop_it->name : "none",
                         events_received, events_dropped);
 
+        esp_event_loop_stats_t waits = loop_it->stats;
+        for (size_t i = 0; i < loop_it->worker_count; i++) {
+            const esp_event_loop_stats_t* stats = &loop_it->workers[i].stats;
+            waits.events += stats->events;
+            waits.wait_time += stats->wait_time;
+            if (stats->max_wait_time > waits.max_wait_time) {
+                waits.max_wait_time = stats->max_wait_time;
+            }
+        }
+        PRINT_DUMP_INFO(dst, sz, WAIT_DUMP_FORMAT, waits.events, waits.events ? waits.wait_time / waits.events : 0,
+                        waits.max_wait_time);
+
+        int64_t lifetime = esp_timer_get_time() - loop_it->created;
+        if (loop_it->worker_count > 0) {
+            for (size_t i = 0; i < loop_it->worker_count; i++) {
+                const esp_event_loop_stats_t* stats = &loop_it->workers[i].stats;
+                PRINT_DUMP_INFO(dst, sz, WORKER_DUMP_FORMAT, (unsigned)i, stats->events, stats->batches, stats->busy_time,
+                                esp_event_dump_utilisation(stats, lifetime));
+            }
+        } else if (loop_it->task != NULL) {
+            PRINT_DUMP_INFO(dst, sz, WORKER_DUMP_FORMAT, 0U, loop_it->stats.events, loop_it->stats.batches,
+                            loop_it->stats.busy_time, esp_event_dump_utilisation(&loop_it->stats, lifetime));
+        }
+
+        if (loop_it->slab.slots != NULL) {
+            esp_event_payload_slab_t* slab = &loop_it->slab;
+            PRINT_DUMP_INFO(dst, sz, SLAB_DUMP_FORMAT, (unsigned)slab->slot_count, (unsigned)slab->slot_size,
+                            (unsigned)slab->used, (unsigned)slab->high_water, slab->fallbacks);
+        }
+
         int sz_bak = sz;
 
         SLIST_FOREACH(loop_node_it, &(loop_it->loop_nodes), next) {
             SLIST_FOREACH(handler_it, &(loop_node_it->handlers), next) {
                 PRINT_DUMP_INFO(dst, sz, HANDLER_DUMP_FORMAT, handler_it->handler_ctx->handler, "ESP_EVENT_ANY_BASE",
-                                "ESP_EVENT_ANY_ID", handler_it->invoked, handler_it->time);
+                                "ESP_EVENT_ANY_ID", (uint32_t)atomic_load(&handler_it->invoked), (long long)atomic_load(&handler_it->time));
             }
 
             SLIST_FOREACH(base_node_it, &(loop_node_it->base_nodes), next) {
                 SLIST_FOREACH(handler_it, &(base_node_it->handlers), next) {
                     PRINT_DUMP_INFO(dst, sz, HANDLER_DUMP_FORMAT, handler_it->handler_ctx->handler, base_node_it->base,
-                                    "ESP_EVENT_ANY_ID", handler_it->invoked, handler_it->time);
+                                    "ESP_EVENT_ANY_ID", (uint32_t)atomic_load(&handler_it->invoked), (long long)atomic_load(&handler_it->time));
                 }
 
                 SLIST_FOREACH(id_node_it, &(base_node_it->id_nodes), next) {
@@ -1200,7 +1950,7 @@ esp_err_t esp_event_dump(FILE* file)
                         snprintf(id_str_buf, sizeof(id_str_buf), "%" PRIi32, id_node_it->id);
 
                         PRINT_DUMP_INFO(dst, sz, HANDLER_DUMP_FORMAT, handler_it->handler_ctx->handler, base_node_it->base,
-                                        id_str_buf, handler_it->invoked, handler_it->time);
+                                        id_str_buf, (uint32_t)atomic_load(&handler_it->invoked), (long long)atomic_load(&handler_it->time));
                     }
                 }
             }
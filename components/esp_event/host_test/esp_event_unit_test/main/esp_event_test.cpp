@@ -8,6 +8,10 @@
 */
 
 #include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <deque>
+#include <vector>
 #include "esp_event.h"
 
 #include <catch2/catch_test_macros.hpp>
@@ -158,3 +162,326 @@ TEST_CASE("registering with ANY_BASE but specific ID fails")
                                           dummy_handler,
                                           nullptr) == ESP_ERR_INVALID_ARG);
 }
+
+namespace {
+
+ESP_EVENT_DEFINE_BASE(TEST_BASE);
+ESP_EVENT_DEFINE_BASE(TEST_OTHER_BASE);
+
+/**
+ * Event loop without a dedicated task, whose queue is an in-memory FIFO standing in for the mocked FreeRTOS queue,
+ * so that the events posted to it are dispatched by esp_event_loop_run().
+ */
+struct FakeQueueLoop : public CMockFix {
+    FakeQueueLoop(uint32_t payload_slots = 0, uint32_t payload_slot_size = 0)
+    {
+        s_items.clear();
+        xQueueGenericCreate_Stub([](UBaseType_t length, UBaseType_t item_size, uint8_t type, [[maybe_unused]] int num_calls) {
+            s_item_size = item_size;
+            return reinterpret_cast<QueueHandle_t>(&s_items);
+        });
+        xQueueGenericSend_Stub([](QueueHandle_t queue, const void *item, TickType_t ticks, BaseType_t position, [[maybe_unused]] int num_calls) {
+            const uint8_t *bytes = static_cast<const uint8_t*>(item);
+            s_items.emplace_back(bytes, bytes + s_item_size);
+            return static_cast<BaseType_t>(pdTRUE);
+        });
+        xQueueReceive_Stub([](QueueHandle_t queue, void *buffer, TickType_t ticks, [[maybe_unused]] int num_calls) {
+            if (s_items.empty()) {
+                return static_cast<BaseType_t>(pdFALSE);
+            }
+            memcpy(buffer, s_items.front().data(), s_item_size);
+            s_items.pop_front();
+            return static_cast<BaseType_t>(pdTRUE);
+        });
+        xQueueCreateMutex_IgnoreAndReturn(reinterpret_cast<QueueHandle_t>(0xdeadbeef));
+        xQueueTakeMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xQueueGiveMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xTaskGetCurrentTaskHandle_IgnoreAndReturn(reinterpret_cast<TaskHandle_t>(1));
+        xTaskGetTickCount_IgnoreAndReturn(0);
+        vQueueDelete_Ignore();
+        vPortEnterCritical_Ignore();
+        vPortExitCritical_Ignore();
+
+        esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+        loop_args.task_name = nullptr;
+        loop_args.payload_slots = payload_slots;
+        loop_args.payload_slot_size = payload_slot_size;
+        REQUIRE(esp_event_loop_create(&loop_args, &loop) == ESP_OK);
+    }
+
+    ~FakeQueueLoop()
+    {
+        esp_event_loop_delete(loop);
+
+        xQueueGenericCreate_Stub(nullptr);
+        xQueueGenericSend_Stub(nullptr);
+        xQueueReceive_Stub(nullptr);
+        xQueueCreateMutex_StopIgnore();
+        xQueueTakeMutexRecursive_StopIgnore();
+        xQueueGiveMutexRecursive_StopIgnore();
+        xTaskGetCurrentTaskHandle_StopIgnore();
+        xTaskGetTickCount_StopIgnore();
+        vQueueDelete_StopIgnore();
+        vPortEnterCritical_StopIgnore();
+        vPortExitCritical_StopIgnore();
+    }
+
+    void dispatch()
+    {
+        CHECK(esp_event_loop_run(loop, portMAX_DELAY) == ESP_OK);
+    }
+
+    esp_event_loop_handle_t loop = nullptr;
+    static std::deque<std::vector<uint8_t>> s_items;
+    static size_t s_item_size;
+};
+
+std::deque<std::vector<uint8_t>> FakeQueueLoop::s_items;
+size_t FakeQueueLoop::s_item_size;
+
+struct Recorder {
+    std::vector<int> calls;
+};
+
+struct RecordedHandler {
+    Recorder *recorder;
+    int label;
+};
+
+void recording_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    RecordedHandler *handler = static_cast<RecordedHandler*>(event_handler_arg);
+    handler->recorder->calls.push_back(handler->label);
+}
+
+struct ReplacingHandler {
+    esp_event_loop_handle_t loop;
+    esp_event_handler_instance_t instance;
+    RecordedHandler recorded;
+    RecordedHandler *replacement;
+};
+
+// Unregisters itself and registers its replacement for the same event
+void replacing_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    ReplacingHandler *handler = static_cast<ReplacingHandler*>(event_handler_arg);
+    recording_handler(&handler->recorded, event_base, event_id, event_data);
+    CHECK(esp_event_handler_instance_unregister_with(handler->loop, event_base, event_id, handler->instance) == ESP_OK);
+    CHECK(esp_event_handler_register_with(handler->loop, event_base, event_id, recording_handler, handler->replacement) == ESP_OK);
+}
+
+// Records the address and the first byte of the data of each event
+void data_recording_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    auto *received = static_cast<std::vector<std::pair<void*, uint8_t>>*>(event_handler_arg);
+    received->emplace_back(event_data, *static_cast<uint8_t*>(event_data));
+}
+
+void counting_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    (*static_cast<size_t*>(event_handler_arg))++;
+}
+
+}
+
+TEST_CASE("handlers of an event are dispatched in registration order")
+{
+    FakeQueueLoop fix;
+    Recorder recorder;
+    RecordedHandler any_base = {&recorder, 1};
+    RecordedHandler any_id = {&recorder, 2};
+    RecordedHandler event = {&recorder, 3};
+    RecordedHandler any_base_late = {&recorder, 4};
+    RecordedHandler other_event = {&recorder, 5};
+    esp_event_handler_instance_t instances[5];
+
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, ESP_EVENT_ANY_BASE, ESP_EVENT_ANY_ID, recording_handler, &any_base, &instances[0]) == ESP_OK);
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_BASE, ESP_EVENT_ANY_ID, recording_handler, &any_id, &instances[1]) == ESP_OK);
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_BASE, 7, recording_handler, &event, &instances[2]) == ESP_OK);
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, ESP_EVENT_ANY_BASE, ESP_EVENT_ANY_ID, recording_handler, &any_base_late, &instances[3]) == ESP_OK);
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_OTHER_BASE, 7, recording_handler, &other_event, &instances[4]) == ESP_OK);
+
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 7, nullptr, 0, 0) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 8, nullptr, 0, 0) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_OTHER_BASE, 7, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+
+    CHECK(recorder.calls == std::vector<int>({1, 2, 3, 4, 1, 2, 4, 1, 4, 5}));
+}
+
+TEST_CASE("dispatch follows handler registration and unregistration")
+{
+    FakeQueueLoop fix;
+    Recorder recorder;
+    RecordedHandler first = {&recorder, 1};
+    RecordedHandler second = {&recorder, 2};
+    RecordedHandler any_id = {&recorder, 3};
+    esp_event_handler_instance_t first_instance, second_instance, any_id_instance;
+
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_BASE, 1, recording_handler, &first, &first_instance) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(recorder.calls == std::vector<int>({1}));
+
+    recorder.calls.clear();
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_BASE, 1, recording_handler, &second, &second_instance) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(recorder.calls == std::vector<int>({1, 2}));
+
+    recorder.calls.clear();
+    REQUIRE(esp_event_handler_instance_unregister_with(fix.loop, TEST_BASE, 1, first_instance) == ESP_OK);
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_BASE, ESP_EVENT_ANY_ID, recording_handler, &any_id, &any_id_instance) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, nullptr, 0, 0) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 2, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(recorder.calls == std::vector<int>({2, 3, 3}));
+
+    recorder.calls.clear();
+    REQUIRE(esp_event_handler_instance_unregister_with(fix.loop, TEST_BASE, ESP_EVENT_ANY_ID, any_id_instance) == ESP_OK);
+    REQUIRE(esp_event_handler_instance_unregister_with(fix.loop, TEST_BASE, 1, second_instance) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(recorder.calls.empty());
+}
+
+TEST_CASE("handlers (un)registered by a handler take effect from the next post")
+{
+    FakeQueueLoop fix;
+    Recorder recorder;
+    RecordedHandler replacement = {&recorder, 2};
+    ReplacingHandler replaced = {fix.loop, nullptr, {&recorder, 1}, &replacement};
+
+    REQUIRE(esp_event_handler_instance_register_with(fix.loop, TEST_BASE, 1, replacing_handler, &replaced, &replaced.instance) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(recorder.calls == std::vector<int>({1}));
+
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(recorder.calls == std::vector<int>({1, 2}));
+}
+
+TEST_CASE("events without handlers or beyond the dispatch table capacity are dispatched")
+{
+    const int32_t EVENTS = 1000;
+    FakeQueueLoop fix;
+    size_t count = 0;
+    size_t late_count = 0;
+
+    // Events without handlers aren't kept, a handler registered afterwards receives them
+    for (int32_t id = 0; id < EVENTS; id++) {
+        REQUIRE(esp_event_post_to(fix.loop, TEST_OTHER_BASE, id, nullptr, 0, 0) == ESP_OK);
+    }
+    fix.dispatch();
+    REQUIRE(esp_event_handler_register_with(fix.loop, TEST_OTHER_BASE, 5, counting_handler, &late_count) == ESP_OK);
+    REQUIRE(esp_event_post_to(fix.loop, TEST_OTHER_BASE, 5, nullptr, 0, 0) == ESP_OK);
+    fix.dispatch();
+    CHECK(late_count == 1);
+
+    // More events with handlers than the dispatch table holds
+    REQUIRE(esp_event_handler_register_with(fix.loop, TEST_BASE, ESP_EVENT_ANY_ID, counting_handler, &count) == ESP_OK);
+    for (int round = 0; round < 2; round++) {
+        for (int32_t id = 0; id < EVENTS; id++) {
+            REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, id, nullptr, 0, 0) == ESP_OK);
+        }
+        fix.dispatch();
+    }
+    CHECK(count == 2 * EVENTS);
+}
+
+// The rates are only printed, timing depends too much on the host to be checked
+TEST_CASE("dispatch rate with a growing number of registered handlers")
+{
+    const size_t POSTS = 20000;
+    const size_t handler_counts[] = {1, 16, 64, 256};
+
+    for (size_t i = 0; i < sizeof(handler_counts) / sizeof(handler_counts[0]); i++) {
+        FakeQueueLoop fix;
+        size_t other_calls = 0;
+        size_t calls = 0;
+
+        // handlers of other events of the same base and of another base, registered before the handler of the posted event
+        for (size_t j = 1; j < handler_counts[i]; j++) {
+            esp_event_base_t base = (j % 2) ? TEST_BASE : TEST_OTHER_BASE;
+            REQUIRE(esp_event_handler_register_with(fix.loop, base, static_cast<int32_t>(j), counting_handler, &other_calls) == ESP_OK);
+        }
+        REQUIRE(esp_event_handler_register_with(fix.loop, TEST_BASE, 0, counting_handler, &calls) == ESP_OK);
+
+        for (size_t j = 0; j < POSTS; j++) {
+            REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 0, nullptr, 0, 0) == ESP_OK);
+        }
+        auto start = std::chrono::steady_clock::now();
+        fix.dispatch();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        CHECK(calls == POSTS);
+        CHECK(other_calls == 0);
+        printf("%4zu handlers registered: %10.0f posts/s\n", handler_counts[i], POSTS / elapsed.count());
+    }
+}
+
+TEST_CASE("event data acquired for posting is delivered in place and its slot is reused")
+{
+    FakeQueueLoop fix(2, 16);
+    std::vector<std::pair<void*, uint8_t>> received;
+    void *data[3];
+
+    REQUIRE(esp_event_handler_register_with(fix.loop, TEST_BASE, 1, data_recording_handler, &received) == ESP_OK);
+
+    // the third buffer doesn't fit in the slab and is allocated from the heap
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(esp_event_post_acquire(fix.loop, 16, &data[i]) == ESP_OK);
+        memset(data[i], i + 1, 16);
+    }
+    CHECK(data[1] == static_cast<uint8_t*>(data[0]) + 16);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(esp_event_post_commit(fix.loop, TEST_BASE, 1, data[i], 0) == ESP_OK);
+    }
+    fix.dispatch();
+
+    CHECK(received == std::vector<std::pair<void*, uint8_t>>({{data[0], 1}, {data[1], 2}, {data[2], 3}}));
+
+    void *reused[2];
+    REQUIRE(esp_event_post_acquire(fix.loop, 16, &reused[0]) == ESP_OK);
+    REQUIRE(esp_event_post_acquire(fix.loop, 16, &reused[1]) == ESP_OK);
+    CHECK(((reused[0] == data[0] && reused[1] == data[1]) || (reused[0] == data[1] && reused[1] == data[0])));
+    CHECK(esp_event_post_cancel(fix.loop, reused[0]) == ESP_OK);
+    CHECK(esp_event_post_cancel(fix.loop, reused[1]) == ESP_OK);
+}
+
+TEST_CASE("event data acquired for posting is released when the event is not posted")
+{
+    FakeQueueLoop fix(1, 16);
+    void *data;
+    void *again;
+
+    REQUIRE(esp_event_post_acquire(fix.loop, 8, &data) == ESP_OK);
+    CHECK(esp_event_post_commit(fix.loop, ESP_EVENT_ANY_BASE, 1, data, 0) == ESP_ERR_INVALID_ARG);
+
+    REQUIRE(esp_event_post_acquire(fix.loop, 8, &again) == ESP_OK);
+    CHECK(again == data);
+    CHECK(esp_event_post_cancel(fix.loop, again) == ESP_OK);
+
+    REQUIRE(esp_event_post_acquire(fix.loop, 8, &again) == ESP_OK);
+    CHECK(again == data);
+    CHECK(esp_event_post_cancel(fix.loop, again) == ESP_OK);
+}
+
+TEST_CASE("event data posted by copy is held by the payload slab")
+{
+    FakeQueueLoop fix(1, 16);
+    std::vector<std::pair<void*, uint8_t>> received;
+    void *slot;
+    uint8_t event_data[12];
+
+    REQUIRE(esp_event_post_acquire(fix.loop, 16, &slot) == ESP_OK);
+    REQUIRE(esp_event_post_cancel(fix.loop, slot) == ESP_OK);
+    REQUIRE(esp_event_handler_register_with(fix.loop, TEST_BASE, 1, data_recording_handler, &received) == ESP_OK);
+
+    memset(event_data, 0x5a, sizeof(event_data));
+    REQUIRE(esp_event_post_to(fix.loop, TEST_BASE, 1, event_data, sizeof(event_data), 0) == ESP_OK);
+    fix.dispatch();
+
+    CHECK(received == std::vector<std::pair<void*, uint8_t>>({{slot, 0x5a}}));
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,11 +27,23 @@ typedef struct {
     uint32_t task_stack_size;                   /**< stack size of the event loop task, ignored if task name is NULL */
     BaseType_t task_core_id;                    /**< core to which the event loop task is pinned to,
                                                         ignored if task name is NULL */
+    uint32_t payload_slot_size;                 /**< size of the slots of the payload slab of the loop, which hold
+                                                        the data of the posted events instead of heap allocations */
+    uint32_t payload_slots;                     /**< number of slots of the payload slab; 0 for no slab */
+    uint32_t task_count;                        /**< number of tasks of the event loop, pinned to consecutive cores
+                                                        from task_core_id; each event base is dispatched by one
+                                                        of them. 0 or 1 for a single task, ignored if task name
+                                                        is NULL */
 } esp_event_loop_args_t;
 
 /**
  * @brief Create a new event loop.
  *
+ * An event loop with a task_count of more than 1 is run by that many tasks, which take the events from the queue
+ * in batches. The events of a base are always dispatched by the same task, in the order they were posted, so a
+ * slow handler only delays the events of the bases dispatched by its task. Handlers of different bases, and
+ * handlers registered for any base, may run concurrently.
+ *
  * @param[in] event_loop_args configuration structure for the event loop to create
  * @param[out] event_loop handle to the created event loop
  *
@@ -395,6 +407,67 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop,
                             size_t event_data_size,
                             TickType_t ticks_to_wait);
 
+/**
+ * @brief Acquire a buffer for the data of an event to post to the specified event loop.
+ *
+ * The producer writes the event data in place and posts the event with esp_event_post_commit, which hands the buffer
+ * over to the event loop without copying it. The buffer is a slot of the payload slab of the loop if the loop has one
+ * (see esp_event_loop_args_t) and a slot of at least event_data_size bytes is free, otherwise it is allocated from
+ * the heap.
+ *
+ * Each acquired buffer must be given back by esp_event_post_commit or esp_event_post_cancel. The event loop is not
+ * deleted while buffers are acquired.
+ *
+ * @param[in] event_loop the event loop to post to, must not be NULL
+ * @param[in] event_data_size the size of the event data, must not be 0
+ * @param[out] event_data the buffer for the event data
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: event_data is NULL or event_data_size is 0
+ *  - ESP_ERR_INVALID_STATE: The event loop is being deleted
+ *  - ESP_ERR_NO_MEM: No slot is free and the heap allocation failed
+ */
+esp_err_t esp_event_post_acquire(esp_event_loop_handle_t event_loop,
+                                 size_t event_data_size,
+                                 void **event_data);
+
+/**
+ * @brief Post an event whose data was written in a buffer acquired by esp_event_post_acquire.
+ *
+ * The buffer is given back to the event loop whatever the result: it is released once the handlers of the event
+ * were executed, or immediately if the event could not be posted.
+ *
+ * @param[in] event_loop the event loop to post to, the one the buffer was acquired from
+ * @param[in] event_base the event base that identifies the event
+ * @param[in] event_id the event ID that identifies the event
+ * @param[in] event_data the buffer acquired by esp_event_post_acquire, holding the data of the event
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired
+ *  - ESP_ERR_INVALID_ARG: Invalid combination of event base and event ID, or event_data is NULL
+ *  - Others: Fail
+ */
+esp_err_t esp_event_post_commit(esp_event_loop_handle_t event_loop,
+                                esp_event_base_t event_base,
+                                int32_t event_id,
+                                void *event_data,
+                                TickType_t ticks_to_wait);
+
+/**
+ * @brief Give back a buffer acquired by esp_event_post_acquire without posting an event.
+ *
+ * @param[in] event_loop the event loop the buffer was acquired from
+ * @param[in] event_data the buffer acquired by esp_event_post_acquire
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: event_data is NULL
+ */
+esp_err_t esp_event_post_cancel(esp_event_loop_handle_t event_loop, void *event_data);
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 /**
  * @brief Special variant of esp_event_post for posting events from interrupt handlers.
@@ -462,6 +535,10 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop,
  *
  @verbatim
        event loop
+           wait
+           worker
+           ...
+           slab
            handler
            handler
            ...
@@ -480,6 +557,31 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop,
            total_received - number of successfully posted events
            total_dropped - number of events unsuccessfully posted due to queue being full
 
+   wait
+       format: ev:events_dispatched avg:average_wait max:max_wait
+       where:
+           events_dispatched - number of events dispatched
+           average_wait - average time the dispatched events waited in the queue
+           max_wait - longest time a dispatched event waited in the queue
+
+   worker (only for event loops with dedicated tasks, one for each task)
+       format: index ev:events_dispatched batches:batches busy:busy_time util:utilisation
+       where:
+           index - index of the task of the event loop
+           events_dispatched - number of events dispatched by the task
+           batches - number of batches of events taken from the queue by the task
+           busy_time - total time the task spent dispatching events
+           utilisation - percentage of time the task spent dispatching events since the loop was created
+
+   slab (only for event loops with a payload slab)
+       format: slots:slot_count size:slot_size used:slots_used hwm:high_water fb:fallbacks
+       where:
+           slot_count - number of slots of the payload slab
+           slot_size - size of each slot
+           slots_used - number of slots holding the data of events not dispatched yet
+           high_water - highest number of slots used at once since the loop was created
+           fallbacks - number of event data allocated from the heap because no slot was free or large enough
+
    handler
        format: address ev:base,id inv:total_invoked run:total_runtime
        where:
@@ -27,11 +27,15 @@ typedef struct esp_event_handler_context {
 typedef struct esp_event_handler_node {
     esp_event_handler_instance_context_t* handler_ctx;              /**< event handler context*/
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    uint32_t invoked;                                               /**< number of times this handler has been invoked */
-    int64_t time;                                                   /**< total runtime of this handler across all calls */
+    atomic_uint_least32_t invoked;                                  /**< number of times this handler has been invoked */
+    atomic_int_least64_t time;                                      /**< total runtime of this handler across all calls,
+                                                                            updated by the tasks of the loop concurrently */
 #endif
     SLIST_ENTRY(esp_event_handler_node) next;                   /**< next event handler in the list */
-    bool unregistered;
+    atomic_bool unregistered;                                       /**< set when the handler is unregistered, read without
+                                                                            the loop mutex by the tasks of the loop */
+    uint32_t retired_epoch;                                         /**< epoch of the loop when the handler was removed
+                                                                            from a loop run by several tasks */
 } esp_event_handler_node_t;
 
 typedef SLIST_HEAD(esp_event_handler_instances, esp_event_handler_node) esp_event_handler_nodes_t;
@@ -66,6 +70,65 @@ typedef struct esp_event_loop_node {
 
 typedef SLIST_HEAD(esp_event_loop_nodes, esp_event_loop_node) esp_event_loop_nodes_t;
 
+/// Handlers to execute for an event, in the order given by the lists of loop, base and id nodes
+typedef struct esp_event_dispatch_entry {
+    esp_event_base_t base;                                          /**< base of the event */
+    int32_t id;                                                     /**< id of the event */
+    uint16_t in_use;                                                /**< number of dispatches using the entry */
+    bool stale;                                                     /**< removed from the table while in use,
+                                                                            freed once no dispatch uses it */
+    size_t count;                                                   /**< number of handlers */
+    SLIST_ENTRY(esp_event_dispatch_entry) next;                     /**< next entry in the bucket */
+    esp_event_handler_node_t* handlers[];                           /**< handlers to execute */
+} esp_event_dispatch_entry_t;
+
+typedef SLIST_HEAD(esp_event_dispatch_entries, esp_event_dispatch_entry) esp_event_dispatch_entries_t;
+
+/// Hash table of the events posted to a loop, built on dispatch and invalidated on handler (un)registration
+typedef struct esp_event_dispatch_table {
+    esp_event_dispatch_entries_t* buckets;                          /**< buckets of entries, hashed by base and id */
+    size_t bucket_count;                                            /**< number of buckets, a power of two */
+    size_t entry_count;                                             /**< number of entries in the buckets */
+} esp_event_dispatch_table_t;
+
+/// Fixed-size slots for the data of the events posted to a loop, allocated at loop creation
+typedef struct esp_event_payload_slab {
+    portMUX_TYPE lock;                                              /**< spinlock protecting the free slots and statistics */
+    uint8_t* slots;                                                 /**< memory of the slots, NULL if the loop has no slab */
+    size_t slot_size;                                               /**< size of each slot */
+    size_t slot_count;                                              /**< number of slots */
+    void* free_slots;                                               /**< list of free slots, linked by their first word */
+    size_t used;                                                    /**< number of slots in use */
+    size_t high_water;                                              /**< highest number of slots in use at once */
+    uint32_t fallbacks;                                             /**< number of event data allocated from the heap
+                                                                            because no slot was free or large enough */
+} esp_event_payload_slab_t;
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+/// Statistics of the dispatch of the events of a loop by a task
+typedef struct esp_event_loop_stats {
+    uint32_t events;                                                /**< number of events dispatched */
+    uint32_t batches;                                               /**< number of batches of events dispatched */
+    int64_t busy_time;                                              /**< total time spent dispatching events */
+    int64_t wait_time;                                              /**< total time the events waited in the queue */
+    int64_t max_wait_time;                                          /**< longest time an event waited in the queue */
+} esp_event_loop_stats_t;
+#endif
+
+struct esp_event_loop_instance;
+
+/// Task of an event loop run by several tasks, dispatching the events of the bases assigned to it
+typedef struct esp_event_loop_worker {
+    struct esp_event_loop_instance* loop;                           /**< loop of the worker */
+    QueueHandle_t queue;                                            /**< queue of the events of the assigned bases */
+    TaskHandle_t task;                                              /**< task of the worker */
+    uint32_t epoch;                                                 /**< epoch of the loop when the batch being
+                                                                            dispatched started, 0 when idle */
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    esp_event_loop_stats_t stats;                                   /**< dispatch statistics of the worker */
+#endif
+} esp_event_loop_worker_t;
+
 typedef struct esp_event_loop_state {
     portMUX_TYPE lock;                  /**< spinlock protecting deleting and posts_in_flight */
     atomic_bool deleting;               /**< true when loop deletion has started; read lock-free from ISR */
@@ -82,8 +145,18 @@ typedef struct esp_event_loop_instance {
     SemaphoreHandle_t mutex;                                        /**< mutex for updating the events linked list */
     esp_event_loop_nodes_t loop_nodes;                              /**< set of linked lists containing the
                                                                             registered handlers for the loop */
+    esp_event_dispatch_table_t dispatch;                            /**< handlers of each event posted to the loop */
+    esp_event_payload_slab_t slab;                                  /**< slots for the data of the posted events */
     esp_event_loop_state_t state;                                   /**< loop deletion and post-entry state */
+    esp_event_loop_worker_t* workers;                               /**< tasks of a loop run by several tasks */
+    size_t worker_count;                                            /**< number of workers, 0 if the loop isn't
+                                                                            run by several tasks */
+    uint32_t epoch;                                                 /**< incremented each time a handler is retired */
+    esp_event_handler_nodes_t retired;                              /**< handlers removed from a loop run by several
+                                                                            tasks, freed once no worker can run them */
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    int64_t created;                                                /**< time the loop was created */
+    esp_event_loop_stats_t stats;                                   /**< dispatch statistics of esp_event_loop_run */
     atomic_uint_least32_t events_received;                          /**< number of events successfully posted to the loop */
     atomic_uint_least32_t events_dropped;                           /**< number of events dropped due to queue being full */
     SLIST_ENTRY(esp_event_loop_instance) next;                      /**< next event loop in the list */
@@ -116,6 +189,9 @@ typedef struct esp_event_post_instance {
     esp_event_base_t base;                                           /**< the event base */
     int32_t id;                                                      /**< the event id */
     esp_event_post_data_t data;                                      /**< data associated with the event */
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    int64_t posted;                                                  /**< time the event was posted */
+#endif
 } esp_event_post_instance_t;
 
 #ifdef __cplusplus
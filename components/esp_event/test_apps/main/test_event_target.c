@@ -649,6 +649,88 @@ TEST_CASE("performance test - no dedicated task", "[event][qemu-ignore]")
     performance_test(false);
 }
 
+#define TEST_CONFIG_WORKER_BASES    16
+#define TEST_CONFIG_WORKER_ROUNDS   5
+
+typedef struct {
+    int count;
+    int out_of_order;
+} ordered_data_t;
+
+// Bases spread over the tasks of the loop, which dispatch the events of a base by hashing its address
+static const char s_test_worker_bases[TEST_CONFIG_WORKER_BASES][8];
+
+static void test_event_blocking_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    xSemaphoreTake((SemaphoreHandle_t) event_handler_arg, portMAX_DELAY);
+}
+
+static void test_event_ordered_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    ordered_data_t* data = (ordered_data_t*) event_handler_arg;
+
+    if (*((int*) event_data) != data->count) {
+        data->out_of_order++;
+    }
+    data->count++;
+}
+
+TEST_CASE("loop with several tasks dispatches other bases while a handler blocks", "[event]")
+{
+    /* this test aims to verify that:
+     *  - a handler blocking one task of the loop doesn't delay the events of the bases dispatched by the other task
+     *  - the events of a base are dispatched in the order they were posted */
+
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+
+    loop_args.task_count = 2;
+    loop_args.task_stack_size = 3072;
+    loop_args.queue_size = TEST_CONFIG_WORKER_BASES * TEST_CONFIG_WORKER_ROUNDS + 1;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    SemaphoreHandle_t release = xSemaphoreCreateBinary();
+    ordered_data_t data[TEST_CONFIG_WORKER_BASES] = { 0 };
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, TEST_EVENT_BASE1_EV1, test_event_blocking_handler, release));
+    for (int i = 0; i < TEST_CONFIG_WORKER_BASES; i++) {
+        TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_worker_bases[i], TEST_EVENT_BASE1_EV1, test_event_ordered_handler, &data[i]));
+    }
+
+    // Block the task dispatching s_test_base1
+    TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    for (int round = 0; round < TEST_CONFIG_WORKER_ROUNDS; round++) {
+        for (int i = 0; i < TEST_CONFIG_WORKER_BASES; i++) {
+            TEST_ESP_OK(esp_event_post_to(loop, s_test_worker_bases[i], TEST_EVENT_BASE1_EV1, &round, sizeof(round), portMAX_DELAY));
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    int dispatched = 0;
+    for (int i = 0; i < TEST_CONFIG_WORKER_BASES; i++) {
+        if (data[i].count == TEST_CONFIG_WORKER_ROUNDS) {
+            dispatched++;
+        }
+    }
+    // the bases of the other task were dispatched, the bases of the blocked task were not
+    TEST_ASSERT_GREATER_THAN(0, dispatched);
+    TEST_ASSERT_LESS_THAN(TEST_CONFIG_WORKER_BASES, dispatched);
+
+    xSemaphoreGive(release);
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    for (int i = 0; i < TEST_CONFIG_WORKER_BASES; i++) {
+        TEST_ASSERT_EQUAL(TEST_CONFIG_WORKER_ROUNDS, data[i].count);
+        TEST_ASSERT_EQUAL(0, data[i].out_of_order);
+    }
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+
+    vSemaphoreDelete(release);
+
+    vTaskDelay(pdMS_TO_TICKS(TEST_CONFIG_TEARDOWN_WAIT));
+}
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 TEST_CASE("data posted normally is correctly set internally", "[event][intr]")
 {
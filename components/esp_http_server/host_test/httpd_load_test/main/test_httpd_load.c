@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <esp_http_server.h>
+#include "unity.h"
+
+#define LOAD_TEST_SERVER_PORT   8086
+#define LOAD_TEST_CTRL_PORT     32779
+#define LOAD_TEST_CLIENTS       1000
+#define LOAD_TEST_ROUNDS        20
+#define LOAD_TEST_PING_PONGS    200
+
+static const char s_request[] = "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+static const char s_body[] = "Hello World!";
+
+static int s_client_fds[LOAD_TEST_CLIENTS];
+
+static esp_err_t hello_get_handler(httpd_req_t *req)
+{
+    return httpd_resp_send(req, s_body, HTTPD_RESP_USE_STRLEN);
+}
+
+/* Responses are written in several small chunks, which Nagle's algorithm
+ * would hold back until the client's delayed ACK */
+static esp_err_t nodelay_open_fn(httpd_handle_t hd, int sockfd)
+{
+    int nodelay = 1;
+    setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    return ESP_OK;
+}
+
+static int64_t time_us(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int client_connect(void)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(LOAD_TEST_SERVER_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, fd);
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    return fd;
+}
+
+static void client_send_request(int fd)
+{
+    TEST_ASSERT_EQUAL(sizeof(s_request) - 1, send(fd, s_request, sizeof(s_request) - 1, 0));
+}
+
+/* Reads one response from a keep-alive connection and checks its body */
+static void client_read_response(int fd)
+{
+    char buf[256];
+    size_t len = 0;
+    while (len < sizeof(buf) - 1) {
+        ssize_t ret = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+        TEST_ASSERT_GREATER_THAN(0, ret);
+        len += ret;
+        buf[len] = '\0';
+        char *body = strstr(buf, "\r\n\r\n");
+        if (body && strlen(body + 4) >= strlen(s_body)) {
+            TEST_ASSERT_EQUAL_STRING(s_body, body + 4);
+            return;
+        }
+    }
+    TEST_FAIL_MESSAGE("response too long");
+}
+
+/* Measures sequential requests on one connection. Returns the wall clock
+ * and the process CPU time spent per request, in microseconds. */
+static void ping_pong(int fd, int64_t *wall_us, int64_t *cpu_us)
+{
+    int64_t wall = time_us(CLOCK_MONOTONIC);
+    int64_t cpu = time_us(CLOCK_PROCESS_CPUTIME_ID);
+    for (int i = 0; i < LOAD_TEST_PING_PONGS; i++) {
+        client_send_request(fd);
+        client_read_response(fd);
+    }
+    *wall_us = (time_us(CLOCK_MONOTONIC) - wall) / LOAD_TEST_PING_PONGS;
+    *cpu_us = (time_us(CLOCK_PROCESS_CPUTIME_ID) - cpu) / LOAD_TEST_PING_PONGS;
+}
+
+TEST_CASE("httpd serves 1000 keep-alive clients", "[httpd][load]")
+{
+    /* Both ends of every connection are open in this process */
+    const rlim_t fds_needed = 2 * LOAD_TEST_CLIENTS + 32;
+    struct rlimit lim;
+    TEST_ASSERT_EQUAL(0, getrlimit(RLIMIT_NOFILE, &lim));
+    if (lim.rlim_cur < fds_needed) {
+        if (lim.rlim_max < fds_needed) {
+            TEST_IGNORE_MESSAGE("RLIMIT_NOFILE is too low for the load test");
+        }
+        lim.rlim_cur = fds_needed;
+        TEST_ASSERT_EQUAL(0, setrlimit(RLIMIT_NOFILE, &lim));
+    }
+
+    httpd_handle_t hd = NULL;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = LOAD_TEST_SERVER_PORT;
+    config.ctrl_port = LOAD_TEST_CTRL_PORT;
+    config.max_open_sockets = LOAD_TEST_CLIENTS;
+    config.backlog_conn = LOAD_TEST_CLIENTS;
+    config.open_fn = nodelay_open_fn;
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_start(&hd, &config));
+
+    httpd_uri_t hello = {
+        .uri = "/hello",
+        .method = HTTP_GET,
+        .handler = hello_get_handler,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_register_uri_handler(hd, &hello));
+
+    /* Baseline: a single connection */
+    int64_t single_wall_us, single_cpu_us;
+    s_client_fds[0] = client_connect();
+    ping_pong(s_client_fds[0], &single_wall_us, &single_cpu_us);
+
+    for (int i = 1; i < LOAD_TEST_CLIENTS; i++) {
+        s_client_fds[i] = client_connect();
+    }
+
+    /* Every client sends a request, then every response is read */
+    int64_t wall = time_us(CLOCK_MONOTONIC);
+    int64_t cpu = time_us(CLOCK_PROCESS_CPUTIME_ID);
+    for (int round = 0; round < LOAD_TEST_ROUNDS; round++) {
+        for (int i = 0; i < LOAD_TEST_CLIENTS; i++) {
+            client_send_request(s_client_fds[i]);
+        }
+        for (int i = 0; i < LOAD_TEST_CLIENTS; i++) {
+            client_read_response(s_client_fds[i]);
+        }
+    }
+    int64_t all_wall_us = time_us(CLOCK_MONOTONIC) - wall;
+    int64_t all_cpu_us = time_us(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+
+    size_t client_cnt = LOAD_TEST_CLIENTS;
+    int client_fds[LOAD_TEST_CLIENTS];
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_get_client_list(hd, &client_cnt, client_fds));
+    TEST_ASSERT_EQUAL(LOAD_TEST_CLIENTS, client_cnt);
+
+    /* One connection busy, all the others idle but kept alive */
+    int64_t loaded_wall_us, loaded_cpu_us;
+    ping_pong(s_client_fds[0], &loaded_wall_us, &loaded_cpu_us);
+
+    const int requests = LOAD_TEST_ROUNDS * LOAD_TEST_CLIENTS;
+    printf("[httpd load] %d clients: %d requests in %lld ms, %lld requests/s, %lld us CPU per request\n",
+           LOAD_TEST_CLIENTS, requests, (long long)all_wall_us / 1000,
+           (long long)requests * 1000000 / all_wall_us, (long long)all_cpu_us / requests);
+    printf("[httpd load] 1 busy client: %lld us (%lld us CPU) per request alone, "
+           "%lld us (%lld us CPU) with %d idle clients\n",
+           (long long)single_wall_us, (long long)single_cpu_us,
+           (long long)loaded_wall_us, (long long)loaded_cpu_us, LOAD_TEST_CLIENTS - 1);
+
+    for (int i = 0; i < LOAD_TEST_CLIENTS; i++) {
+        close(s_client_fds[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, httpd_stop(hd));
+}
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    UNITY_END();
+}
@@ -17,6 +17,7 @@
 
 #include <esp_http_server.h>
 #include "osal.h"
+#include "httpd_poll.h"
 #include "freertos/semphr.h"
 #include "sdkconfig.h"
 
@@ -84,6 +85,9 @@ struct sock_db {
     char pending_data[PARSER_BLOCK_SIZE];   /*!< Buffer for pending data to be received */
     size_t pending_len;                     /*!< Length of pending data to be received */
     bool for_async_req;                     /*!< If true, the socket will not be LRU purged */
+    bool polled;                            /*!< True while the socket is registered with the server's httpd_poll_t */
+    bool pending_queued;                    /*!< True while the session is on the server's pending list */
+    struct sock_db *pending_next;           /*!< Next session on the server's pending list */
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     bool ws_handshake_done;                 /*!< True if it has done WebSocket handshake (if this socket is a valid WS) */
     bool ws_close;                          /*!< Set to true to close the socket later (when WS Close frame received) */
@@ -136,6 +140,11 @@ struct httpd_data {
     struct thread_data hd_td;               /*!< Information for the HTTPD thread */
     struct sock_db *hd_sd;                  /*!< The socket database */
     int hd_sd_active_count;                 /*!< The number of the active sockets */
+    int hd_sd_parked_count;                 /*!< The number of active sockets not registered with hd_poll */
+    struct sock_db *hd_sd_pending;          /*!< Sessions with data buffered above the socket */
+    httpd_poll_t *hd_poll;                  /*!< Readiness notification for the listener, control and session sockets */
+    void **hd_poll_ready;                   /*!< Arguments of the ready sockets, filled by httpd_poll_wait() */
+    bool listen_polled;                     /*!< True while the listener is registered with hd_poll */
     httpd_uri_t **hd_calls;                 /*!< Registered URI handlers */
     struct httpd_req hd_req;                /*!< The current HTTPD request */
     struct httpd_req_aux hd_req_aux;        /*!< Additional data about the HTTPD request kept unexposed */
@@ -195,7 +204,7 @@ struct sock_db *httpd_sess_get(struct httpd_data *hd, int sockfd);
 
 /**
  * @brief Delete sessions whose FDs have became invalid.
- *        This is a recovery strategy e.g. after select() fails.
+ *        This is a recovery strategy e.g. after httpd_poll_wait() fails.
  *
  * @param[in] hd    Server instance data
  */
@@ -251,15 +260,42 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session);
 void httpd_sess_free_ctx(void **ctx, httpd_free_ctx_fn_t free_fn);
 
 /**
- * @brief   Add descriptors present in the socket database to an fdset and
- *          update the value of maxfd which are needed by the select function
- *          for looking through all available sockets for incoming data.
+ * @brief   Stops watching a session socket for incoming data, while an
+ *          asynchronous request handler owns the session.
  *
- * @param[in]  hd    Server instance data
- * @param[out] fdset File descriptor set to be updated.
- * @param[out] maxfd Maximum value among all file descriptors.
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_sess_park(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Watches again the sockets of the sessions whose asynchronous
+ *          request has completed since they were parked.
+ *
+ * @param[in] hd    Server instance data
+ */
+void httpd_sess_unpark(struct httpd_data *hd);
+
+/**
+ * @brief   Queues a session whose pending data must be processed even
+ *          though its socket may not become readable.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_sess_queue_pending(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Detaches the list of sessions queued with httpd_sess_queue_pending().
+ *
+ * The caller walks the list through sock_db::pending_next. The sessions
+ * are no longer queued, so processing them may queue them again.
+ *
+ * @param[in] hd    Server instance data
+ *
+ * @return First session of the list, or NULL if none is queued
  */
-void httpd_sess_set_descriptors(struct httpd_data *hd, fd_set *fdset, int *maxfd);
+struct sock_db *httpd_sess_take_pending(struct httpd_data *hd);
 
 /**
  * @brief   Checks if session can accept another connection from new client.
@@ -277,7 +313,7 @@ bool httpd_is_sess_available(struct httpd_data *hd);
  *
  * This is needed as httpd_unrecv may un-receive next
  * packet in the stream. If only partial packet was
- * received then select() would mark the fd for processing
+ * received then httpd_poll_wait() would report the fd as ready
  * as remaining part of the packet would still be in socket
  * recv queue. But if a complete packet got unreceived
  * then it would not be processed until further data is
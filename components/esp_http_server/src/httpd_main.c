@@ -5,6 +5,7 @@
  */
 
 #include <string.h>
+#include <limits.h>
 #include <sys/socket.h>
 #include <sys/param.h>
 #include <errno.h>
@@ -21,7 +22,10 @@
 #include "freertos/semphr.h"
 #endif
 
-#if defined(CONFIG_LWIP_MAX_SOCKETS)
+#if CONFIG_IDF_TARGET_LINUX && !CONFIG_LWIP_ENABLE
+/* Sockets of the host network stack, only bounded by the descriptor limit of the process */
+#define HTTPD_MAX_SOCKETS INT_MAX
+#elif defined(CONFIG_LWIP_MAX_SOCKETS)
 #define HTTPD_MAX_SOCKETS CONFIG_LWIP_MAX_SOCKETS
 #else
 /* LwIP component is not included into the build, use a default value */
@@ -32,11 +36,6 @@ static const int DEFAULT_KEEP_ALIVE_IDLE = 5;
 static const int DEFAULT_KEEP_ALIVE_INTERVAL= 5;
 static const int DEFAULT_KEEP_ALIVE_COUNT= 3;
 
-typedef struct {
-    fd_set *fdset;
-    struct httpd_data *hd;
-} process_session_context_t;
-
 static const char *TAG = "httpd";
 
 #ifdef CONFIG_HTTPD_ENABLE_EVENTS
@@ -219,7 +218,7 @@ static void httpd_process_ctrl_msg(struct httpd_data *hd)
         /* No packet was actually consumed from the mbox here, so this give
          * is unbalanced. It's tolerated because the counting semaphore is
          * capped at its max — excess gives become no-ops. Spurious recv
-         * errors after select() are rare in practice. */
+         * errors after httpd_poll_wait() are rare in practice. */
         xSemaphoreGive(hd->ctrl_sock_semaphore);
         return;
     }
@@ -246,82 +245,110 @@ static void httpd_process_ctrl_msg(struct httpd_data *hd)
     xSemaphoreGive(hd->ctrl_sock_semaphore);
 }
 
-// Called for each session from httpd_server
-static int httpd_process_session(struct sock_db *session, void *context)
+// Called for each ready or pending session from httpd_server
+static void httpd_process_session(struct httpd_data *hd, struct sock_db *session)
 {
-    if ((!session) || (!context)) {
-        return 0;
-    }
-
+    // session was deleted after it was reported
     if (session->fd < 0) {
-        return 1;
+        return;
     }
 
     // session is busy in an async task, do not process here.
     if (session->for_async_req) {
-        return 1;
+        httpd_sess_park(hd, session);
+        return;
     }
 
-    process_session_context_t *ctx = (process_session_context_t *)context;
-    int fd = session->fd;
+    ESP_LOGD(TAG, LOG_FMT("processing socket %d"), session->fd);
+    if (httpd_sess_process(hd, session) != ESP_OK) {
+        httpd_sess_delete(hd, session); // Delete session
+        return;
+    }
 
-    if (FD_ISSET(fd, ctx->fdset) || httpd_sess_pending(ctx->hd, session)) {
-        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), fd);
-        if (httpd_sess_process(ctx->hd, session) != ESP_OK) {
-            httpd_sess_delete(ctx->hd, session); // Delete session
-        }
+    if (session->for_async_req) {
+        /* The handler passed the request on to another task, stop
+         * watching the socket until httpd_req_async_handler_complete() */
+        httpd_sess_park(hd, session);
+    } else if (httpd_sess_pending(hd, session)) {
+        /* The socket may not become readable again for data that is
+         * already buffered, process the session on the next turn */
+        httpd_sess_queue_pending(hd, session);
     }
-    return 1;
 }
 
 /* Manage in-coming connection or data requests */
 static esp_err_t httpd_server(struct httpd_data *hd)
 {
-    fd_set read_set;
-    FD_ZERO(&read_set);
-    if (hd->config.lru_purge_enable || httpd_is_sess_available(hd)) {
-        /* Only listen for new connections if server has capacity to
-         * handle more (or when LRU purge is enabled, in which case
-         * older connections will be closed) */
-        FD_SET(hd->listen_fd, &read_set);
-    }
-    FD_SET(hd->ctrl_fd, &read_set);
-
-    int tmp_max_fd;
-    httpd_sess_set_descriptors(hd, &read_set, &tmp_max_fd);
-    int maxfd = MAX(hd->listen_fd, tmp_max_fd);
-    tmp_max_fd = maxfd;
-    maxfd = MAX(hd->ctrl_fd, tmp_max_fd);
-
-    ESP_LOGD(TAG, LOG_FMT("doing select maxfd+1 = %d"), maxfd + 1);
-    int active_cnt = select(maxfd + 1, &read_set, NULL, NULL, NULL);
-    if (active_cnt < 0) {
-        ESP_LOGE(TAG, LOG_FMT("error in select (%d)"), errno);
+    /* Only listen for new connections if server has capacity to
+     * handle more (or when LRU purge is enabled, in which case
+     * older connections will be closed) */
+    bool accept_conn = hd->config.lru_purge_enable || httpd_is_sess_available(hd);
+    if (accept_conn && !hd->listen_polled) {
+        if (httpd_poll_add(hd->hd_poll, hd->listen_fd, &hd->listen_fd) == 0) {
+            hd->listen_polled = true;
+        } else {
+            ESP_LOGE(TAG, LOG_FMT("error watching listen socket (%d)"), errno);
+        }
+    } else if (!accept_conn && hd->listen_polled) {
+        httpd_poll_remove(hd->hd_poll, hd->listen_fd);
+        hd->listen_polled = false;
+    }
+
+    /* Don't block while some sessions have buffered data left */
+    int timeout_ms = hd->hd_sd_pending ? 0 : -1;
+    ESP_LOGD(TAG, LOG_FMT("waiting for ready sockets (timeout %d)"), timeout_ms);
+    int ready_cnt = httpd_poll_wait(hd->hd_poll, hd->hd_poll_ready, hd->config.max_open_sockets + 2, timeout_ms);
+    if (ready_cnt < 0) {
+        ESP_LOGE(TAG, LOG_FMT("error in httpd_poll_wait (%d)"), errno);
         httpd_sess_delete_invalid(hd);
         return ESP_OK;
     }
 
+    bool ctrl_ready = false;
+    bool listen_ready = false;
+    for (int i = 0; i < ready_cnt; i++) {
+        if (hd->hd_poll_ready[i] == &hd->ctrl_fd) {
+            ctrl_ready = true;
+        } else if (hd->hd_poll_ready[i] == &hd->listen_fd) {
+            listen_ready = true;
+        }
+    }
+
     /* Case0: Do we have a control message? */
-    if (FD_ISSET(hd->ctrl_fd, &read_set)) {
+    if (ctrl_ready) {
         ESP_LOGD(TAG, LOG_FMT("processing ctrl message"));
         httpd_process_ctrl_msg(hd);
         if (hd->hd_td.status == THREAD_STOPPING) {
             ESP_LOGD(TAG, LOG_FMT("stopping thread"));
             return ESP_FAIL;
         }
+        /* Completed async requests signal the server with a control
+         * message, watch their sessions again */
+        httpd_sess_unpark(hd);
     }
 
     /* Case1: Do we have any activity on the current data
-     * sessions? */
-    process_session_context_t context = {
-        .fdset = &read_set,
-        .hd = hd
-    };
-    httpd_sess_enum(hd, httpd_process_session, &context);
+     * sessions? Only the ready ones are visited. */
+    for (int i = 0; i < ready_cnt; i++) {
+        void *arg = hd->hd_poll_ready[i];
+        if (arg != &hd->ctrl_fd && arg != &hd->listen_fd) {
+            httpd_process_session(hd, (struct sock_db *)arg);
+        }
+    }
+
+    /* ... and on the sessions with data buffered above the socket? */
+    struct sock_db *session = httpd_sess_take_pending(hd);
+    while (session) {
+        struct sock_db *next = session->pending_next;
+        if (session->fd >= 0 && httpd_sess_pending(hd, session)) {
+            httpd_process_session(hd, session);
+        }
+        session = next;
+    }
 
     /* Case2: Do we have any incoming connection requests to
      * process? */
-    if (FD_ISSET(hd->listen_fd, &read_set)) {
+    if (listen_ready) {
         ESP_LOGD(TAG, LOG_FMT("processing listen socket %d"), hd->listen_fd);
         if (httpd_accept_conn(hd) != ESP_OK) {
             ESP_LOGW(TAG, LOG_FMT("error accepting new connection"));
@@ -439,6 +466,15 @@ static esp_err_t httpd_server_init(struct httpd_data *hd)
         return ESP_FAIL;
     }
 
+    /* The listen socket is watched by httpd_server() while sessions are available */
+    if (httpd_poll_add(hd->hd_poll, ctrl_fd, &hd->ctrl_fd) != 0) {
+        ESP_LOGE(TAG, LOG_FMT("error watching ctrl socket (%d)"), errno);
+        close(fd);
+        close(ctrl_fd);
+        close(msg_fd);
+        return ESP_FAIL;
+    }
+
     hd->listen_fd = fd;
     hd->ctrl_fd = ctrl_fd;
     hd->msg_fd  = msg_fd;
@@ -484,6 +520,20 @@ static struct httpd_data *httpd_create(const httpd_config_t *config)
         free(hd);
         return NULL;
     }
+    /* Sessions plus the listen and ctrl sockets */
+    hd->hd_poll_ready = calloc(config->max_open_sockets + 2, sizeof(void *));
+    hd->hd_poll = httpd_poll_create(config->max_open_sockets + 2);
+    if (!hd->hd_poll_ready || !hd->hd_poll) {
+        ESP_LOGE(TAG, LOG_FMT("Failed to create HTTP socket readiness notification"));
+        httpd_poll_delete(hd->hd_poll);
+        free(hd->hd_poll_ready);
+        free(hd->err_handler_fns);
+        free(ra->resp_hdrs);
+        free(hd->hd_sd);
+        free(hd->hd_calls);
+        free(hd);
+        return NULL;
+    }
     /* Save the configuration for this instance */
     hd->config = *config;
     return hd;
@@ -493,6 +543,8 @@ static void httpd_delete(struct httpd_data *hd)
 {
     struct httpd_req_aux *ra = &hd->hd_req_aux;
     /* Free memory of httpd instance data */
+    httpd_poll_delete(hd->hd_poll);
+    free(hd->hd_poll_ready);
     free(hd->err_handler_fns);
     free(ra->resp_hdrs);
     free(hd->hd_sd);
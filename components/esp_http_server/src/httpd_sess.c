@@ -21,7 +21,7 @@ typedef enum {
     HTTPD_TASK_GET_ACTIVE,      // Get active session (fd!=-1)
     HTTPD_TASK_GET_FREE,        // Get free session slot (fd<0)
     HTTPD_TASK_FIND_FD,         // Find session with specific fd
-    HTTPD_TASK_SET_DESCRIPTOR,  // Set descriptor
+    HTTPD_TASK_UNPARK,          // Watch again a parked session
     HTTPD_TASK_DELETE_INVALID,  // Delete invalid session
     HTTPD_TASK_FIND_LOWEST_LRU, // Find session with lowest lru
     HTTPD_TASK_CLOSE            // Close session
@@ -30,8 +30,6 @@ typedef enum {
 typedef struct {
     task_t task;
     int fd;
-    fd_set *fdset;
-    int max_fd;
     struct httpd_data *hd;
     uint64_t lru_counter;
     struct sock_db    *session;
@@ -86,12 +84,19 @@ static int enum_function(struct sock_db *session, void *context)
     case HTTPD_TASK_FIND_FD:
         found = (session->fd == ctx->fd);
         break;
-    // Set descriptor
-    case HTTPD_TASK_SET_DESCRIPTOR:
-        if (session->fd != -1 && !session->for_async_req) {
-            FD_SET(session->fd, ctx->fdset);
-            if (session->fd > ctx->max_fd) {
-                ctx->max_fd = session->fd;
+    // Watch again a parked session
+    case HTTPD_TASK_UNPARK:
+        if (session->fd != -1 && !session->polled && !session->for_async_req) {
+            if (httpd_poll_add(ctx->hd->hd_poll, session->fd, session) != 0) {
+                ESP_LOGW(TAG, LOG_FMT("failed to watch socket %d (%d)"), session->fd, errno);
+                httpd_sess_delete(ctx->hd, session);
+                break;
+            }
+            session->polled = true;
+            ctx->hd->hd_sd_parked_count--;
+            // The async handler may have left data in the pending buffer
+            if (httpd_sess_pending(ctx->hd, session)) {
+                httpd_sess_queue_pending(ctx->hd, session);
             }
         }
         break;
@@ -210,6 +215,13 @@ esp_err_t httpd_sess_new(struct httpd_data *hd, int newfd)
     session->recv_fn = httpd_default_recv;
     session->lru_counter = hd->lru_counter;
 
+    if (httpd_poll_add(hd->hd_poll, newfd, session) != 0) {
+        ESP_LOGE(TAG, LOG_FMT("failed to watch fd = %d (%d)"), newfd, errno);
+        session->fd = -1;
+        return ESP_FAIL;
+    }
+    session->polled = true;
+
     // increment number of sessions
     hd->hd_sd_active_count++;
 
@@ -331,17 +343,49 @@ void httpd_sess_set_transport_ctx(httpd_handle_t handle, int sockfd, void *ctx,
     session->free_transport_ctx = free_fn;
 }
 
-void httpd_sess_set_descriptors(struct httpd_data *hd, fd_set *fdset, int *maxfd)
+void httpd_sess_park(struct httpd_data *hd, struct sock_db *session)
+{
+    if (!session->polled) {
+        return;
+    }
+    ESP_LOGD(TAG, LOG_FMT("fd = %d"), session->fd);
+    httpd_poll_remove(hd->hd_poll, session->fd);
+    session->polled = false;
+    hd->hd_sd_parked_count++;
+}
+
+void httpd_sess_unpark(struct httpd_data *hd)
 {
+    if (!hd->hd_sd_parked_count) {
+        return;
+    }
     enum_context_t context = {
-        .task = HTTPD_TASK_SET_DESCRIPTOR,
-        .max_fd = -1,
-        .fdset = fdset
+        .task = HTTPD_TASK_UNPARK,
+        .hd = hd
     };
     httpd_sess_enum(hd, enum_function, &context);
-    if (maxfd) {
-        *maxfd = context.max_fd;
+}
+
+void httpd_sess_queue_pending(struct httpd_data *hd, struct sock_db *session)
+{
+    if (session->pending_queued) {
+        return;
     }
+    session->pending_queued = true;
+    session->pending_next = hd->hd_sd_pending;
+    hd->hd_sd_pending = session;
+}
+
+struct sock_db *httpd_sess_take_pending(struct httpd_data *hd)
+{
+    struct sock_db *list = hd->hd_sd_pending;
+    hd->hd_sd_pending = NULL;
+    // Sessions are off the list from now on, even if deleted before the
+    // caller reaches them; processing may queue them again
+    for (struct sock_db *session = list; session; session = session->pending_next) {
+        session->pending_queued = false;
+    }
+    return list;
 }
 
 void httpd_sess_delete_invalid(struct httpd_data *hd)
@@ -360,6 +404,23 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session)
     }
 
     ESP_LOGD(TAG, LOG_FMT("fd = %d"), session->fd);
+
+    // Stop watching the socket before it is closed
+    if (session->polled) {
+        httpd_poll_remove(hd->hd_poll, session->fd);
+        session->polled = false;
+    } else {
+        hd->hd_sd_parked_count--;
+    }
+    if (session->pending_queued) {
+        struct sock_db **link = &hd->hd_sd_pending;
+        while (*link != session) {
+            link = &(*link)->pending_next;
+        }
+        *link = session->pending_next;
+        session->pending_queued = false;
+    }
+
     if (hd->config.enable_so_linger) {
         struct linger so_linger = {
             .l_onoff = true,
@@ -407,7 +468,7 @@ bool httpd_sess_pending(struct httpd_data *hd, struct sock_db *session)
         return false;
     }
     if (session->pending_fn) {
-        // test if there's any data to be read (besides read() function, which is handled by select() in the main httpd loop)
+        // test if there's any data to be read (besides read() function, which is handled by httpd_poll_wait() in the main httpd loop)
         // this should check e.g. for the SSL data buffer
         if (session->pending_fn(hd, session->fd) > 0) {
             return true;
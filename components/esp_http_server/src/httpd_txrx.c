@@ -733,9 +733,9 @@ esp_err_t httpd_req_async_handler_complete(httpd_req_t *r)
     free(r->aux);
     free(r);
 
-    // Send a dummy control message(httpd_ctrl_data) to unblock the main HTTP server task from the select() call.
-    // Since the current connection FD was marked as inactive for async requests, the main task
-    // will now re-add this FD to its select() descriptor list. This ensures that subsequent requests
+    // Send a dummy control message(httpd_ctrl_data) to unblock the main HTTP server task from httpd_poll_wait().
+    // Since the current connection FD was parked for the async request, the main task
+    // will now watch this FD again. This ensures that subsequent requests
     // on the same FD are processed correctly
     struct httpd_ctrl_data msg = {.hc_msg = HTTPD_CTRL_MAX};
 
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/param.h>
+#include "sdkconfig.h"
+#include "httpd_poll.h"
+
+#if CONFIG_IDF_TARGET_LINUX && defined(__linux__)
+#define HTTPD_POLL_USE_EPOLL 1
+#else
+#define HTTPD_POLL_USE_EPOLL 0
+#endif
+
+#if HTTPD_POLL_USE_EPOLL
+
+#include <unistd.h>
+#include <sys/epoll.h>
+
+struct httpd_poll {
+    int epfd;
+    int max_events;
+    struct epoll_event *events;
+};
+
+httpd_poll_t *httpd_poll_create(int max_fds)
+{
+    httpd_poll_t *poll = calloc(1, sizeof(httpd_poll_t));
+    if (!poll) {
+        return NULL;
+    }
+    poll->max_events = MAX(max_fds, 1);
+    poll->events = calloc(poll->max_events, sizeof(struct epoll_event));
+    if (!poll->events) {
+        free(poll);
+        return NULL;
+    }
+    poll->epfd = epoll_create1(0);
+    if (poll->epfd < 0) {
+        free(poll->events);
+        free(poll);
+        return NULL;
+    }
+    return poll;
+}
+
+void httpd_poll_delete(httpd_poll_t *poll)
+{
+    if (!poll) {
+        return;
+    }
+    close(poll->epfd);
+    free(poll->events);
+    free(poll);
+}
+
+int httpd_poll_add(httpd_poll_t *poll, int fd, void *arg)
+{
+    struct epoll_event ev = {
+        .events = EPOLLIN,
+        .data.ptr = arg,
+    };
+    return epoll_ctl(poll->epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+void httpd_poll_remove(httpd_poll_t *poll, int fd)
+{
+    /* Fails harmlessly if fd has already been closed, in which
+     * case the kernel has dropped it from the interest list */
+    epoll_ctl(poll->epfd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+int httpd_poll_wait(httpd_poll_t *poll, void **ready, int max_ready, int timeout_ms)
+{
+    int cnt = epoll_wait(poll->epfd, poll->events, MIN(max_ready, poll->max_events), timeout_ms);
+    for (int i = 0; i < cnt; i++) {
+        /* EPOLLHUP and EPOLLERR are reported as readable, so that the
+         * following recv() surfaces the error and the session is closed */
+        ready[i] = poll->events[i].data.ptr;
+    }
+    return cnt;
+}
+
+#else /* !HTTPD_POLL_USE_EPOLL */
+
+#include <sys/select.h>
+
+struct httpd_poll_entry {
+    int fd;
+    void *arg;
+};
+
+/* lwIP select() still scans every descriptor, but the fd_set is kept up to
+ * date on add/remove instead of being rebuilt from the socket database
+ * before each call, and only the registered entries are tested afterwards */
+struct httpd_poll {
+    fd_set fds;
+    int max_fd;
+    int count;
+    int capacity;
+    struct httpd_poll_entry *entries;
+};
+
+httpd_poll_t *httpd_poll_create(int max_fds)
+{
+    httpd_poll_t *poll = calloc(1, sizeof(httpd_poll_t));
+    if (!poll) {
+        return NULL;
+    }
+    poll->capacity = MAX(max_fds, 1);
+    poll->entries = calloc(poll->capacity, sizeof(struct httpd_poll_entry));
+    if (!poll->entries) {
+        free(poll);
+        return NULL;
+    }
+    FD_ZERO(&poll->fds);
+    poll->max_fd = -1;
+    return poll;
+}
+
+void httpd_poll_delete(httpd_poll_t *poll)
+{
+    if (!poll) {
+        return;
+    }
+    free(poll->entries);
+    free(poll);
+}
+
+int httpd_poll_add(httpd_poll_t *poll, int fd, void *arg)
+{
+    if (fd < 0 || fd >= FD_SETSIZE || poll->count == poll->capacity) {
+        errno = EINVAL;
+        return -1;
+    }
+    poll->entries[poll->count].fd = fd;
+    poll->entries[poll->count].arg = arg;
+    poll->count++;
+    FD_SET(fd, &poll->fds);
+    poll->max_fd = MAX(poll->max_fd, fd);
+    return 0;
+}
+
+void httpd_poll_remove(httpd_poll_t *poll, int fd)
+{
+    for (int i = 0; i < poll->count; i++) {
+        if (poll->entries[i].fd == fd) {
+            /* Order of the entries doesn't matter, move the last one here */
+            poll->entries[i] = poll->entries[--poll->count];
+            FD_CLR(fd, &poll->fds);
+            break;
+        }
+    }
+    if (fd == poll->max_fd) {
+        poll->max_fd = -1;
+        for (int i = 0; i < poll->count; i++) {
+            poll->max_fd = MAX(poll->max_fd, poll->entries[i].fd);
+        }
+    }
+}
+
+int httpd_poll_wait(httpd_poll_t *poll, void **ready, int max_ready, int timeout_ms)
+{
+    fd_set read_set = poll->fds;
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    int active_cnt = select(poll->max_fd + 1, &read_set, NULL, NULL, timeout_ms < 0 ? NULL : &tv);
+    if (active_cnt <= 0) {
+        return active_cnt;
+    }
+    int cnt = 0;
+    for (int i = 0; i < poll->count && cnt < active_cnt && cnt < max_ready; i++) {
+        if (FD_ISSET(poll->entries[i].fd, &read_set)) {
+            ready[cnt++] = poll->entries[i].arg;
+        }
+    }
+    return cnt;
+}
+
+#endif /* !HTTPD_POLL_USE_EPOLL */
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * \file httpd_poll.h
+ * \brief Readiness notification for the server sockets
+ *
+ * Descriptors are registered once, together with an opaque argument, and
+ * httpd_poll_wait() returns the arguments of the descriptors that are
+ * readable. The server therefore only visits the sessions that have
+ * something to do, instead of walking the whole socket database on every
+ * wakeup.
+ *
+ * On the Linux target this is backed by epoll. Elsewhere (lwIP) it falls
+ * back to select() over an incrementally maintained fd_set.
+ */
+#ifndef _HTTPD_POLL_H_
+#define _HTTPD_POLL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque readiness notification instance
+ */
+typedef struct httpd_poll httpd_poll_t;
+
+/**
+ * @brief Create a readiness notification instance
+ *
+ * @param[in] max_fds maximum number of descriptors registered at once
+ *
+ * @return - the new instance
+ *         - NULL if out of memory or descriptors
+ */
+httpd_poll_t *httpd_poll_create(int max_fds);
+
+/**
+ * @brief Free a readiness notification instance
+ *
+ *      Descriptors still registered are not closed.
+ *
+ * @param[in] poll the instance, may be NULL
+ */
+void httpd_poll_delete(httpd_poll_t *poll);
+
+/**
+ * @brief Watch a descriptor for incoming data
+ *
+ * @param[in] poll the instance
+ * @param[in] fd   the descriptor
+ * @param[in] arg  argument returned by httpd_poll_wait() when fd is readable
+ *
+ * @return - 0 on success
+ *         - -1 if the descriptor could not be registered
+ */
+int httpd_poll_add(httpd_poll_t *poll, int fd, void *arg);
+
+/**
+ * @brief Stop watching a descriptor
+ *
+ *      Must be called before the descriptor is closed.
+ *
+ * @param[in] poll the instance
+ * @param[in] fd   the descriptor
+ */
+void httpd_poll_remove(httpd_poll_t *poll, int fd);
+
+/**
+ * @brief Wait until some of the registered descriptors are readable
+ *
+ * @param[in]  poll       the instance
+ * @param[out] ready      filled with the arguments of the readable descriptors
+ * @param[in]  max_ready  capacity of ready
+ * @param[in]  timeout_ms time to wait, 0 to poll, -1 to wait forever
+ *
+ * @return - the number of entries written to ready, 0 on timeout
+ *         - -1 on error (errno is set)
+ */
+int httpd_poll_wait(httpd_poll_t *poll, void **ready, int max_ready, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ! _HTTPD_POLL_H_ */
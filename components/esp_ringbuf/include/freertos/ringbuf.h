@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -41,6 +41,21 @@ typedef enum {
      * time.
      */
     RINGBUF_TYPE_BYTEBUF,
+    /**
+     * Single-producer single-consumer variant of RINGBUF_TYPE_NOSPLIT. Items
+     * are sent, received and returned without entering a critical section,
+     * which is only entered to block when the buffer is full or empty. Only one
+     * task or ISR may send to the buffer, and only one may receive from and
+     * return items to it. Acquiring items with xRingbufferSendAcquire() and
+     * adding the buffer to a queue set are not supported.
+     */
+    RINGBUF_TYPE_SPSC_NOSPLIT,
+    /**
+     * Single-producer single-consumer variant of RINGBUF_TYPE_BYTEBUF, with the
+     * same restrictions as RINGBUF_TYPE_SPSC_NOSPLIT. One byte of the buffer is
+     * always left free, thus the buffer holds at most xBufferSize - 1 bytes.
+     */
+    RINGBUF_TYPE_SPSC_BYTEBUF,
     RINGBUF_TYPE_MAX,
 } RingbufferType_t;
 
@@ -65,6 +80,17 @@ typedef struct xSTATIC_RINGBUFFER {
     /** @endcond */
 } StaticRingbuffer_t;
 
+/**
+ * @brief Struct that describes a contiguous block of memory
+ *
+ * Used to describe the parts of an item sent using xRingbufferSendv(), and the
+ * items retrieved using xRingbufferReceiveMultiple().
+ */
+typedef struct {
+    void *pvBase;       /**< Pointer to the start of the block */
+    size_t xLen;        /**< Length of the block in bytes */
+} RingbufferIovec_t;
+
 /**
  * @brief       Create a ring buffer
  *
@@ -173,6 +199,32 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
                                   size_t xItemSize,
                                   BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief       Insert an item gathered from several blocks of memory into the ring buffer
+ *
+ * Attempt to insert a single item made of the concatenation of uxIovCount
+ * blocks of memory into the ring buffer. The blocks are copied directly into
+ * the ring buffer, thus they do not need to be assembled into a contiguous
+ * buffer beforehand. This function will block until enough free space is
+ * available for the whole item or until it times out.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to insert the item into
+ * @param[in]   pxIov           Array of blocks making up the item. pvBase is allowed to be NULL if xLen is 0.
+ * @param[in]   uxIovCount      Number of blocks in pxIov
+ * @param[in]   xTicksToWait    Ticks to wait for room in the ring buffer.
+ *
+ * @note    The item is sent the same way as an item of the same total size sent
+ *          with xRingbufferSend(), i.e., it is retrieved as a single item.
+ *
+ * @return
+ *      - pdTRUE if succeeded
+ *      - pdFALSE on time-out or when the data is larger than the maximum permissible size of the buffer
+ */
+BaseType_t xRingbufferSendv(RingbufHandle_t xRingbuffer,
+                            const RingbufferIovec_t *pxIov,
+                            UBaseType_t uxIovCount,
+                            TickType_t xTicksToWait);
+
 /**
  * @brief Acquire memory from the ring buffer to be written to by an external
  *        source and to be sent later.
@@ -369,6 +421,31 @@ void *xRingbufferReceiveUpTo(RingbufHandle_t xRingbuffer,
  */
 void *xRingbufferReceiveUpToFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemSize, size_t xMaxSize);
 
+/**
+ * @brief   Retrieve multiple items from a no-split ring buffer
+ *
+ * Attempt to retrieve all items available in the ring buffer, up to uxMaxItems
+ * items and xMaxSize bytes of data, within a single critical section. This
+ * function will block until at least one item is available or until it times out.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to retrieve the items from
+ * @param[out]  pxItems         Array to which the pointer to and size of each retrieved item will be written, in the order the items were sent
+ * @param[in]   uxMaxItems      Maximum number of items to retrieve, i.e., the length of pxItems
+ * @param[in]   xMaxSize        Maximum total size of the retrieved items in bytes, or 0 for no limit
+ * @param[in]   xTicksToWait    Ticks to wait for items in the ring buffer.
+ *
+ * @note    The first available item is always retrieved, even if it is larger than xMaxSize.
+ * @note    The retrieved items must be returned, e.g., all at once by passing pxItems to vRingbufferReturnItems().
+ * @note    Only applicable to no-split ring buffers (RINGBUF_TYPE_NOSPLIT and RINGBUF_TYPE_SPSC_NOSPLIT).
+ *
+ * @return  Number of items retrieved, 0 on timeout.
+ */
+UBaseType_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                       RingbufferIovec_t *pxItems,
+                                       UBaseType_t uxMaxItems,
+                                       size_t xMaxSize,
+                                       TickType_t xTicksToWait);
+
 /**
  * @brief   Return a previously-retrieved item to the ring buffer
  *
@@ -391,11 +468,25 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem);
  */
 void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief   Return multiple previously-retrieved items to the ring buffer
+ *
+ * Equivalent to calling vRingbufferReturnItem() for the pvBase of each element
+ * of pxItems, but the items are returned within a single critical section.
+ *
+ * @param[in]   xRingbuffer     Ring buffer the items were retrieved from
+ * @param[in]   pxItems         Items that were received earlier, e.g., by xRingbufferReceiveMultiple()
+ * @param[in]   uxItemCount     Number of items in pxItems
+ */
+void vRingbufferReturnItems(RingbufHandle_t xRingbuffer, const RingbufferIovec_t *pxItems, UBaseType_t uxItemCount);
+
 /**
  * @brief   Reset a ring buffer back to its original empty state
  *
  * @param[in]   xRingbuffer     Ring buffer to reset
  *
+ * @note    SPSC ring buffers must not be sent to or received from while they are being reset.
+ *
  * @return ESP_ERR_INVALID_STATE if one or more items are not sent, completed or returned
  *         ESP_OK if the operation was successful
  */
@@ -457,6 +548,8 @@ size_t xRingbufferGetCurFreeSize(RingbufHandle_t xRingbuffer);
  * @param[in]   xRingbuffer     Ring buffer to add to the queue set
  * @param[in]   xQueueSet       Queue set to add the ring buffer to
  *
+ * @note    SPSC ring buffers cannot be added to a queue set.
+ *
  * @return
  *      - pdTRUE on success, pdFALSE otherwise
  */
@@ -508,7 +601,8 @@ BaseType_t xRingbufferRemoveFromQueueSetRead(RingbufHandle_t xRingbuffer, QueueS
  * @param[out]  uxRead          Pointer use to store read pointer position
  * @param[out]  uxWrite         Pointer use to store write pointer position
  * @param[out]  uxAcquire       Pointer use to store acquire pointer position
- * @param[out]  uxItemsWaiting  Pointer use to store number of items (bytes for byte buffer) waiting to be retrieved
+ * @param[out]  uxItemsWaiting  Pointer use to store number of items (bytes for byte buffer) waiting to be retrieved.
+ *                              This is not tracked by SPSC ring buffers and is always 0 for them.
  */
 void vRingbufferGetInfo(RingbufHandle_t xRingbuffer,
                         UBaseType_t *uxFree,
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,6 +27,11 @@
 #define rbBUFFER_FULL_FLAG          ( ( UBaseType_t ) 4 )   //The ring buffer is currently full (write pointer == free pointer)
 #define rbBUFFER_STATIC_FLAG        ( ( UBaseType_t ) 8 )   //The ring buffer is statically allocated
 #define rbUSING_QUEUE_SET           ( ( UBaseType_t ) 16 )  //The ring buffer has been added to a queue set
+#define rbSPSC_FLAG                 ( ( UBaseType_t ) 32 )  //The ring buffer has a single producer and a single consumer
+#define rbSPSC_SEND_WAITING_FLAG    ( ( UBaseType_t ) 64 )  //The producer of an SPSC ring buffer is about to block or is blocked
+#define rbSPSC_RECEIVE_WAITING_FLAG ( ( UBaseType_t ) 128 ) //The consumer of an SPSC ring buffer is about to block or is blocked
+
+#define rbIS_BYTE_BUFFER_TYPE( xType )  ( ( xType ) == RINGBUF_TYPE_BYTEBUF || ( xType ) == RINGBUF_TYPE_SPSC_BYTEBUF )
 
 //Item flags
 #define rbITEM_FREE_FLAG            ( ( UBaseType_t ) 1 )   //Item has been retrieved and returned by application, free to overwrite
@@ -43,7 +48,7 @@ typedef struct {
 #define rbHEADER_SIZE     sizeof(ItemHeader_t)
 typedef struct RingbufferDefinition Ringbuffer_t;
 typedef BaseType_t (*CheckItemFitsFunction_t)(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
-typedef void (*CopyItemFunction_t)(Ringbuffer_t *pxRingbuffer, const uint8_t *pcItem, size_t xItemSize);
+typedef void (*CopyItemFunction_t)(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize);
 typedef BaseType_t (*CheckItemAvailFunction_t)(Ringbuffer_t *pxRingbuffer);
 typedef void *(*GetItemFunction_t)(Ringbuffer_t *pxRingbuffer, BaseType_t *pxIsSplit, size_t xMaxSize, size_t *pxItemSize);
 typedef void (*ReturnItemFunction_t)(Ringbuffer_t *pxRingbuffer, uint8_t *pvItem);
@@ -75,8 +80,31 @@ typedef struct RingbufferDefinition {
     portMUX_TYPE mux;                           //Spinlock required for SMP
 } Ringbuffer_t;
 
+/*
+ * SPSC ring buffers reuse the same structure without taking the spinlock on the
+ * data path. The producer owns pucAcquire and publishes its progress by storing
+ * pucWrite with release semantics, the consumer owns pucRead and publishes the
+ * space it returns by storing pucFree with release semantics. As no flag can be
+ * shared to tell a full buffer from an empty one, pucAcquire never catches up
+ * with pucFree (i.e., pucWrite == pucFree always means empty). xItemsWaiting and
+ * rbBUFFER_FULL_FLAG are unused. The spinlock and the task lists are only used
+ * to block when the buffer is full or empty: a side about to block sets its
+ * waiting flag before checking the buffer again, and the other side checks the
+ * flag after publishing its progress, so that a wake up can't be missed.
+ */
+
 _Static_assert(sizeof(StaticRingbuffer_t) == sizeof(Ringbuffer_t), "StaticRingbuffer_t != Ringbuffer_t");
 
+/*
+ * Items are copied into ring buffers from an array of blocks (a single block
+ * unless sent with xRingbufferSendv()). The cursor tracks how much of the item
+ * has been copied, as an item may be copied in two parts when wrapping around.
+ */
+typedef struct {
+    const RingbufferIovec_t *pxIov;             //Block currently being copied from
+    size_t xOffset;                             //Number of bytes already copied from the current block
+} IovCursor_t;
+
 // ------------------------------------------------ Forward Declares ---------------------------------------------------
 
 /*
@@ -108,6 +136,9 @@ static BaseType_t prvCheckItemFitsDefault(Ringbuffer_t *pxRingbuffer, size_t xIt
 //Checks if an item will currently fit in a byte buffer
 static BaseType_t prvCheckItemFitsByteBuffer(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
 
+//Copy xLen bytes of an item to pucDest and advance the cursor
+static void prvCopyFromIov(uint8_t *pucDest, IovCursor_t *pxCursor, size_t xLen);
+
 /*
 Copies an item to a no-split ring buffer
 Entry:
@@ -117,7 +148,7 @@ Exit:
     - pucAcquire and pucWrite updated.
     - Dummy item added if necessary
 */
-static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize);
 
 /*
 Copies an item to a allow-split ring buffer
@@ -128,10 +159,10 @@ Exit:
     - pucAcquire and pucWrite updated
     - Item may be split
 */
-static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize);
 
 //Copies an item to a byte buffer. Only call this function  after calling prvCheckItemFitsByteBuffer()
-static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize);
 
 //Retrieve item from no-split/allow-split ring buffer. *pxIsSplit is set to pdTRUE if the retrieved item is split
 /*
@@ -174,13 +205,55 @@ static size_t prvGetCurMaxSizeAllowSplit(Ringbuffer_t *pxRingbuffer);
 //Get the maximum size an item that can currently have if sent to a byte buffer
 static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer);
 
+//Get where an item of xItemSize should be written in a SPSC no-split ring buffer (pucAcquire or pucHead), or NULL if it doesn't fit
+static uint8_t *prvGetSpscNoSplitWritePos(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Checks if an item will currently fit in a SPSC no-split ring buffer
+static BaseType_t prvCheckItemFitsSpscNoSplit(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Checks if an item will currently fit in a SPSC byte buffer
+static BaseType_t prvCheckItemFitsSpscByteBuf(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Copies an item to a SPSC no-split ring buffer and publishes it to the consumer. Must only be called by the producer
+static void prvCopyItemSpscNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize);
+
+//Copies an item to a SPSC byte buffer and publishes it to the consumer. Must only be called by the producer
+static void prvCopyItemSpscByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize);
+
+//Checks if an item/data is currently available for retrieval from a SPSC ring buffer. Must only be called by the consumer
+static BaseType_t prvCheckItemAvailSpsc(Ringbuffer_t *pxRingbuffer);
+
+//Retrieve item from a SPSC no-split ring buffer. Returns NULL if no item is available. Must only be called by the consumer
+static void *prvGetItemSpscNoSplit(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxIsSplit,
+                                   size_t xUnusedParam,
+                                   size_t *pxItemSize);
+
+//Retrieve data from a SPSC byte buffer. Returns NULL if no data is available. Must only be called by the consumer
+static void *prvGetItemSpscByteBuf(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxUnusedParam,
+                                   size_t xMaxSize,
+                                   size_t *pxItemSize);
+
+//Return an item to a SPSC no-split ring buffer and publish the freed space to the producer
+static void prvReturnItemSpscNoSplit(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
+
+//Return data to a SPSC byte buffer and publish the freed space to the producer
+static void prvReturnItemSpscByteBuf(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
+
+//Get the maximum size an item that can currently have if sent to a SPSC no-split ring buffer
+static size_t prvGetCurMaxSizeSpscNoSplit(Ringbuffer_t *pxRingbuffer);
+
+//Get the maximum size an item that can currently have if sent to a SPSC byte buffer
+static size_t prvGetCurMaxSizeSpscByteBuf(Ringbuffer_t *pxRingbuffer);
+
 /*
 Generic function used to send or acquire an item/buffer.
-- If sending, set ppvItem to NULL. pvItem remains unchanged on failure.
-- If acquiring, set pvItem to NULL. ppvItem remains unchanged on failure.
+- If sending, set ppvItem to NULL. pxIov describes the blocks making up the item.
+- If acquiring, set pxIov to NULL. ppvItem remains unchanged on failure.
 */
 static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
-                                        const void *pvItem,
+                                        const RingbufferIovec_t *pxIov,
                                         void **ppvItem,
                                         size_t xItemSize,
                                         TickType_t xTicksToWait);
@@ -207,6 +280,59 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
                                            size_t *xItemSize2,
                                            size_t xMaxSize);
 
+/*
+Retrieve the items currently available in a no-split/SPSC no-split ring buffer,
+up to uxMaxItems items and xMaxSize bytes (no limit if 0). The first available
+item is always retrieved. Returns the number of items retrieved. Must be called
+within a critical section unless the ring buffer is a SPSC ring buffer.
+*/
+static UBaseType_t prvGetItemsNoSplit(Ringbuffer_t *pxRingbuffer,
+                                      RingbufferIovec_t *pxItems,
+                                      UBaseType_t uxMaxItems,
+                                      size_t xMaxSize);
+
+//Generic function used to retrieve multiple items from no-split/SPSC no-split ring buffers
+static UBaseType_t prvReceiveMultipleGeneric(Ringbuffer_t *pxRingbuffer,
+                                             RingbufferIovec_t *pxItems,
+                                             UBaseType_t uxMaxItems,
+                                             size_t xMaxSize,
+                                             TickType_t xTicksToWait);
+
+/*
+Block the producer (xSending == pdTRUE) or the consumer of a SPSC ring buffer
+until the other side makes progress. The waiting flag of the calling side is
+left set and must be cleared with prvClearSpscWaiting() once done. Returns
+pdFALSE on time-out.
+*/
+static BaseType_t prvBlockSpsc(Ringbuffer_t *pxRingbuffer,
+                               BaseType_t xSending,
+                               size_t xItemSize,
+                               TimeOut_t *pxTimeOut,
+                               BaseType_t *pxEntryTimeSet,
+                               TickType_t *pxTicksToWait);
+
+//Clear the waiting flag set by prvBlockSpsc()
+static void prvClearSpscWaiting(Ringbuffer_t *pxRingbuffer, BaseType_t xSending);
+
+//Unblock the other side of a SPSC ring buffer if it is waiting for the progress just published
+static void prvNotifySpscWaiter(Ringbuffer_t *pxRingbuffer, BaseType_t xSending);
+
+//From ISR version of prvNotifySpscWaiter()
+static void prvNotifySpscWaiterFromISR(Ringbuffer_t *pxRingbuffer, BaseType_t xSending, BaseType_t *pxHigherPriorityTaskWoken);
+
+//Send an item to a SPSC ring buffer, blocking only if it does not fit
+static BaseType_t prvSendSpsc(Ringbuffer_t *pxRingbuffer,
+                              const RingbufferIovec_t *pxIov,
+                              size_t xItemSize,
+                              TickType_t xTicksToWait);
+
+//Retrieve an item/data from a SPSC ring buffer, blocking only if none is available
+static BaseType_t prvReceiveSpsc(Ringbuffer_t *pxRingbuffer,
+                                 void **pvItem,
+                                 size_t *xItemSize,
+                                 size_t xMaxSize,
+                                 TickType_t xTicksToWait);
+
 // ------------------------------------------------ Static Functions ---------------------------------------------------
 
 static BaseType_t prvGetAlignedBufferSize(size_t xBufferSize,
@@ -218,7 +344,7 @@ static BaseType_t prvGetAlignedBufferSize(size_t xBufferSize,
     }
 
     //No-split/allow-split buffers must be large enough to avoid underflowing xMaxItemSize
-    if (xBufferType != RINGBUF_TYPE_BYTEBUF) {
+    if (!rbIS_BYTE_BUFFER_TYPE(xBufferType)) {
         if (xBufferSize > SIZE_MAX - rbALIGN_MASK) {
             return pdFALSE;     //Alignment would overflow
         }
@@ -269,6 +395,27 @@ static void prvInitializeNewRingbuffer(size_t xBufferSize,
         //Worst case an item is split into two, incurring two headers of overhead
         pxNewRingbuffer->xMaxItemSize = pxNewRingbuffer->xSize - (sizeof(ItemHeader_t) * 2);
         pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeAllowSplit;
+    } else if (xBufferType == RINGBUF_TYPE_SPSC_NOSPLIT) {
+        pxNewRingbuffer->uxRingbufferFlags |= rbSPSC_FLAG;
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsSpscNoSplit;
+        pxNewRingbuffer->vCopyItem = prvCopyItemSpscNoSplit;
+        pxNewRingbuffer->pvGetItem = prvGetItemSpscNoSplit;
+        pxNewRingbuffer->vReturnItem = prvReturnItemSpscNoSplit;
+        /*
+         * Same worst case as no-split buffers, but items must leave at least
+         * one aligned word free before pucFree, thus the halfway point is rounded down.
+         */
+        pxNewRingbuffer->xMaxItemSize = ((pxNewRingbuffer->xSize / 2) & ~rbALIGN_MASK) - rbHEADER_SIZE;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeSpscNoSplit;
+    } else if (xBufferType == RINGBUF_TYPE_SPSC_BYTEBUF) {
+        pxNewRingbuffer->uxRingbufferFlags |= rbBYTE_BUFFER_FLAG | rbSPSC_FLAG;
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsSpscByteBuf;
+        pxNewRingbuffer->vCopyItem = prvCopyItemSpscByteBuf;
+        pxNewRingbuffer->pvGetItem = prvGetItemSpscByteBuf;
+        pxNewRingbuffer->vReturnItem = prvReturnItemSpscByteBuf;
+        //One byte is always left free to distinguish a full buffer from an empty one
+        pxNewRingbuffer->xMaxItemSize = pxNewRingbuffer->xSize - 1;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeSpscByteBuf;
     } else { //Byte Buffer
         pxNewRingbuffer->uxRingbufferFlags |= rbBYTE_BUFFER_FLAG;
         pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsByteBuffer;
@@ -439,15 +586,37 @@ static void prvSendItemDoneNoSplit(Ringbuffer_t *pxRingbuffer, uint8_t* pucItem)
     }
 }
 
-static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+static void prvCopyFromIov(uint8_t *pucDest, IovCursor_t *pxCursor, size_t xLen)
+{
+    while (xLen > 0) {
+        //Skip over blocks that have been copied completely (or are empty)
+        size_t xBlockLen = pxCursor->pxIov->xLen - pxCursor->xOffset;
+        if (xBlockLen == 0) {
+            pxCursor->pxIov++;
+            pxCursor->xOffset = 0;
+            continue;
+        }
+        if (xBlockLen > xLen) {
+            xBlockLen = xLen;
+        }
+        memcpy(pucDest, (const uint8_t *)pxCursor->pxIov->pvBase + pxCursor->xOffset, xBlockLen);
+        pucDest += xBlockLen;
+        pxCursor->xOffset += xBlockLen;
+        xLen -= xBlockLen;
+    }
+}
+
+static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize)
 {
+    IovCursor_t xCursor = { .pxIov = pxIov, .xOffset = 0 };
     uint8_t* item_addr = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
-    memcpy(item_addr, pucItem, xItemSize);
+    prvCopyFromIov(item_addr, &xCursor, xItemSize);
     prvSendItemDoneNoSplit(pxRingbuffer, item_addr);
 }
 
-static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize)
 {
+    IovCursor_t xCursor = { .pxIov = pxIov, .xOffset = 0 };
     //Check arguments and buffer state
     size_t xAlignedItemSize = rbALIGN_SIZE(xItemSize);                  //Rounded up aligned item size
     size_t xRemLen = pxRingbuffer->pucTail - pxRingbuffer->pucAcquire;    //Length from pucAcquire until end of buffer
@@ -464,10 +633,9 @@ static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *puc
         pxRingbuffer->pucAcquire += rbHEADER_SIZE;            //Advance pucAcquire past header
         xRemLen -= rbHEADER_SIZE;
         if (xRemLen > 0) {
-            memcpy(pxRingbuffer->pucAcquire, pucItem, xRemLen);
+            prvCopyFromIov(pxRingbuffer->pucAcquire, &xCursor, xRemLen);
             pxRingbuffer->xItemsWaiting++;
             //Update item arguments to account for data already copied
-            pucItem += xRemLen;
             xItemSize -= xRemLen;
             xAlignedItemSize -= xRemLen;
             pxFirstHeader->uxItemFlags |= rbITEM_SPLIT_FLAG;        //There must be more data
@@ -483,7 +651,7 @@ static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *puc
     pxSecondHeader->xItemLen = xItemSize;
     pxSecondHeader->uxItemFlags = 0;
     pxRingbuffer->pucAcquire += rbHEADER_SIZE;     //Advance acquire pointer past header
-    memcpy(pxRingbuffer->pucAcquire, pucItem, xItemSize);
+    prvCopyFromIov(pxRingbuffer->pucAcquire, &xCursor, xItemSize);
     pxRingbuffer->xItemsWaiting++;
     pxRingbuffer->pucAcquire += xAlignedItemSize;  //Advance pucAcquire past item to next aligned address
 
@@ -501,23 +669,23 @@ static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *puc
     pxRingbuffer->pucWrite = pxRingbuffer->pucAcquire;
 }
 
-static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize)
 {
+    IovCursor_t xCursor = { .pxIov = pxIov, .xOffset = 0 };
     //Check arguments and buffer state
     configASSERT(pxRingbuffer->pucAcquire >= pxRingbuffer->pucHead && pxRingbuffer->pucAcquire < pxRingbuffer->pucTail);    //Check acquire pointer is within bounds
 
     size_t xRemLen = pxRingbuffer->pucTail - pxRingbuffer->pucAcquire;    //Length from pucAcquire until end of buffer
     if (xRemLen < xItemSize) {
         //Copy as much as possible into remaining length
-        memcpy(pxRingbuffer->pucAcquire, pucItem, xRemLen);
+        prvCopyFromIov(pxRingbuffer->pucAcquire, &xCursor, xRemLen);
         pxRingbuffer->xItemsWaiting += xRemLen;
         //Update item arguments to account for data already written
-        pucItem += xRemLen;
         xItemSize -= xRemLen;
         pxRingbuffer->pucAcquire = pxRingbuffer->pucHead;     //Reset acquire pointer to start of buffer
     }
     //Copy all or remaining portion of the item
-    memcpy(pxRingbuffer->pucAcquire, pucItem, xItemSize);
+    prvCopyFromIov(pxRingbuffer->pucAcquire, &xCursor, xItemSize);
     pxRingbuffer->xItemsWaiting += xItemSize;
     pxRingbuffer->pucAcquire += xItemSize;
 
@@ -791,8 +959,246 @@ static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer)
     return xFreeSize;
 }
 
+static uint8_t *prvGetSpscNoSplitWritePos(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    size_t xTotalItemSize = rbALIGN_SIZE(xItemSize) + rbHEADER_SIZE;    //Rounded up aligned item size with header
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    uint8_t *pucFree = __atomic_load_n(&pxRingbuffer->pucFree, __ATOMIC_ACQUIRE);
+    configASSERT(rbCHECK_ALIGNED(pucAcquire));
+    configASSERT(pucAcquire >= pxRingbuffer->pucHead && pucAcquire < pxRingbuffer->pucTail);
+
+    if (pucFree > pucAcquire) {
+        //Free space does not wrap around. The item must not reach pucFree, or the buffer would look empty
+        return (xTotalItemSize < pucFree - pucAcquire) ? pucAcquire : NULL;
+    }
+    //Free space wraps around. Store the item at the end unless pucAcquire would then wrap around onto pucFree
+    size_t xRemLen = pxRingbuffer->pucTail - pucAcquire;
+    if (xTotalItemSize <= xRemLen && (pucFree != pxRingbuffer->pucHead || xRemLen - xTotalItemSize >= rbHEADER_SIZE)) {
+        return pucAcquire;
+    }
+    //Otherwise the end is marked as dummy data and the item is stored at the head
+    return (xTotalItemSize < pucFree - pxRingbuffer->pucHead) ? pxRingbuffer->pucHead : NULL;
+}
+
+static BaseType_t prvCheckItemFitsSpscNoSplit(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    return (prvGetSpscNoSplitWritePos(pxRingbuffer, xItemSize) != NULL) ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t prvCheckItemFitsSpscByteBuf(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    return (xItemSize <= prvGetCurMaxSizeSpscByteBuf(pxRingbuffer)) ? pdTRUE : pdFALSE;
+}
+
+static void prvCopyItemSpscNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize)
+{
+    //The consumer only ever frees space, so an item that was checked to fit still fits
+    uint8_t *pucAcquire = prvGetSpscNoSplitWritePos(pxRingbuffer, xItemSize);
+    configASSERT(pucAcquire != NULL);
+
+    if (pucAcquire != pxRingbuffer->pucAcquire) {
+        //Item is stored at the head, set remaining length as dummy data
+        ItemHeader_t *pxDummy = (ItemHeader_t *)pxRingbuffer->pucAcquire;
+        pxDummy->uxItemFlags = rbITEM_DUMMY_DATA_FLAG;
+        pxDummy->xItemLen = 0;
+    }
+
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pucAcquire;
+    pxHeader->xItemLen = xItemSize;
+    pxHeader->uxItemFlags = 0;
+    IovCursor_t xCursor = { .pxIov = pxIov, .xOffset = 0 };
+    prvCopyFromIov(pucAcquire + rbHEADER_SIZE, &xCursor, xItemSize);
+    pucAcquire += rbHEADER_SIZE + rbALIGN_SIZE(xItemSize);
+
+    //If current remaining length can't fit a header, wrap around acquire pointer
+    if (pxRingbuffer->pucTail - pucAcquire < rbHEADER_SIZE) {
+        pucAcquire = pxRingbuffer->pucHead;
+    }
+    pxRingbuffer->pucAcquire = pucAcquire;
+    //Publish the item (and the dummy data before it) to the consumer
+    __atomic_store_n(&pxRingbuffer->pucWrite, pucAcquire, __ATOMIC_RELEASE);
+}
+
+static void prvCopyItemSpscByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIovec_t *pxIov, size_t xItemSize)
+{
+    IovCursor_t xCursor = { .pxIov = pxIov, .xOffset = 0 };
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    configASSERT(pucAcquire >= pxRingbuffer->pucHead && pucAcquire < pxRingbuffer->pucTail);
+
+    size_t xRemLen = pxRingbuffer->pucTail - pucAcquire;    //Length from pucAcquire until end of buffer
+    if (xRemLen <= xItemSize) {
+        //Copy as much as possible into remaining length, then wrap around
+        prvCopyFromIov(pucAcquire, &xCursor, xRemLen);
+        xItemSize -= xRemLen;
+        pucAcquire = pxRingbuffer->pucHead;
+    }
+    //Copy all or remaining portion of the item
+    prvCopyFromIov(pucAcquire, &xCursor, xItemSize);
+    pucAcquire += xItemSize;
+
+    pxRingbuffer->pucAcquire = pucAcquire;
+    //Publish the data to the consumer
+    __atomic_store_n(&pxRingbuffer->pucWrite, pucAcquire, __ATOMIC_RELEASE);
+}
+
+static BaseType_t prvCheckItemAvailSpsc(Ringbuffer_t *pxRingbuffer)
+{
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && pxRingbuffer->pucRead != pxRingbuffer->pucFree) {
+        return pdFALSE;     //Byte buffers do not allow multiple retrievals before return
+    }
+    return (pxRingbuffer->pucRead != __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE)) ? pdTRUE : pdFALSE;
+}
+
+static void *prvGetItemSpscNoSplit(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxIsSplit,
+                                   size_t xUnusedParam,
+                                   size_t *pxItemSize)
+{
+    uint8_t *pucRead = pxRingbuffer->pucRead;
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE);
+    if (pucRead == pucWrite) {
+        return NULL;        //No items available for retrieval
+    }
+
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pucRead;
+    configASSERT(rbCHECK_ALIGNED(pucRead));
+    configASSERT(pucRead >= pxRingbuffer->pucHead && pucRead < pxRingbuffer->pucTail);
+    //Wrap around if dummy data. The item stored at the head was published along with it
+    if (pxHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+        pucRead = pxRingbuffer->pucHead;
+        pxHeader = (ItemHeader_t *)pucRead;
+        configASSERT(pucRead != pucWrite);
+    }
+    configASSERT(pxHeader->xItemLen <= pxRingbuffer->xMaxItemSize);
+
+    uint8_t *pcReturn = pucRead + rbHEADER_SIZE;
+    *pxItemSize = pxHeader->xItemLen;
+    if (pxIsSplit != NULL) {
+        *pxIsSplit = pdFALSE;
+    }
+
+    pucRead += rbHEADER_SIZE + rbALIGN_SIZE(pxHeader->xItemLen);
+    //Check if pucRead requires wrap around
+    if ((pxRingbuffer->pucTail - pucRead) < rbHEADER_SIZE) {
+        pucRead = pxRingbuffer->pucHead;
+    }
+    pxRingbuffer->pucRead = pucRead;
+    return (void *)pcReturn;
+}
+
+static void *prvGetItemSpscByteBuf(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxUnusedParam,
+                                   size_t xMaxSize,
+                                   size_t *pxItemSize)
+{
+    uint8_t *pucRead = pxRingbuffer->pucRead;
+    if (pucRead != pxRingbuffer->pucFree) {
+        return NULL;        //Byte buffers do not allow multiple retrievals before return
+    }
+    uint8_t *pucWrite = __atomic_load_n(&pxRingbuffer->pucWrite, __ATOMIC_ACQUIRE);
+    if (pucRead == pucWrite) {
+        return NULL;        //No data available for retrieval
+    }
+
+    //Return contiguous data from read pointer until write pointer or buffer tail, up to xMaxSize
+    size_t xSize = (pucWrite > pucRead) ? (size_t)(pucWrite - pucRead) : (size_t)(pxRingbuffer->pucTail - pucRead);
+    if (xMaxSize != 0 && xSize > xMaxSize) {
+        xSize = xMaxSize;
+    }
+    *pxItemSize = xSize;
+    pxRingbuffer->pucRead = (pucRead + xSize == pxRingbuffer->pucTail) ? pxRingbuffer->pucHead : pucRead + xSize;
+    return (void *)pucRead;
+}
+
+static void prvReturnItemSpscNoSplit(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    //Check arguments and buffer state
+    configASSERT(rbCHECK_ALIGNED(pucItem));
+    configASSERT(pucItem >= pxRingbuffer->pucHead);
+    configASSERT(pucItem <= pxRingbuffer->pucTail);     //Inclusive of pucTail in the case of zero length item at the very end
+
+    ItemHeader_t *pxCurHeader = (ItemHeader_t *)(pucItem - rbHEADER_SIZE);
+    configASSERT(pxCurHeader->xItemLen <= pxRingbuffer->xMaxItemSize);
+    configASSERT((pxCurHeader->uxItemFlags & (rbITEM_DUMMY_DATA_FLAG | rbITEM_FREE_FLAG)) == 0);
+    pxCurHeader->uxItemFlags |= rbITEM_FREE_FLAG;
+
+    /*
+     * As for no-split buffers, move the free pointer up to the next item that
+     * has not been returned, or up till the read pointer. Items between the free
+     * and read pointers are only ever accessed by the consumer.
+     */
+    uint8_t *pucFree = pxRingbuffer->pucFree;
+    while (pucFree != pxRingbuffer->pucRead) {
+        pxCurHeader = (ItemHeader_t *)pucFree;
+        if (pxCurHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+            pucFree = pxRingbuffer->pucHead;    //Wrap around due to dummy data
+            continue;
+        }
+        if ((pxCurHeader->uxItemFlags & rbITEM_FREE_FLAG) == 0) {
+            break;
+        }
+        pucFree += rbHEADER_SIZE + rbALIGN_SIZE(pxCurHeader->xItemLen);
+        //Check if pucFree requires wrap around
+        if ((pxRingbuffer->pucTail - pucFree) < rbHEADER_SIZE) {
+            pucFree = pxRingbuffer->pucHead;
+        }
+    }
+    //Publish the freed space to the producer
+    __atomic_store_n(&pxRingbuffer->pucFree, pucFree, __ATOMIC_RELEASE);
+}
+
+static void prvReturnItemSpscByteBuf(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    //Check pointer points to address inside buffer
+    configASSERT((uint8_t *)pucItem >= pxRingbuffer->pucHead);
+    configASSERT((uint8_t *)pucItem < pxRingbuffer->pucTail);
+    //Free the read memory and publish it to the producer
+    __atomic_store_n(&pxRingbuffer->pucFree, pxRingbuffer->pucRead, __ATOMIC_RELEASE);
+}
+
+static size_t prvGetCurMaxSizeSpscNoSplit(Ringbuffer_t *pxRingbuffer)
+{
+    BaseType_t xFreeSize;
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    uint8_t *pucFree = __atomic_load_n(&pxRingbuffer->pucFree, __ATOMIC_ACQUIRE);
+
+    //See prvGetSpscNoSplitWritePos(). Items are aligned, so at least one aligned word is left before pucFree
+    if (pucFree > pucAcquire) {
+        xFreeSize = (pucFree - pucAcquire) - (rbALIGN_MASK + 1);
+    } else {
+        BaseType_t xSize1 = pxRingbuffer->pucTail - pucAcquire;
+        BaseType_t xSize2 = (pucFree - pxRingbuffer->pucHead) - (rbALIGN_MASK + 1);
+        if (pucFree == pxRingbuffer->pucHead) {
+            xSize1 -= rbHEADER_SIZE;    //pucAcquire must not wrap around onto pucFree
+        }
+        xFreeSize = (xSize1 > xSize2) ? xSize1 : xSize2;
+    }
+
+    //No-split ring buffer items need space for a header
+    xFreeSize -= rbHEADER_SIZE;
+    if (xFreeSize < 0) {
+        xFreeSize = 0;
+    } else if (xFreeSize > pxRingbuffer->xMaxItemSize) {
+        xFreeSize = pxRingbuffer->xMaxItemSize;
+    }
+    return xFreeSize;
+}
+
+static size_t prvGetCurMaxSizeSpscByteBuf(Ringbuffer_t *pxRingbuffer)
+{
+    uint8_t *pucAcquire = pxRingbuffer->pucAcquire;
+    uint8_t *pucFree = __atomic_load_n(&pxRingbuffer->pucFree, __ATOMIC_ACQUIRE);
+
+    //One byte is always left free, pucAcquire == pucFree means the buffer is empty
+    BaseType_t xFreeSize = pucFree - pucAcquire;
+    if (xFreeSize <= 0) {
+        xFreeSize += pxRingbuffer->xSize;
+    }
+    return xFreeSize - 1;
+}
+
 static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
-                                        const void *pvItem,
+                                        const RingbufferIovec_t *pxIov,
                                         void **ppvItem,
                                         size_t xItemSize,
                                         TickType_t xTicksToWait)
@@ -812,7 +1218,7 @@ static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
                 *ppvItem = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
             } else {
                 //Copy item into buffer
-                pxRingbuffer->vCopyItem(pxRingbuffer, pvItem, xItemSize);
+                pxRingbuffer->vCopyItem(pxRingbuffer, pxIov, xItemSize);
                 if (pxRingbuffer->xQueueSet) {
                     //If ring buffer was added to a queue set, notify the queue set
                     xNotifyQueueSet = pdTRUE;
@@ -873,6 +1279,10 @@ static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvReceiveSpsc(pxRingbuffer, pvItem1, xItemSize1, xMaxSize, xTicksToWait);
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
         if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
@@ -935,6 +1345,16 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        //SPSC ring buffers are read without entering the critical section
+        void *pvTempItem = pxRingbuffer->pvGetItem(pxRingbuffer, NULL, xMaxSize, xItemSize1);
+        if (pvTempItem == NULL) {
+            return pdFALSE;
+        }
+        *pvItem1 = pvTempItem;
+        return pdTRUE;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         BaseType_t xIsSplit = pdFALSE;
@@ -965,6 +1385,238 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
     return xReturn;
 }
 
+static UBaseType_t prvGetItemsNoSplit(Ringbuffer_t *pxRingbuffer,
+                                      RingbufferIovec_t *pxItems,
+                                      UBaseType_t uxMaxItems,
+                                      size_t xMaxSize)
+{
+    UBaseType_t uxItemCount = 0;
+    size_t xTotalSize = 0;
+    BaseType_t xIsSplit;
+
+    while (uxItemCount < uxMaxItems) {
+        if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+            if (prvCheckItemAvailSpsc(pxRingbuffer) == pdFALSE) {
+                break;
+            }
+        } else if (prvCheckItemAvail(pxRingbuffer) == pdFALSE) {
+            break;
+        }
+        //Peek at the size of the next item, which is stored at the head if pucRead points to dummy data
+        ItemHeader_t *pxHeader = (ItemHeader_t *)pxRingbuffer->pucRead;
+        if (pxHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+            pxHeader = (ItemHeader_t *)pxRingbuffer->pucHead;
+        }
+        if (uxItemCount > 0 && xMaxSize != 0 && xTotalSize + pxHeader->xItemLen > xMaxSize) {
+            break;
+        }
+        pxItems[uxItemCount].pvBase = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, &pxItems[uxItemCount].xLen);
+        configASSERT(pxItems[uxItemCount].pvBase != NULL);
+        xTotalSize += pxItems[uxItemCount].xLen;
+        uxItemCount++;
+    }
+    return uxItemCount;
+}
+
+static UBaseType_t prvReceiveMultipleGeneric(Ringbuffer_t *pxRingbuffer,
+                                             RingbufferIovec_t *pxItems,
+                                             UBaseType_t uxMaxItems,
+                                             size_t xMaxSize,
+                                             TickType_t xTicksToWait)
+{
+    UBaseType_t uxItemCount = 0;
+    BaseType_t xExitLoop = pdFALSE;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        while ((uxItemCount = prvGetItemsNoSplit(pxRingbuffer, pxItems, uxMaxItems, xMaxSize)) == 0) {
+            if (xTicksToWait == (TickType_t) 0 ||
+                    prvBlockSpsc(pxRingbuffer, pdFALSE, 0, &xTimeOut, &xEntryTimeSet, &xTicksToWait) == pdFALSE) {
+                break;
+            }
+        }
+        if (xEntryTimeSet == pdTRUE) {
+            prvClearSpscWaiting(pxRingbuffer, pdFALSE);
+        }
+        return uxItemCount;
+    }
+
+    while (xExitLoop == pdFALSE) {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        uxItemCount = prvGetItemsNoSplit(pxRingbuffer, pxItems, uxMaxItems, xMaxSize);
+        if (uxItemCount > 0) {
+            xExitLoop = pdTRUE;
+            goto loop_end;
+        } else if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            xExitLoop = pdTRUE;
+            goto loop_end;
+        } else if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+            //Not timed out yet. Block the current task
+            vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToReceive, xTicksToWait);
+            portYIELD_WITHIN_API();
+        } else {
+            //We have timed out.
+            xExitLoop = pdTRUE;
+        }
+loop_end:
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+
+    return uxItemCount;
+}
+
+static BaseType_t prvBlockSpsc(Ringbuffer_t *pxRingbuffer,
+                               BaseType_t xSending,
+                               size_t xItemSize,
+                               TimeOut_t *pxTimeOut,
+                               BaseType_t *pxEntryTimeSet,
+                               TickType_t *pxTicksToWait)
+{
+    BaseType_t xReturn = pdTRUE;
+    BaseType_t xReady;
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    if (*pxEntryTimeSet == pdFALSE) {
+        //This is our first block. Set entry time
+        vTaskInternalSetTimeOutState(pxTimeOut);
+        *pxEntryTimeSet = pdTRUE;
+    }
+    //Let the other side know that it has to unblock us, then check again for progress made before it could see the flag
+    __atomic_fetch_or(&pxRingbuffer->uxRingbufferFlags, xSending ? rbSPSC_SEND_WAITING_FLAG : rbSPSC_RECEIVE_WAITING_FLAG, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (xSending) {
+        xReady = pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize);
+    } else {
+        xReady = prvCheckItemAvailSpsc(pxRingbuffer);
+    }
+
+    if (xReady == pdFALSE) {
+        if (xTaskCheckForTimeOut(pxTimeOut, pxTicksToWait) == pdFALSE) {
+            //Not timed out yet. Block the current task
+            vTaskPlaceOnEventList(xSending ? &pxRingbuffer->xTasksWaitingToSend : &pxRingbuffer->xTasksWaitingToReceive, *pxTicksToWait);
+            portYIELD_WITHIN_API();
+        } else {
+            //We have timed out
+            xReturn = pdFALSE;
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+
+    return xReturn;
+}
+
+static void prvClearSpscWaiting(Ringbuffer_t *pxRingbuffer, BaseType_t xSending)
+{
+    //Waiting flags are only modified within the critical section, as vRingbufferReset() may update the flags
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    __atomic_fetch_and(&pxRingbuffer->uxRingbufferFlags, ~(xSending ? rbSPSC_SEND_WAITING_FLAG : rbSPSC_RECEIVE_WAITING_FLAG), __ATOMIC_RELAXED);
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
+static void prvNotifySpscWaiter(Ringbuffer_t *pxRingbuffer, BaseType_t xSending)
+{
+    //The producer wakes up a waiting consumer and vice versa
+    UBaseType_t uxWaitingFlag = xSending ? rbSPSC_RECEIVE_WAITING_FLAG : rbSPSC_SEND_WAITING_FLAG;
+    List_t *pxTasksWaiting = xSending ? &pxRingbuffer->xTasksWaitingToReceive : &pxRingbuffer->xTasksWaitingToSend;
+
+    //Order the publication of the read/write pointers before the check of the waiting flag
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&pxRingbuffer->uxRingbufferFlags, __ATOMIC_RELAXED) & uxWaitingFlag) == 0) {
+        return;
+    }
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    if (listLIST_IS_EMPTY(pxTasksWaiting) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxTasksWaiting) == pdTRUE) {
+            //The unblocked task will preempt us. Trigger a yield here.
+            portYIELD_WITHIN_API();
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
+static void prvNotifySpscWaiterFromISR(Ringbuffer_t *pxRingbuffer, BaseType_t xSending, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    UBaseType_t uxWaitingFlag = xSending ? rbSPSC_RECEIVE_WAITING_FLAG : rbSPSC_SEND_WAITING_FLAG;
+    List_t *pxTasksWaiting = xSending ? &pxRingbuffer->xTasksWaitingToReceive : &pxRingbuffer->xTasksWaitingToSend;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&pxRingbuffer->uxRingbufferFlags, __ATOMIC_RELAXED) & uxWaitingFlag) == 0) {
+        return;
+    }
+    portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
+    if (listLIST_IS_EMPTY(pxTasksWaiting) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxTasksWaiting) == pdTRUE) {
+            //The unblocked task will preempt us. Record that a context switch is required.
+            if (pxHigherPriorityTaskWoken != NULL) {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+        }
+    }
+    portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
+}
+
+static BaseType_t prvSendSpsc(Ringbuffer_t *pxRingbuffer,
+                              const RingbufferIovec_t *pxIov,
+                              size_t xItemSize,
+                              TickType_t xTicksToWait)
+{
+    BaseType_t xReturn = pdTRUE;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+        if (xTicksToWait == (TickType_t) 0 ||
+                prvBlockSpsc(pxRingbuffer, pdTRUE, xItemSize, &xTimeOut, &xEntryTimeSet, &xTicksToWait) == pdFALSE) {
+            xReturn = pdFALSE;
+            break;
+        }
+    }
+    if (xEntryTimeSet == pdTRUE) {
+        prvClearSpscWaiting(pxRingbuffer, pdTRUE);
+    }
+
+    if (xReturn == pdTRUE) {
+        pxRingbuffer->vCopyItem(pxRingbuffer, pxIov, xItemSize);
+        prvNotifySpscWaiter(pxRingbuffer, pdTRUE);
+    }
+    return xReturn;
+}
+
+static BaseType_t prvReceiveSpsc(Ringbuffer_t *pxRingbuffer,
+                                 void **pvItem,
+                                 size_t *xItemSize,
+                                 size_t xMaxSize,
+                                 TickType_t xTicksToWait)
+{
+    void *pvTempItem;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while ((pvTempItem = pxRingbuffer->pvGetItem(pxRingbuffer, NULL, xMaxSize, xItemSize)) == NULL) {
+        if (xTicksToWait == (TickType_t) 0 ||
+                prvBlockSpsc(pxRingbuffer, pdFALSE, 0, &xTimeOut, &xEntryTimeSet, &xTicksToWait) == pdFALSE) {
+            break;
+        }
+    }
+    if (xEntryTimeSet == pdTRUE) {
+        prvClearSpscWaiting(pxRingbuffer, pdFALSE);
+    }
+
+    if (pvTempItem == NULL) {
+        return pdFALSE;
+    }
+    *pvItem = pvTempItem;
+    return pdTRUE;
+}
+
 // ------------------------------------------------ Public Functions ---------------------------------------------------
 
 RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferType)
@@ -1019,7 +1671,7 @@ RingbufHandle_t xRingbufferCreateStatic(size_t xBufferSize,
     if (xBufferType >= RINGBUF_TYPE_MAX || xBufferSize == 0) {
         return NULL;
     }
-    if (xBufferType != RINGBUF_TYPE_BYTEBUF) {
+    if (!rbIS_BYTE_BUFFER_TYPE(xBufferType)) {
         //No-split/allow-split buffer sizes must be 32-bit aligned and large enough to avoid underflowing xMaxItemSize
         configASSERT(rbCHECK_ALIGNED(xBufferSize));
         if (!rbCHECK_ALIGNED(xBufferSize) || xBufferSize < rbHEADER_SIZE * 2) {
@@ -1040,7 +1692,7 @@ BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, s
     //Check arguments
     configASSERT(pxRingbuffer);
     configASSERT(ppvItem != NULL);
-    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0); //Send acquire currently only supported in NoSplit buffers
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG | rbSPSC_FLAG)) == 0); //Send acquire currently only supported in NoSplit buffers
 
     *ppvItem = NULL;
     if (xItemSize > pxRingbuffer->xMaxItemSize) {
@@ -1058,7 +1710,7 @@ BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem)
     //Check arguments
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
-    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG | rbSPSC_FLAG)) == 0);
 
     portENTER_CRITICAL(&pxRingbuffer->mux);
     prvSendItemDoneNoSplit(pxRingbuffer, pvItem);
@@ -1098,8 +1750,40 @@ BaseType_t xRingbufferSend(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    RingbufferIovec_t xIov = { .pvBase = (void *)pvItem, .xLen = xItemSize };
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSendSpsc(pxRingbuffer, &xIov, xItemSize, xTicksToWait);
+    }
+
+    return prvSendAcquireGeneric(pxRingbuffer, &xIov, NULL, xItemSize, xTicksToWait);
+}
+
+BaseType_t xRingbufferSendv(RingbufHandle_t xRingbuffer,
+                            const RingbufferIovec_t *pxIov,
+                            UBaseType_t uxIovCount,
+                            TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+    size_t xItemSize = 0;
+
+    //Check arguments
+    configASSERT(pxRingbuffer);
+    configASSERT(pxIov != NULL || uxIovCount == 0);
+    for (UBaseType_t i = 0; i < uxIovCount; i++) {
+        configASSERT(pxIov[i].pvBase != NULL || pxIov[i].xLen == 0);
+        if (pxIov[i].xLen > pxRingbuffer->xMaxItemSize - xItemSize) {
+            return pdFALSE;     //Data will never ever fit in the queue.
+        }
+        xItemSize += pxIov[i].xLen;
+    }
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
+        return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
+    }
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSendSpsc(pxRingbuffer, pxIov, xItemSize, xTicksToWait);
+    }
 
-    return prvSendAcquireGeneric(pxRingbuffer, pvItem, NULL, xItemSize, xTicksToWait);
+    return prvSendAcquireGeneric(pxRingbuffer, pxIov, NULL, xItemSize, xTicksToWait);
 }
 
 BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
@@ -1120,10 +1804,20 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    RingbufferIovec_t xIov = { .pvBase = (void *)pvItem, .xLen = xItemSize };
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        //SPSC ring buffers are written without entering the critical section
+        if (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+            return pdFALSE;
+        }
+        pxRingbuffer->vCopyItem(pxRingbuffer, &xIov, xItemSize);
+        prvNotifySpscWaiterFromISR(pxRingbuffer, pdTRUE, pxHigherPriorityTaskWoken);
+        return pdTRUE;
+    }
 
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (pxRingbuffer->xCheckItemFits(xRingbuffer, xItemSize) == pdTRUE) {
-        pxRingbuffer->vCopyItem(xRingbuffer, pvItem, xItemSize);
+        pxRingbuffer->vCopyItem(xRingbuffer, &xIov, xItemSize);
         if (pxRingbuffer->xQueueSet) {
             //If ring buffer was added to a queue set, notify the queue set
             xNotifyQueueSet = pdTRUE;
@@ -1258,12 +1952,36 @@ void *xRingbufferReceiveUpToFromISR(RingbufHandle_t xRingbuffer, size_t *pxItemS
     }
 }
 
+UBaseType_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                       RingbufferIovec_t *pxItems,
+                                       UBaseType_t uxMaxItems,
+                                       size_t xMaxSize,
+                                       TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer && pxItems);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);   //This function should only be called for no-split buffers
+
+    if (uxMaxItems == 0) {
+        return 0;
+    }
+    return prvReceiveMultipleGeneric(pxRingbuffer, pxItems, uxMaxItems, xMaxSize, xTicksToWait);
+}
+
 void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
+        prvNotifySpscWaiter(pxRingbuffer, pdFALSE);
+        return;
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1282,6 +2000,12 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
+        prvNotifySpscWaiterFromISR(pxRingbuffer, pdFALSE, pxHigherPriorityTaskWoken);
+        return;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1296,6 +2020,44 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
 }
 
+void vRingbufferReturnItems(RingbufHandle_t xRingbuffer, const RingbufferIovec_t *pxItems, UBaseType_t uxItemCount)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+    BaseType_t xYieldRequired = pdFALSE;
+    configASSERT(pxRingbuffer);
+    configASSERT(pxItems != NULL || uxItemCount == 0);
+
+    if (uxItemCount == 0) {
+        return;
+    }
+
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        for (UBaseType_t i = 0; i < uxItemCount; i++) {
+            configASSERT(pxItems[i].pvBase != NULL);
+            pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pxItems[i].pvBase);
+        }
+        prvNotifySpscWaiter(pxRingbuffer, pdFALSE);
+        return;
+    }
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    for (UBaseType_t i = 0; i < uxItemCount; i++) {
+        configASSERT(pxItems[i].pvBase != NULL);
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pxItems[i].pvBase);
+        //Unblock a task waiting for space to send for every item returned, as vRingbufferReturnItem() would
+        if (listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToSend) == pdFALSE) {
+            if (xTaskRemoveFromEventList(&pxRingbuffer->xTasksWaitingToSend) == pdTRUE) {
+                xYieldRequired = pdTRUE;
+            }
+        }
+    }
+    if (xYieldRequired == pdTRUE) {
+        //An unblocked task will preempt us. Trigger a yield here.
+        portYIELD_WITHIN_API();
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
 esp_err_t vRingbufferReset(RingbufHandle_t xRingbuffer)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
@@ -1367,8 +2129,9 @@ BaseType_t xRingbufferAddToQueueSetRead(RingbufHandle_t xRingbuffer, QueueSetHan
     configASSERT(pxRingbuffer && xQueueSet);
 
     portENTER_CRITICAL(&pxRingbuffer->mux);
-    if (pxRingbuffer->xQueueSet != NULL || prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
+    if (pxRingbuffer->xQueueSet != NULL || (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) || prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         /*
+        - SPSC ring buffers do not support queue sets
         - Cannot add ring buffer to more than one queue set
         - It is dangerous to add a ring buffer to a queue set if the ring buffer currently has data to be read.
         */
@@ -1469,6 +2232,9 @@ void xRingbufferPrintInfo(RingbufHandle_t xRingbuffer)
         if (RingbufferFlags & rbUSING_QUEUE_SET) {
             printf(" [USING_QUEUE_SET]");
         }
+        if (RingbufferFlags & rbSPSC_FLAG) {
+            printf(" [SPSC]");
+        }
     }
     printf(" ]\n  Items:\n");
 
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -23,6 +23,7 @@
 #include "esp_heap_caps.h"
 #include "esp_rom_sys.h"
 #include "esp_task.h"
+#include "esp_timer.h"
 
 #include "test_functions.h"
 
@@ -700,6 +701,214 @@ TEST_CASE("TC#3: Byte buffer", "[esp_ringbuf][linux]")
     vRingbufferDelete(buffer_handle);
 }
 
+/* ------------------ SPSC ring buffer behavior test cases ---------------------
+ * The following test cases test the send, receive, wrap around and buffer full
+ * behavior of the single-producer single-consumer (SPSC) ring buffer types.
+ * SPSC buffers always leave some space unused to tell a full buffer from an empty one.
+ *     1) Send items until the buffer is full and verify that a send failure occurs
+ *     2) Receive and check the sent items, verify that the buffer is empty again
+ *     3) Send a final item that causes a wrap around
+ *     4) Receive and check the wrapped item
+ */
+
+TEST_CASE("TC#1: SPSC No-Split", "[esp_ringbuf][linux]")
+{
+    //Create buffer
+    RingbufHandle_t buffer_handle = xRingbufferCreate(BUFFER_SIZE, RINGBUF_TYPE_SPSC_NOSPLIT);
+    TEST_ASSERT_MESSAGE(buffer_handle != NULL, "Failed to create ring buffer");
+
+    //Check buffer free size and max item size upon buffer creation. Should be BUFFER_SIZE/2 - ITEM_HDR_SIZE.
+    TEST_ASSERT_MESSAGE(xRingbufferGetCurFreeSize(buffer_handle) == ((BUFFER_SIZE >> 1) - ITEM_HDR_SIZE), "Incorrect buffer free size received");
+    TEST_ASSERT_MESSAGE(xRingbufferGetMaxItemSize(buffer_handle) == ((BUFFER_SIZE >> 1) - ITEM_HDR_SIZE), "Incorrect max item size received");
+
+    //Fill the buffer. One item slot is left unused to distinguish a full buffer from an empty one
+    int no_of_items = (BUFFER_SIZE - 1) / (ITEM_HDR_SIZE + SMALL_ITEM_SIZE);
+    for (int i = 0; i < no_of_items; i++) {
+        send_item_and_check(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+    }
+    send_item_and_check_failure(buffer_handle, small_item, SMALL_ITEM_SIZE, 0, false);
+
+    //Test receiving items
+    for (int i = 0; i < no_of_items; i++) {
+        receive_check_and_return_item_no_split(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+    }
+
+    //Verify that the buffer is empty
+    size_t item_size;
+    TEST_ASSERT_MESSAGE(xRingbufferReceive(buffer_handle, &item_size, 0) == NULL, "Received an item from an empty buffer");
+    TEST_ASSERT_MESSAGE(xRingbufferGetCurFreeSize(buffer_handle) > 0, "Incorrect buffer free size received");
+
+    //Write pointer should be near the end, test wrap around
+    UBaseType_t write_pos_before, write_pos_after;
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, &write_pos_before, NULL, NULL);
+    //Send large item that causes wrap around
+    send_item_and_check(buffer_handle, large_item, LARGE_ITEM_SIZE, TIMEOUT_TICKS, false);
+    //Receive wrapped item
+    receive_check_and_return_item_no_split(buffer_handle, large_item, LARGE_ITEM_SIZE, TIMEOUT_TICKS, false);
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, &write_pos_after, NULL, NULL);
+    TEST_ASSERT_MESSAGE(write_pos_after < write_pos_before, "Failed to wrap around");
+
+    //Cleanup
+    vRingbufferDelete(buffer_handle);
+}
+
+TEST_CASE("TC#1: SPSC Byte buffer", "[esp_ringbuf][linux]")
+{
+    //Create buffer
+    RingbufHandle_t buffer_handle = xRingbufferCreate(BUFFER_SIZE, RINGBUF_TYPE_SPSC_BYTEBUF);
+    TEST_ASSERT_MESSAGE(buffer_handle != NULL, "Failed to create ring buffer");
+
+    //Check buffer free size and max item size upon buffer creation. Should be BUFFER_SIZE - 1
+    TEST_ASSERT_MESSAGE(xRingbufferGetCurFreeSize(buffer_handle) == BUFFER_SIZE - 1, "Incorrect buffer free size received");
+    TEST_ASSERT_MESSAGE(xRingbufferGetMaxItemSize(buffer_handle) == BUFFER_SIZE - 1, "Incorrect max item size received");
+
+    //Fill the buffer
+    int no_of_items = (BUFFER_SIZE - 1) / SMALL_ITEM_SIZE;
+    for (int i = 0; i < no_of_items; i++) {
+        send_item_and_check(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+    }
+    size_t free_size = xRingbufferGetCurFreeSize(buffer_handle);
+    TEST_ASSERT_MESSAGE(free_size == BUFFER_SIZE - 1 - (no_of_items * SMALL_ITEM_SIZE), "Incorrect buffer free size received");
+    send_item_and_check_failure(buffer_handle, small_item, free_size + 1, 0, false);
+
+    //Test receiving items
+    for (int i = 0; i < no_of_items; i++) {
+        receive_check_and_return_item_byte_buffer(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+    }
+
+    //Verify that the buffer is empty
+    TEST_ASSERT_MESSAGE(xRingbufferGetCurFreeSize(buffer_handle) == BUFFER_SIZE - 1, "Incorrect buffer free size received");
+
+    //Write pointer should be near the end, test wrap around
+    UBaseType_t write_pos_before, write_pos_after;
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, &write_pos_before, NULL, NULL);
+    //Send large item that causes wrap around
+    send_item_and_check(buffer_handle, large_item, LARGE_ITEM_SIZE, TIMEOUT_TICKS, false);
+    //Receive wrapped item
+    receive_check_and_return_item_byte_buffer(buffer_handle, large_item, LARGE_ITEM_SIZE, TIMEOUT_TICKS, false);
+    vRingbufferGetInfo(buffer_handle, NULL, NULL, &write_pos_after, NULL, NULL);
+    TEST_ASSERT_MESSAGE(write_pos_after < write_pos_before, "Failed to wrap around");
+
+    //Cleanup
+    vRingbufferDelete(buffer_handle);
+}
+
+/* ------------------------- SPSC ring buffer blocking -------------------------
+ * The following test case checks that the consumer and producer of a SPSC ring
+ * buffer only need the critical section to block, and are unblocked by the other
+ * side making progress.
+ */
+
+static volatile bool spsc_task_done = false;
+
+static void spsc_receive_task(void *arg)
+{
+    RingbufHandle_t rb = (RingbufHandle_t)arg;
+    size_t item_size;
+    void *rx_item = xRingbufferReceiveUpTo(rb, &item_size, portMAX_DELAY, SMALL_ITEM_SIZE);
+    TEST_ASSERT_NOT_NULL(rx_item);
+    TEST_ASSERT_EQUAL(SMALL_ITEM_SIZE, item_size);
+    vRingbufferReturnItem(rb, rx_item);
+    spsc_task_done = true;
+    vTaskDelete(NULL);
+}
+
+static void spsc_send_task(void *arg)
+{
+    RingbufHandle_t rb = (RingbufHandle_t)arg;
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(rb, small_item, SMALL_ITEM_SIZE, portMAX_DELAY));
+    spsc_task_done = true;
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("Test SPSC ring buffer unblocks receiver and sender", "[esp_ringbuf][linux]")
+{
+    RingbufHandle_t rb = xRingbufferCreate(SMALL_ITEM_SIZE + 1, RINGBUF_TYPE_SPSC_BYTEBUF);
+    TEST_ASSERT_MESSAGE(rb != NULL, "Failed to create ring buffer");
+
+    // Launch task to block on receiving from the empty ring buffer
+    spsc_task_done = false;
+    xTaskCreatePinnedToCore(spsc_receive_task, "rec tsk", 2048, (void*)rb, ESP_TASK_MAIN_PRIO + 1, NULL, 0);
+    vTaskDelay(10);
+    TEST_ASSERT_EQUAL(false, spsc_task_done);
+    // Sending an item must unblock the receiver
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(rb, small_item, SMALL_ITEM_SIZE, 0));
+    vTaskDelay(10);
+    TEST_ASSERT_EQUAL(true, spsc_task_done);
+
+    // Fill buffer and launch task to block on sending to the full ring buffer
+    TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(rb, small_item, SMALL_ITEM_SIZE, 0));
+    TEST_ASSERT_EQUAL(0, xRingbufferGetCurFreeSize(rb));
+    spsc_task_done = false;
+    xTaskCreatePinnedToCore(spsc_send_task, "send tsk", 2048, (void*)rb, ESP_TASK_MAIN_PRIO + 1, NULL, 0);
+    vTaskDelay(10);
+    TEST_ASSERT_EQUAL(false, spsc_task_done);
+    // Returning the received data must unblock the sender
+    receive_check_and_return_item_byte_buffer(rb, small_item, SMALL_ITEM_SIZE, 0, false);
+    vTaskDelay(10);
+    TEST_ASSERT_EQUAL(true, spsc_task_done);
+    receive_check_and_return_item_byte_buffer(rb, small_item, SMALL_ITEM_SIZE, 0, false);
+
+    // Cleanup
+    vRingbufferDelete(rb);
+    vTaskDelay(1);
+}
+
+/* ------------------------ SPSC ring buffer throughput ------------------------
+ * The following test case streams data from a producer task to a consumer task
+ * through a byte buffer and a SPSC byte buffer of the same size, and reports the
+ * throughput of both.
+ */
+
+#define THROUGHPUT_BUFFER_SIZE          4096
+#define THROUGHPUT_CHUNK_SIZE           64
+#define THROUGHPUT_TOTAL_SIZE           (1024 * 1024)
+
+static void throughput_send_task(void *arg)
+{
+    RingbufHandle_t rb = (RingbufHandle_t)arg;
+    uint8_t chunk[THROUGHPUT_CHUNK_SIZE] = {0};
+    for (size_t sent = 0; sent < THROUGHPUT_TOTAL_SIZE; sent += THROUGHPUT_CHUNK_SIZE) {
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(rb, chunk, THROUGHPUT_CHUNK_SIZE, portMAX_DELAY));
+    }
+    xSemaphoreGive(tasks_done);
+    vTaskDelete(NULL);
+}
+
+static int64_t measure_throughput_us(RingbufferType_t buf_type)
+{
+    RingbufHandle_t rb = xRingbufferCreate(THROUGHPUT_BUFFER_SIZE, buf_type);
+    TEST_ASSERT_MESSAGE(rb != NULL, "Failed to create ring buffer");
+
+    int64_t start = esp_timer_get_time();
+    xTaskCreatePinnedToCore(throughput_send_task, "send tsk", 2048, (void *)rb, ESP_TASK_MAIN_PRIO, NULL, 0);
+    size_t received = 0;
+    while (received < THROUGHPUT_TOTAL_SIZE) {
+        size_t item_size;
+        void *rx_item = xRingbufferReceiveUpTo(rb, &item_size, portMAX_DELAY, THROUGHPUT_CHUNK_SIZE);
+        TEST_ASSERT_NOT_NULL(rx_item);
+        received += item_size;
+        vRingbufferReturnItem(rb, rx_item);
+    }
+    xSemaphoreTake(tasks_done, portMAX_DELAY);
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    vRingbufferDelete(rb);
+    vTaskDelay(5);  //Allow idle to clean up
+    return elapsed;
+}
+
+TEST_CASE("Test SPSC byte buffer throughput", "[esp_ringbuf][linux]")
+{
+    tasks_done = xSemaphoreCreateBinary();
+    int64_t bytebuf_us = measure_throughput_us(RINGBUF_TYPE_BYTEBUF);
+    int64_t spsc_bytebuf_us = measure_throughput_us(RINGBUF_TYPE_SPSC_BYTEBUF);
+    vSemaphoreDelete(tasks_done);
+
+    printf("Byte buffer: %lld us, SPSC byte buffer: %lld us for %d bytes in chunks of %d bytes\n",
+           (long long)bytebuf_us, (long long)spsc_bytebuf_us, THROUGHPUT_TOTAL_SIZE, THROUGHPUT_CHUNK_SIZE);
+}
+
 /* ----------------------- Ring buffer queue sets test ------------------------
  * The following test case will test receiving from ring buffers that have been
  * added to a queue set. The test case will do the following...
@@ -839,7 +1048,7 @@ void read_from_buffer(RingbufHandle_t buffer, RingbufferType_t buf_type, size_t
             char *item_data, *item_data2;
 
             //Select appropriate receive function for type of ring buffer
-            if (buf_type ==  RINGBUF_TYPE_NOSPLIT) {
+            if (buf_type ==  RINGBUF_TYPE_NOSPLIT || buf_type == RINGBUF_TYPE_SPSC_NOSPLIT) {
                 item_data = (char *)xRingbufferReceive(buffer, &item_size, TIMEOUT_TICKS);
             } else if (buf_type == RINGBUF_TYPE_ALLOWSPLIT) {
                 BaseType_t ret = xRingbufferReceiveSplit(buffer, (void **)&item_data, (void **)&item_data2, &item_size, &item_size2, TIMEOUT_TICKS);
@@ -850,7 +1059,7 @@ void read_from_buffer(RingbufHandle_t buffer, RingbufferType_t buf_type, size_t
 
             //Check received item and return it
             TEST_ASSERT_MESSAGE(item_data != NULL, "Failed to receive an item");
-            if (buf_type == RINGBUF_TYPE_BYTEBUF) {
+            if (buf_type == RINGBUF_TYPE_BYTEBUF || buf_type == RINGBUF_TYPE_SPSC_BYTEBUF) {
                 TEST_ASSERT_MESSAGE(item_size <= max_rec_size, "Received data exceeds max size");
             }
             for (int i = 0; i < item_size; i++) {
@@ -924,7 +1133,7 @@ void cleanup(void)
 TEST_CASE("Test ring buffer SMP", "[esp_ringbuf][linux]")
 {
     setup();
-    //Iterate through buffer types (No split, split, then byte buff)
+    //Iterate through buffer types (No split, split, byte buff, then their SPSC variants)
     for (RingbufferType_t buf_type = 0; buf_type < RINGBUF_TYPE_MAX; buf_type++) {
         //Create buffer
         task_args_t task_args;
@@ -956,7 +1165,7 @@ TEST_CASE("Test ring buffer SMP", "[esp_ringbuf][linux]")
 TEST_CASE("Test static ring buffer SMP", "[esp_ringbuf][linux]")
 {
     setup();
-    //Iterate through buffer types (No split, split, then byte buff)
+    //Iterate through buffer types (No split, split, byte buff, then their SPSC variants)
     for (RingbufferType_t buf_type = 0; buf_type < RINGBUF_TYPE_MAX; buf_type++) {
         StaticRingbuffer_t *buffer_struct;
         uint8_t *buffer_storage;
@@ -1401,6 +1610,117 @@ TEST_CASE("Test no-split full buffer becomes empty when oldest is returned last"
     vRingbufferDelete(buffer_handle);
 }
 
+/* ------------------------ Test ring buffer vectored send ---------------------
+ * The following test case tests that an item sent from several blocks using
+ * xRingbufferSendv() is received as a single item that is the concatenation of
+ * those blocks, including when the item wraps around, for each type of ring buffer.
+ */
+
+#define VECTORED_ITEM_SIZE          (SMALL_ITEM_SIZE + MEDIUM_ITEM_SIZE)
+#define VECTORED_SEND_ITERATIONS    10
+
+TEST_CASE("Test ring buffer vectored send", "[esp_ringbuf][linux]")
+{
+    uint8_t expected_item[VECTORED_ITEM_SIZE];
+    for (int i = 0; i < VECTORED_ITEM_SIZE; i++) {
+        expected_item[i] = (uint8_t)(i * 3 + 1);
+    }
+    //Split the item into three blocks, one of them empty
+    RingbufferIovec_t iov[] = {
+        { .pvBase = expected_item, .xLen = 5 },
+        { .pvBase = NULL, .xLen = 0 },
+        { .pvBase = expected_item + 5, .xLen = VECTORED_ITEM_SIZE - 5 },
+    };
+
+    for (RingbufferType_t buf_type = 0; buf_type < RINGBUF_TYPE_MAX; buf_type++) {
+        RingbufHandle_t buffer_handle = xRingbufferCreate(BUFFER_SIZE, buf_type);
+        TEST_ASSERT_MESSAGE(buffer_handle != NULL, "Failed to create ring buffer");
+
+        //Send and receive enough items for the items to wrap around
+        for (int i = 0; i < VECTORED_SEND_ITERATIONS; i++) {
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendv(buffer_handle, iov, sizeof(iov) / sizeof(iov[0]), TIMEOUT_TICKS));
+            if (buf_type == RINGBUF_TYPE_NOSPLIT || buf_type == RINGBUF_TYPE_SPSC_NOSPLIT) {
+                receive_check_and_return_item_no_split(buffer_handle, expected_item, VECTORED_ITEM_SIZE, TIMEOUT_TICKS, false);
+            } else if (buf_type == RINGBUF_TYPE_ALLOWSPLIT) {
+                receive_check_and_return_item_allow_split(buffer_handle, expected_item, VECTORED_ITEM_SIZE, TIMEOUT_TICKS, false);
+            } else {
+                receive_check_and_return_item_byte_buffer(buffer_handle, expected_item, VECTORED_ITEM_SIZE, TIMEOUT_TICKS, false);
+            }
+        }
+
+        //Items larger than the maximum item size in total must be rejected
+        RingbufferIovec_t large_iov[] = {
+            { .pvBase = (void *)small_item, .xLen = SMALL_ITEM_SIZE },
+            { .pvBase = (void *)small_item, .xLen = xRingbufferGetMaxItemSize(buffer_handle) },
+        };
+        TEST_ASSERT_EQUAL(pdFALSE, xRingbufferSendv(buffer_handle, large_iov, 2, 0));
+
+        vRingbufferDelete(buffer_handle);
+    }
+}
+
+/* ----------------------- Test ring buffer batch receive ----------------------
+ * The following test case tests retrieving several items from a no-split ring
+ * buffer at once using xRingbufferReceiveMultiple(), and returning them at once
+ * using vRingbufferReturnItems().
+ *     1) Send multiple items of different sizes
+ *     2) Receive them in batches limited by item count and total size, and check their order and data
+ *     3) Return each batch and verify that all the space is freed
+ *     4) Verify that receiving from an empty buffer times out
+ */
+
+#define BATCH_NO_OF_ITEMS           4
+
+static void check_batch_receive(RingbufferType_t buf_type)
+{
+    RingbufHandle_t buffer_handle = xRingbufferCreate(BUFFER_SIZE, buf_type);
+    TEST_ASSERT_MESSAGE(buffer_handle != NULL, "Failed to create ring buffer");
+    size_t free_size = xRingbufferGetCurFreeSize(buffer_handle);
+
+    //Item i is made of the first i + 1 bytes of small_item
+    for (int i = 0; i < BATCH_NO_OF_ITEMS; i++) {
+        send_item_and_check(buffer_handle, small_item, i + 1, TIMEOUT_TICKS, false);
+    }
+
+    //Receive the first two items, limited by item count
+    RingbufferIovec_t items[BATCH_NO_OF_ITEMS];
+    TEST_ASSERT_EQUAL(2, xRingbufferReceiveMultiple(buffer_handle, items, 2, 0, TIMEOUT_TICKS));
+    //Receive the third item only, limited by total size (the fourth item would exceed 4 bytes)
+    TEST_ASSERT_EQUAL(1, xRingbufferReceiveMultiple(buffer_handle, &items[2], BATCH_NO_OF_ITEMS, 4, TIMEOUT_TICKS));
+    //The first item is retrieved even if it exceeds the size limit
+    TEST_ASSERT_EQUAL(1, xRingbufferReceiveMultiple(buffer_handle, &items[3], BATCH_NO_OF_ITEMS, 1, TIMEOUT_TICKS));
+    for (int i = 0; i < BATCH_NO_OF_ITEMS; i++) {
+        TEST_ASSERT_EQUAL(i + 1, items[i].xLen);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(small_item, items[i].pvBase, items[i].xLen);
+    }
+    vRingbufferReturnItems(buffer_handle, items, BATCH_NO_OF_ITEMS);
+    TEST_ASSERT_EQUAL(free_size, xRingbufferGetCurFreeSize(buffer_handle));
+
+    //Send and receive batches until the items wrap around
+    for (int iter = 0; iter < 4; iter++) {
+        for (int i = 0; i < 2; i++) {
+            send_item_and_check(buffer_handle, small_item, SMALL_ITEM_SIZE, TIMEOUT_TICKS, false);
+        }
+        TEST_ASSERT_EQUAL(2, xRingbufferReceiveMultiple(buffer_handle, items, BATCH_NO_OF_ITEMS, 0, TIMEOUT_TICKS));
+        for (int i = 0; i < 2; i++) {
+            TEST_ASSERT_EQUAL(SMALL_ITEM_SIZE, items[i].xLen);
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(small_item, items[i].pvBase, SMALL_ITEM_SIZE);
+        }
+        vRingbufferReturnItems(buffer_handle, items, 2);
+    }
+
+    //Receiving from an empty buffer times out
+    TEST_ASSERT_EQUAL(0, xRingbufferReceiveMultiple(buffer_handle, items, BATCH_NO_OF_ITEMS, 0, 1));
+
+    vRingbufferDelete(buffer_handle);
+}
+
+TEST_CASE("Test no-split buffers batch receive", "[esp_ringbuf][linux]")
+{
+    check_batch_receive(RINGBUF_TYPE_NOSPLIT);
+    check_batch_receive(RINGBUF_TYPE_SPSC_NOSPLIT);
+}
+
 /* ----------------------------------- Test ring buffer reset --------------------------------------
  * Reset Case: Test that vRingbufferReset() empties the ring buffer
  * Reset unblocks sender: Test that vRingbufferReset() will unblock a previously blocked sender
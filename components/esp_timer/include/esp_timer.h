@@ -76,8 +76,20 @@ typedef struct {
     //                                !< CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
     const char* name;               //!< Timer name, used in esp_timer_dump() function
     bool skip_unhandled_events;     //!< Setting to skip unhandled events in light sleep for periodic timers
+    uint32_t slack_us;              //!< Time in microseconds by which the callback may be dispatched after the alarm,
+    //                                !< so that timers with close alarms are dispatched together after a single
+    //                                !< wakeup. 0 (default) dispatches the callback at the alarm
 } esp_timer_create_args_t;
 
+/**
+ * @brief Statistics of the alarms, returned by esp_timer_get_coalescing_stats()
+ */
+typedef struct {
+    uint32_t alarms;                //!< Number of alarms after which timer callbacks were dispatched
+    uint32_t wakeups_saved;         //!< Number of alarms saved by dispatching timers, within their slack,
+    //                                !< after the alarm of another timer
+} esp_timer_coalescing_stats_t;
+
 /**
  * @brief Minimal initialization of esp_timer
  *
@@ -328,7 +340,9 @@ int64_t esp_timer_get_time(void);
  * @brief Get the timestamp when the next timer will expire
  *
  * This function returns the alarm time of the timer that will expire soonest
- * across all dispatch methods (TASK and ISR).
+ * across all dispatch methods (TASK and ISR). If timers have a slack
+ * (::esp_timer_create_args_t::slack_us), this is the time at which the timers
+ * due by then are dispatched together, which may be later than their alarms.
  *
  * @return Timestamp of the nearest timer event, in microseconds since boot.
  *         Returns INT64_MAX if no timers are currently armed.
@@ -342,6 +356,7 @@ int64_t esp_timer_get_next_alarm(void);
  * This function returns the alarm time of the timer that will expire soonest, excluding
  * timers that have ::esp_timer_create_args_t::skip_unhandled_events enabled. Used by
  * the power management system to determine when to wake from light sleep.
+ * The slack of the timers is taken into account as in esp_timer_get_next_alarm().
  *
  * @return Timestamp of the nearest timer event that should wake the system, in microseconds since boot.
  *         Returns INT64_MAX if no wake-capable timers are currently armed.
@@ -418,6 +433,21 @@ esp_err_t esp_timer_get_expiry_time(esp_timer_handle_t timer, uint64_t *expiry);
  */
 esp_err_t esp_timer_dump(FILE* stream);
 
+/**
+ * @brief Get the statistics of the alarms of all the timers
+ *
+ * Timers armed with a slack (::esp_timer_create_args_t::slack_us) whose dispatch
+ * windows overlap are dispatched together after a single alarm. The statistics
+ * count the alarms after which callbacks were dispatched, and the alarms saved
+ * by this, i.e. the number of alarms without slack minus the number of alarms.
+ *
+ * @param[out] stats statistics of the alarms since esp_timer was initialized
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t esp_timer_get_coalescing_stats(esp_timer_coalescing_stats_t* stats);
+
 #if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD || defined __DOXYGEN__
 /**
  * @brief Requests a context switch from a timer callback function.
@@ -51,6 +51,7 @@ struct esp_timer {
         uint32_t event_id;
     };
     void* arg;
+    uint32_t slack;
 #if WITH_PROFILING
     const char* name;
     size_t times_triggered;
@@ -58,16 +59,34 @@ struct esp_timer {
     size_t times_skipped;
     uint64_t total_callback_run_time;
 #endif // WITH_PROFILING
+#if CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+    uint32_t seq;                   // order of arming, timers with the same alarm fire in this order
+    struct esp_timer* heap_child;   // leftmost child in the heap
+    struct esp_timer* heap_sibling; // right sibling in the heap
+    struct esp_timer* heap_prev;    // parent if this is the leftmost child, left sibling otherwise
+#endif
+#if !CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP || WITH_PROFILING
     LIST_ENTRY(esp_timer) list_entry;
+#endif
 };
 
 static inline bool is_initialized(void);
-static esp_err_t timer_insert(esp_timer_handle_t timer, bool without_update_alarm);
+static esp_err_t timer_insert(esp_timer_handle_t timer);
 static void timer_remove(esp_timer_handle_t timer);
 static bool timer_armed(esp_timer_handle_t timer);
 static void timer_list_lock(esp_timer_dispatch_t timer_type);
 static void timer_list_unlock(esp_timer_dispatch_t timer_type);
 static esp_err_t timer_restart(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t alarm_us);
+static esp_timer_handle_t timer_queue_first(esp_timer_dispatch_t dispatch_method);
+static esp_timer_handle_t timer_queue_next(esp_timer_handle_t timer);
+/* The alarm is set at the earliest time by which an armed timer has to be dispatched,
+ * given its slack, and all the timers due by then are dispatched together.
+ * Returns this time, or UINT64_MAX if no timer is armed. With wake_up set, the
+ * timers which skip unhandled events do not set the alarm, but are dispatched too.
+ */
+static uint64_t timer_queue_coalesced_alarm(esp_timer_dispatch_t dispatch_method, bool wake_up);
+static void timer_queue_add(esp_timer_handle_t timer);
+static void timer_queue_remove(esp_timer_handle_t timer);
 
 #if WITH_PROFILING
 static void timer_insert_inactive(esp_timer_handle_t timer);
@@ -76,10 +95,17 @@ static void timer_remove_inactive(esp_timer_handle_t timer);
 
 ESP_LOG_ATTR_TAG(TAG, "esp_timer");
 
+#if CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+// roots of the heaps of currently armed timers for two dispatch methods: ISR and TASK
+static esp_timer_handle_t s_timers[ESP_TIMER_MAX];
+// arming order of the timers of each heap
+static uint32_t s_timer_seq[ESP_TIMER_MAX];
+#else
 // lists of currently armed timers for two dispatch methods: ISR and TASK
 static LIST_HEAD(esp_timer_list, esp_timer) s_timers[ESP_TIMER_MAX] = {
     [0 ...(ESP_TIMER_MAX - 1)] = LIST_HEAD_INITIALIZER(s_timers)
 };
+#endif
 #if WITH_PROFILING
 // lists of unarmed timers for two dispatch methods: ISR and TASK,
 // used only to be able to dump statistics about all the timers
@@ -87,10 +113,16 @@ static LIST_HEAD(esp_inactive_timer_list, esp_timer) s_inactive_timers[ESP_TIMER
     [0 ...(ESP_TIMER_MAX - 1)] = LIST_HEAD_INITIALIZER(s_timers)
 };
 #endif
+// alarms last set for two dispatch methods: ISR and TASK
+static uint64_t s_next_alarm[ESP_TIMER_MAX] = {
+    [0 ...(ESP_TIMER_MAX - 1)] = UINT64_MAX
+};
+// statistics of the alarms for two dispatch methods: ISR and TASK
+static esp_timer_coalescing_stats_t s_coalescing_stats[ESP_TIMER_MAX];
 // task used to dispatch timer callbacks
 static TaskHandle_t s_timer_task;
 
-// lock protecting s_timers, s_inactive_timers
+// lock protecting s_timers, s_inactive_timers, s_next_alarm, s_coalescing_stats
 static portMUX_TYPE s_timer_lock[ESP_TIMER_MAX] = {
     [0 ...(ESP_TIMER_MAX - 1)] = portMUX_INITIALIZER_UNLOCKED
 };
@@ -116,6 +148,7 @@ esp_err_t esp_timer_create(const esp_timer_create_args_t* args,
     }
     result->callback = args->callback;
     result->arg = args->arg;
+    result->slack = args->slack_us;
     result->flags = (args->dispatch_method ? FL_ISR_DISPATCH_METHOD : 0) |
                     (args->skip_unhandled_events ? FL_SKIP_UNHANDLED_EVENTS : 0);
 #if WITH_PROFILING
@@ -186,7 +219,7 @@ static esp_err_t ESP_TIMER_IRAM_ATTR timer_restart(esp_timer_handle_t timer, uin
         timer->alarm = (first_alarm_us != 0) ? first_alarm_us : now + timeout_us;
         timer->period = 0;
     }
-    ret = timer_insert(timer, false);
+    ret = timer_insert(timer);
 
     timer_list_unlock(dispatch_method);
 
@@ -221,7 +254,7 @@ static esp_err_t ESP_TIMER_IRAM_ATTR timer_init(esp_timer_handle_t timer, uint64
         timer->times_armed++;
         timer->times_skipped = 0;
 #endif
-        err = timer_insert(timer, false);
+        err = timer_insert(timer);
     }
     timer_list_unlock(dispatch_method);
     return err;
@@ -379,36 +412,30 @@ esp_err_t esp_timer_delete(esp_timer_handle_t timer)
         timer->event_id = EVENT_ID_DELETE_TIMER;
         timer->alarm = alarm;
         timer->period = 0;
-        err = timer_insert(timer, false);
+        timer->slack = 0;
+        err = timer_insert(timer);
     }
     timer_list_unlock(ESP_TIMER_TASK);
     return err;
 }
 
-static ESP_TIMER_IRAM_ATTR esp_err_t timer_insert(esp_timer_handle_t timer, bool without_update_alarm)
+static ESP_TIMER_IRAM_ATTR void timer_set_alarm(esp_timer_dispatch_t dispatch_method, uint64_t alarm)
+{
+    s_next_alarm[dispatch_method] = alarm;
+    esp_timer_impl_set_alarm_id(alarm, dispatch_method);
+}
+
+static ESP_TIMER_IRAM_ATTR esp_err_t timer_insert(esp_timer_handle_t timer)
 {
 #if WITH_PROFILING
     timer_remove_inactive(timer);
 #endif
-    esp_timer_handle_t it, last = NULL;
     esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
-    if (LIST_FIRST(&s_timers[dispatch_method]) == NULL) {
-        LIST_INSERT_HEAD(&s_timers[dispatch_method], timer, list_entry);
-    } else {
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            if (timer->alarm < it->alarm) {
-                LIST_INSERT_BEFORE(it, timer, list_entry);
-                break;
-            }
-            last = it;
-        }
-        if (it == NULL) {
-            assert(last);
-            LIST_INSERT_AFTER(last, timer, list_entry);
-        }
-    }
-    if (without_update_alarm == false && timer == LIST_FIRST(&s_timers[dispatch_method])) {
-        esp_timer_impl_set_alarm_id(timer->alarm, dispatch_method);
+    timer_queue_add(timer);
+    /* The alarm is only moved earlier if the timer can't be dispatched at the alarm already set */
+    const uint64_t latest_alarm = timer->alarm + timer->slack;
+    if (latest_alarm < s_next_alarm[dispatch_method]) {
+        timer_set_alarm(dispatch_method, latest_alarm);
     }
     return ESP_OK;
 }
@@ -417,17 +444,16 @@ static ESP_TIMER_IRAM_ATTR esp_err_t timer_insert(esp_timer_handle_t timer, bool
 static ESP_TIMER_IRAM_ATTR void timer_remove(esp_timer_handle_t timer)
 {
     esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
-    esp_timer_handle_t first_timer = LIST_FIRST(&s_timers[dispatch_method]);
-    LIST_REMOVE(timer, list_entry);
+    esp_timer_handle_t first_timer = timer_queue_first(dispatch_method);
+    timer_queue_remove(timer);
+    /* If this timer was the first in the list, or the alarm was set by its deadline,
+     * the alarm may be later now. */
+    const bool update_alarm = (timer == first_timer) ||
+                              (timer->alarm + timer->slack == s_next_alarm[dispatch_method]);
     timer->alarm = 0;
     timer->period = 0;
-    if (timer == first_timer) { // if this timer was the first in the list.
-        uint64_t next_timestamp = UINT64_MAX;
-        first_timer = LIST_FIRST(&s_timers[dispatch_method]);
-        if (first_timer) { // if after removing the timer from the list, this list is not empty.
-            next_timestamp = first_timer->alarm;
-        }
-        esp_timer_impl_set_alarm_id(next_timestamp, dispatch_method);
+    if (update_alarm) {
+        timer_set_alarm(dispatch_method, timer_queue_coalesced_alarm(dispatch_method, false));
     }
 #if WITH_PROFILING
     timer_insert_inactive(timer);
@@ -460,6 +486,222 @@ static ESP_TIMER_IRAM_ATTR void timer_remove_inactive(esp_timer_handle_t timer)
 
 #endif // WITH_PROFILING
 
+#if CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+
+/* Armed timers are kept in a pairing heap ordered by alarm, then by arming order.
+ * Adding a timer takes O(1) time, removing any timer O(log n) amortized time.
+ * The children of a node are a list linked by heap_sibling, each child points back
+ * to its left sibling, or to the parent for the leftmost child, with heap_prev.
+ * All of these functions should be called with the timer list locked.
+ */
+
+static ESP_TIMER_IRAM_ATTR bool timer_fires_before(const struct esp_timer* a, const struct esp_timer* b)
+{
+    return a->alarm < b->alarm || (a->alarm == b->alarm && (int32_t)(a->seq - b->seq) < 0);
+}
+
+// Merge two heaps which are not linked to any other node, returns the root of the result
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_heap_meld(esp_timer_handle_t a, esp_timer_handle_t b)
+{
+    if (timer_fires_before(b, a)) {
+        esp_timer_handle_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->heap_prev = a;
+    b->heap_sibling = a->heap_child;
+    if (a->heap_child) {
+        a->heap_child->heap_prev = b;
+    }
+    a->heap_child = b;
+    return a;
+}
+
+// Merge the list of heaps starting at first into one heap, in two passes, returns its root
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_heap_merge_pairs(esp_timer_handle_t first)
+{
+    /* First pass: meld the heaps in pairs from left to right,
+     * pushing the results on a stack linked by heap_sibling. */
+    esp_timer_handle_t pairs = NULL;
+    while (first != NULL) {
+        esp_timer_handle_t a = first;
+        esp_timer_handle_t b = a->heap_sibling;
+        first = (b != NULL) ? b->heap_sibling : NULL;
+        a->heap_prev = a->heap_sibling = NULL;
+        if (b != NULL) {
+            b->heap_prev = b->heap_sibling = NULL;
+            a = timer_heap_meld(a, b);
+        }
+        a->heap_sibling = pairs;
+        pairs = a;
+    }
+    /* Second pass: meld the pairs from right to left */
+    esp_timer_handle_t root = NULL;
+    while (pairs != NULL) {
+        esp_timer_handle_t next = pairs->heap_sibling;
+        pairs->heap_sibling = NULL;
+        root = (root != NULL) ? timer_heap_meld(root, pairs) : pairs;
+        pairs = next;
+    }
+    return root;
+}
+
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_heap_parent(esp_timer_handle_t timer)
+{
+    while (timer->heap_prev != NULL && timer->heap_prev->heap_child != timer) {
+        timer = timer->heap_prev;
+    }
+    return timer->heap_prev;
+}
+
+// Next timer in pre-order after all the timers of the sub-heap of the given one
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_heap_skip(esp_timer_handle_t timer)
+{
+    while (timer != NULL && timer->heap_sibling == NULL) {
+        timer = timer_heap_parent(timer);
+    }
+    return (timer != NULL) ? timer->heap_sibling : NULL;
+}
+
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_queue_first(esp_timer_dispatch_t dispatch_method)
+{
+    return s_timers[dispatch_method];
+}
+
+// Iterates over the heap in pre-order, which is not the order of the alarms
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_queue_next(esp_timer_handle_t timer)
+{
+    return (timer->heap_child != NULL) ? timer->heap_child : timer_heap_skip(timer);
+}
+
+static ESP_TIMER_IRAM_ATTR uint64_t timer_queue_coalesced_alarm(esp_timer_dispatch_t dispatch_method, bool wake_up)
+{
+    uint64_t alarm = UINT64_MAX;
+    esp_timer_handle_t it = s_timers[dispatch_method];
+    while (it != NULL) {
+        if (it->alarm >= alarm) {
+            // the timers of this sub-heap are due at or after the alarm found so far
+            it = timer_heap_skip(it);
+            continue;
+        }
+        if (!wake_up || (it->flags & FL_SKIP_UNHANDLED_EVENTS) == 0) {
+            alarm = MIN(alarm, it->alarm + it->slack);
+            if (it == s_timers[dispatch_method] && alarm == it->alarm) {
+                // no other timer is due before the earliest one
+                break;
+            }
+        }
+        it = timer_queue_next(it);
+    }
+    return alarm;
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_queue_add(esp_timer_handle_t timer)
+{
+    esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
+    timer->seq = s_timer_seq[dispatch_method]++;
+    timer->heap_child = timer->heap_sibling = timer->heap_prev = NULL;
+    esp_timer_handle_t root = s_timers[dispatch_method];
+    s_timers[dispatch_method] = (root != NULL) ? timer_heap_meld(root, timer) : timer;
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_queue_remove(esp_timer_handle_t timer)
+{
+    esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
+    esp_timer_handle_t children = timer_heap_merge_pairs(timer->heap_child);
+    if (timer == s_timers[dispatch_method]) {
+        s_timers[dispatch_method] = children;
+    } else {
+        // unlink the sub-heap of the timer from its parent, then meld its children back into the heap
+        if (timer->heap_prev->heap_child == timer) {
+            timer->heap_prev->heap_child = timer->heap_sibling;
+        } else {
+            timer->heap_prev->heap_sibling = timer->heap_sibling;
+        }
+        if (timer->heap_sibling != NULL) {
+            timer->heap_sibling->heap_prev = timer->heap_prev;
+        }
+        if (children != NULL) {
+            s_timers[dispatch_method] = timer_heap_meld(s_timers[dispatch_method], children);
+        }
+    }
+    timer->heap_child = timer->heap_sibling = timer->heap_prev = NULL;
+}
+
+/* Copy of a timer taken by esp_timer_dump, printed once the timer list is unlocked */
+typedef struct {
+    struct esp_timer timer;
+    esp_timer_handle_t handle;
+} timer_snapshot_t;
+
+static int timer_compare_alarms(const void* a, const void* b)
+{
+    const struct esp_timer* ta = &((const timer_snapshot_t*) a)->timer;
+    const struct esp_timer* tb = &((const timer_snapshot_t*) b)->timer;
+    return timer_fires_before(ta, tb) ? -1 : timer_fires_before(tb, ta) ? 1 : 0;
+}
+
+#else // CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+
+/* Armed timers are kept in a list sorted by alarm. Adding a timer walks the list
+ * to find its position, so it takes O(n) time. Removing a timer takes O(1) time.
+ * All of these functions should be called with the timer list locked.
+ */
+
+static ESP_TIMER_IRAM_ATTR esp_timer_handle_t timer_queue_first(esp_timer_dispatch_t dispatch_method)
+{
+    return LIST_FIRST(&s_timers[dispatch_method]);
+}
+
+static esp_timer_handle_t timer_queue_next(esp_timer_handle_t timer)
+{
+    return LIST_NEXT(timer, list_entry);
+}
+
+static ESP_TIMER_IRAM_ATTR uint64_t timer_queue_coalesced_alarm(esp_timer_dispatch_t dispatch_method, bool wake_up)
+{
+    uint64_t alarm = UINT64_MAX;
+    esp_timer_handle_t it;
+    LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
+        if (it->alarm >= alarm) {
+            // this timer and the next ones are due at or after the alarm found so far
+            break;
+        }
+        if (!wake_up || (it->flags & FL_SKIP_UNHANDLED_EVENTS) == 0) {
+            alarm = MIN(alarm, it->alarm + it->slack);
+        }
+    }
+    return alarm;
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_queue_add(esp_timer_handle_t timer)
+{
+    esp_timer_handle_t it, last = NULL;
+    esp_timer_dispatch_t dispatch_method = timer->flags & FL_ISR_DISPATCH_METHOD;
+    if (LIST_FIRST(&s_timers[dispatch_method]) == NULL) {
+        LIST_INSERT_HEAD(&s_timers[dispatch_method], timer, list_entry);
+    } else {
+        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
+            if (timer->alarm < it->alarm) {
+                LIST_INSERT_BEFORE(it, timer, list_entry);
+                break;
+            }
+            last = it;
+        }
+        if (it == NULL) {
+            assert(last);
+            LIST_INSERT_AFTER(last, timer, list_entry);
+        }
+    }
+}
+
+static ESP_TIMER_IRAM_ATTR void timer_queue_remove(esp_timer_handle_t timer)
+{
+    LIST_REMOVE(timer, list_entry);
+}
+
+#endif // CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+
 static ESP_TIMER_IRAM_ATTR bool timer_armed(esp_timer_handle_t timer)
 {
     return timer->alarm > 0;
@@ -481,16 +723,21 @@ ESP_TIMER_IRAM_ATTR
 static void timer_process_alarm(esp_timer_dispatch_t dispatch_method)
 {
     timer_list_lock(dispatch_method);
+    /* Timers due by the alarm which woke us up count as one wakeup. Without slack,
+     * each different alarm among them would have been a separate wakeup. */
+    const uint64_t coalesced_alarm = s_next_alarm[dispatch_method];
+    uint64_t last_alarm = 0;
+    uint32_t alarms = 0;
     esp_timer_handle_t it;
     while (1) {
-        it = LIST_FIRST(&s_timers[dispatch_method]);
+        it = timer_queue_first(dispatch_method);
         int64_t now = esp_timer_impl_get_time();
         ESP_COMPILER_DIAGNOSTIC_PUSH_IGNORE("-Wanalyzer-use-after-free") // False-positive detection. TODO GCC-366
         if (it == NULL || it->alarm > now) {
             break;
         }
         ESP_COMPILER_DIAGNOSTIC_POP("-Wanalyzer-use-after-free")
-        LIST_REMOVE(it, list_entry);
+        timer_queue_remove(it);
         if (it->event_id == EVENT_ID_DELETE_TIMER) {
             // It is handled only by ESP_TIMER_TASK (see esp_timer_delete()).
             // All the ESP_TIMER_ISR timers which should be deleted are moved by esp_timer_delete() to the ESP_TIMER_TASK list.
@@ -498,6 +745,10 @@ static void timer_process_alarm(esp_timer_dispatch_t dispatch_method)
             free(it);
             it = NULL;
         } else {
+            if (it->alarm <= coalesced_alarm && it->alarm != last_alarm) {
+                last_alarm = it->alarm;
+                ++alarms;
+            }
             it->flags |= FL_CALLBACK_IS_RUNNING;
             if (it->period > 0) {
                 int skipped = (now - it->alarm) / it->period;
@@ -509,7 +760,8 @@ static void timer_process_alarm(esp_timer_dispatch_t dispatch_method)
                 } else {
                     it->alarm += it->period;
                 }
-                timer_insert(it, true);
+                // the alarm is set once all the due timers are processed
+                timer_queue_add(it);
             } else {
                 it->alarm = 0;
 #if WITH_PROFILING
@@ -531,8 +783,11 @@ static void timer_process_alarm(esp_timer_dispatch_t dispatch_method)
 #endif
         }
     } // while(1)
-    uint64_t next_alarm = (it != NULL) ? it->alarm : UINT64_MAX;
-    esp_timer_impl_set_alarm_id(next_alarm, dispatch_method);
+    if (alarms > 0) {
+        s_coalescing_stats[dispatch_method].alarms++;
+        s_coalescing_stats[dispatch_method].wakeups_saved += alarms - 1;
+    }
+    timer_set_alarm(dispatch_method, timer_queue_coalesced_alarm(dispatch_method, false));
     timer_list_unlock(dispatch_method);
 }
 
@@ -677,7 +932,7 @@ esp_err_t esp_timer_deinit(void)
 
     /* Check if there are any active timers */
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
-        if (!LIST_EMPTY(&s_timers[dispatch_method])) {
+        if (timer_queue_first(dispatch_method) != NULL) {
             return ESP_ERR_INVALID_STATE;
         }
     }
@@ -727,14 +982,15 @@ static void append_to_buffer(char** dst, size_t* dst_size, const char* format, .
     *dst_size -= cb;
 }
 
-static void print_timer_info(esp_timer_handle_t t, char** dst, size_t* dst_size)
+// t may be a copy of the timer, handle is the timer itself
+static void print_timer_info(const struct esp_timer* t, esp_timer_handle_t handle, char** dst, size_t* dst_size)
 {
 #if WITH_PROFILING
     // name is optional, might be missed.
     if (t->name) {
         append_to_buffer(dst, dst_size, "%-20.20s  ", t->name);
     } else {
-        append_to_buffer(dst, dst_size, "timer@%-10p  ", t);
+        append_to_buffer(dst, dst_size, "timer@%-10p  ", handle);
     }
 
     append_to_buffer(dst, dst_size, "%-10" PRIu64"  %-12" PRIu64"  %-12zu  %-12zu  %-12zu  %-12" PRIu64"\n",
@@ -743,7 +999,7 @@ static void print_timer_info(esp_timer_handle_t t, char** dst, size_t* dst_size)
     /* keep this in sync with the format string, used in esp_timer_dump */
 #define TIMER_INFO_LINE_LEN 103
 #else
-    append_to_buffer(dst, dst_size, "timer@%-14p  %-10" PRIu64"  %-12" PRIu64"\n", t, (uint64_t)t->period, t->alarm);
+    append_to_buffer(dst, dst_size, "timer@%-14p  %-10" PRIu64"  %-12" PRIu64"\n", handle, (uint64_t)t->period, t->alarm);
 #define TIMER_INFO_LINE_LEN 47
 #endif
 }
@@ -762,7 +1018,7 @@ esp_err_t esp_timer_dump(FILE* stream)
     size_t timer_count = 0;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
+        for (it = timer_queue_first(dispatch_method); it != NULL; it = timer_queue_next(it)) {
             ++timer_count;
         }
 #if WITH_PROFILING
@@ -784,20 +1040,57 @@ esp_err_t esp_timer_dump(FILE* stream)
     if (print_buf == NULL) {
         return ESP_ERR_NO_MEM;
     }
+#if CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+    /* The heap is not ordered by alarm. The timers are copied with the timer list
+     * locked, then the armed ones are sorted to be printed in the same order as
+     * with the sorted list, once the timer list is unlocked.
+     */
+    const size_t snapshot_size = timer_count + 3;
+    timer_snapshot_t* snapshot = calloc(snapshot_size, sizeof(*snapshot));
+    if (snapshot == NULL) {
+        free(print_buf);
+        return ESP_ERR_NO_MEM;
+    }
+#endif
 
     /* Print to the buffer */
     char* pos = print_buf;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
+#if CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+        size_t snapshot_count = 0;
         timer_list_lock(dispatch_method);
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            print_timer_info(it, &pos, &buf_size);
+        for (it = timer_queue_first(dispatch_method); it != NULL && snapshot_count < snapshot_size; it = timer_queue_next(it)) {
+            snapshot[snapshot_count].timer = *it;
+            snapshot[snapshot_count++].handle = it;
+        }
+        const size_t armed_count = snapshot_count;
+#if WITH_PROFILING
+        LIST_FOREACH(it, &s_inactive_timers[dispatch_method], list_entry) {
+            if (snapshot_count == snapshot_size) {
+                break;
+            }
+            snapshot[snapshot_count].timer = *it;
+            snapshot[snapshot_count++].handle = it;
+        }
+#endif
+        timer_list_unlock(dispatch_method);
+
+        qsort(snapshot, armed_count, sizeof(*snapshot), timer_compare_alarms);
+        for (size_t i = 0; i < snapshot_count; ++i) {
+            print_timer_info(&snapshot[i].timer, snapshot[i].handle, &pos, &buf_size);
+        }
+#else
+        timer_list_lock(dispatch_method);
+        for (it = timer_queue_first(dispatch_method); it != NULL; it = timer_queue_next(it)) {
+            print_timer_info(it, it, &pos, &buf_size);
         }
 #if WITH_PROFILING
         LIST_FOREACH(it, &s_inactive_timers[dispatch_method], list_entry) {
-            print_timer_info(it, &pos, &buf_size);
+            print_timer_info(it, it, &pos, &buf_size);
         }
 #endif
         timer_list_unlock(dispatch_method);
+#endif
     }
 
     if (stream != NULL) {
@@ -813,6 +1106,9 @@ esp_err_t esp_timer_dump(FILE* stream)
         fputs(print_buf, stream);
     }
 
+#if CONFIG_ESP_TIMER_QUEUE_PAIRING_HEAP
+    free(snapshot);
+#endif
     free(print_buf);
     return ESP_OK;
 }
@@ -822,11 +1118,9 @@ int64_t ESP_TIMER_IRAM_ATTR esp_timer_get_next_alarm(void)
     int64_t next_alarm = INT64_MAX;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        esp_timer_handle_t it = LIST_FIRST(&s_timers[dispatch_method]);
-        if (it) {
-            if (next_alarm > it->alarm) {
-                next_alarm = it->alarm;
-            }
+        uint64_t alarm = timer_queue_coalesced_alarm(dispatch_method, false);
+        if (next_alarm > alarm) {
+            next_alarm = alarm;
         }
         timer_list_unlock(dispatch_method);
     }
@@ -838,21 +1132,31 @@ int64_t ESP_TIMER_IRAM_ATTR esp_timer_get_next_alarm_for_wake_up(void)
     int64_t next_alarm = INT64_MAX;
     for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
         timer_list_lock(dispatch_method);
-        esp_timer_handle_t it = NULL;
-        LIST_FOREACH(it, &s_timers[dispatch_method], list_entry) {
-            // timers with the SKIP_UNHANDLED_EVENTS flag do not want to wake up CPU from a sleep mode.
-            if ((it->flags & FL_SKIP_UNHANDLED_EVENTS) == 0) {
-                if (next_alarm > it->alarm) {
-                    next_alarm = it->alarm;
-                }
-                break;
-            }
+        // timers with the SKIP_UNHANDLED_EVENTS flag do not want to wake up CPU from a sleep mode.
+        uint64_t alarm = timer_queue_coalesced_alarm(dispatch_method, true);
+        if (next_alarm > alarm) {
+            next_alarm = alarm;
         }
         timer_list_unlock(dispatch_method);
     }
     return next_alarm;
 }
 
+esp_err_t esp_timer_get_coalescing_stats(esp_timer_coalescing_stats_t* stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = (esp_timer_coalescing_stats_t) { 0 };
+    for (esp_timer_dispatch_t dispatch_method = ESP_TIMER_TASK; dispatch_method < ESP_TIMER_MAX; ++dispatch_method) {
+        timer_list_lock(dispatch_method);
+        stats->alarms += s_coalescing_stats[dispatch_method].alarms;
+        stats->wakeups_saved += s_coalescing_stats[dispatch_method].wakeups_saved;
+        timer_list_unlock(dispatch_method);
+    }
+    return ESP_OK;
+}
+
 esp_err_t ESP_TIMER_IRAM_ATTR esp_timer_get_period(esp_timer_handle_t timer, uint64_t *period)
 {
     if (timer == NULL || period == NULL) {
@@ -11,6 +11,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/param.h>
+#include <stdatomic.h>
 #include "esp_timer.h"
 #include "esp_timer_impl.h"
 #include "unity.h"
@@ -585,6 +586,238 @@ TEST_CASE("Can dump esp_timer stats", "[esp_timer]")
     }
 }
 
+typedef struct {
+    SemaphoreHandle_t done;
+    int expected;
+    int count;
+    int64_t first_fire;
+    int64_t last_fire;
+} test_queue_cost_state_t;
+
+static void test_queue_cost_cb(void* arg)
+{
+    test_queue_cost_state_t* state = (test_queue_cost_state_t*) arg;
+    int64_t now = esp_timer_get_time();
+    if (state->count == 0) {
+        state->first_fire = now;
+    }
+    state->last_fire = now;
+    if (++state->count == state->expected) {
+        xSemaphoreGive(state->done);
+    }
+}
+
+TEST_CASE("esp_timer arm, cancel and fire cost vs number of timers", "[esp_timer]")
+{
+    /* Measures the time taken to arm and to cancel a timer while the others are armed,
+     * and to dispatch a periodic timer, which is re-armed before its callback runs,
+     * so that CONFIG_ESP_TIMER_QUEUE backends can be compared.
+     */
+#if CONFIG_IDF_TARGET_LINUX
+    const int timer_counts[] = { 16, 64, 256, 1024, 4096 };
+#else
+    const int timer_counts[] = { 16, 64, 256 };
+#endif
+    test_queue_cost_state_t state = {
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(state.done);
+    uint32_t seed = 1;
+
+    for (size_t c = 0; c < sizeof(timer_counts) / sizeof(timer_counts[0]); ++c) {
+        const int n = timer_counts[c];
+        esp_timer_handle_t* timers = calloc(n, sizeof(*timers));
+        TEST_ASSERT_NOT_NULL(timers);
+        const esp_timer_create_args_t args = {
+            .callback = &test_queue_cost_cb,
+            .arg = &state,
+            .name = "queue_cost",
+        };
+        for (int i = 0; i < n; ++i) {
+            TEST_ESP_OK(esp_timer_create(&args, &timers[i]));
+        }
+
+        /* Timeouts are spread over 1-2 s in a pseudo-random order, so that none fires */
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < n; ++i) {
+            seed = seed * 1103515245 + 12345;
+            TEST_ESP_OK(esp_timer_start_once(timers[i], 1000000 + (seed >> 12) % 1000000));
+        }
+        const int64_t arm_time = esp_timer_get_time() - start;
+
+        start = esp_timer_get_time();
+        for (int i = 0; i < n; ++i) {
+            TEST_ESP_OK(esp_timer_stop(timers[(i * 7919) % n]));
+        }
+        const int64_t cancel_time = esp_timer_get_time() - start;
+
+        /* All the timers fire at the same alarm and are dispatched in one go */
+        state.expected = n;
+        state.count = 0;
+        const uint64_t first_alarm = esp_timer_get_time() + 100000;
+        for (int i = 0; i < n; ++i) {
+            TEST_ESP_OK(esp_timer_start_periodic_at(timers[i], 10 * SEC + i, first_alarm));
+        }
+        TEST_ASSERT_TRUE(xSemaphoreTake(state.done, pdMS_TO_TICKS(5000)));
+        const int64_t fire_time = state.last_fire - state.first_fire;
+
+        for (int i = 0; i < n; ++i) {
+            TEST_ESP_OK(esp_timer_stop(timers[i]));
+            TEST_ESP_OK(esp_timer_delete(timers[i]));
+        }
+        free(timers);
+        printf("%5d timers: arm %5" PRId64 " ns, cancel %5" PRId64 " ns, fire %5" PRId64 " ns per timer\n",
+               n, arm_time * 1000 / n, cancel_time * 1000 / n, fire_time * 1000 / (n - 1));
+    }
+    vTaskDelay(3); // wait for the esp_timer task to delete all timers
+    vSemaphoreDelete(state.done);
+}
+
+#if CONFIG_IDF_TARGET_LINUX && !defined(__APPLE__)
+/* esp_timer_impl_set_alarm_id is wrapped on the linux target, see CMakeLists.txt */
+#define TEST_COUNT_SET_ALARM 1
+
+static atomic_uint s_set_alarm_count;
+
+void __real_esp_timer_impl_set_alarm_id(uint64_t timestamp, unsigned alarm_id);
+
+void __wrap_esp_timer_impl_set_alarm_id(uint64_t timestamp, unsigned alarm_id)
+{
+    atomic_fetch_add(&s_set_alarm_count, 1);
+    __real_esp_timer_impl_set_alarm_id(timestamp, alarm_id);
+}
+#endif // CONFIG_IDF_TARGET_LINUX && !defined(__APPLE__)
+
+#define SLACK_TEST_TIMERS 8
+
+typedef struct {
+    SemaphoreHandle_t done;
+    atomic_int count;
+    int64_t fire_time[SLACK_TEST_TIMERS];
+} test_slack_state_t;
+
+static test_slack_state_t s_slack_state;
+
+static void test_slack_cb(void* arg)
+{
+    int index = (int)(intptr_t) arg;
+    s_slack_state.fire_time[index] = esp_timer_get_time();
+    if (atomic_fetch_add(&s_slack_state.count, 1) + 1 == SLACK_TEST_TIMERS) {
+        xSemaphoreGive(s_slack_state.done);
+    }
+}
+
+/* Arms timers 2 ms apart with the given slack, waits for all of them to fire,
+ * and returns the number of alarms set while they were dispatched (linux only).
+ */
+static unsigned test_slack_dispatch(uint32_t slack_us, esp_timer_coalescing_stats_t* stats)
+{
+    esp_timer_handle_t timers[SLACK_TEST_TIMERS];
+    uint64_t alarms[SLACK_TEST_TIMERS];
+    esp_timer_coalescing_stats_t before;
+    unsigned set_alarm_count = 0;
+
+    s_slack_state.done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(s_slack_state.done);
+    atomic_store(&s_slack_state.count, 0);
+    TEST_ESP_OK(esp_timer_get_coalescing_stats(&before));
+
+    for (int i = 0; i < SLACK_TEST_TIMERS; ++i) {
+        const esp_timer_create_args_t args = {
+            .callback = &test_slack_cb,
+            .arg = (void*)(intptr_t) i,
+            .name = "slack",
+            .slack_us = slack_us,
+        };
+        TEST_ESP_OK(esp_timer_create(&args, &timers[i]));
+        TEST_ESP_OK(esp_timer_start_once(timers[i], 20000 + 2000 * i));
+        TEST_ESP_OK(esp_timer_get_expiry_time(timers[i], &alarms[i]));
+    }
+#if CONFIG_IDF_TARGET_LINUX
+    /* No other timer is armed on linux: the alarm is set within the slack of the first timer,
+     * which all the other timers are due by */
+    TEST_ASSERT_EQUAL_INT64(alarms[0] + slack_us, esp_timer_get_next_alarm());
+    TEST_ASSERT_EQUAL_UINT64(alarms[0] + slack_us, esp_timer_impl_get_alarm_reg());
+#endif
+#if TEST_COUNT_SET_ALARM
+    atomic_store(&s_set_alarm_count, 0);
+#endif
+
+    TEST_ASSERT_TRUE(xSemaphoreTake(s_slack_state.done, pdMS_TO_TICKS(1000)));
+#if TEST_COUNT_SET_ALARM
+    set_alarm_count = atomic_load(&s_set_alarm_count);
+#endif
+    TEST_ESP_OK(esp_timer_get_coalescing_stats(stats));
+    stats->alarms -= before.alarms;
+    stats->wakeups_saved -= before.wakeups_saved;
+
+    for (int i = 0; i < SLACK_TEST_TIMERS; ++i) {
+        TEST_ASSERT_GREATER_OR_EQUAL_INT64(alarms[i], s_slack_state.fire_time[i]);
+        TEST_ESP_OK(esp_timer_delete(timers[i]));
+    }
+    vSemaphoreDelete(s_slack_state.done);
+    vTaskDelay(3); // wait for the esp_timer task to delete all timers
+    return set_alarm_count;
+}
+
+TEST_CASE("esp_timer dispatches timers with overlapping slack after one alarm", "[esp_timer]")
+{
+    esp_timer_coalescing_stats_t stats;
+
+    /* Without slack, each timer fires at its own alarm */
+    unsigned set_alarm_count = test_slack_dispatch(0, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.wakeups_saved);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SLACK_TEST_TIMERS, stats.alarms);
+#if TEST_COUNT_SET_ALARM
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SLACK_TEST_TIMERS, set_alarm_count);
+#endif
+
+    /* With 50 ms slack, all the windows overlap and the timers fire together */
+    set_alarm_count = test_slack_dispatch(50000, &stats);
+    TEST_ASSERT_EQUAL_UINT32(SLACK_TEST_TIMERS - 1, stats.wakeups_saved);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1, stats.alarms);
+#if TEST_COUNT_SET_ALARM
+    TEST_ASSERT_EQUAL_UINT32(1, set_alarm_count);
+#endif
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+TEST_CASE("esp_timer moves the alarm later when the timer which set it is stopped", "[esp_timer]")
+{
+    esp_timer_handle_t first_timer;
+    esp_timer_handle_t exact_timer;
+    uint64_t first_alarm;
+    uint64_t exact_alarm;
+    const esp_timer_create_args_t first_args = {
+        .callback = &test_slack_cb,
+        .name = "first",
+        .slack_us = 20000,
+    };
+    const esp_timer_create_args_t exact_args = {
+        .callback = &test_slack_cb,
+        .name = "exact",
+    };
+    TEST_ESP_OK(esp_timer_create(&first_args, &first_timer));
+    TEST_ESP_OK(esp_timer_create(&exact_args, &exact_timer));
+
+    /* The first timer to expire has slack, the alarm is set by the deadline of the other one */
+    TEST_ESP_OK(esp_timer_start_once(first_timer, 10000));
+    TEST_ESP_OK(esp_timer_start_once(exact_timer, 20000));
+    TEST_ESP_OK(esp_timer_get_expiry_time(first_timer, &first_alarm));
+    TEST_ESP_OK(esp_timer_get_expiry_time(exact_timer, &exact_alarm));
+    TEST_ASSERT_EQUAL_INT64(exact_alarm, esp_timer_get_next_alarm());
+
+    /* Stopping it must not leave the alarm at its deadline */
+    TEST_ESP_OK(esp_timer_stop(exact_timer));
+    TEST_ASSERT_EQUAL_INT64(first_alarm + 20000, esp_timer_get_next_alarm());
+    TEST_ASSERT_EQUAL_UINT64(first_alarm + 20000, esp_timer_impl_get_alarm_reg());
+
+    TEST_ESP_OK(esp_timer_stop(first_timer));
+    TEST_ESP_OK(esp_timer_delete(first_timer));
+    TEST_ESP_OK(esp_timer_delete(exact_timer));
+}
+#endif // CONFIG_IDF_TARGET_LINUX
+
 typedef struct {
     SemaphoreHandle_t notify_from_timer_cb;
     esp_timer_handle_t timer;
@@ -15,6 +15,8 @@ from pytest_embedded_idf.utils import idf_parametrize
         ('freertos_compliance', 'esp32'),
         ('isr_dispatch_esp32', 'esp32'),
         ('isr_dispatch_esp32c3', 'esp32c3'),
+        ('pairing_heap', 'esp32'),
+        ('pairing_heap', 'esp32c3'),
         ('cpu1_esp32', 'esp32'),
         ('any_cpu_esp32', 'esp32'),
         ('cpu1_esp32s3', 'esp32s3'),
@@ -27,7 +29,7 @@ def test_esp_timer(dut: Dut) -> None:
 
 
 @pytest.mark.host_test
-@pytest.mark.parametrize('config', ['default'], indirect=True)
+@pytest.mark.parametrize('config', ['default', 'pairing_heap'], indirect=True)
 @idf_parametrize('target', ['linux'], indirect=['target'])
 def test_esp_timer_linux(dut: Dut) -> None:
     dut.run_all_single_board_cases(timeout=180)
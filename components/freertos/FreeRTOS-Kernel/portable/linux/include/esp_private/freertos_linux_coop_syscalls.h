@@ -22,6 +22,9 @@
 #include <sys/socket.h>
 #include <poll.h>
 #include <signal.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -302,6 +305,38 @@ int freertos_linux_coop_pselect(int nfds, fd_set *readfds, fd_set *writefds,
  */
 int freertos_linux_coop_poll(struct pollfd *fds, nfds_t nfds, int timeout);
 
+#ifdef __linux__
+/**
+ * @brief Create an epoll instance using the real libc epoll_create1.
+ *
+ * @param flags epoll_create1 flags (EPOLL_CLOEXEC).
+ * @return epoll file descriptor on success, or -1 on error (errno is set).
+ */
+int freertos_linux_coop_epoll_create1(int flags);
+
+/**
+ * @brief Control an epoll instance using the real libc epoll_ctl.
+ *
+ * @param epfd  epoll file descriptor.
+ * @param op    Operation (EPOLL_CTL_ADD, EPOLL_CTL_MOD, EPOLL_CTL_DEL).
+ * @param fd    Target file descriptor.
+ * @param event Event description (may be NULL for EPOLL_CTL_DEL).
+ * @return 0 on success, or -1 on error (errno is set).
+ */
+int freertos_linux_coop_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+
+/**
+ * @brief Cooperative epoll_wait — polls with cooperative yield.
+ *
+ * @param epfd      epoll file descriptor.
+ * @param events    Output array for ready events.
+ * @param maxevents Capacity of the events array.
+ * @param timeout   Timeout in milliseconds (-1 for infinite, 0 for non-blocking).
+ * @return Number of ready descriptors, 0 on timeout, or -1 on error (errno is set).
+ */
+int freertos_linux_coop_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+#endif
+
 /**
  * @brief Set stdin/stdout/stderr to non-blocking and start tracking them.
  *
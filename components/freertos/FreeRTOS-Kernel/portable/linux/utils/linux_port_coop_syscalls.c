@@ -29,6 +29,9 @@
 #include <sys/time.h>
 #include <time.h>
 #include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 #include <dlfcn.h>
 #include <pthread.h>
 
@@ -64,6 +67,11 @@ static ssize_t  (*real_pwrite)(int, const void *, size_t, off_t);
 static int      (*real_close)(int);
 static int      (*real_select)(int, fd_set *, fd_set *, fd_set *,
                                 struct timeval *);
+#ifdef __linux__
+static int      (*real_epoll_create1)(int);
+static int      (*real_epoll_ctl)(int, int, int, struct epoll_event *);
+static int      (*real_epoll_wait)(int, struct epoll_event *, int, int);
+#endif
 
 typedef int (*linux_coop_fcntl_fn_t)(int, int, ...);
 static linux_coop_fcntl_fn_t real_fcntl;
@@ -121,6 +129,11 @@ static void __attribute__((constructor)) linux_coop_resolve_all(void)
     LINUX_COOP_RESOLVE(close);
     LINUX_COOP_RESOLVE(select);
     LINUX_COOP_RESOLVE(open);
+#ifdef __linux__
+    LINUX_COOP_RESOLVE(epoll_create1);
+    LINUX_COOP_RESOLVE(epoll_ctl);
+    LINUX_COOP_RESOLVE(epoll_wait);
+#endif
 }
 
 void linux_coop_set_nonblocking(int fd)
@@ -638,6 +651,44 @@ int freertos_linux_coop_poll(struct pollfd *fds, nfds_t nfds, int timeout)
     }
 }
 
+#ifdef __linux__
+int freertos_linux_coop_epoll_create1(int flags)
+{
+    return real_epoll_create1(flags);
+}
+
+int freertos_linux_coop_epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    return real_epoll_ctl(epfd, op, fd, event);
+}
+
+int freertos_linux_coop_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    if (timeout == 0) {
+        return real_epoll_wait(epfd, events, maxevents, 0);
+    }
+
+    long waited_ms = 0;
+    while (1)
+    {
+        int ret = real_epoll_wait(epfd, events, maxevents, 0);
+        if (ret > 0) {
+            return ret;
+        } else if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (timeout > 0 && waited_ms >= timeout) {
+            return 0;
+        }
+        linux_coop_yield(LINUX_COOP_TICK_MS);
+        waited_ms += LINUX_COOP_TICK_MS;
+    }
+}
+#endif
+
 int nanosleep(const struct timespec *req, struct timespec *rem)
 {
     if (req == NULL) {
@@ -764,6 +815,13 @@ __attribute__((weak)) int poll(struct pollfd *fds, nfds_t nfds, int timeout)
     return freertos_linux_coop_poll(fds, nfds, timeout);
 }
 
+#ifdef __linux__
+__attribute__((weak)) int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    return freertos_linux_coop_epoll_wait(epfd, events, maxevents, timeout);
+}
+#endif
+
 __attribute__((weak)) int socket(int domain, int type, int protocol)
 {
     return freertos_linux_coop_socket(domain, type, protocol);
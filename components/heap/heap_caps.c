@@ -295,6 +295,7 @@ size_t heap_caps_get_total_size(uint32_t caps)
 size_t heap_caps_get_free_size( uint32_t caps )
 {
     size_t ret = 0;
+    heap_caps_cache_flush();
     heap_t *heap;
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap_caps_match(heap, caps)) {
@@ -389,6 +390,7 @@ esp_err_t heap_caps_monitor_local_minimum_free_size_stop(void)
 void heap_caps_get_info( multi_heap_info_t *info, uint32_t caps )
 {
     memset(info, 0, sizeof(multi_heap_info_t));
+    heap_caps_cache_flush();
 
     heap_t *heap;
     SLIST_FOREACH(heap, &registered_heaps, next) {
@@ -414,6 +416,7 @@ void heap_caps_print_heap_info( uint32_t caps )
 {
     multi_heap_info_t info;
     printf("Heap summary for capabilities 0x%08"PRIX32":\n", caps);
+    heap_caps_cache_flush();
     heap_t *heap;
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap_caps_match(heap, caps)) {
@@ -426,6 +429,7 @@ void heap_caps_print_heap_info( uint32_t caps )
                    info.free_blocks, info.total_blocks);
         }
     }
+    heap_caps_pools_print_info(caps);
     printf("  Totals:\n");
     heap_caps_get_info(&info, caps);
 
@@ -437,6 +441,9 @@ bool heap_caps_check_integrity(uint32_t caps, bool print_errors)
     bool all_heaps = caps & MALLOC_CAP_INVALID;
     bool valid = true;
 
+    valid = heap_caps_cache_check(print_errors) && valid;
+    valid = heap_caps_pools_check(caps, print_errors) && valid;
+
     heap_t *heap;
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap->heap != NULL
@@ -465,6 +472,7 @@ bool heap_caps_check_integrity_addr(intptr_t addr, bool print_errors)
 void heap_caps_dump(uint32_t caps)
 {
     bool all_heaps = caps & MALLOC_CAP_INVALID;
+    heap_caps_cache_flush();
     heap_t *heap;
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap->heap != NULL
@@ -621,6 +629,10 @@ __attribute__((noinline)) static bool heap_caps_walker(void *block_ptr, size_t b
         (bool)block_used
     };
 
+    bool walk_on;
+    if (block_used && heap_caps_pools_walk_block(heap_info, block_info, walker_data->cb_func, walker_data->opaque_ptr, &walk_on)) {
+        return walk_on;
+    }
     return walker_data->cb_func(heap_info, block_info, walker_data->opaque_ptr);
 }
 
@@ -629,6 +641,7 @@ void heap_caps_walk(uint32_t caps, heap_caps_walker_cb_t walker_func, void *user
     assert(walker_func != NULL);
 
     bool all_heaps = caps & MALLOC_CAP_INVALID;
+    heap_caps_cache_flush();
     heap_t *heap;
     SLIST_FOREACH(heap, &registered_heaps, next) {
         if (heap->heap != NULL
@@ -116,7 +116,14 @@ HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
     assert(heap != NULL && "free() target pointer is outside heap areas");
 
 #if CONFIG_HEAP_TASK_TRACKING
-    heap_caps_update_per_task_info_free(heap, raw_ptr);
+    heap_caps_update_per_task_info_free(heap, block_owner_ptr);
+#endif
+
+#if CONFIG_HEAP_CORE_CACHE
+    if (heap_caps_cache_free(heap, block_owner_ptr)) {
+        CALL_HOOK(esp_heap_trace_free_hook, ptr);
+        return;
+    }
 #endif
 
 #if CONFIG_COMPILER_KASAN && CONFIG_HEAP_USE_HOOKS
@@ -184,6 +191,18 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
 
     const size_t alloc_size = KASAN_ADD_RZ(size);
 
+#if CONFIG_HEAP_CORE_CACHE
+    if (alignment <= UNALIGNED_MEM_ALIGNMENT_BYTES && !exec_in_caps) {
+        ret = heap_caps_cache_malloc(size, caps);
+        if (ret != NULL) {
+            CALL_HOOK(esp_heap_trace_alloc_hook, ret, size, caps);
+            return ret;
+        }
+    }
+    bool cache_flushed = false;
+retry:
+#endif
+
     for (int prio = 0; prio < SOC_MEMORY_TYPE_NO_PRIOS; prio++) {
         //Iterate over heaps and check capabilities at this priority
         heap_t *heap;
@@ -208,13 +227,11 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                                                         alignment, MULTI_HEAP_BLOCK_OWNER_SIZE());  // int overflow checked above
                         if (ret != NULL) {
 #if CONFIG_HEAP_TASK_TRACKING
-                            heap_caps_update_per_task_info_alloc(heap,
-                                                                 MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ret),
+                            heap_caps_update_per_task_info_alloc(heap, ret,
                                                                  multi_heap_get_full_block_size(heap->heap, ret),
                                                                  get_all_caps(heap));
 #endif
 
-                            MULTI_HEAP_SET_BLOCK_OWNER(ret);
                             ret = MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ret);
                             ret = KASAN_PTR_TO_USER(ret);
                             uint32_t *iptr = dram_alloc_to_iram_addr(ret, size + 4);  // int overflow checked above
@@ -227,13 +244,11 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                                                         alignment, MULTI_HEAP_BLOCK_OWNER_SIZE());
                         if (ret != NULL) {
 #if CONFIG_HEAP_TASK_TRACKING
-                            heap_caps_update_per_task_info_alloc(heap,
-                                                                 MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ret),
+                            heap_caps_update_per_task_info_alloc(heap, ret,
                                                                  multi_heap_get_full_block_size(heap->heap, ret),
                                                                  get_all_caps(heap));
 #endif
 
-                            MULTI_HEAP_SET_BLOCK_OWNER(ret);
                             ret = MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ret);
                             ret = KASAN_PTR_TO_USER(ret);
                             CALL_HOOK(esp_heap_trace_alloc_hook, ret, size, caps);
@@ -245,6 +260,14 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
         }
     }
 
+#if CONFIG_HEAP_CORE_CACHE
+    //The cached blocks may be what is missing to satisfy this allocation.
+    if (!cache_flushed && heap_caps_cache_flush()) {
+        cache_flushed = true;
+        goto retry;
+    }
+#endif
+
     //Nothing usable found.
     return NULL;
 }
@@ -333,18 +356,13 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_realloc_base( void *ptr, size_t siz
 
 #if CONFIG_HEAP_TASK_TRACKING
         size_t old_size = multi_heap_get_full_block_size(heap->heap, raw_ptr);
-        TaskHandle_t old_task = MULTI_HEAP_GET_BLOCK_OWNER(raw_ptr);
+        void *old_owner = MULTI_HEAP_GET_BLOCK_OWNER(raw_ptr);
 #endif
 
         void *r = multi_heap_realloc(heap->heap, raw_ptr, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(alloc_size));
         if (r != NULL) {
-            MULTI_HEAP_SET_BLOCK_OWNER(r);
-
 #if CONFIG_HEAP_TASK_TRACKING
-            heap_caps_update_per_task_info_realloc(heap,
-                                                   MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(raw_ptr),
-                                                   MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(r),
-                                                   old_size, old_task,
+            heap_caps_update_per_task_info_realloc(heap, old_owner, old_size, r,
                                                    multi_heap_get_full_block_size(heap->heap, r),
                                                    get_all_caps(heap));
 #endif
@@ -0,0 +1,198 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "multi_heap.h"
+#include "multi_heap_platform.h"
+#include "heap_private.h"
+#include "heap_caps_cache.h"
+
+/*
+ * Per-core cache of free small blocks, see CONFIG_HEAP_CORE_CACHE.
+ *
+ * Each core has its own cache, locked with its own spinlock: the lock of a cache is
+ * only contended when a core flushes the cache of the other one, so the small
+ * allocations and frees of the cores don't wait for each other. The heap locks are
+ * only taken to refill or drain the caches, once per batch of blocks.
+ *
+ * Only the blocks of the internal heaps are cached, they satisfy any allocation
+ * whose capabilities are within HEAP_CACHE_CAPS.
+ */
+
+#if CONFIG_HEAP_TASK_TRACKING
+#error "The heap core cache doesn't keep the block owner of the cached blocks"
+#endif
+
+#define HEAP_CACHE_CAPS (MALLOC_CAP_8BIT | MALLOC_CAP_32BIT | MALLOC_CAP_INTERNAL | MALLOC_CAP_DEFAULT)
+
+typedef struct {
+    heap_cache_t cache;
+    multi_heap_lock_t lock;
+} core_cache_t;
+
+static DRAM_ATTR core_cache_t s_core_cache[portNUM_PROCESSORS] = {
+    [0 ... portNUM_PROCESSORS - 1] = { .lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER },
+};
+
+HEAP_IRAM_ATTR static inline bool heap_is_cached(const heap_t *heap)
+{
+    return heap->heap != NULL && (get_all_caps(heap) & HEAP_CACHE_CAPS) == HEAP_CACHE_CAPS;
+}
+
+/* Allocate up to 'count' blocks of 'size' bytes, from the cached heaps in the
+   usual order of the heaps. The heap lock is held for the whole batch, the
+   locks taken again by multi_heap_malloc() are then not contended. */
+HEAP_IRAM_ATTR static size_t alloc_blocks(void **blocks, size_t count, size_t size)
+{
+    size_t allocated = 0;
+    for (int prio = 0; prio < SOC_MEMORY_TYPE_NO_PRIOS; prio++) {
+        heap_t *heap;
+        SLIST_FOREACH(heap, &registered_heaps, next) {
+            if ((heap->caps[prio] & HEAP_CACHE_CAPS) == 0 || !heap_is_cached(heap)) {
+                continue;
+            }
+            MULTI_HEAP_LOCK(&heap->heap_mux);
+            while (allocated < count) {
+                void *block = multi_heap_malloc(heap->heap, size);
+                if (block == NULL) {
+                    break;
+                }
+                blocks[allocated++] = block;
+            }
+            MULTI_HEAP_UNLOCK(&heap->heap_mux);
+            if (allocated == count) {
+                return allocated;
+            }
+        }
+    }
+    return allocated;
+}
+
+/* Give blocks back to their heaps, taking the lock of a heap once for
+   consecutive blocks of this heap */
+HEAP_IRAM_ATTR static void free_blocks(void **blocks, size_t count)
+{
+    heap_t *locked_heap = NULL;
+    for (size_t i = 0; i < count; i++) {
+        heap_t *heap = find_containing_heap(blocks[i]);
+        assert(heap != NULL && "cached block is outside heap areas");
+        if (heap != locked_heap) {
+            if (locked_heap != NULL) {
+                MULTI_HEAP_UNLOCK(&locked_heap->heap_mux);
+            }
+            MULTI_HEAP_LOCK(&heap->heap_mux);
+            locked_heap = heap;
+        }
+        multi_heap_free(heap->heap, blocks[i]);
+    }
+    if (locked_heap != NULL) {
+        MULTI_HEAP_UNLOCK(&locked_heap->heap_mux);
+    }
+}
+
+HEAP_IRAM_ATTR void *heap_caps_cache_malloc(size_t size, uint32_t caps)
+{
+    const size_t cls = heap_cache_alloc_class(size);
+    if (cls == HEAP_CACHE_CLASSES || (caps & ~HEAP_CACHE_CAPS) != 0) {
+        return NULL;
+    }
+
+    core_cache_t *core = &s_core_cache[xPortGetCoreID()];
+    MULTI_HEAP_LOCK(&core->lock);
+    void *block = heap_cache_pop(&core->cache, cls);
+    MULTI_HEAP_UNLOCK(&core->lock);
+    if (block != NULL) {
+        return block;
+    }
+
+    // The class is empty, refill it with a batch of blocks
+    void *blocks[HEAP_CACHE_BATCH];
+    size_t count = alloc_blocks(blocks, HEAP_CACHE_BATCH, heap_cache_class_size(cls));
+    if (count == 0) {
+        return NULL;
+    }
+    block = blocks[--count];
+    MULTI_HEAP_LOCK(&core->lock);
+    while (count > 0 && heap_cache_push(&core->cache, cls, blocks[count - 1])) {
+        count--;
+    }
+    MULTI_HEAP_UNLOCK(&core->lock);
+    // the blocks which didn't fit anymore (the class was refilled meanwhile) go back to their heap
+    free_blocks(blocks, count);
+    return block;
+}
+
+HEAP_IRAM_ATTR bool heap_caps_cache_free(heap_t *heap, void *block)
+{
+    if (!heap_is_cached(heap)) {
+        return false;
+    }
+    const size_t cls = heap_cache_free_class(multi_heap_get_allocated_size(heap->heap, block));
+    if (cls == HEAP_CACHE_CLASSES) {
+        return false;
+    }
+
+    void *drained[HEAP_CACHE_BATCH];
+    size_t count = 0;
+    core_cache_t *core = &s_core_cache[xPortGetCoreID()];
+    MULTI_HEAP_LOCK(&core->lock);
+    assert(!heap_cache_contains(&core->cache, cls, block) && "free() target pointer is already free");
+    if (!heap_cache_push(&core->cache, cls, block)) {
+        // The class is full, drain its oldest blocks
+        count = heap_cache_take(&core->cache, cls, drained, HEAP_CACHE_BATCH);
+        heap_cache_push(&core->cache, cls, block);
+    }
+    MULTI_HEAP_UNLOCK(&core->lock);
+    free_blocks(drained, count);
+    return true;
+}
+
+/* Called by heap_caps_aligned_alloc_base() when an allocation fails, so in IRAM as well */
+HEAP_IRAM_ATTR bool heap_caps_cache_flush(void)
+{
+    bool flushed = false;
+    void *blocks[HEAP_CACHE_DEPTH];
+    for (int core_id = 0; core_id < portNUM_PROCESSORS; core_id++) {
+        core_cache_t *core = &s_core_cache[core_id];
+        for (size_t cls = 0; cls < HEAP_CACHE_CLASSES; cls++) {
+            MULTI_HEAP_LOCK(&core->lock);
+            size_t count = heap_cache_take(&core->cache, cls, blocks, HEAP_CACHE_DEPTH);
+            MULTI_HEAP_UNLOCK(&core->lock);
+            free_blocks(blocks, count);
+            flushed |= (count != 0);
+        }
+    }
+    return flushed;
+}
+
+bool heap_caps_cache_check(bool print_errors)
+{
+    bool valid = true;
+    for (int core_id = 0; core_id < portNUM_PROCESSORS; core_id++) {
+        core_cache_t *core = &s_core_cache[core_id];
+        MULTI_HEAP_LOCK(&core->lock);
+        for (size_t cls = 0; cls < HEAP_CACHE_CLASSES; cls++) {
+            for (size_t i = 0; i < core->cache.count[cls]; i++) {
+                void *block = core->cache.blocks[cls][i];
+                heap_t *heap = find_containing_heap(block);
+                if (heap == NULL || !heap_is_cached(heap)
+                        || multi_heap_get_allocated_size(heap->heap, block) < heap_cache_class_size(cls)) {
+                    if (print_errors) {
+                        MULTI_HEAP_STDERR_PRINTF("CORRUPT HEAP: cached block %p is not a block of %u bytes\n",
+                                                 block, (unsigned)heap_cache_class_size(cls));
+                    }
+                    valid = false;
+                }
+            }
+        }
+        MULTI_HEAP_UNLOCK(&core->lock);
+    }
+    return valid;
+}
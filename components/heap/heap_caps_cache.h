@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cache of free small blocks, in front of the heaps.
+
+   The blocks of the cache are still allocated for the heap they belong to. They are
+   sorted by size class (a multiple of HEAP_CACHE_GRANULE bytes up to
+   CONFIG_HEAP_CORE_CACHE_MAX_SIZE), each class being a stack of up to
+   HEAP_CACHE_DEPTH blocks. An empty class is refilled, and a full class drained,
+   HEAP_CACHE_BATCH blocks at a time, so that the heaps are accessed once per batch
+   of allocations rather than once per allocation.
+
+   These functions don't lock the cache, this is up to the caller.
+*/
+
+#define HEAP_CACHE_GRANULE  8
+#define HEAP_CACHE_CLASSES  (CONFIG_HEAP_CORE_CACHE_MAX_SIZE / HEAP_CACHE_GRANULE)
+#define HEAP_CACHE_DEPTH    (CONFIG_HEAP_CORE_CACHE_DEPTH)
+#define HEAP_CACHE_BATCH    (HEAP_CACHE_DEPTH / 2)
+
+typedef struct {
+    unsigned char count[HEAP_CACHE_CLASSES];                 ///< Number of blocks in each class
+    void *blocks[HEAP_CACHE_CLASSES][HEAP_CACHE_DEPTH];      ///< Blocks of each class, the oldest first
+} heap_cache_t;
+
+/* Size of the blocks of a class */
+static inline size_t heap_cache_class_size(size_t cls)
+{
+    return (cls + 1) * HEAP_CACHE_GRANULE;
+}
+
+/* Class to allocate 'size' bytes from, the blocks of this class have at least 'size' bytes.
+   Returns HEAP_CACHE_CLASSES if 'size' is too big for the cache. */
+static inline size_t heap_cache_alloc_class(size_t size)
+{
+    if (size == 0 || size > CONFIG_HEAP_CORE_CACHE_MAX_SIZE) {
+        return HEAP_CACHE_CLASSES;
+    }
+    return (size - 1) / HEAP_CACHE_GRANULE;
+}
+
+/* Class to store a block of 'block_size' usable bytes in, the biggest one whose size
+   is at most 'block_size'. Returns HEAP_CACHE_CLASSES if the block doesn't fit any class. */
+static inline size_t heap_cache_free_class(size_t block_size)
+{
+    size_t cls = block_size / HEAP_CACHE_GRANULE;
+    if (cls == 0 || cls > HEAP_CACHE_CLASSES) {
+        return HEAP_CACHE_CLASSES;
+    }
+    return cls - 1;
+}
+
+static inline void *heap_cache_pop(heap_cache_t *cache, size_t cls)
+{
+    if (cache->count[cls] == 0) {
+        return NULL;
+    }
+    return cache->blocks[cls][--cache->count[cls]];
+}
+
+/* Returns false if the class is full */
+static inline bool heap_cache_push(heap_cache_t *cache, size_t cls, void *block)
+{
+    if (cache->count[cls] == HEAP_CACHE_DEPTH) {
+        return false;
+    }
+    cache->blocks[cls][cache->count[cls]++] = block;
+    return true;
+}
+
+static inline bool heap_cache_contains(const heap_cache_t *cache, size_t cls, const void *block)
+{
+    for (size_t i = 0; i < cache->count[cls]; i++) {
+        if (cache->blocks[cls][i] == block) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Remove up to 'max' of the oldest blocks of a class, to give them back to their heap.
+   Returns the number of blocks copied to 'blocks'. */
+static inline size_t heap_cache_take(heap_cache_t *cache, size_t cls, void **blocks, size_t max)
+{
+    size_t count = cache->count[cls] < max ? cache->count[cls] : max;
+    memcpy(blocks, cache->blocks[cls], count * sizeof(void *));
+    cache->count[cls] -= count;
+    memmove(cache->blocks[cls], &cache->blocks[cls][count], cache->count[cls] * sizeof(void *));
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,386 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/queue.h>
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_frag.h"
+#include "esp_heap_caps_pool.h"
+#include "multi_heap.h"
+#include "multi_heap_platform.h"
+#include "heap_private.h"
+
+/*
+ * Fragmentation metrics and movable blocks.
+ *
+ * A movable block is a regular heap block whose address is only known through its handle.
+ * heap_caps_compact allocates each unlocked movable block again and keeps the new block
+ * if it is "lower" than the old one: in a heap coming first in registered_heaps, or at a
+ * lower address in the same heap. Each move makes the blocks lower, so the passes end,
+ * and the free memory gathers at the end of the heaps.
+ *
+ * The copy is made without holding any lock: heap_caps_movable_lock increments the
+ * generation of the handle, and the move is only committed if the generation didn't
+ * change during the copy.
+ */
+
+#define FRAG_FIRST_CLASS_SHIFT 5    // class 0 holds the blocks smaller than 32 bytes
+#define MOVABLE_HANDLES_PER_CHUNK 16
+#define MOVABLE_MAX_HANDLES 4096
+#define COMPACT_MAX_PASSES 8
+
+struct heap_caps_movable {
+    LIST_ENTRY(heap_caps_movable) next;
+    void *ptr;
+    size_t size;
+    uint32_t caps;
+    uint32_t generation;    ///< Incremented each time the block is locked
+    uint16_t lock_count;
+    bool compacting;        ///< The handle is used by heap_caps_compact and must not be freed
+    bool freed;             ///< heap_caps_free_movable was called while compacting
+};
+
+static LIST_HEAD(heap_caps_movable_ll, heap_caps_movable) s_movables = LIST_HEAD_INITIALIZER(s_movables);
+static multi_heap_lock_t s_movables_lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER;
+static heap_caps_pool_handle_t s_handles_pool = NULL;
+
+static size_t frag_size_class(size_t size)
+{
+    size_t class = 0;
+    size >>= FRAG_FIRST_CLASS_SHIFT;
+    while (size != 0 && class < HEAP_CAPS_FRAG_SIZE_CLASSES - 1) {
+        size >>= 1;
+        class++;
+    }
+    return class;
+}
+
+static bool frag_walker(void *block_ptr, size_t block_size, int block_used, void *user_data)
+{
+    heap_caps_frag_info_t *info = (heap_caps_frag_info_t *)user_data;
+    (void)block_ptr;
+
+    if (!block_used) {
+        const size_t class = frag_size_class(block_size);
+        info->total_free_bytes += block_size;
+        info->free_blocks++;
+        info->free_blocks_by_class[class]++;
+        info->free_bytes_by_class[class] += block_size;
+        if (block_size > info->largest_free_block) {
+            info->largest_free_block = block_size;
+        }
+    }
+    return true;
+}
+
+void heap_caps_get_frag_info(uint32_t caps, heap_caps_frag_info_t *info)
+{
+    assert(info != NULL);
+    memset(info, 0, sizeof(heap_caps_frag_info_t));
+
+    heap_caps_cache_flush();
+    heap_t *heap;
+    SLIST_FOREACH(heap, &registered_heaps, next) {
+        if (heap_caps_match(heap, caps)) {
+            multi_heap_walk(heap->heap, frag_walker, info);
+        }
+    }
+
+    if (info->total_free_bytes != 0) {
+        info->fragmentation = 1000 - (uint32_t)(((uint64_t)info->largest_free_block * 1000) / info->total_free_bytes);
+    }
+}
+
+void heap_caps_frag_trend_sample(heap_caps_frag_trend_t *trend, uint32_t caps, uint32_t timestamp)
+{
+    assert(trend != NULL);
+    heap_caps_frag_info_t info;
+    heap_caps_get_frag_info(caps, &info);
+
+    heap_caps_frag_sample_t *sample = &trend->samples[trend->next];
+    sample->timestamp = timestamp;
+    sample->fragmentation = info.fragmentation;
+    sample->total_free_bytes = info.total_free_bytes;
+    sample->largest_free_block = info.largest_free_block;
+
+    trend->next = (trend->next + 1) % HEAP_CAPS_FRAG_TREND_SAMPLES;
+    if (trend->count < HEAP_CAPS_FRAG_TREND_SAMPLES) {
+        trend->count++;
+    }
+}
+
+esp_err_t heap_caps_frag_trend_get(const heap_caps_frag_trend_t *trend, heap_caps_frag_trend_info_t *info)
+{
+    if (trend == NULL || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (trend->count < 2) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // the oldest sample is at 'next' once the buffer is full, at 0 before
+    const size_t first = (trend->count == HEAP_CAPS_FRAG_TREND_SAMPLES) ? trend->next : 0;
+    const heap_caps_frag_sample_t *oldest = &trend->samples[first];
+    const heap_caps_frag_sample_t *newest = &trend->samples[(first + trend->count - 1) % HEAP_CAPS_FRAG_TREND_SAMPLES];
+
+    // least squares on the times relative to the oldest sample
+    double mean_t = 0;
+    double mean_frag = 0;
+    double mean_largest = 0;
+    size_t min_largest = SIZE_MAX;
+    for (size_t i = 0; i < trend->count; i++) {
+        const heap_caps_frag_sample_t *sample = &trend->samples[(first + i) % HEAP_CAPS_FRAG_TREND_SAMPLES];
+        mean_t += (uint32_t)(sample->timestamp - oldest->timestamp);
+        mean_frag += sample->fragmentation;
+        mean_largest += sample->largest_free_block;
+        if (sample->largest_free_block < min_largest) {
+            min_largest = sample->largest_free_block;
+        }
+    }
+    mean_t /= trend->count;
+    mean_frag /= trend->count;
+    mean_largest /= trend->count;
+
+    double var_t = 0;
+    double cov_frag = 0;
+    double cov_largest = 0;
+    for (size_t i = 0; i < trend->count; i++) {
+        const heap_caps_frag_sample_t *sample = &trend->samples[(first + i) % HEAP_CAPS_FRAG_TREND_SAMPLES];
+        const double dt = (uint32_t)(sample->timestamp - oldest->timestamp) - mean_t;
+        var_t += dt * dt;
+        cov_frag += dt * (sample->fragmentation - mean_frag);
+        cov_largest += dt * (sample->largest_free_block - mean_largest);
+    }
+    if (var_t == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    info->samples = trend->count;
+    info->duration = newest->timestamp - oldest->timestamp;
+    info->fragmentation_slope = (int32_t)(cov_frag * 1000 / var_t);
+    info->largest_free_block_slope = (int32_t)(cov_largest * 1000 / var_t);
+    info->min_largest_free_block = min_largest;
+    return ESP_OK;
+}
+
+static heap_caps_pool_handle_t get_handles_pool(void)
+{
+    heap_caps_pool_handle_t pool = __atomic_load_n(&s_handles_pool, __ATOMIC_ACQUIRE);
+    if (pool != NULL) {
+        return pool;
+    }
+
+    pool = heap_caps_pool_create_growable(sizeof(struct heap_caps_movable), MOVABLE_HANDLES_PER_CHUNK,
+                                          MOVABLE_MAX_HANDLES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (pool == NULL) {
+        return NULL;
+    }
+    heap_caps_pool_handle_t expected = NULL;
+    if (!__atomic_compare_exchange_n(&s_handles_pool, &expected, pool, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // another task created the pool meanwhile
+        heap_caps_pool_delete(pool);
+        pool = expected;
+    }
+    return pool;
+}
+
+heap_caps_movable_handle_t heap_caps_malloc_movable(size_t size, uint32_t caps)
+{
+    heap_caps_pool_handle_t pool = get_handles_pool();
+    if (pool == NULL) {
+        return NULL;
+    }
+    heap_caps_movable_handle_t handle = heap_caps_pool_alloc(pool);
+    if (handle == NULL) {
+        return NULL;
+    }
+    handle->ptr = heap_caps_malloc(size, caps);
+    if (handle->ptr == NULL) {
+        heap_caps_pool_free(pool, handle);
+        return NULL;
+    }
+    handle->size = size;
+    handle->caps = caps;
+    handle->generation = 0;
+    handle->lock_count = 0;
+    handle->compacting = false;
+    handle->freed = false;
+
+    MULTI_HEAP_LOCK(&s_movables_lock);
+    LIST_INSERT_HEAD(&s_movables, handle, next);
+    MULTI_HEAP_UNLOCK(&s_movables_lock);
+    return handle;
+}
+
+static void free_movable_handle(heap_caps_movable_handle_t handle)
+{
+    if (handle != NULL) {
+        heap_caps_free(handle->ptr);
+        heap_caps_pool_free(s_handles_pool, handle);
+    }
+}
+
+void heap_caps_free_movable(heap_caps_movable_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+
+    MULTI_HEAP_LOCK(&s_movables_lock);
+    assert(handle->lock_count == 0 && !handle->freed);
+    if (handle->compacting) {
+        // heap_caps_compact frees the block once it is done with it
+        handle->freed = true;
+        MULTI_HEAP_UNLOCK(&s_movables_lock);
+        return;
+    }
+    LIST_REMOVE(handle, next);
+    MULTI_HEAP_UNLOCK(&s_movables_lock);
+
+    free_movable_handle(handle);
+}
+
+void *heap_caps_movable_lock(heap_caps_movable_handle_t handle)
+{
+    assert(handle != NULL);
+    MULTI_HEAP_LOCK(&s_movables_lock);
+    assert(handle->lock_count != UINT16_MAX);
+    handle->lock_count++;
+    handle->generation++;
+    void *ptr = handle->ptr;
+    MULTI_HEAP_UNLOCK(&s_movables_lock);
+    return ptr;
+}
+
+void heap_caps_movable_unlock(heap_caps_movable_handle_t handle)
+{
+    assert(handle != NULL);
+    MULTI_HEAP_LOCK(&s_movables_lock);
+    assert(handle->lock_count != 0);
+    handle->lock_count--;
+    MULTI_HEAP_UNLOCK(&s_movables_lock);
+}
+
+size_t heap_caps_movable_get_size(heap_caps_movable_handle_t handle)
+{
+    assert(handle != NULL);
+    return handle->size;
+}
+
+/* Position of the heap in registered_heaps, the allocator tries the heaps in this order */
+static size_t heap_rank(const heap_t *heap)
+{
+    size_t rank = 0;
+    const heap_t *it;
+    SLIST_FOREACH(it, &registered_heaps, next) {
+        if (it == heap) {
+            break;
+        }
+        rank++;
+    }
+    return rank;
+}
+
+/* True if the block at new_ptr is preferred to the block at old_ptr */
+static bool is_lower_block(void *new_ptr, void *old_ptr)
+{
+    const heap_t *new_heap = find_containing_heap(new_ptr);
+    const heap_t *old_heap = find_containing_heap(old_ptr);
+    assert(new_heap != NULL && old_heap != NULL);
+    if (new_heap == old_heap) {
+        return (intptr_t)new_ptr < (intptr_t)old_ptr;
+    }
+    return heap_rank(new_heap) < heap_rank(old_heap);
+}
+
+/* Try to move the block of a handle marked as compacting, returns true if it moved */
+static bool compact_block(heap_caps_movable_handle_t handle, void *old_ptr, uint32_t generation)
+{
+    void *new_ptr = heap_caps_malloc_base(handle->size, handle->caps);
+    if (new_ptr == NULL) {
+        return false;
+    }
+    if (!is_lower_block(new_ptr, old_ptr)) {
+        heap_caps_free(new_ptr);
+        return false;
+    }
+
+    memcpy(new_ptr, old_ptr, handle->size);
+
+    bool moved = false;
+    MULTI_HEAP_LOCK(&s_movables_lock);
+    // the block wasn't locked nor moved since it was copied
+    if (handle->lock_count == 0 && handle->generation == generation && handle->ptr == old_ptr) {
+        handle->ptr = new_ptr;
+        moved = true;
+    }
+    MULTI_HEAP_UNLOCK(&s_movables_lock);
+
+    heap_caps_free(moved ? old_ptr : new_ptr);
+    return moved;
+}
+
+static size_t compact_pass(uint32_t caps)
+{
+    size_t moved = 0;
+    // handle freed while it was compacting, removed from the list but freed once the lock is released
+    heap_caps_movable_handle_t freed_handle = NULL;
+
+    MULTI_HEAP_LOCK(&s_movables_lock);
+    heap_caps_movable_handle_t handle = LIST_FIRST(&s_movables);
+    while (handle != NULL) {
+        void *ptr = handle->ptr;
+        const heap_t *heap = find_containing_heap(ptr);
+        // a handle already compacting is being moved by a concurrent heap_caps_compact
+        if (handle->lock_count != 0 || handle->freed || handle->compacting
+                || heap == NULL || !heap_caps_match(heap, caps)) {
+            handle = LIST_NEXT(handle, next);
+            continue;
+        }
+
+        // the handle stays in the list while compacting, so the iteration can go on after it
+        handle->compacting = true;
+        const uint32_t generation = handle->generation;
+        MULTI_HEAP_UNLOCK(&s_movables_lock);
+
+        free_movable_handle(freed_handle);
+        freed_handle = NULL;
+        if (compact_block(handle, ptr, generation)) {
+            moved++;
+        }
+
+        MULTI_HEAP_LOCK(&s_movables_lock);
+        heap_caps_movable_handle_t next = LIST_NEXT(handle, next);
+        handle->compacting = false;
+        if (handle->freed) {
+            LIST_REMOVE(handle, next);
+            freed_handle = handle;
+        }
+        handle = next;
+    }
+    MULTI_HEAP_UNLOCK(&s_movables_lock);
+
+    free_movable_handle(freed_handle);
+    return moved;
+}
+
+size_t heap_caps_compact(uint32_t caps)
+{
+    size_t moved = 0;
+
+    // the blocks of the core caches are given back to the heaps, so they can merge
+    heap_caps_cache_flush();
+    for (size_t pass = 0; pass < COMPACT_MAX_PASSES; pass++) {
+        const size_t pass_moved = compact_pass(caps);
+        if (pass_moved == 0) {
+            break;
+        }
+        moved += pass_moved;
+    }
+    return moved;
+}
@@ -25,6 +25,9 @@ static bool s_in_startup = true;
 /* Linked-list of registered heaps */
 struct registered_heap_ll registered_heaps;
 
+/* Index of the heaps registered by heap_caps_init(), empty until then */
+heap_index_t registered_heaps_index;
+
 ESP_SYSTEM_INIT_FN(init_heap, CORE, BIT(0), 100)
 {
     heap_caps_init();
@@ -68,6 +71,37 @@ static void sorted_add_to_registered_heaps(heap_t *new_heap)
     SLIST_INSERT_AFTER(prev_heap, new_heap, next);
 }
 
+/**
+ * @brief This helper function fills the index of the heaps registered
+ * at startup, sorted by ascending start address.
+ *
+ * @param heaps array of the heaps registered at startup
+ * @param num_heaps number of heaps in the array
+ * @param starts array of num_heaps entries, receiving the sorted start addresses
+ * @param sorted_heaps array of num_heaps entries, receiving the heap of each start address
+ */
+static void build_registered_heaps_index(heap_t *heaps, size_t num_heaps, intptr_t *starts, heap_t **sorted_heaps)
+{
+    // insertion sort, there are only a few heaps
+    for (size_t i = 0; i < num_heaps; i++) {
+        size_t j = i;
+        while (j > 0 && starts[j - 1] > heaps[i].start) {
+            starts[j] = starts[j - 1];
+            sorted_heaps[j] = sorted_heaps[j - 1];
+            j--;
+        }
+        starts[j] = heaps[i].start;
+        sorted_heaps[j] = &heaps[i];
+    }
+
+    registered_heaps_index = (heap_index_t) {
+        .array = heaps,
+        .count = num_heaps,
+        .starts = starts,
+        .heaps = sorted_heaps,
+    };
+}
+
 static void register_heap(heap_t *region)
 {
     size_t heap_size = region->end - region->start;
@@ -156,6 +190,7 @@ void heap_caps_init(void)
         // add the name of the newly created heap to match the region name in which it will be created
 #if CONFIG_HEAP_TASK_TRACKING
         heap->name = type->name;
+        heap_caps_task_tracking_register_heap(heap);
 #endif // CONFIG_HEAP_TASK_TRACKING
         memcpy(heap->caps, type->caps, sizeof(heap->caps));
         heap->start = region->start;
@@ -177,8 +212,10 @@ void heap_caps_init(void)
 
     /* Allocate the permanent heap data that we'll use as a linked list at runtime.
 
-       Allocate this part of data contiguously, even though it's a linked list... */
+       Allocate this part of data contiguously, even though it's a linked list...
+       The index of the heaps by address is allocated right after it. */
     assert(SLIST_EMPTY(&registered_heaps));
+    const size_t heaps_array_size = (sizeof(heap_t) + sizeof(intptr_t) + sizeof(heap_t *)) * num_heaps;
 
     heap_t *heaps_array = NULL;
     heap_t *used_heap = NULL;
@@ -189,14 +226,13 @@ void heap_caps_init(void)
              * the allocated block won't include the block owner bytes since this operation
              * is done by the top level API heap_caps_malloc(). So we need to add it manually
              * after successful allocation. Allocate extra 4 bytes for that purpose. */
-            heaps_array = multi_heap_malloc(used_heap->heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(sizeof(heap_t) * num_heaps));
+            heaps_array = multi_heap_malloc(used_heap->heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(heaps_array_size));
             if (heaps_array != NULL) {
                 break;
             }
         }
     }
     assert(heaps_array != NULL); /* if NULL, there's not enough free startup heap space */
-    MULTI_HEAP_SET_BLOCK_OWNER(heaps_array);
     heaps_array = (heap_t *)MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(heaps_array);
 
     memcpy(heaps_array, temp_heaps, sizeof(heap_t)*num_heaps);
@@ -215,9 +251,11 @@ void heap_caps_init(void)
         sorted_add_to_registered_heaps(&heaps_array[i]);
     }
 
+    intptr_t *index_starts = (intptr_t *)(heaps_array + num_heaps);
+    build_registered_heaps_index(heaps_array, num_heaps, index_starts, (heap_t **)(index_starts + num_heaps));
+
 #if CONFIG_HEAP_TASK_TRACKING
-    heap_caps_update_per_task_info_alloc(used_heap,
-                                         MULTI_HEAP_REMOVE_BLOCK_OWNER_OFFSET(heaps_array),
+    heap_caps_update_per_task_info_alloc(used_heap, MULTI_HEAP_REMOVE_BLOCK_OWNER_OFFSET(heaps_array),
                                          multi_heap_get_full_block_size(used_heap->heap, MULTI_HEAP_REMOVE_BLOCK_OWNER_OFFSET(heaps_array)),
                                          get_all_caps(used_heap));
 #endif
@@ -309,6 +347,7 @@ esp_err_t heap_caps_add_region_with_caps(const uint32_t caps[], intptr_t start,
             break;
         }
     }
+    heap_caps_task_tracking_register_heap(p_new);
 #endif // CONFIG_HEAP_TASK_TRACKING
     memcpy(p_new->caps, caps, sizeof(p_new->caps));
     p_new->start = start;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -17,6 +17,17 @@
 #include "esp_system.h"
 #endif
 
+#if CONFIG_HEAP_TRACING_SAMPLING
+/* The heap functions can't be wrapped on linux, they call heap_trace_sampling.c directly */
+void heap_trace_sampling_alloc_hook(void *ptr, size_t size);
+void heap_trace_sampling_free_hook(void *ptr);
+#define TRACE_ALLOC(ptr, size) heap_trace_sampling_alloc_hook(ptr, size)
+#define TRACE_FREE(ptr) heap_trace_sampling_free_hook(ptr)
+#else
+#define TRACE_ALLOC(ptr, size)
+#define TRACE_FREE(ptr)
+#endif
+
 static esp_alloc_failed_hook_t alloc_failed_callback;
 
 static const uint32_t MAGIC_HEAP_SIZE = UINT32_MAX;
@@ -54,6 +65,7 @@ static void *heap_caps_malloc_base( size_t size, uint32_t caps)
     if (!ptr && size > 0) {
         heap_caps_alloc_failed(size, caps, __func__);
     }
+    TRACE_ALLOC(ptr, size);
 
     return ptr;
 }
@@ -84,10 +96,15 @@ void *heap_caps_malloc_prefer( size_t size, size_t num, ... )
 
 static void *heap_caps_realloc_base( void *ptr, size_t size, uint32_t caps)
 {
+    // traced as free-then-alloc
+    TRACE_FREE(ptr);
     void *new_ptr = realloc(ptr, size);
     if (new_ptr == NULL && size > 0) {
         heap_caps_alloc_failed(size, caps, __func__);
     }
+    if (size > 0) {
+        TRACE_ALLOC(new_ptr, size);
+    }
     // If realloc fails, it returns NULL and the original pointer is left unchanged.
     // If realloc succeeds, it returns a pointer to the allocated memory, which may be the
     // same as the original pointer or a new pointer if the memory was moved.
@@ -114,6 +131,7 @@ void *heap_caps_realloc_prefer( void *ptr, size_t size, size_t num, ... )
 
 void heap_caps_free( void *ptr)
 {
+    TRACE_FREE(ptr);
     free(ptr);
 }
 
@@ -125,7 +143,9 @@ static void *heap_caps_calloc_base( size_t n, size_t size, uint32_t caps)
         return NULL;
     }
 
-    return calloc(n, size);
+    void *ptr = calloc(n, size);
+    TRACE_ALLOC(ptr, size_bytes);
+    return ptr;
 }
 
 void *heap_caps_calloc( size_t n, size_t size, uint32_t caps)
@@ -215,6 +235,7 @@ void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
     if (!ptr && size > 0) {
         heap_caps_alloc_failed(size, caps, __func__);
     }
+    TRACE_ALLOC(ptr, size);
 
     return ptr;
 }
@@ -0,0 +1,204 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
+#include "multi_heap.h"
+#include "multi_heap_platform.h"
+#include "heap_private.h"
+#include "heap_caps_pool.h"
+
+/*
+ * Pools of fixed-size objects, see heap_caps_pool.h for the lock-free part.
+ *
+ * The pool structure and its chunks are regular heap blocks. The pools are kept in a
+ * list so that the heap functions can report the objects of the chunks rather than
+ * the heap blocks holding them.
+ */
+
+struct heap_caps_pool {
+    SLIST_ENTRY(heap_caps_pool) next;
+    uint32_t caps;
+    multi_heap_lock_t grow_lock;    ///< Serializes the chunks being published
+    heap_pool_t pool;
+};
+
+static SLIST_HEAD(heap_caps_pool_ll, heap_caps_pool) s_pools = SLIST_HEAD_INITIALIZER(s_pools);
+static multi_heap_lock_t s_pools_lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER;
+
+/* Add a chunk to the pool, returns false if the pool can't grow anymore */
+HEAP_IRAM_ATTR static bool pool_grow(heap_caps_pool_handle_t pool)
+{
+    const size_t chunk = __atomic_load_n(&pool->pool.chunk_count, __ATOMIC_ACQUIRE);
+    if (chunk == pool->pool.max_chunks) {
+        return false;
+    }
+    uint8_t *mem = heap_caps_malloc(heap_pool_chunk_size(&pool->pool), pool->caps);
+    if (mem == NULL) {
+        return false;
+    }
+    heap_pool_prepare_chunk(&pool->pool, chunk, mem);
+
+    bool published = false;
+    MULTI_HEAP_LOCK(&pool->grow_lock);
+    if (pool->pool.chunk_count == chunk) {
+        heap_pool_publish_chunk(&pool->pool, mem);
+        published = true;
+    }
+    MULTI_HEAP_UNLOCK(&pool->grow_lock);
+    if (!published) {
+        // another task added this chunk meanwhile
+        heap_caps_free(mem);
+    }
+    return true;
+}
+
+heap_caps_pool_handle_t heap_caps_pool_create_growable(size_t obj_size, size_t count, size_t max_count, uint32_t caps)
+{
+    if (count == 0 || max_count < count) {
+        return NULL;
+    }
+    const size_t max_chunks = (max_count + count - 1) / count;
+    heap_caps_pool_handle_t pool = heap_caps_malloc(sizeof(struct heap_caps_pool) + max_chunks * sizeof(uint8_t *), caps);
+    if (pool == NULL) {
+        return NULL;
+    }
+    if (!heap_pool_init(&pool->pool, (uint8_t **)&pool[1], obj_size, count, max_chunks)) {
+        heap_caps_free(pool);
+        return NULL;
+    }
+    pool->caps = caps;
+    MULTI_HEAP_LOCK_INIT(&pool->grow_lock);
+    if (!pool_grow(pool)) {
+        heap_caps_free(pool);
+        return NULL;
+    }
+
+    MULTI_HEAP_LOCK(&s_pools_lock);
+    SLIST_INSERT_HEAD(&s_pools, pool, next);
+    MULTI_HEAP_UNLOCK(&s_pools_lock);
+    return pool;
+}
+
+heap_caps_pool_handle_t heap_caps_pool_create(size_t obj_size, size_t count, uint32_t caps)
+{
+    return heap_caps_pool_create_growable(obj_size, count, count, caps);
+}
+
+void heap_caps_pool_delete(heap_caps_pool_handle_t pool)
+{
+    assert(pool != NULL);
+    MULTI_HEAP_LOCK(&s_pools_lock);
+    SLIST_REMOVE(&s_pools, pool, heap_caps_pool, next);
+    MULTI_HEAP_UNLOCK(&s_pools_lock);
+    for (size_t chunk = 0; chunk < pool->pool.chunk_count; chunk++) {
+        heap_caps_free(pool->pool.chunks[chunk]);
+    }
+    heap_caps_free(pool);
+}
+
+HEAP_IRAM_ATTR void *heap_caps_pool_alloc(heap_caps_pool_handle_t pool)
+{
+    void *obj = heap_pool_alloc(&pool->pool);
+    while (obj == NULL && pool_grow(pool)) {
+        obj = heap_pool_alloc(&pool->pool);
+    }
+    return obj;
+}
+
+HEAP_IRAM_ATTR void heap_caps_pool_free(heap_caps_pool_handle_t pool, void *obj)
+{
+    if (obj == NULL) {
+        return;
+    }
+    heap_pool_free(&pool->pool, obj);
+}
+
+void heap_caps_pool_get_info(heap_caps_pool_handle_t pool, heap_caps_pool_info_t *info)
+{
+    const size_t chunk_count = __atomic_load_n(&pool->pool.chunk_count, __ATOMIC_ACQUIRE);
+    info->obj_size = pool->pool.obj_size;
+    info->total_objects = chunk_count * pool->pool.chunk_objects;
+    info->free_objects = __atomic_load_n(&pool->pool.free_count, __ATOMIC_RELAXED);
+    info->minimum_free_objects = __atomic_load_n(&pool->pool.min_free_count, __ATOMIC_RELAXED);
+    info->max_objects = pool->pool.max_chunks * pool->pool.chunk_objects;
+    info->total_bytes = heap_caps_get_allocated_size(pool) + chunk_count * heap_caps_get_allocated_size(pool->pool.chunks[0]);
+}
+
+/* A pool matches the capabilities of the heap of its first chunk */
+static bool pool_match(heap_caps_pool_handle_t pool, uint32_t caps)
+{
+    if (caps & MALLOC_CAP_INVALID) {
+        return true;
+    }
+    heap_t *heap = find_containing_heap(pool->pool.chunks[0]);
+    return heap != NULL && (get_all_caps(heap) & caps) == caps;
+}
+
+void heap_caps_pools_print_info(uint32_t caps)
+{
+    heap_caps_pool_handle_t pool;
+    MULTI_HEAP_LOCK(&s_pools_lock);
+    SLIST_FOREACH(pool, &s_pools, next) {
+        if (pool_match(pool, caps)) {
+            heap_caps_pool_info_t info;
+            heap_caps_pool_get_info(pool, &info);
+            MULTI_HEAP_PRINTF("  Pool 0x%08x obj_size %d objects %d free %d min_free %d max_objects %d\n",
+                              (intptr_t)pool, info.obj_size, info.total_objects, info.free_objects,
+                              info.minimum_free_objects, info.max_objects);
+        }
+    }
+    MULTI_HEAP_UNLOCK(&s_pools_lock);
+}
+
+bool heap_caps_pools_check(uint32_t caps, bool print_errors)
+{
+    bool valid = true;
+    heap_caps_pool_handle_t pool;
+    MULTI_HEAP_LOCK(&s_pools_lock);
+    SLIST_FOREACH(pool, &s_pools, next) {
+        if (pool_match(pool, caps)) {
+            valid = heap_pool_check(&pool->pool, print_errors) && valid;
+        }
+    }
+    MULTI_HEAP_UNLOCK(&s_pools_lock);
+    return valid;
+}
+
+bool heap_caps_pools_walk_block(walker_heap_into_t heap_info, walker_block_info_t block_info,
+                                heap_caps_walker_cb_t walker_func, void *user_data, bool *walk_on)
+{
+    const uint8_t *block_start = block_info.ptr;
+    const uint8_t *block_end = block_start + block_info.size;
+    heap_caps_pool_handle_t pool;
+    MULTI_HEAP_LOCK(&s_pools_lock);
+    SLIST_FOREACH(pool, &s_pools, next) {
+        const size_t chunk_count = __atomic_load_n(&pool->pool.chunk_count, __ATOMIC_ACQUIRE);
+        for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+            const uint8_t *mem = pool->pool.chunks[chunk];
+            if (mem < block_start || mem + heap_pool_chunk_size(&pool->pool) > block_end) {
+                continue;
+            }
+            // the heap block holds this chunk, report its objects instead
+            *walk_on = true;
+            const size_t first = chunk * pool->pool.chunk_objects;
+            for (size_t i = first; *walk_on && i < first + pool->pool.chunk_objects; i++) {
+                walker_block_info_t obj_info = {
+                    heap_pool_slot_data(heap_pool_slot(&pool->pool, i)),
+                    pool->pool.obj_size,
+                    heap_pool_is_used(&pool->pool, i)
+                };
+                *walk_on = walker_func(heap_info, obj_info, user_data);
+            }
+            MULTI_HEAP_UNLOCK(&s_pools_lock);
+            return true;
+        }
+    }
+    MULTI_HEAP_UNLOCK(&s_pools_lock);
+    return false;
+}
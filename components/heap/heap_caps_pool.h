@@ -0,0 +1,274 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "multi_heap_config.h"
+#include "multi_heap_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Lock-free pool of fixed-size objects.
+
+   The objects are stored in chunks of 'chunk_objects' slots, the pool grows by adding
+   chunks up to 'max_chunks'. Each slot starts with a state word, HEAP_POOL_SLOT_USED while
+   the object is allocated, or HEAP_POOL_SLOT_FREE ORed with the link to the next free
+   object. The objects are identified by their index in the pool, so the head of the free
+   list fits a 32-bit word together with a tag changed by each update, which makes the
+   compare-and-swap of the head safe against ABA.
+
+   Chunks are only added by heap_pool_publish_chunk(), which the caller must serialize;
+   heap_pool_alloc() and heap_pool_free() don't take any lock.
+*/
+
+#define HEAP_POOL_MAX_OBJECTS       0xFFFF
+#define HEAP_POOL_LINK_MASK         0x0000FFFF
+#define HEAP_POOL_TAG_ONE           0x00010000
+
+#define HEAP_POOL_SLOT_USED         0xA110CA7E
+#define HEAP_POOL_SLOT_FREE         0xF4EE0000
+#define HEAP_POOL_SLOT_FREE_MASK    0xFFFF0000
+
+/* The state word takes a pointer size, so that the objects are aligned as heap blocks */
+#define HEAP_POOL_HEAD_SIZE         sizeof(void *)
+
+/* Same patterns as multi_heap_poisoning.c */
+#ifdef MULTI_HEAP_POISONING
+#define HEAP_POOL_TAIL_CANARY       0xBAAD5678
+#define HEAP_POOL_TAIL_SIZE         sizeof(uint32_t)
+#else
+#define HEAP_POOL_TAIL_SIZE         0
+#endif
+#ifdef MULTI_HEAP_POISONING_SLOW
+#define HEAP_POOL_MALLOC_FILL       0xce
+#define HEAP_POOL_FREE_FILL         0xfe
+#endif
+
+typedef struct {
+    uint32_t head;              ///< Tag in the upper half, link (index + 1) of the first free object in the lower half
+    uint32_t free_count;        ///< Number of free objects
+    uint32_t min_free_count;    ///< Lowest number of free objects since the pool was created
+    uint32_t chunk_count;       ///< Number of published chunks
+    size_t obj_size;
+    size_t slot_size;
+    size_t chunk_objects;
+    size_t max_chunks;
+    uint8_t **chunks;           ///< Table of 'max_chunks' chunks
+} heap_pool_t;
+
+static inline size_t heap_pool_slot_size(size_t obj_size)
+{
+    size_t size = HEAP_POOL_HEAD_SIZE + obj_size + HEAP_POOL_TAIL_SIZE;
+    return (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+}
+
+static inline size_t heap_pool_chunk_size(const heap_pool_t *pool)
+{
+    return pool->chunk_objects * pool->slot_size;
+}
+
+/* Returns false if the pool would have too many objects */
+static inline bool heap_pool_init(heap_pool_t *pool, uint8_t **chunks, size_t obj_size, size_t chunk_objects, size_t max_chunks)
+{
+    if (obj_size == 0 || chunk_objects == 0 || max_chunks == 0
+            || chunk_objects > HEAP_POOL_MAX_OBJECTS / max_chunks) {
+        return false;
+    }
+    memset(pool, 0, sizeof(heap_pool_t));
+    memset(chunks, 0, max_chunks * sizeof(uint8_t *));
+    pool->obj_size = obj_size;
+    pool->slot_size = heap_pool_slot_size(obj_size);
+    pool->chunk_objects = chunk_objects;
+    pool->max_chunks = max_chunks;
+    pool->chunks = chunks;
+    return true;
+}
+
+static inline uint32_t *heap_pool_slot(const heap_pool_t *pool, size_t index)
+{
+    return (uint32_t *)(pool->chunks[index / pool->chunk_objects] + (index % pool->chunk_objects) * pool->slot_size);
+}
+
+static inline void *heap_pool_slot_data(uint32_t *slot)
+{
+    return (uint8_t *)slot + HEAP_POOL_HEAD_SIZE;
+}
+
+/* Index of the object at 'data', or HEAP_POOL_MAX_OBJECTS if it isn't an object of the pool */
+static inline size_t heap_pool_index(const heap_pool_t *pool, const void *data)
+{
+    const uintptr_t slot = (uintptr_t)data - HEAP_POOL_HEAD_SIZE;
+    const size_t chunk_count = __atomic_load_n(&pool->chunk_count, __ATOMIC_ACQUIRE);
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+        const uintptr_t offset = slot - (uintptr_t)pool->chunks[chunk];
+        if (offset < heap_pool_chunk_size(pool)) {
+            if (offset % pool->slot_size != 0) {
+                return HEAP_POOL_MAX_OBJECTS;
+            }
+            return chunk * pool->chunk_objects + offset / pool->slot_size;
+        }
+    }
+    return HEAP_POOL_MAX_OBJECTS;
+}
+
+#ifdef MULTI_HEAP_POISONING
+static inline uint32_t *heap_pool_slot_tail(const heap_pool_t *pool, uint32_t *slot)
+{
+    return (uint32_t *)((uint8_t *)heap_pool_slot_data(slot) + pool->obj_size);
+}
+#endif
+
+/* Fill the slots of the chunk 'chunk' stored at 'mem', linking them in a free list. This
+   doesn't publish the chunk, so the caller may do it without holding its lock. */
+static inline void heap_pool_prepare_chunk(const heap_pool_t *pool, size_t chunk, uint8_t *mem)
+{
+    const size_t first = chunk * pool->chunk_objects;
+    for (size_t i = 0; i < pool->chunk_objects; i++) {
+        uint32_t *slot = (uint32_t *)(mem + i * pool->slot_size);
+        // the last link is set when the chunk is published
+        *slot = HEAP_POOL_SLOT_FREE | (uint32_t)(first + i + 2);
+#ifdef MULTI_HEAP_POISONING
+        const uint32_t canary = HEAP_POOL_TAIL_CANARY;
+        memcpy(heap_pool_slot_tail(pool, slot), &canary, sizeof(canary));
+#endif
+#ifdef MULTI_HEAP_POISONING_SLOW
+        memset(heap_pool_slot_data(slot), HEAP_POOL_FREE_FILL, pool->obj_size);
+#endif
+    }
+}
+
+/* Add the next chunk of the pool, prepared at 'mem' by heap_pool_prepare_chunk(), and make
+   its objects available */
+static inline void heap_pool_publish_chunk(heap_pool_t *pool, uint8_t *mem)
+{
+    const size_t chunk = pool->chunk_count;
+    assert(chunk < pool->max_chunks);
+    pool->chunks[chunk] = mem;
+    __atomic_store_n(&pool->chunk_count, chunk + 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&pool->free_count, pool->chunk_objects, __ATOMIC_RELAXED);
+    if (chunk == 0) {
+        pool->min_free_count = pool->chunk_objects;
+    }
+
+    const size_t first = chunk * pool->chunk_objects;
+    uint32_t *last = heap_pool_slot(pool, first + pool->chunk_objects - 1);
+    uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+    uint32_t new_head;
+    do {
+        __atomic_store_n(last, HEAP_POOL_SLOT_FREE | (head & HEAP_POOL_LINK_MASK), __ATOMIC_RELAXED);
+        new_head = ((head + HEAP_POOL_TAG_ONE) & ~HEAP_POOL_LINK_MASK) | (uint32_t)(first + 1);
+    } while (!__atomic_compare_exchange_n(&pool->head, &head, new_head, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/* Check the state word and the canaries of a slot. The fill pattern of free objects is
+   only checked when they are allocated, a concurrent allocation would overwrite it. */
+static inline bool heap_pool_check_slot(const heap_pool_t *pool, uint32_t *slot, bool print_errors)
+{
+    const uint32_t state = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    if (state != HEAP_POOL_SLOT_USED && (state & HEAP_POOL_SLOT_FREE_MASK) != HEAP_POOL_SLOT_FREE) {
+        if (print_errors) {
+            MULTI_HEAP_STDERR_PRINTF("CORRUPT HEAP: Bad pool object head at %p, got 0x%08x\n", slot, (unsigned)state);
+        }
+        return false;
+    }
+#ifdef MULTI_HEAP_POISONING
+    uint32_t canary;
+    memcpy(&canary, heap_pool_slot_tail(pool, slot), sizeof(canary));
+    if (canary != HEAP_POOL_TAIL_CANARY) {
+        if (print_errors) {
+            MULTI_HEAP_STDERR_PRINTF("CORRUPT HEAP: Bad pool object tail at %p. Expected 0x%08x got 0x%08x\n",
+                                     heap_pool_slot_tail(pool, slot), HEAP_POOL_TAIL_CANARY, (unsigned)canary);
+        }
+        return false;
+    }
+#else
+    (void)pool;
+#endif
+    return true;
+}
+
+static inline bool heap_pool_check(const heap_pool_t *pool, bool print_errors)
+{
+    bool valid = true;
+    const size_t count = __atomic_load_n(&pool->chunk_count, __ATOMIC_ACQUIRE) * pool->chunk_objects;
+    for (size_t i = 0; i < count; i++) {
+        valid = heap_pool_check_slot(pool, heap_pool_slot(pool, i), print_errors) && valid;
+    }
+    return valid;
+}
+
+/* Returns NULL if all objects are allocated */
+static inline void *heap_pool_alloc(heap_pool_t *pool)
+{
+    uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    uint32_t *slot;
+    uint32_t new_head;
+    do {
+        if ((head & HEAP_POOL_LINK_MASK) == 0) {
+            return NULL;
+        }
+        slot = heap_pool_slot(pool, (head & HEAP_POOL_LINK_MASK) - 1);
+        // if the object was allocated meanwhile, the link is garbage but the head changed and the exchange fails
+        const uint32_t next = __atomic_load_n(slot, __ATOMIC_RELAXED) & HEAP_POOL_LINK_MASK;
+        new_head = ((head + HEAP_POOL_TAG_ONE) & ~HEAP_POOL_LINK_MASK) | next;
+    } while (!__atomic_compare_exchange_n(&pool->head, &head, new_head, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+    MULTI_HEAP_ASSERT((*slot & HEAP_POOL_SLOT_FREE_MASK) == HEAP_POOL_SLOT_FREE, slot);
+    MULTI_HEAP_ASSERT(heap_pool_check_slot(pool, slot, true), slot);
+    void *data = heap_pool_slot_data(slot);
+#ifdef MULTI_HEAP_POISONING_SLOW
+    for (size_t i = 0; i < pool->obj_size; i++) {
+        // a free object was written to
+        MULTI_HEAP_ASSERT(((uint8_t *)data)[i] == HEAP_POOL_FREE_FILL, (uint8_t *)data + i);
+    }
+    memset(data, HEAP_POOL_MALLOC_FILL, pool->obj_size);
+#endif
+    __atomic_store_n(slot, HEAP_POOL_SLOT_USED, __ATOMIC_RELAXED);
+
+    const uint32_t free_count = __atomic_sub_fetch(&pool->free_count, 1, __ATOMIC_RELAXED);
+    uint32_t min_free_count = __atomic_load_n(&pool->min_free_count, __ATOMIC_RELAXED);
+    while (free_count < min_free_count
+            && !__atomic_compare_exchange_n(&pool->min_free_count, &min_free_count, free_count, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return data;
+}
+
+static inline void heap_pool_free(heap_pool_t *pool, void *data)
+{
+    const size_t index = heap_pool_index(pool, data);
+    assert(index != HEAP_POOL_MAX_OBJECTS && "free() target pointer is not an object of the pool");
+    uint32_t *slot = heap_pool_slot(pool, index);
+    assert((*slot & HEAP_POOL_SLOT_FREE_MASK) != HEAP_POOL_SLOT_FREE && "free() target pointer is already free");
+    MULTI_HEAP_ASSERT(*slot == HEAP_POOL_SLOT_USED, slot);
+    MULTI_HEAP_ASSERT(heap_pool_check_slot(pool, slot, true), slot);
+#ifdef MULTI_HEAP_POISONING_SLOW
+    memset(data, HEAP_POOL_FREE_FILL, pool->obj_size);
+#endif
+
+    // counted before it can be allocated again, so that free_count doesn't wrap around
+    __atomic_add_fetch(&pool->free_count, 1, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+    uint32_t new_head;
+    do {
+        __atomic_store_n(slot, HEAP_POOL_SLOT_FREE | (head & HEAP_POOL_LINK_MASK), __ATOMIC_RELAXED);
+        new_head = ((head + HEAP_POOL_TAG_ONE) & ~HEAP_POOL_LINK_MASK) | (uint32_t)(index + 1);
+    } while (!__atomic_compare_exchange_n(&pool->head, &head, new_head, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static inline bool heap_pool_is_used(const heap_pool_t *pool, size_t index)
+{
+    return __atomic_load_n(heap_pool_slot(pool, index), __ATOMIC_RELAXED) == HEAP_POOL_SLOT_USED;
+}
+
+#ifdef __cplusplus
+}
+#endif
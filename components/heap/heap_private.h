@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -9,9 +9,11 @@
 #include <stdint.h>
 #include <soc/soc_memory_layout.h>
 #include "multi_heap.h"
+#include "esp_heap_caps.h"
 #include "multi_heap_platform.h"
 #include "sys/queue.h"
 #include "esp_attr.h"
+#include "heap_region_index.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +29,7 @@ extern "C" {
 typedef struct heap_t_ {
 #if CONFIG_HEAP_TASK_TRACKING
     const char *name;
+    size_t index; ///< Index of the heap in the per-task statistics
 #endif // CONFIG_HEAP_TASK_TRACKING
     uint32_t caps[SOC_MEMORY_TYPE_NO_PRIOS]; ///< Capabilities for the type of memory in this heap (as a prioritised set). Copied from soc_memory_types so it's in RAM not flash.
     intptr_t start;
@@ -44,6 +47,22 @@ typedef struct heap_t_ {
 */
 extern SLIST_HEAD(registered_heap_ll, heap_t_) registered_heaps;
 
+/* Index of the heaps registered by heap_caps_init(), sorted by start address.
+
+   These heaps don't overlap and don't change once heap_caps_init() returns, so the
+   index is searched without locking. The heaps added later by
+   heap_caps_add_region_with_caps() are not in the index: they are inserted at the
+   head of registered_heaps, before all the heaps of 'array'.
+*/
+typedef struct {
+    heap_t *array;          ///< Heaps registered by heap_caps_init()
+    size_t count;           ///< Number of heaps in 'array'
+    intptr_t *starts;       ///< Start addresses of the heaps, in ascending order
+    heap_t **heaps;         ///< Heap starting at each address of 'starts'
+} heap_index_t;
+
+extern heap_index_t registered_heaps_index;
+
 bool heap_caps_match(const heap_t *heap, uint32_t caps);
 
 FORCE_INLINE_ATTR uint32_t get_ored_caps(const uint32_t caps[SOC_MEMORY_TYPE_NO_PRIOS])
@@ -73,15 +92,71 @@ FORCE_INLINE_ATTR uint32_t get_all_caps(const heap_t *heap)
 FORCE_INLINE_ATTR heap_t *find_containing_heap(void *ptr )
 {
     intptr_t p = (intptr_t)ptr;
+    const heap_index_t *index = &registered_heaps_index;
     heap_t *heap;
+    /* The heaps added at runtime come first, they may be nested in a heap of the index */
     SLIST_FOREACH(heap, &registered_heaps, next) {
+        if (heap >= index->array && heap < index->array + index->count) {
+            break;
+        }
         if (heap->heap != NULL && p >= heap->start && p < heap->end) {
             return heap;
         }
     }
+    size_t i = heap_region_index_search(index->starts, index->count, p);
+    if (i == 0) {
+        return NULL;
+    }
+    heap = index->heaps[i - 1];
+    if (heap->heap != NULL && p < heap->end) {
+        return heap;
+    }
     return NULL;
 }
 
+#if CONFIG_HEAP_CORE_CACHE
+/* Per-core cache of free small blocks, see heap_caps_cache.c */
+
+/* Allocate a block from the cache of the current core, or NULL if the request can't
+   be served by the cache (too big, other capabilities, or no memory to refill it) */
+void *heap_caps_cache_malloc(size_t size, uint32_t caps);
+
+/* Keep a freed block in the cache of the current core, returns false if the block
+   isn't cached and must be given back to its heap */
+bool heap_caps_cache_free(heap_t *heap, void *block);
+
+/* Give back the blocks of all caches to their heaps, returns true if there were any */
+bool heap_caps_cache_flush(void);
+
+/* Check that the blocks of all caches are valid heap blocks */
+bool heap_caps_cache_check(bool print_errors);
+#else
+static inline bool heap_caps_cache_flush(void)
+{
+    return false;
+}
+
+static inline bool heap_caps_cache_check(bool print_errors)
+{
+    (void)print_errors;
+    return true;
+}
+#endif // CONFIG_HEAP_CORE_CACHE
+
+/* Pools of fixed-size objects, see heap_caps_pool.c */
+
+/* Print the statistics of the pools whose memory has the given capabilities */
+void heap_caps_pools_print_info(uint32_t caps);
+
+/* Check the objects of the pools whose memory has the given capabilities */
+bool heap_caps_pools_check(uint32_t caps, bool print_errors);
+
+/* If the heap block described by block_info holds a chunk of a pool, call walker_func for
+   the objects of the chunk rather than for the block, and return true. '*walk_on' is then
+   set to the result of the last call of walker_func. */
+bool heap_caps_pools_walk_block(walker_heap_into_t heap_info, walker_block_info_t block_info,
+                                heap_caps_walker_cb_t walker_func, void *user_data, bool *walk_on);
+
 /*
  Because we don't want to add _another_ known allocation method to the stack of functions to trace wrt memory tracing,
  these are declared private. The libc malloc()/realloc() implementation also calls these, so they are declared
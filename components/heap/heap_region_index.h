@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Search in an array of region start addresses, sorted in ascending order.
+
+   Returns the number of regions starting at or below 'addr', so the region which
+   may contain 'addr' is at index (result - 1), and no region contains it if the
+   result is 0.
+
+   The loop runs log2(count) times whatever the address, and the only branch in it
+   is the loop condition (the comparison compiles to a conditional move), so the
+   cost of a lookup doesn't depend on where the address is.
+*/
+static inline size_t heap_region_index_search(const intptr_t *starts, size_t count, intptr_t addr)
+{
+    if (count == 0) {
+        return 0;
+    }
+    const intptr_t *base = starts;
+    size_t n = count;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = (base[half] <= addr) ? base + half : base;
+        n -= half;
+    }
+    return (size_t)(base - starts) + (*base <= addr);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -8,6 +8,7 @@
 #include <inttypes.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
 #include <multi_heap.h>
 #include "multi_heap_internal.h"
 #include "heap_private.h"
@@ -18,39 +19,71 @@
 
 #ifdef CONFIG_HEAP_TASK_TRACKING
 
-const static char *TAG = "heap_task_tracking";
-
-static SemaphoreHandle_t s_task_tracking_mutex = NULL;
-static StaticSemaphore_t s_task_tracking_mutex_buf;
-
+/* Index of the thread local storage pointer of the statistics of a task. The last one is taken,
+ * so the low indexes stay available to the application. Kconfig makes
+ * CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS at least 2 when task tracking is enabled, so
+ * it is never index 0 used by pthread */
+#define HEAP_TASK_TRACKING_TLS_INDEX (configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1)
+
+/* The statistics of a task are kept in a task_info_t. The task finds it through one of
+ * its thread local storage pointers when it allocates memory, and the block owner word
+ * at the start of each block points to the task_info_t of the task which allocated the
+ * block, so any task freeing the block finds it too. The statistics of a task on each
+ * heap are in an array indexed by the index of the heap. Allocating or freeing memory
+ * thus updates the statistics in constant time, in a short critical section.
+ *
+ * The allocations of a task aren't listed: the functions returning them walk the heaps
+ * and select the blocks owned by the task.
+ *
+ * A task_info_t is created at the first allocation of the task, and marked as deleted by
+ * the deletion callback of the thread local storage pointer. Unless deleted tasks are
+ * tracked, it is removed from the list of tasks then, and freed with the last block the
+ * task allocated.
+ */
 
-typedef struct alloc_stats {
-    heap_task_block_t alloc_stat;
-    STAILQ_ENTRY(alloc_stats) next_alloc_stat;
-} alloc_stats_t;
+const static char *TAG = "heap_task_tracking";
 
 /**
- * @brief Internal singly linked list used to gather information of the heap used
- * by a given task.
+ * @brief Statistics of a task on a heap, the heap is unused by the task if heap_stat.size is 0.
  */
-typedef struct heap_stats {
-    multi_heap_handle_t heap;
+typedef struct {
     heap_stat_t heap_stat;
-    STAILQ_HEAD(alloc_stats_ll, alloc_stats) allocs_stats;
-    STAILQ_ENTRY(heap_stats) next_heap_stat;
+    heap_stat_t *query_stat; ///< Statistics returned by the running query, receiving the allocations of the task
+    size_t query_alloc_left; ///< Number of entries of query_stat->alloc_stat not filled yet
 } heap_stats_t;
 
-/** @brief Internal singly linked list used to gather information on all created
- * tasks since startup.
+/**
+ * @brief Statistics of a task.
  */
-typedef struct task_stats {
+typedef struct task_info {
+    struct task_info *self; ///< Points to itself while valid, to recognize the block owners when walking the heaps
     task_stat_t task_stat;
-    STAILQ_HEAD(heap_stats_ll, heap_stats) heaps_stats;
-    SLIST_ENTRY(task_stats) next_task_info;
+    size_t block_count; ///< Number of blocks owned by the task, in all heaps
+    bool listed; ///< True if the task is in task_stats
+    size_t heap_stats_count; ///< Number of entries of heap_stats
+    heap_stats_t *heap_stats; ///< Statistics of the task on each heap, indexed by heap_t::index
+    LIST_ENTRY(task_info) next_task_info;
 } task_info_t;
 
+/* Protects the statistics, the block owners and the list of tasks */
+static multi_heap_lock_t s_task_tracking_lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER;
+
+/* Serializes the functions returning the allocations, which fill the query fields */
+static SemaphoreHandle_t s_query_mutex = NULL;
+
+/* Tasks which allocated memory since startup, the most recent first */
+static LIST_HEAD(task_stats_ll, task_info) task_stats = LIST_HEAD_INITIALIZER(task_stats);
 
-static SLIST_HEAD(task_stats_ll, task_stats) task_stats = SLIST_HEAD_INITIALIZER(task_stats);
+/* Owner of the blocks allocated before the scheduler started */
+static task_info_t s_prescheduler_task_info = {
+    .self = &s_prescheduler_task_info,
+    .task_stat = {
+        .name = "Pre-scheduler",
+        .is_alive = true,
+    },
+};
+
+static size_t s_heap_count = 0;
 
 FORCE_INLINE_ATTR heap_t* find_biggest_heap(void)
 {
@@ -73,403 +106,416 @@ FORCE_INLINE_ATTR heap_t* find_biggest_heap(void)
 }
 
 /**
- * @brief Create a new alloc stats entry object
+ * @brief Allocate memory for the statistics from the biggest heap, without accounting it.
+ *
+ * The block has a block owner word like the other blocks, set to NULL, so that the
+ * owner of any block can be read when walking the heaps.
  *
- * @param heap_stats The heap statistics of the heap used for the allocation
- * @param task_handle The task handler of the task which performed the allocation
- * @param ptr The address of the allocation
- * @param size The size of the allocation
+ * @param size The size of the memory to allocate
+ * @return The allocated memory, or NULL
  */
-static HEAP_IRAM_ATTR void create_new_alloc_stats_entry(heap_stats_t *heap_stats, alloc_stats_t *alloc_stats, TaskHandle_t task_handle, void *ptr, size_t size)
+static HEAP_IRAM_ATTR void *task_tracking_malloc(size_t size)
 {
-    // init the list of allocs with a new entry in heap_stats->allocs_stats. No need
-    // to memset the memory since all field will be set later in the function.
-    if (!alloc_stats) {
-        // find the heap with the most available free memory to store the statistics
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-
-        alloc_stats = multi_heap_malloc(heap_used_for_alloc->heap, sizeof(alloc_stats_t));
-        if (!alloc_stats) {
-            ESP_LOGE(TAG, "Could not allocate memory to add new task statistics");
-            return;
-        }
+    heap_t *heap_used_for_alloc = find_biggest_heap();
+    void *block = multi_heap_malloc(heap_used_for_alloc->heap, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size));
+    if (block == NULL) {
+        return NULL;
     }
+    MULTI_HEAP_SET_BLOCK_OWNER(block, NULL);
+    return MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(block);
+}
 
-    alloc_stats->alloc_stat.task = task_handle;
-    alloc_stats->alloc_stat.address = ptr;
-    alloc_stats->alloc_stat.size = size;
+static HEAP_IRAM_ATTR void task_tracking_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    void *block = MULTI_HEAP_REMOVE_BLOCK_OWNER_OFFSET(ptr);
+    heap_t *containing_heap = find_containing_heap(block);
+    assert(containing_heap != NULL);
+    multi_heap_free(containing_heap->heap, block);
+}
 
-    STAILQ_INSERT_TAIL(&heap_stats->allocs_stats, alloc_stats, next_alloc_stat);
+static HEAP_IRAM_ATTR void free_task_info(task_info_t *task_info)
+{
+    task_tracking_free(task_info->heap_stats);
+    task_tracking_free(task_info);
 }
 
 /**
- * @brief Create a new heap stats entry object
+ * @brief Check that a block owner read when walking a heap is a valid task_info_t.
  *
- * @param task_stats The task statistics of the task that triggered the allocation
- * @param used_heap Information about the heap used for the allocation
- * @param caps The caps of the heap used for the allocation
- * @param size The size of the allocation
+ * The owner of a block just allocated is only set after the heap lock is released, so
+ * the word read can still be a stale value. Must be called with s_task_tracking_lock held.
  */
-static HEAP_IRAM_ATTR void create_new_heap_stats_entry(task_info_t *task_stats, heap_t *used_heap, void *ptr, uint32_t caps, size_t size)
+static bool is_valid_owner(task_info_t *task_info)
 {
-    // find the heap with the most available free memory to store the statistics
-    heap_t *heap_used_for_alloc = find_biggest_heap();
-
-    // init the list of heap with a new entry in task_stats->heaps_stats. No need
-    // to memset the memory since all field will be set later in the function.
-    heap_stats_t *heap_stats = multi_heap_malloc(heap_used_for_alloc->heap, sizeof(heap_stats_t));
-    if (!heap_stats) {
-        ESP_LOGE(TAG, "Could not allocate memory to add new task statistics");
-        return;
+    if (task_info == NULL || ((intptr_t)task_info & (sizeof(void *) - 1)) != 0) {
+        return false;
     }
+    if (task_info != &s_prescheduler_task_info && find_containing_heap(task_info) == NULL) {
+        return false;
+    }
+    return task_info->self == task_info;
+}
 
-    // create the alloc stats for the new heap entry
-    STAILQ_INIT(&heap_stats->allocs_stats);
-
-    task_stats->task_stat.heap_count += 1;
-
-    heap_stats->heap = used_heap->heap;
-    heap_stats->heap_stat.name = used_heap->name;
-    heap_stats->heap_stat.size = used_heap->end - used_heap->start;
-    heap_stats->heap_stat.caps = caps;
-    heap_stats->heap_stat.current_usage = size;
-    heap_stats->heap_stat.peak_usage = size;
-    heap_stats->heap_stat.alloc_count = 1;
-    heap_stats->heap_stat.alloc_stat = NULL; // this will be used to point at the user defined array of alloc_stat
+/**
+ * @brief Deletion callback of the thread local storage pointer, called when the task is deleted.
+ */
+static void task_deleted_cb(int index, void *pvalue)
+{
+    (void)index;
+    task_info_t *task_info = pvalue;
+    bool free_info = false;
 
-    STAILQ_INSERT_TAIL(&task_stats->heaps_stats, heap_stats, next_heap_stat);
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    task_info->task_stat.is_alive = false;
+#if !CONFIG_HEAP_TRACK_DELETED_TASKS
+    // the statistics of the task are not reported anymore, they are freed with the last
+    // block allocated by the task
+    LIST_REMOVE(task_info, next_task_info);
+    task_info->listed = false;
+    if (task_info->block_count == 0) {
+        task_info->self = NULL;
+        free_info = true;
+    }
+#endif // !CONFIG_HEAP_TRACK_DELETED_TASKS
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-    create_new_alloc_stats_entry(heap_stats, NULL, task_stats->task_stat.handle, ptr, size);
+    if (free_info) {
+        free_task_info(task_info);
+    }
 }
 
 /**
- * @brief Create a new task info entry in task_stats if the tasks allocating memory is not in task_stats already.
+ * @brief Get the statistics of the current task, create them at the first allocation of the task.
  *
- * @param heap The heap by the task to allocate memory
- * @param task_handle The task handle of the task allocating memory
- * @param task_stats The task entry in task_stats. If NULL, the task allocating memory is allocating for the first time
- * @param ptr The address of the allocation
- * @param size The size of the allocation
- * @param caps The ORED caps of the heap used for the allocation
+ * @return The statistics of the current task, or NULL if they can't be allocated
  */
-static HEAP_IRAM_ATTR void create_new_task_stats_entry(heap_t *used_heap, TaskHandle_t task_handle, task_info_t *task_info, void *ptr, size_t size, uint32_t caps)
-{
-    // If task_info passed as parameter is NULL, it means the this task is doing
-    // its first allocation. Add the task entry to task_info and add heap_stats
-    // to this new task_info entry.
-    // If task_info is not NULL, it means that the task already allocated memory
-    // but now it is allocating in a new heap for the first time. Don't add a new
-    // task entry to task_info but add a new heap_stats to the task_info
-    if (!task_info) {
-        // find the heap with the most available free memory to store the statistics
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-
-        // create the task_stats entry. No need to memset since all fields are set later
-        task_info = multi_heap_malloc(heap_used_for_alloc->heap, sizeof(task_info_t));
-        if (!task_info) {
-            ESP_LOGE(TAG, "Could not allocate memory to add new task statistics");
-            return;
-        }
+static HEAP_IRAM_ATTR task_info_t *get_current_task_info(void)
+{
+    TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
+    task_info_t *task_info = NULL;
 
-        // create the heap stats for the new task entry
-        STAILQ_INIT(&task_info->heaps_stats);
+    if (task_handle == NULL) {
+        task_info = &s_prescheduler_task_info;
+    } else {
+        task_info = pvTaskGetThreadLocalStoragePointer(NULL, HEAP_TASK_TRACKING_TLS_INDEX);
+        if (task_info != NULL) {
+            return task_info;
+        }
 
+        task_info = task_tracking_malloc(sizeof(task_info_t));
+        if (task_info == NULL) {
+            ESP_LOGE(TAG, "Could not allocate memory to add new task statistics");
+            return NULL;
+        }
+        memset(task_info, 0, sizeof(task_info_t));
+        task_info->self = task_info;
         task_info->task_stat.handle = task_handle;
         task_info->task_stat.is_alive = true;
-        task_info->task_stat.overall_peak_usage = size;
-        task_info->task_stat.overall_current_usage = size;
-        task_info->task_stat.heap_count = 0;
-        task_info->task_stat.heap_stat = NULL; // this will be used to point at the user defined array of heap_stat
-        if (task_handle == 0x00) {
-            char task_name[] = "Pre-scheduler";
-            strcpy(task_info->task_stat.name, task_name);
-        } else {
-            strcpy(task_info->task_stat.name, pcTaskGetName(task_handle));
-        }
+        strcpy(task_info->task_stat.name, pcTaskGetName(NULL));
 
-        // Add the new / first task_info in the list (sorted by decreasing address).
-        // The decreasing order is chosen because the task_handle 0x00000000 is used for pre-scheduler
-        // operations and therefore need to appear last so it is not parsed when trying to find a suitable
-        // task to update the stats from.
-        if (SLIST_EMPTY(&task_stats) || task_info->task_stat.handle >= SLIST_FIRST(&task_stats)->task_stat.handle) {
-            // the list is empty, or the new task handler is at a higher address than the one from the first item
-            SLIST_INSERT_HEAD(&task_stats, task_info, next_task_info);
-        } else {
-            // the new task handle is at a lower address than the first item in the list, go through the list to
-            // properly insert the new item
-            task_info_t *cur_task_info = NULL;
-            task_info_t *prev_task_info = NULL;
-            SLIST_FOREACH(cur_task_info, &task_stats, next_task_info) {
-                if (cur_task_info->task_stat.handle < task_info->task_stat.handle) {
-                    SLIST_INSERT_AFTER(prev_task_info, task_info, next_task_info);
-                    break;
-                } else {
-                    prev_task_info = cur_task_info;
-                }
-            }
-            // here should be a last case handling: new task info as a task handle address smaller than all existing
-            // items in the list. But this is case is impossible given that the pre-scheduler allocations always
-            // happen first and the task handle defaults to 0x00000000 for the pre-scheduler so it will always be
-            // last in the list.
-        }
+        vTaskSetThreadLocalStoragePointerAndDelCallback(NULL, HEAP_TASK_TRACKING_TLS_INDEX, task_info, task_deleted_cb);
     }
 
-    create_new_heap_stats_entry(task_info, used_heap, ptr, caps, size);
+    if (!task_info->listed) {
+        MULTI_HEAP_LOCK(&s_task_tracking_lock);
+        LIST_INSERT_HEAD(&task_stats, task_info, next_task_info);
+        task_info->listed = true;
+        MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
+    }
+    return task_info;
 }
 
-#if !CONFIG_HEAP_TRACK_DELETED_TASKS
 /**
- * @brief Delete an entry from the list of task statistics
+ * @brief Make sure the statistics of a task have an entry for a heap.
  *
- * @param task_info The task statistics to delete from the list of task statistics
+ * Only called by the task owning the statistics, so only one task can grow the array.
+ *
+ * @param task_info The statistics of the current task
+ * @param heap_index The index of the heap used for the allocation
+ * @return True if the entry exists, false if the array can't be grown
  */
-static HEAP_IRAM_ATTR void delete_task_info_entry(task_info_t *task_info)
+static HEAP_IRAM_ATTR bool reserve_heap_stats(task_info_t *task_info, size_t heap_index)
 {
-    if (task_info == NULL) {
-        return;
+    const size_t old_count = task_info->heap_stats_count;
+    if (heap_index < old_count) {
+        return true;
     }
 
-    heap_stats_t *current_heap_stat = STAILQ_FIRST(&task_info->heaps_stats);
-    heap_stats_t *prev_heap_stat = NULL;
+    // make room for all the heaps registered so far, so it is rarely done again
+    const size_t new_count = __atomic_load_n(&s_heap_count, __ATOMIC_RELAXED);
+    assert(heap_index < new_count);
+    heap_stats_t *heap_stats = task_tracking_malloc(new_count * sizeof(heap_stats_t));
+    if (heap_stats == NULL) {
+        ESP_LOGE(TAG, "Could not allocate memory to add new task statistics");
+        return false;
+    }
+    memset(heap_stats + old_count, 0, (new_count - old_count) * sizeof(heap_stats_t));
 
-    // pointer used to free the memory of the statistics
-    heap_t *containing_heap = NULL;
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    heap_stats_t *old_heap_stats = task_info->heap_stats;
+    if (old_count != 0) {
+        memcpy(heap_stats, old_heap_stats, old_count * sizeof(heap_stats_t));
+    }
+    task_info->heap_stats = heap_stats;
+    task_info->heap_stats_count = new_count;
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-    // remove all entries from task_info->heaps_stats and free the memory
-    while(current_heap_stat != NULL) {
-        prev_heap_stat = current_heap_stat;
-        current_heap_stat = STAILQ_NEXT(current_heap_stat, next_heap_stat);
+    task_tracking_free(old_heap_stats);
+    return true;
+}
 
-        /* remove all entries from heap_stats->allocs_stats */
-        alloc_stats_t *alloc_stat = NULL;
-        while ((alloc_stat = STAILQ_FIRST( &prev_heap_stat->allocs_stats)) != NULL) {
-            STAILQ_REMOVE(&prev_heap_stat->allocs_stats, alloc_stat, alloc_stats, next_alloc_stat);
-            containing_heap = find_containing_heap(alloc_stat);
-            // prev_heap_stat must be allocated somewhere
-            if (containing_heap != NULL) {
-                multi_heap_free(containing_heap->heap, alloc_stat);
-            }
-        }
-        if (STAILQ_EMPTY(&prev_heap_stat->allocs_stats)) {
-            STAILQ_REMOVE(&task_info->heaps_stats, prev_heap_stat, heap_stats, next_heap_stat);
-            containing_heap = find_containing_heap(prev_heap_stat);
-            // prev_heap_stat must be allocated somewhere
-            if (containing_heap != NULL) {
-                multi_heap_free(containing_heap->heap, prev_heap_stat);
-            }
-        }
+/**
+ * @brief Account a block to a task and set the task as its owner. Called with s_task_tracking_lock held.
+ */
+static HEAP_IRAM_ATTR void account_alloc(task_info_t *task_info, heap_t *heap, void *block, size_t size, uint32_t caps)
+{
+    heap_stat_t *heap_stat = &task_info->heap_stats[heap->index].heap_stat;
+    if (heap_stat->size == 0) {
+        // first allocation of the task in this heap
+        heap_stat->name = heap->name;
+        heap_stat->size = heap->end - heap->start;
+        heap_stat->caps = caps;
+        task_info->task_stat.heap_count += 1;
     }
-    if (STAILQ_EMPTY(&task_info->heaps_stats)) {
-        // remove task_info from task_stats (and free the memory)
-        SLIST_REMOVE(&task_stats, task_info, task_stats, next_task_info);
-        containing_heap = find_containing_heap(task_info);
-        if (containing_heap != NULL) {
-            multi_heap_free(containing_heap->heap, task_info);
-        }
+
+    heap_stat->current_usage += size;
+    heap_stat->alloc_count++;
+    if (heap_stat->current_usage > heap_stat->peak_usage) {
+        heap_stat->peak_usage = heap_stat->current_usage;
+    }
+
+    task_info->task_stat.overall_current_usage += size;
+    if (task_info->task_stat.overall_current_usage > task_info->task_stat.overall_peak_usage) {
+        task_info->task_stat.overall_peak_usage = task_info->task_stat.overall_current_usage;
     }
+    task_info->block_count++;
+
+    MULTI_HEAP_SET_BLOCK_OWNER(block, task_info);
 }
-#endif // !CONFIG_HEAP_TRACK_DELETED_TASKS
 
-HEAP_IRAM_ATTR void heap_caps_update_per_task_info_alloc(heap_t *heap, void *ptr, size_t size, uint32_t caps)
+/**
+ * @brief Remove a block from the statistics of its owner. Called with s_task_tracking_lock held.
+ *
+ * @return True if the statistics of the owner must be freed (deleted task not listed anymore,
+ * whose last block was freed)
+ */
+static HEAP_IRAM_ATTR bool account_free(task_info_t *task_info, heap_t *heap, size_t size)
 {
-    if (s_task_tracking_mutex == NULL) {
-        s_task_tracking_mutex = xSemaphoreCreateMutexStatic(&s_task_tracking_mutex_buf);
-        assert(s_task_tracking_mutex);
-    }
+    heap_stat_t *heap_stat = &task_info->heap_stats[heap->index].heap_stat;
+    heap_stat->current_usage -= size;
+    heap_stat->alloc_count--;
+    task_info->task_stat.overall_current_usage -= size;
+    task_info->block_count--;
 
-    TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
-    task_info_t *task_info = NULL;
+    if (!task_info->listed && task_info->block_count == 0) {
+        task_info->self = NULL;
+        return true;
+    }
+    return false;
+}
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    /* find the task in the list and update the overall stats */
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        if (task_info->task_stat.handle == task_handle && task_info->task_stat.is_alive) {
-            task_info->task_stat.overall_current_usage += size;
-            if (task_info->task_stat.overall_current_usage > task_info->task_stat.overall_peak_usage) {
-                task_info->task_stat.overall_peak_usage = task_info->task_stat.overall_current_usage;
-            }
+void heap_caps_task_tracking_register_heap(heap_t *heap)
+{
+    heap->index = __atomic_fetch_add(&s_heap_count, 1, __ATOMIC_RELAXED);
+}
 
-            heap_stats_t *heap_stats = NULL;
-            /* find the heap in the list and update the overall stats */
-            STAILQ_FOREACH(heap_stats, &task_info->heaps_stats, next_heap_stat) {
-                if (heap_stats->heap == heap->heap) {
-                    heap_stats->heap_stat.current_usage += size;
-                    heap_stats->heap_stat.alloc_count++;
-                    if (heap_stats->heap_stat.current_usage > heap_stats->heap_stat.peak_usage) {
-                        heap_stats->heap_stat.peak_usage = heap_stats->heap_stat.current_usage;
-                    }
+HEAP_IRAM_ATTR void heap_caps_update_per_task_info_alloc(heap_t *heap, void *block, size_t size, uint32_t caps)
+{
+    task_info_t *task_info = get_current_task_info();
+    if (task_info == NULL || !reserve_heap_stats(task_info, heap->index)) {
+        // the block is not accounted to any task
+        MULTI_HEAP_SET_BLOCK_OWNER(block, NULL);
+        return;
+    }
 
-                    /* add the alloc info to the list */
-                    create_new_alloc_stats_entry(heap_stats, NULL, task_handle, ptr, size);
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    account_alloc(task_info, heap, block, size, caps);
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
+}
 
-                    xSemaphoreGive(s_task_tracking_mutex);
-                    return;
-                }
-            }
-            break;
-        }
+HEAP_IRAM_ATTR void heap_caps_update_per_task_info_realloc(heap_t *heap, void *old_owner, size_t old_size,
+                                                           void *new_block, size_t new_size, uint32_t caps)
+{
+    // the reallocated block belongs to the task calling realloc
+    task_info_t *task_info = get_current_task_info();
+    const bool accounted = task_info != NULL && reserve_heap_stats(task_info, heap->index);
+    bool free_old_owner = false;
 
-        // since the list of task info is sorted by decreasing size, if the current task info
-        // has a smaller task handle address than the one we are checking against, we can be sure
-        // the task handle will not be found in the list, and we can break the loop.
-        if (task_info->task_stat.handle < task_handle) {
-            task_info = NULL;
-            break;
-        }
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    if (old_owner != NULL) {
+        free_old_owner = account_free(old_owner, heap, old_size);
     }
+    if (accounted) {
+        account_alloc(task_info, heap, new_block, new_size, caps);
+    } else {
+        MULTI_HEAP_SET_BLOCK_OWNER(new_block, NULL);
+    }
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-    // No task entry was found OR no heap in the task entry was found.
-    // Add the info to the list (either new task stats or new heap stat if task_info not NULL)
-    create_new_task_stats_entry(heap, task_handle, task_info, ptr, size, caps);
-
-    xSemaphoreGive(s_task_tracking_mutex);
+    if (free_old_owner) {
+        free_task_info(old_owner);
+    }
 }
 
-HEAP_IRAM_ATTR void heap_caps_update_per_task_info_realloc(heap_t *heap, void *old_ptr, void *new_ptr,
-                                                           size_t old_size, TaskHandle_t old_task,
-                                                           size_t new_size, uint32_t caps)
+HEAP_IRAM_ATTR void heap_caps_update_per_task_info_free(heap_t *heap, void *block)
 {
-    TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
-    bool task_in_list = false;
-    task_info_t *task_info = NULL;
-    alloc_stats_t *alloc_stat = NULL;
-
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        if (task_info->task_stat.handle == old_task) {
-            heap_stats_t *heap_stats = NULL;
-            STAILQ_FOREACH(heap_stats, &task_info->heaps_stats, next_heap_stat) {
-                if (heap_stats->heap == heap->heap) {
-
-                    /* remove the alloc from the list. The updated alloc stats are added later
-                     * in the function */
-                    alloc_stat = NULL;
-                    STAILQ_FOREACH(alloc_stat, &heap_stats->allocs_stats, next_alloc_stat) {
-                        if (alloc_stat->alloc_stat.address == old_ptr) {
-                            STAILQ_REMOVE(&heap_stats->allocs_stats, alloc_stat, alloc_stats, next_alloc_stat);
-                            /* keep the memory used to store alloc_stat since we will fill it with new alloc
-                                * info later in the function */
-                            break;
-                        }
-                    }
+    task_info_t *task_info = MULTI_HEAP_GET_BLOCK_OWNER(block);
+    if (task_info == NULL) {
+        return;
+    }
+    const size_t size = multi_heap_get_full_block_size(heap->heap, block);
 
-                    if (alloc_stat != NULL) {
-                        heap_stats->heap_stat.current_usage -= old_size;
-                        heap_stats->heap_stat.alloc_count--;
-                        task_info->task_stat.overall_current_usage -= old_size;
-                    }
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    const bool free_info = account_free(task_info, heap, size);
+    MULTI_HEAP_SET_BLOCK_OWNER(block, NULL);
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-                    break;
-                }
-            }
+    if (free_info) {
+        free_task_info(task_info);
+    }
+}
+
+static void query_lock(void)
+{
+    SemaphoreHandle_t mutex = __atomic_load_n(&s_query_mutex, __ATOMIC_ACQUIRE);
+    if (mutex == NULL) {
+        // Created by the first query. Queries starting concurrently each create one, only the first one stored is kept
+        SemaphoreHandle_t created = xSemaphoreCreateMutex();
+        assert(created);
+        if (__atomic_compare_exchange_n(&s_query_mutex, &mutex, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            mutex = created;
+        } else {
+            vSemaphoreDelete(created);
         }
+    }
+    xSemaphoreTake(mutex, portMAX_DELAY);
+}
 
-        if (task_info->task_stat.handle == task_handle && task_info->task_stat.is_alive) {
-            heap_stats_t *heap_stats = NULL;
-            task_info->task_stat.overall_current_usage += new_size;
-            STAILQ_FOREACH(heap_stats, &task_info->heaps_stats, next_heap_stat) {
-                if (heap_stats->heap == heap->heap) {
-                    heap_stats->heap_stat.current_usage  += new_size;
-                    heap_stats->heap_stat.alloc_count++;
-                    if (heap_stats->heap_stat.current_usage > heap_stats->heap_stat.peak_usage) {
-                        heap_stats->heap_stat.peak_usage = heap_stats->heap_stat.current_usage;
-                    }
+static void query_unlock(void)
+{
+    xSemaphoreGive(s_query_mutex);
+}
 
-                    create_new_alloc_stats_entry(heap_stats, alloc_stat, task_handle, new_ptr, new_size);
-                    break;
-                }
+/**
+ * @brief Find the statistics of a task, prefer the alive task if the handle of a deleted task was reused.
+ * Called with s_task_tracking_lock held.
+ */
+static task_info_t *find_task_info(TaskHandle_t task_handle)
+{
+    task_info_t *task_info = NULL;
+    task_info_t *found = NULL;
+    LIST_FOREACH(task_info, &task_stats, next_task_info) {
+        if (task_info->task_stat.handle == task_handle) {
+            if (task_info->task_stat.is_alive) {
+                return task_info;
+            }
+            if (found == NULL) {
+                found = task_info;
             }
-            task_in_list = true;
         }
+    }
+    return found;
+}
 
-        if (task_info->task_stat.overall_current_usage > task_info->task_stat.overall_peak_usage) {
-            task_info->task_stat.overall_peak_usage = task_info->task_stat.overall_current_usage;
+/**
+ * @brief Copy the statistics of a task on each heap it used to a user defined array, and prepare
+ * the query of the allocations of the task, filled later by fill_queried_allocs().
+ * Called with s_task_tracking_lock held.
+ *
+ * If the number of entries remaining for the allocations is inferior to the number of allocations
+ * of the task on a heap, no allocation is returned for this heap.
+ *
+ * @param task_info The statistics of the task
+ * @param heap_stat The user defined array receiving the statistics of the heaps
+ * @param heap_count The number of entries of heap_stat
+ * @param alloc_stat The user defined array receiving the allocations
+ * @param alloc_count The number of entries of alloc_stat
+ * @param[out] heap_stat_used The number of entries of heap_stat used
+ * @return The number of entries of alloc_stat reserved for the allocations of the task
+ */
+static size_t prepare_task_query(task_info_t *task_info, heap_stat_t *heap_stat, size_t heap_count,
+                                 heap_task_block_t *alloc_stat, size_t alloc_count, size_t *heap_stat_used)
+{
+    size_t heap_index = 0;
+    size_t alloc_index = 0;
+    for (size_t i = 0; i < task_info->heap_stats_count && heap_index < heap_count; i++) {
+        heap_stats_t *heap_stats = &task_info->heap_stats[i];
+        if (heap_stats->heap_stat.size == 0) {
+            continue;
         }
-    }
 
-    if (!task_in_list) {
-        // No task entry was found OR no heap in the task entry was found.
-        // Add the info to the list (either new task stats or new heap stat if task_info not NULL)
-        create_new_task_stats_entry(heap, task_handle, task_info, new_ptr, new_size, caps);
+        heap_stat_t *current_heap_stat = heap_stat + heap_index;
+        memcpy(current_heap_stat, &heap_stats->heap_stat, sizeof(heap_stat_t));
+        heap_index++;
+
+        if (alloc_index + heap_stats->heap_stat.alloc_count > alloc_count) {
+            current_heap_stat->alloc_stat = NULL;
+        } else {
+            // set the pointer where the allocations on the given heap will be in the user array,
+            // they are counted again when walking the heap
+            current_heap_stat->alloc_stat = alloc_stat + alloc_index;
+            current_heap_stat->alloc_count = 0;
+            heap_stats->query_stat = current_heap_stat;
+            heap_stats->query_alloc_left = heap_stats->heap_stat.alloc_count;
+            alloc_index += heap_stats->heap_stat.alloc_count;
+        }
     }
 
-    xSemaphoreGive(s_task_tracking_mutex);
+    *heap_stat_used = heap_index;
+    return alloc_index;
 }
 
-HEAP_IRAM_ATTR void heap_caps_update_per_task_info_free(heap_t *heap, void *ptr)
+/**
+ * @brief Walk all heaps and fill the allocations of the tasks prepared by prepare_task_query(),
+ * then clear the query of all tasks.
+ */
+static void fill_queried_allocs(void)
 {
-    void *block_owner_ptr = MULTI_HEAP_REMOVE_BLOCK_OWNER_OFFSET(ptr);
-    TaskHandle_t task_handle = MULTI_HEAP_GET_BLOCK_OWNER(block_owner_ptr);
-    if (!task_handle) {
-        return;
-    }
-
-    task_info_t *task_info = NULL;
-#if !CONFIG_HEAP_TRACK_DELETED_TASKS
-    task_info_t *task_info_to_delete = NULL;
-#endif // !CONFIG_HEAP_TRACK_DELETED_TASKS
-
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    /* find the matching task */
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        /* check all tasks (alive and deleted) since the free can come from any tasks,
-         * not necessarily the one which allocated the memory. */
-        if (task_info->task_stat.handle == task_handle) {
-            heap_stats_t *heap_stats = NULL;
-            alloc_stats_t *alloc_stat = NULL;
-            /* find the matching heap */
-            STAILQ_FOREACH(heap_stats, &task_info->heaps_stats, next_heap_stat) {
-                if(heap_stats->heap == heap->heap) {
-                    /* find the matching allocation and remove it from the list*/
-                    STAILQ_FOREACH(alloc_stat, &heap_stats->allocs_stats, next_alloc_stat) {
-                        if (alloc_stat->alloc_stat.address == ptr) {
-                            STAILQ_REMOVE(&heap_stats->allocs_stats, alloc_stat, alloc_stats, next_alloc_stat);
-                            /* keep the memory used to store alloc_stat since we will fill it with new alloc
-                             * info later in the function */
-                            break;
-                        }
-                    }
-
-                    if (alloc_stat != NULL) {
-                        heap_stats->heap_stat.alloc_count--;
-                        heap_stats->heap_stat.current_usage -= alloc_stat->alloc_stat.size;
-                        task_info->task_stat.overall_current_usage -= alloc_stat->alloc_stat.size;
-                    }
+    heap_t *reg;
+    SLIST_FOREACH(reg, &registered_heaps, next) {
+        multi_heap_handle_t heap = reg->heap;
+        if (heap == NULL) {
+            continue;
+        }
 
-                    break;
-                }
+        multi_heap_internal_lock(heap);
+        multi_heap_block_handle_t b = multi_heap_get_first_block(heap);
+        for ( ; b ; b = multi_heap_get_next_block(heap, b)) {
+            if (multi_heap_is_free(b)) {
+                continue;
             }
+            void *p = multi_heap_get_block_address(b);  // Safe, only arithmetic
 
-            /* free the memory used to store alloc_stat */
-            heap_t *containing_heap = find_containing_heap(alloc_stat);
-            // task_stats must be allocated somewhere
-            if (containing_heap != NULL) {
-                multi_heap_free(containing_heap->heap, alloc_stat);
+            MULTI_HEAP_LOCK(&s_task_tracking_lock);
+            task_info_t *task_info = MULTI_HEAP_GET_BLOCK_OWNER(p);
+            if (is_valid_owner(task_info) && reg->index < task_info->heap_stats_count) {
+                heap_stats_t *heap_stats = &task_info->heap_stats[reg->index];
+                if (heap_stats->query_stat != NULL && heap_stats->query_alloc_left != 0) {
+                    heap_task_block_t *alloc_stat = &heap_stats->query_stat->alloc_stat[heap_stats->query_stat->alloc_count];
+                    alloc_stat->task = task_info->task_stat.handle;
+                    alloc_stat->address = MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(p);
+                    alloc_stat->size = multi_heap_get_full_block_size(heap, p);
+                    heap_stats->query_stat->alloc_count++;
+                    heap_stats->query_alloc_left--;
+                }
             }
+            MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
         }
-
-        // when a task is deleted, esp_caps_free is called to delete the TCB of the task from vTaskDelete.
-        // Try to make a TaskHandle out of ptr and compare it to the list of tasks in task_stats.
-        // If one task_info contains the newly made TaskHandle from ptr it means that esp_caps_free
-        // was indeed called from vTaskDelete. We can then update the task_stats by marking the corresponding
-        // task as deleted.
-        if (task_info->task_stat.handle == ptr) {
-            // we found the task info from the task that is being deleted.
-            task_info->task_stat.is_alive = false;
-#if !CONFIG_HEAP_TRACK_DELETED_TASKS
-            task_info_to_delete = task_info;
-#endif // !CONFIG_HEAP_TRACK_DELETED_TASKS
-        }
+        multi_heap_internal_unlock(heap);
     }
 
-#if !CONFIG_HEAP_TRACK_DELETED_TASKS
-    // remove the entry related to the task that was just deleted.
-    if (task_info_to_delete != NULL) {
-        delete_task_info_entry(task_info_to_delete);
+    task_info_t *task_info = NULL;
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    LIST_FOREACH(task_info, &task_stats, next_task_info) {
+        for (size_t i = 0; i < task_info->heap_stats_count; i++) {
+            task_info->heap_stats[i].query_stat = NULL;
+            task_info->heap_stats[i].query_alloc_left = 0;
+        }
     }
-#endif // !CONFIG_HEAP_TRACK_DELETED_TASKS
-
-    xSemaphoreGive(s_task_tracking_mutex);
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 }
 
 esp_err_t heap_caps_get_all_task_stat(heap_all_tasks_stat_t *tasks_stat)
@@ -486,8 +532,9 @@ esp_err_t heap_caps_get_all_task_stat(heap_all_tasks_stat_t *tasks_stat)
     size_t alloc_index = 0;
     task_info_t *task_info = NULL;
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
+    query_lock();
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    LIST_FOREACH(task_info, &task_stats, next_task_info) {
         // If there is no more task stat entries available in tasks_stat->stat_arr
         // break the loop and return the function.
         if (task_index >= tasks_stat->task_count) {
@@ -509,41 +556,15 @@ esp_err_t heap_caps_get_all_task_stat(heap_all_tasks_stat_t *tasks_stat)
         current_task_stat->heap_stat = tasks_stat->heap_stat_start + heap_index;
         heap_index += task_info->task_stat.heap_count;
 
-
-        // copy the stats of the different heaps the task has used and the different allocs
-        // allocated in those heaps. If the number of entries remaining for alloc stats is
-        // inferior to the number of allocs allocated on the current heap no alloc stat will
-        // be copied at all.
-        size_t h_index = 0;
-        heap_stats_t *heap_info = STAILQ_FIRST(&task_info->heaps_stats);
-        while(h_index < task_info->task_stat.heap_count || heap_info != NULL) {
-            // increase alloc_index before filling the alloc info of the given heap
-            // to avoid running out of alloc stat entry while doing it.
-            if (alloc_index + heap_info->heap_stat.alloc_count > tasks_stat->alloc_count) {
-                heap_info->heap_stat.alloc_stat = NULL;
-            } else {
-                // set the pointer where the alloc info for the given heap will
-                // be in the user array
-                heap_info->heap_stat.alloc_stat = tasks_stat->alloc_stat_start + alloc_index;
-                // fill the alloc array in heap_info by running through all blocks of a given heap
-                // and storing info about the blocks allocated by the given task
-                alloc_stats_t *alloc_stats = NULL;
-                size_t a_index = 0;
-                STAILQ_FOREACH(alloc_stats, &heap_info->allocs_stats, next_alloc_stat) {
-                    heap_info->heap_stat.alloc_stat[a_index] = alloc_stats->alloc_stat;
-                    a_index++;
-                }
-
-                alloc_index += heap_info->heap_stat.alloc_count;
-            }
-
-            memcpy(current_task_stat->heap_stat + h_index, &heap_info->heap_stat, sizeof(heap_stat_t));
-            h_index++;
-            heap_info = STAILQ_NEXT(heap_info, next_heap_stat);
-        }
+        size_t heap_stat_used;
+        alloc_index += prepare_task_query(task_info, current_task_stat->heap_stat, task_info->task_stat.heap_count,
+                                          tasks_stat->alloc_stat_start + alloc_index, tasks_stat->alloc_count - alloc_index,
+                                          &heap_stat_used);
     }
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-    xSemaphoreGive(s_task_tracking_mutex);
+    fill_queried_allocs();
+    query_unlock();
 
     tasks_stat->task_count = task_index;
     tasks_stat->heap_count = heap_index;
@@ -564,66 +585,31 @@ esp_err_t heap_caps_get_single_task_stat(heap_single_task_stat_t *task_stat, Tas
         task_handle = xTaskGetCurrentTaskHandle();
     }
 
-    task_info_t *task_info = NULL;
+    size_t heap_index = 0;
+    size_t alloc_index = 0;
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        if(task_info->task_stat.handle == task_handle) {
-            // copy the task_stat of the task itself
-            memcpy(&task_stat->stat, &task_info->task_stat, sizeof(task_stat_t));
-            break;
-        }
+    query_lock();
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    task_info_t *task_info = find_task_info(task_handle);
+    if (task_info != NULL) {
+        // copy the task_stat of the task itself
+        memcpy(&task_stat->stat, &task_info->task_stat, sizeof(task_stat_t));
+        task_stat->stat.heap_stat = task_stat->heap_stat_start;
+
+        // copy the stats of the different heaps the task has used, the blocks allocated
+        // in those heaps are filled when walking the heaps.
+        alloc_index = prepare_task_query(task_info, task_stat->heap_stat_start, task_stat->heap_count,
+                                         task_stat->alloc_stat_start, task_stat->alloc_count, &heap_index);
     }
-    xSemaphoreGive(s_task_tracking_mutex);
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
     if (task_info == NULL) {
+        query_unlock();
         return ESP_FAIL;
     }
 
-    task_stat->stat.heap_stat = task_stat->heap_stat_start;
-
-    // copy the stats of the different heaps the task has used and the different blocks
-    // allocated in those heaps. If the number of entries remaining for block stats is
-    // inferior to the number of blocks allocated on the current heap no block stat will
-    // be copied at all.
-    size_t heap_index = 0;
-    size_t alloc_index = 0;
-
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    heap_stats_t *heap_info = STAILQ_FIRST(&task_info->heaps_stats);
-    while(heap_index < task_info->task_stat.heap_count || heap_info != NULL) {
-        // check that there is enough heap_stat entry left to add another one to the user defined
-        // array of heap_stat
-        if (heap_index >= task_stat->heap_count) {
-            break;
-        }
-
-        // increase alloc_index before filling the block info of the given heap
-        // to avoid running out of block stat entry while doing it.
-        if (alloc_index + heap_info->heap_stat.alloc_count > task_stat->alloc_count) {
-            heap_info->heap_stat.alloc_stat = NULL;
-        } else {
-            // set the pointer where the block info for the given heap will
-            // be in the user array
-            heap_info->heap_stat.alloc_stat = task_stat->alloc_stat_start + alloc_index;
-
-            // fill the alloc array in heap_info by running through all blocks of a given heap
-            // and storing info about the blocks allocated by the given task
-            alloc_stats_t *alloc_stats = NULL;
-            size_t a_index = 0;
-            STAILQ_FOREACH(alloc_stats, &heap_info->allocs_stats, next_alloc_stat) {
-                heap_info->heap_stat.alloc_stat[a_index] = alloc_stats->alloc_stat;
-                a_index++;
-            }
-
-            alloc_index += heap_info->heap_stat.alloc_count;
-        }
-
-        memcpy(task_stat->stat.heap_stat + heap_index, &heap_info->heap_stat, sizeof(heap_stat_t));
-        heap_index++;
-        heap_info = STAILQ_NEXT(heap_info, next_heap_stat);
-    }
-    xSemaphoreGive(s_task_tracking_mutex);
+    fill_queried_allocs();
+    query_unlock();
 
     task_stat->heap_count = heap_index;
     task_stat->alloc_count = alloc_index;
@@ -631,7 +617,7 @@ esp_err_t heap_caps_get_single_task_stat(heap_single_task_stat_t *task_stat, Tas
     return ESP_OK;
 }
 
-static void heap_caps_print_task_info(FILE *stream, task_info_t *task_info, bool is_last_task_info)
+static void heap_caps_print_task_info(FILE *stream, const task_stat_t *task_stat, bool is_last_task_info)
 {
     if (stream == NULL) {
         stream = stdout;
@@ -640,39 +626,46 @@ static void heap_caps_print_task_info(FILE *stream, task_info_t *task_info, bool
     const char *task_info_visual = is_last_task_info ? " " : "│";
     const char *task_info_visual_start = is_last_task_info ? "└" : "├";
     fprintf(stream, "%s %s: %s, CURRENT MEMORY USAGE %d, PEAK MEMORY USAGE %d, TOTAL HEAP USED %d:\n", task_info_visual_start,
-                                                                                                      task_info->task_stat.is_alive ? "ALIVE" : "DELETED",
-                                                                                                      task_info->task_stat.name,
-                                                                                                      task_info->task_stat.overall_current_usage,
-                                                                                                      task_info->task_stat.overall_peak_usage,
-                                                                                                      task_info->task_stat.heap_count);
-
-    heap_stats_t *heap_info = NULL;
-    STAILQ_FOREACH(heap_info, &task_info->heaps_stats, next_heap_stat) {
-        const char *next_heap_visual = !STAILQ_NEXT(heap_info, next_heap_stat) ? " " : "│";
-        const char *next_heap_visual_start = !STAILQ_NEXT(heap_info, next_heap_stat) ? "└" : "├";
+                                                                                                      task_stat->is_alive ? "ALIVE" : "DELETED",
+                                                                                                      task_stat->name,
+                                                                                                      task_stat->overall_current_usage,
+                                                                                                      task_stat->overall_peak_usage,
+                                                                                                      task_stat->heap_count);
+
+    if (task_stat->heap_stat == NULL) {
+        return;
+    }
+
+    for (size_t heap_index = 0; heap_index < task_stat->heap_count; heap_index++) {
+        const heap_stat_t *heap_stat = &task_stat->heap_stat[heap_index];
+        const bool is_last_heap = (heap_index + 1 == task_stat->heap_count);
+        const char *next_heap_visual = is_last_heap ? " " : "│";
+        const char *next_heap_visual_start = is_last_heap ? "└" : "├";
         fprintf(stream, "%s    %s HEAP: %s, CAPS: 0x%08lx, SIZE: %d, USAGE: CURRENT %d (%d%%), PEAK %d (%d%%), ALLOC COUNT: %d\n",
                 task_info_visual,
                 next_heap_visual_start,
-                heap_info->heap_stat.name,
-                heap_info->heap_stat.caps,
-                heap_info->heap_stat.size,
-                heap_info->heap_stat.current_usage,
-                (heap_info->heap_stat.current_usage * 100) / heap_info->heap_stat.size,
-                heap_info->heap_stat.peak_usage,
-                (heap_info->heap_stat.peak_usage * 100) / heap_info->heap_stat.size,
-                heap_info->heap_stat.alloc_count);
-
-        alloc_stats_t *alloc_stats = NULL;
-        STAILQ_FOREACH(alloc_stats, &heap_info->allocs_stats, next_alloc_stat) {
+                heap_stat->name,
+                heap_stat->caps,
+                heap_stat->size,
+                heap_stat->current_usage,
+                (heap_stat->current_usage * 100) / heap_stat->size,
+                heap_stat->peak_usage,
+                (heap_stat->peak_usage * 100) / heap_stat->size,
+                heap_stat->alloc_count);
+
+        if (heap_stat->alloc_stat == NULL) {
+            continue;
+        }
+        for (size_t alloc_index = 0; alloc_index < heap_stat->alloc_count; alloc_index++) {
             fprintf(stream, "%s    %s    ├ ALLOC %p, SIZE %" PRIu32 "\n", task_info_visual,
                                                                 next_heap_visual,
-                                                                alloc_stats->alloc_stat.address,
-                                                                alloc_stats->alloc_stat.size);
+                                                                heap_stat->alloc_stat[alloc_index].address,
+                                                                heap_stat->alloc_stat[alloc_index].size);
         }
     }
 }
 
-static void heap_caps_print_task_overview(FILE *stream, task_info_t *task_info, bool is_first_task_info, bool is_last_task_info)
+static void heap_caps_print_task_overview(FILE *stream, const task_stat_t *task_stat, bool is_first_task_info, bool is_last_task_info)
 {
     if (stream == NULL) {
         stream = stdout;
@@ -684,49 +677,87 @@ static void heap_caps_print_task_overview(FILE *stream, task_info_t *task_info,
         fprintf(stream, "├────────────────────┼─────────┼──────────────────────┼───────────────────┼─────────────────┤\n");
     }
 
-    task_stat_t task_stat = task_info->task_stat;
     fprintf(stream, "│ %18s │ %7s │ %20d │ %17d │ %15d │\n",
-                    task_stat.name,
-                    task_stat.is_alive ? "ALIVE  " : "DELETED",
-                    task_stat.overall_current_usage,
-                    task_stat.overall_peak_usage,
-                    task_stat.heap_count);
+                    task_stat->name,
+                    task_stat->is_alive ? "ALIVE  " : "DELETED",
+                    task_stat->overall_current_usage,
+                    task_stat->overall_peak_usage,
+                    task_stat->heap_count);
 
     if (is_last_task_info) {
         fprintf(stream, "└────────────────────┴─────────┴──────────────────────┴───────────────────┴─────────────────┘\n");
     }
 }
 
-void heap_caps_print_single_task_stat(FILE *stream, TaskHandle_t task_handle)
+/**
+ * @brief Allocate the arrays receiving the statistics of all tasks, optionally without the allocations.
+ */
+static esp_err_t alloc_all_task_stat_arrays(heap_all_tasks_stat_t *tasks_stat, bool with_allocs)
 {
-    if (task_handle == NULL) {
-        task_handle = xTaskGetCurrentTaskHandle();
-    }
+    tasks_stat->stat_arr = NULL;
+    tasks_stat->heap_stat_start = NULL;
+    tasks_stat->alloc_stat_start = NULL;
+    tasks_stat->task_count = 0;
+    tasks_stat->heap_count = 0;
+    tasks_stat->alloc_count = 0;
 
     task_info_t *task_info = NULL;
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        if (task_info->task_stat.handle == task_handle) {
-            heap_caps_print_task_info(stream, task_info, true);
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    LIST_FOREACH(task_info, &task_stats, next_task_info) {
+        tasks_stat->task_count += 1;
+        tasks_stat->heap_count += task_info->task_stat.heap_count;
+        if (with_allocs) {
+            tasks_stat->alloc_count += task_info->block_count;
+        }
+    }
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-            xSemaphoreGive(s_task_tracking_mutex);
-            return;
+    // allocate the memory used to store the statistics of allocs, heaps and tasks
+    if (tasks_stat->task_count != 0) {
+        tasks_stat->stat_arr = task_tracking_malloc(tasks_stat->task_count * sizeof(task_stat_t));
+        if (tasks_stat->stat_arr == NULL) {
+            return ESP_FAIL;
         }
     }
-    xSemaphoreGive(s_task_tracking_mutex);
+    if (tasks_stat->heap_count != 0) {
+        tasks_stat->heap_stat_start = task_tracking_malloc(tasks_stat->heap_count * sizeof(heap_stat_t));
+        if (tasks_stat->heap_stat_start == NULL) {
+            return ESP_FAIL;
+        }
+    }
+    if (tasks_stat->alloc_count != 0) {
+        tasks_stat->alloc_stat_start = task_tracking_malloc(tasks_stat->alloc_count * sizeof(heap_task_block_t));
+        if (tasks_stat->alloc_stat_start == NULL) {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+void heap_caps_print_single_task_stat(FILE *stream, TaskHandle_t task_handle)
+{
+    heap_single_task_stat_t task_stat;
+
+    if (heap_caps_alloc_single_task_stat_arrays(&task_stat, task_handle) == ESP_OK &&
+        heap_caps_get_single_task_stat(&task_stat, task_handle) == ESP_OK) {
+        heap_caps_print_task_info(stream, &task_stat.stat, true);
+    }
+    heap_caps_free_single_task_stat_arrays(&task_stat);
 }
 
 void heap_caps_print_all_task_stat(FILE *stream)
 {
-    task_info_t *task_info = NULL;
+    heap_all_tasks_stat_t tasks_stat;
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        const bool last_task_info = (SLIST_NEXT(task_info, next_task_info) == NULL);
-        heap_caps_print_task_info(stream, task_info, last_task_info);
+    if (heap_caps_alloc_all_task_stat_arrays(&tasks_stat) == ESP_OK &&
+        heap_caps_get_all_task_stat(&tasks_stat) == ESP_OK) {
+        for (size_t task_index = 0; task_index < tasks_stat.task_count; task_index++) {
+            const bool last_task_info = (task_index + 1 == tasks_stat.task_count);
+            heap_caps_print_task_info(stream, &tasks_stat.stat_arr[task_index], last_task_info);
+        }
     }
-    xSemaphoreGive(s_task_tracking_mutex);
+    heap_caps_free_all_task_stat_arrays(&tasks_stat);
 }
 
 void heap_caps_print_single_task_stat_overview(FILE *stream, TaskHandle_t task_handle)
@@ -735,32 +766,32 @@ void heap_caps_print_single_task_stat_overview(FILE *stream, TaskHandle_t task_h
         task_handle = xTaskGetCurrentTaskHandle();
     }
 
-    task_info_t *task_info = NULL;
+    task_stat_t task_stat;
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        if (task_info->task_stat.handle == task_handle) {
-            heap_caps_print_task_overview(stream, task_info, true, true);
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    task_info_t *task_info = find_task_info(task_handle);
+    if (task_info != NULL) {
+        memcpy(&task_stat, &task_info->task_stat, sizeof(task_stat_t));
+    }
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
-            xSemaphoreGive(s_task_tracking_mutex);
-            return;
-        }
+    if (task_info != NULL) {
+        heap_caps_print_task_overview(stream, &task_stat, true, true);
     }
-    xSemaphoreGive(s_task_tracking_mutex);
 }
 
 void heap_caps_print_all_task_stat_overview(FILE *stream)
 {
-    task_info_t *task_info = NULL;
-    bool is_first_task_info = true;
+    heap_all_tasks_stat_t tasks_stat;
 
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        const bool last_task_info = (SLIST_NEXT(task_info, next_task_info) == NULL);
-        heap_caps_print_task_overview(stream, task_info, is_first_task_info, last_task_info);
-        is_first_task_info = false;
+    if (alloc_all_task_stat_arrays(&tasks_stat, false) == ESP_OK &&
+        heap_caps_get_all_task_stat(&tasks_stat) == ESP_OK) {
+        for (size_t task_index = 0; task_index < tasks_stat.task_count; task_index++) {
+            const bool last_task_info = (task_index + 1 == tasks_stat.task_count);
+            heap_caps_print_task_overview(stream, &tasks_stat.stat_arr[task_index], task_index == 0, last_task_info);
+        }
     }
-    xSemaphoreGive(s_task_tracking_mutex);
+    heap_caps_free_all_task_stat_arrays(&tasks_stat);
 }
 
 esp_err_t heap_caps_alloc_single_task_stat_arrays(heap_single_task_stat_t *task_stat, TaskHandle_t task_handle)
@@ -774,32 +805,23 @@ esp_err_t heap_caps_alloc_single_task_stat_arrays(heap_single_task_stat_t *task_
     task_stat->heap_count = 0;
     task_stat->alloc_count = 0;
 
-    task_info_t *task_info = NULL;
-
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        if(task_info->task_stat.handle == task_handle && task_info->task_stat.is_alive) {
-            task_stat->heap_count = task_info->task_stat.heap_count;
-            heap_stats_t *heap_info = NULL;
-            STAILQ_FOREACH(heap_info, &task_info->heaps_stats, next_heap_stat) {
-                task_stat->alloc_count += heap_info->heap_stat.alloc_count;
-            }
-            break;
-        }
+    MULTI_HEAP_LOCK(&s_task_tracking_lock);
+    task_info_t *task_info = find_task_info(task_handle);
+    if (task_info != NULL) {
+        task_stat->heap_count = task_info->task_stat.heap_count;
+        task_stat->alloc_count = task_info->block_count;
     }
-    xSemaphoreGive(s_task_tracking_mutex);
+    MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
 
     // allocate the memory used to store the statistics of allocs, heaps
     if (task_stat->heap_count != 0) {
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-        task_stat->heap_stat_start = multi_heap_malloc(heap_used_for_alloc->heap, task_stat->heap_count * sizeof(heap_stat_t));
+        task_stat->heap_stat_start = task_tracking_malloc(task_stat->heap_count * sizeof(heap_stat_t));
         if (task_stat->heap_stat_start == NULL) {
             return ESP_FAIL;
         }
     }
     if (task_stat->alloc_count != 0) {
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-        task_stat->alloc_stat_start = multi_heap_malloc(heap_used_for_alloc->heap, task_stat->alloc_count * sizeof(heap_task_block_t));
+        task_stat->alloc_stat_start = task_tracking_malloc(task_stat->alloc_count * sizeof(heap_task_block_t));
         if (task_stat->alloc_stat_start == NULL) {
             return ESP_FAIL;
         }
@@ -810,93 +832,30 @@ esp_err_t heap_caps_alloc_single_task_stat_arrays(heap_single_task_stat_t *task_
 
 void heap_caps_free_single_task_stat_arrays(heap_single_task_stat_t *task_stat)
 {
-    if (task_stat->heap_stat_start != NULL) {
-        heap_t *heap_used_for_alloc = find_containing_heap(task_stat->heap_stat_start);
-        assert(heap_used_for_alloc != NULL);
-        multi_heap_free(heap_used_for_alloc->heap, task_stat->heap_stat_start);
-        task_stat->heap_stat_start = NULL;
-        task_stat->heap_count = 0;
-    }
-    if (task_stat->alloc_stat_start != NULL) {
-        heap_t *heap_used_for_alloc = find_containing_heap(task_stat->alloc_stat_start);
-        assert(heap_used_for_alloc != NULL);
-        multi_heap_free(heap_used_for_alloc->heap, task_stat->alloc_stat_start);
-        task_stat->alloc_stat_start = NULL;
-        task_stat->alloc_count = 0;
-    }
+    task_tracking_free(task_stat->heap_stat_start);
+    task_stat->heap_stat_start = NULL;
+    task_stat->heap_count = 0;
+    task_tracking_free(task_stat->alloc_stat_start);
+    task_stat->alloc_stat_start = NULL;
+    task_stat->alloc_count = 0;
 }
 
 esp_err_t heap_caps_alloc_all_task_stat_arrays(heap_all_tasks_stat_t *tasks_stat)
 {
-    tasks_stat->stat_arr = NULL;
-    tasks_stat->heap_stat_start = NULL;
-    tasks_stat->alloc_stat_start = NULL;
-    tasks_stat->task_count = 0;
-    tasks_stat->heap_count = 0;
-    tasks_stat->alloc_count = 0;
-
-    task_info_t *task_info = NULL;
-
-    xSemaphoreTake(s_task_tracking_mutex, portMAX_DELAY);
-    SLIST_FOREACH(task_info, &task_stats, next_task_info) {
-        tasks_stat->task_count += 1;
-
-        tasks_stat->heap_count += task_info->task_stat.heap_count;
-        heap_stats_t *heap_info = NULL;
-        STAILQ_FOREACH(heap_info, &task_info->heaps_stats, next_heap_stat) {
-            tasks_stat->alloc_count += heap_info->heap_stat.alloc_count;
-        }
-    }
-    xSemaphoreGive(s_task_tracking_mutex);
-
-    // allocate the memory used to store the statistics of allocs, heaps and tasks
-    if (tasks_stat->task_count != 0) {
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-        tasks_stat->stat_arr = multi_heap_malloc(heap_used_for_alloc->heap, tasks_stat->task_count * sizeof(task_stat_t));
-        if (tasks_stat->stat_arr == NULL) {
-            return ESP_FAIL;
-        }
-    }
-    if (tasks_stat->heap_count != 0) {
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-        tasks_stat->heap_stat_start = multi_heap_malloc(heap_used_for_alloc->heap, tasks_stat->heap_count * sizeof(heap_stat_t));
-        if (tasks_stat->heap_stat_start == NULL) {
-            return ESP_FAIL;
-        }
-    }
-    if (tasks_stat->alloc_count != 0) {
-        heap_t *heap_used_for_alloc = find_biggest_heap();
-        tasks_stat->alloc_stat_start = multi_heap_malloc(heap_used_for_alloc->heap, tasks_stat->alloc_count * sizeof(heap_task_block_t));
-        if (tasks_stat->alloc_stat_start == NULL) {
-            return ESP_FAIL;
-        }
-    }
-    return ESP_OK;
+    return alloc_all_task_stat_arrays(tasks_stat, true);
 }
 
 void heap_caps_free_all_task_stat_arrays(heap_all_tasks_stat_t *tasks_stat)
 {
-    if (tasks_stat->stat_arr != NULL) {
-        heap_t *heap_used_for_alloc = find_containing_heap(tasks_stat->stat_arr);
-        assert(heap_used_for_alloc != NULL);
-        multi_heap_free(heap_used_for_alloc->heap, tasks_stat->stat_arr);
-        tasks_stat->stat_arr = NULL;
-        tasks_stat->task_count = 0;
-    }
-    if (tasks_stat->heap_stat_start != NULL) {
-        heap_t *heap_used_for_alloc = find_containing_heap(tasks_stat->heap_stat_start);
-        assert(heap_used_for_alloc != NULL);
-        multi_heap_free(heap_used_for_alloc->heap, tasks_stat->heap_stat_start);
-        tasks_stat->heap_stat_start = NULL;
-        tasks_stat->heap_count = 0;
-    }
-    if (tasks_stat->alloc_stat_start != NULL) {
-        heap_t *heap_used_for_alloc = find_containing_heap(tasks_stat->alloc_stat_start);
-        assert(heap_used_for_alloc != NULL);
-        multi_heap_free(heap_used_for_alloc->heap, tasks_stat->alloc_stat_start);
-        tasks_stat->alloc_stat_start = NULL;
-        tasks_stat->alloc_count = 0;
-    }
+    task_tracking_free(tasks_stat->stat_arr);
+    tasks_stat->stat_arr = NULL;
+    tasks_stat->task_count = 0;
+    task_tracking_free(tasks_stat->heap_stat_start);
+    tasks_stat->heap_stat_start = NULL;
+    tasks_stat->heap_count = 0;
+    task_tracking_free(tasks_stat->alloc_stat_start);
+    tasks_stat->alloc_stat_start = NULL;
+    tasks_stat->alloc_count = 0;
 }
 
 /*
@@ -954,7 +913,13 @@ size_t heap_caps_get_per_task_info(heap_task_info_params_t *params)
             }
             void *p = multi_heap_get_block_address(b);  // Safe, only arithmetic
             size_t bsize = multi_heap_get_allocated_size(heap, p); // Validates
-            TaskHandle_t btask = MULTI_HEAP_GET_BLOCK_OWNER(p);
+            TaskHandle_t btask = NULL;
+            MULTI_HEAP_LOCK(&s_task_tracking_lock);
+            task_info_t *owner = MULTI_HEAP_GET_BLOCK_OWNER(p);
+            if (is_valid_owner(owner)) {
+                btask = owner->task_stat.handle;
+            }
+            MULTI_HEAP_UNLOCK(&s_task_tracking_lock);
             // Accumulate per-task allocation totals.
             if (params->totals) {
                 size_t i;
@@ -0,0 +1,655 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <stdio.h>
+#include "sdkconfig.h"
+#include <inttypes.h>
+#include <sys/param.h>
+
+#include "esp_heap_trace.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <pthread.h>
+#include <time.h>
+#include <execinfo.h>
+#else
+#include "freertos/FreeRTOS.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_memory_utils.h"
+#include "esp_private/esp_clk.h"
+#endif
+
+/*
+ * Heap tracing in sampling mode.
+ *
+ * The allocated bytes are sampled as a Poisson process, as done by tcmalloc: an allocation is
+ * sampled when the number of bytes allocated since the previous sample crosses a threshold drawn
+ * from an exponential distribution whose mean is the sampling interval. Only the sampled
+ * allocations have their call stack read and are recorded, and a sampled allocation of 'size'
+ * bytes stands for size / (1 - exp(-size / interval)) allocated bytes.
+ *
+ * The sampled allocations not freed yet are kept in a hash table, so that their free is recorded
+ * too. Each free first reads a counter of a small counting filter without taking the lock, so
+ * that only the frees of likely sampled allocations take it.
+ *
+ * The records are written to a ring buffer and read by heap_trace_sampling_read(). They are
+ * 32-bit aligned, in the byte order of the target:
+ *
+ *   header: u8 0, u8 version, u8 pointer size, u8 stack depth, u32 magic "HTSP",
+ *           u32 sampling interval, u32 timestamp frequency in Hz
+ *   alloc:  u8 1, u8 number of callers, u16 0, u32 timestamp, ptr address, u32 size, ptr callers[]
+ *   free:   u8 2, u8 0, u16 0, u32 timestamp, ptr address
+ *   lost:   u8 3, u8 0, u16 0, u32 number of records dropped because the buffer was full
+ */
+
+#define STACK_DEPTH CONFIG_HEAP_TRACING_STACK_DEPTH
+
+#define STREAM_VERSION 1
+#define STREAM_MAGIC 0x50535448 // "HTSP"
+
+typedef enum {
+    RECORD_HEADER,
+    RECORD_ALLOC,
+    RECORD_FREE,
+    RECORD_LOST,
+} record_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t count;
+    uint16_t reserved;
+    uint32_t value;
+} record_head_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t version;
+    uint8_t pointer_size;
+    uint8_t stack_depth;
+    uint32_t magic;
+    uint32_t sampling_interval;
+    uint32_t timestamp_freq;
+} record_header_t;
+
+/* Largest number of bytes counted for an allocation, so that the countdown can't overflow */
+#define SAMPLING_MAX_STEP (INT32_MAX / 4)
+
+/* Number of filter counters for each entry of the table of sampled allocations */
+#define FILTER_RATIO 4
+
+#define FILTER_SATURATED UINT8_MAX
+
+typedef enum {
+    TRACING_STARTED, // start recording allocs and free
+    TRACING_STOPPED, // stop recording allocs and free
+    TRACING_ALLOC_PAUSED, // stop recording allocs but keep recording free
+    TRACING_UNKNOWN // default value
+} tracing_state_t;
+
+#if CONFIG_IDF_TARGET_LINUX
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define TRACE_LOCK() pthread_mutex_lock(&trace_mutex)
+#define TRACE_UNLOCK() pthread_mutex_unlock(&trace_mutex)
+#define TRACE_PRINTF printf
+#else
+static portMUX_TYPE trace_mux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK() portENTER_CRITICAL(&trace_mux)
+#define TRACE_UNLOCK() portEXIT_CRITICAL(&trace_mux)
+#define TRACE_PRINTF esp_rom_printf
+#endif
+
+static tracing_state_t tracing = TRACING_UNKNOWN;
+static heap_trace_mode_t mode;
+
+/* Sampled allocation not freed yet */
+typedef struct {
+    void *address;
+    size_t size;
+} live_sample_t;
+
+typedef struct {
+    /* Open addressing hash table of the sampled allocations, NULL address for a free entry */
+    live_sample_t *table;
+    size_t table_mask;
+    uint32_t table_shift;
+
+    /* Number of sampled allocations in 'table' for each hash value, read without the lock */
+    uint8_t *filter;
+    uint32_t filter_shift;
+
+    size_t capacity;
+    size_t count;
+    size_t high_water_mark;
+    bool has_overflowed;
+} live_samples_t;
+
+typedef struct {
+    uint8_t *buffer;
+    size_t size;
+    size_t read_pos;
+    size_t used;
+    uint32_t dropped;
+} stream_t;
+
+static live_samples_t live;
+static stream_t stream;
+
+static size_t sampling_interval;
+
+/* Bytes left to allocate until the next sampled allocation */
+static int32_t bytes_until_sample;
+
+static uint32_t rand_state;
+
+static size_t total_allocations;
+static size_t total_frees;
+static size_t total_dropped;
+
+static HEAP_IRAM_ATTR uint32_t timestamp(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000 + now.tv_nsec / 1000);
+#else
+    return esp_cpu_get_cycle_count();
+#endif
+}
+
+static uint32_t timestamp_freq(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    return 1000000;
+#else
+    return esp_clk_cpu_freq();
+#endif
+}
+
+static HEAP_IRAM_ATTR uint32_t next_random(void)
+{
+    // xorshift32, never returns 0
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+/* Draw the number of bytes until the next sample from an exponential distribution,
+   as -ln(u) * interval with u uniform in (0, 1]. The logarithm is computed in fixed
+   point to stay usable when the cache is disabled. */
+static HEAP_IRAM_ATTR int32_t next_sampling_step(void)
+{
+    const uint32_t x = next_random();
+    const int msb = 31 - __builtin_clz(x);
+    // mantissa of x in [0, 1), in Q16
+    const uint32_t m = (msb >= 16 ? x >> (msb - 16) : x << (16 - msb)) & 0xFFFF;
+    // log2(1 + m) ~ m + 0.346 * m * (1 - m)
+    const uint32_t log2_m = m + (uint32_t)(((uint64_t)22675 * m * (0x10000 - m)) >> 32);
+    // -log2(x / 2^32) then -ln(x / 2^32), in Q16
+    const uint32_t neg_log2 = ((uint32_t)(32 - msb) << 16) - log2_m;
+    const uint64_t neg_ln = ((uint64_t)neg_log2 * 45426) >> 16;
+    const uint64_t step = (neg_ln * sampling_interval) >> 16;
+    if (step == 0) {
+        return 1;
+    }
+    return step < SAMPLING_MAX_STEP ? (int32_t)step : SAMPLING_MAX_STEP;
+}
+
+static HEAP_IRAM_ATTR uint32_t hash_ptr(const void *p)
+{
+    return ((uint32_t)(uintptr_t)p >> 2) * 2654435769u;
+}
+
+static HEAP_IRAM_ATTR size_t filter_idx(const void *p)
+{
+    return (hash_ptr(p) * 0x85EBCA6Bu) >> live.filter_shift;
+}
+
+static HEAP_IRAM_ATTR size_t table_idx(const void *p)
+{
+    return hash_ptr(p) >> live.table_shift;
+}
+
+static HEAP_IRAM_ATTR void filter_add(const void *p, int delta)
+{
+    uint8_t *counter = &live.filter[filter_idx(p)];
+    // a saturated counter doesn't know its count anymore, it stays saturated
+    if (*counter != FILTER_SATURATED) {
+        __atomic_store_n(counter, *counter + delta, __ATOMIC_RELAXED);
+    }
+}
+
+static HEAP_IRAM_ATTR bool live_add(void *p, size_t size)
+{
+    if (live.count == live.capacity) {
+        live.has_overflowed = true;
+        return false;
+    }
+    size_t i = table_idx(p);
+    while (live.table[i].address != NULL) {
+        i = (i + 1) & live.table_mask;
+    }
+    live.table[i].address = p;
+    live.table[i].size = size;
+    filter_add(p, 1);
+    live.count++;
+    if (live.count > live.high_water_mark) {
+        live.high_water_mark = live.count;
+    }
+    return true;
+}
+
+static HEAP_IRAM_ATTR bool live_remove(void *p)
+{
+    size_t i = table_idx(p);
+    while (live.table[i].address != p) {
+        if (live.table[i].address == NULL) {
+            return false;
+        }
+        i = (i + 1) & live.table_mask;
+    }
+    filter_add(p, -1);
+    live.count--;
+
+    // move back the entries of the same probe sequence, so that no tombstone is needed
+    for (size_t j = (i + 1) & live.table_mask; live.table[j].address != NULL; j = (j + 1) & live.table_mask) {
+        const size_t home = table_idx(live.table[j].address);
+        const bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            live.table[i] = live.table[j];
+            i = j;
+        }
+    }
+    live.table[i].address = NULL;
+    return true;
+}
+
+static HEAP_IRAM_ATTR void stream_put(const void *data, size_t len)
+{
+    const size_t write_pos = (stream.read_pos + stream.used) % stream.size;
+    const size_t first = MIN(len, stream.size - write_pos);
+    memcpy(stream.buffer + write_pos, data, first);
+    memcpy(stream.buffer, (const uint8_t *)data + first, len - first);
+    stream.used += len;
+}
+
+/* Write a record, or count it as dropped if the buffer is full */
+static HEAP_IRAM_ATTR void stream_write(const void *record, size_t len)
+{
+    const size_t lost_len = stream.dropped ? sizeof(record_head_t) : 0;
+    if (stream.size - stream.used < lost_len + len) {
+        stream.dropped++;
+        total_dropped++;
+        return;
+    }
+    if (stream.dropped) {
+        const record_head_t lost = { .type = RECORD_LOST, .value = stream.dropped };
+        stream_put(&lost, sizeof(lost));
+        stream.dropped = 0;
+    }
+    stream_put(record, len);
+}
+
+static void stream_write_header(void)
+{
+    const record_header_t header = {
+        .type = RECORD_HEADER,
+        .version = STREAM_VERSION,
+        .pointer_size = sizeof(void *),
+        .stack_depth = STACK_DEPTH,
+        .magic = STREAM_MAGIC,
+        .sampling_interval = sampling_interval,
+        .timestamp_freq = timestamp_freq(),
+    };
+    stream_write(&header, sizeof(header));
+}
+
+static void free_buffers(void)
+{
+    heap_caps_free(live.table);
+    heap_caps_free(live.filter);
+    heap_caps_free(stream.buffer);
+    memset(&live, 0, sizeof(live));
+    memset(&stream, 0, sizeof(stream));
+}
+
+esp_err_t heap_trace_init_sampling(const heap_trace_sampling_config_t *config)
+{
+    if ((tracing == TRACING_STARTED) || (tracing == TRACING_ALLOC_PAUSED)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    free_buffers();
+    if (config == NULL) {
+        return ESP_OK;
+    }
+    if (config->sampling_interval == 0 || config->buffer_size == 0 || config->max_live_samples == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // keep the hash table at most half full
+    uint32_t table_bits = 1;
+    while (((size_t)1 << table_bits) < 2 * config->max_live_samples) {
+        table_bits++;
+    }
+    if (table_bits > 24) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const size_t table_size = (size_t)1 << table_bits;
+    live.table = heap_caps_calloc(table_size, sizeof(live_sample_t), MALLOC_CAP_INTERNAL);
+    live.filter = heap_caps_calloc(table_size * FILTER_RATIO, sizeof(uint8_t), MALLOC_CAP_INTERNAL);
+    stream.buffer = heap_caps_malloc(config->buffer_size, MALLOC_CAP_INTERNAL);
+    if (live.table == NULL || live.filter == NULL || stream.buffer == NULL) {
+        free_buffers();
+        return ESP_ERR_NO_MEM;
+    }
+    live.table_mask = table_size - 1;
+    live.table_shift = 32 - table_bits;
+    live.filter_shift = 32 - table_bits - __builtin_ctz(FILTER_RATIO);
+    live.capacity = config->max_live_samples;
+    stream.size = config->buffer_size;
+    sampling_interval = config->sampling_interval;
+
+#if CONFIG_IDF_TARGET_LINUX
+    // the first call of backtrace() loads libgcc, do it before tracing any allocation
+    void *frame;
+    backtrace(&frame, 1);
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t set_tracing(tracing_state_t state)
+{
+    if (tracing == state) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    tracing = state;
+    return ESP_OK;
+}
+
+esp_err_t heap_trace_start(heap_trace_mode_t mode_param)
+{
+    if (stream.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TRACE_LOCK();
+
+    set_tracing(TRACING_STOPPED);
+    mode = mode_param;
+
+    memset(live.table, 0, (live.table_mask + 1) * sizeof(live_sample_t));
+    memset(live.filter, 0, (live.table_mask + 1) * FILTER_RATIO);
+    live.count = 0;
+    live.high_water_mark = 0;
+    live.has_overflowed = false;
+
+    stream.read_pos = 0;
+    stream.used = 0;
+    stream.dropped = 0;
+    stream_write_header();
+
+    total_allocations = 0;
+    total_frees = 0;
+    total_dropped = 0;
+
+    rand_state = timestamp() | 1;
+    __atomic_store_n(&bytes_until_sample, next_sampling_step(), __ATOMIC_RELAXED);
+
+    const esp_err_t ret_val = set_tracing(TRACING_STARTED);
+
+    TRACE_UNLOCK();
+    return ret_val;
+}
+
+esp_err_t heap_trace_stop(void)
+{
+    TRACE_LOCK();
+    const esp_err_t ret_val = set_tracing(TRACING_STOPPED);
+    TRACE_UNLOCK();
+    return ret_val;
+}
+
+esp_err_t heap_trace_alloc_pause(void)
+{
+    if (stream.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    TRACE_LOCK();
+    const esp_err_t ret_val = set_tracing(TRACING_ALLOC_PAUSED);
+    TRACE_UNLOCK();
+    return ret_val;
+}
+
+esp_err_t heap_trace_resume(void)
+{
+    if (stream.buffer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    TRACE_LOCK();
+    const esp_err_t ret_val = set_tracing(TRACING_STARTED);
+    TRACE_UNLOCK();
+    return ret_val;
+}
+
+size_t heap_trace_get_count(void)
+{
+    return live.count;
+}
+
+esp_err_t heap_trace_get(size_t index, heap_trace_record_t *r_out)
+{
+    // the records are read with heap_trace_sampling_read()
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+size_t heap_trace_sampling_read(void *buf, size_t size)
+{
+    // copy by parts to keep the critical sections short
+    const size_t max_part = 256;
+    size_t copied = 0;
+    if (stream.buffer == NULL) {
+        return 0;
+    }
+    while (copied < size) {
+        TRACE_LOCK();
+        const size_t part = MIN(MIN(size - copied, stream.used), max_part);
+        if (part > 0) {
+            const size_t first = MIN(part, stream.size - stream.read_pos);
+            memcpy((uint8_t *)buf + copied, stream.buffer + stream.read_pos, first);
+            memcpy((uint8_t *)buf + copied + first, stream.buffer, part - first);
+            stream.read_pos = (stream.read_pos + part) % stream.size;
+            stream.used -= part;
+        }
+        TRACE_UNLOCK();
+        if (part == 0) {
+            break;
+        }
+        copied += part;
+    }
+    return copied;
+}
+
+esp_err_t heap_trace_summary(heap_trace_summary_t *summary)
+{
+    if (summary == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    TRACE_LOCK();
+    summary->mode = mode;
+    summary->total_allocations = total_allocations;
+    summary->total_frees = total_frees;
+    summary->count = live.count;
+    summary->capacity = live.capacity;
+    summary->high_water_mark = live.high_water_mark;
+    summary->has_overflowed = live.has_overflowed || total_dropped != 0;
+    TRACE_UNLOCK();
+
+    return ESP_OK;
+}
+
+void heap_trace_dump(void)
+{
+    heap_trace_dump_caps(MALLOC_CAP_INTERNAL | MALLOC_CAP_SPIRAM);
+}
+
+void heap_trace_dump_caps(const uint32_t caps)
+{
+    TRACE_LOCK();
+
+    size_t sampled_bytes = 0;
+    TRACE_PRINTF("====== Heap Trace: %" PRIu32 " sampled allocations alive (%" PRIu32 " capacity) ======\n",
+                 (uint32_t)live.count, (uint32_t)live.capacity);
+    for (size_t i = 0; i <= live.table_mask && live.table != NULL; i++) {
+        const live_sample_t *sample = &live.table[i];
+        if (sample->address == NULL) {
+            continue;
+        }
+#if !CONFIG_IDF_TARGET_LINUX
+        if (!((caps & MALLOC_CAP_INTERNAL) && esp_ptr_internal(sample->address)) &&
+                !((caps & MALLOC_CAP_SPIRAM) && esp_ptr_external_ram(sample->address))) {
+            continue;
+        }
+#endif
+        TRACE_PRINTF("%6" PRIu32 " bytes (@ %p) sampled\n", (uint32_t)sample->size, sample->address);
+        sampled_bytes += sample->size;
+    }
+
+    TRACE_PRINTF("====== Heap Trace Summary ======\n");
+    TRACE_PRINTF("Mode: Heap Trace Sampling, 1 sample every %" PRIu32 " bytes on average\n", (uint32_t)sampling_interval);
+    TRACE_PRINTF("%" PRIu32 " bytes alive in sampled allocations\n", (uint32_t)sampled_bytes);
+    TRACE_PRINTF("records: %" PRIu32 " bytes not read yet (%" PRIu32 " capacity), %" PRIu32 " dropped\n",
+                 (uint32_t)stream.used, (uint32_t)stream.size, (uint32_t)total_dropped);
+    TRACE_PRINTF("sampled allocations: %" PRIu32 " (%" PRIu32 " high water mark)\n",
+                 (uint32_t)total_allocations, (uint32_t)live.high_water_mark);
+    TRACE_PRINTF("sampled frees: %" PRIu32 "\n", (uint32_t)total_frees);
+    if (live.has_overflowed) {
+        TRACE_PRINTF("(NB: Too many sampled allocations alive, the free of some of them isn't recorded.)\n");
+    }
+    TRACE_PRINTF("================================\n");
+
+    TRACE_UNLOCK();
+}
+
+/* Count the bytes of an allocation, returns true if it is sampled */
+static HEAP_IRAM_ATTR bool sample_allocation(void *p, size_t size)
+{
+    if ((tracing != TRACING_STARTED) || (p == NULL)) {
+        return false;
+    }
+    const int32_t bytes = size < SAMPLING_MAX_STEP ? (int32_t)size : SAMPLING_MAX_STEP;
+    const int32_t left = __atomic_sub_fetch(&bytes_until_sample, bytes, __ATOMIC_RELAXED);
+    // only the allocation crossing the threshold is sampled
+    return left <= 0 && left + bytes > 0;
+}
+
+/* Record a sampled allocation */
+static HEAP_IRAM_ATTR void record_allocation(const heap_trace_record_t *r_allocation)
+{
+    TRACE_LOCK();
+
+    // the countdown starts again from the sampled allocation
+    __atomic_store_n(&bytes_until_sample, next_sampling_step(), __ATOMIC_RELAXED);
+
+    if (tracing == TRACING_STARTED) {
+        size_t depth = 0;
+        while (depth < STACK_DEPTH && r_allocation->alloced_by[depth] != NULL) {
+            depth++;
+        }
+        const record_head_t head = {
+            .type = RECORD_ALLOC,
+            .count = depth,
+            .value = r_allocation->ccount,
+        };
+        const uint32_t size = r_allocation->size;
+        uint8_t record[sizeof(head) + sizeof(void *) + sizeof(size) + STACK_DEPTH * sizeof(void *)];
+        uint8_t *pos = record;
+        memcpy(pos, &head, sizeof(head));
+        pos += sizeof(head);
+        memcpy(pos, &r_allocation->address, sizeof(void *));
+        pos += sizeof(void *);
+        memcpy(pos, &size, sizeof(size));
+        pos += sizeof(size);
+        memcpy(pos, r_allocation->alloced_by, depth * sizeof(void *));
+        pos += depth * sizeof(void *);
+        stream_write(record, pos - record);
+
+        live_add(r_allocation->address, r_allocation->size);
+        total_allocations++;
+    }
+
+    TRACE_UNLOCK();
+}
+
+/* Record the free of a sampled allocation, the call stack isn't used */
+static HEAP_IRAM_ATTR void record_free(void *p, void **callers)
+{
+    if ((tracing == TRACING_STOPPED) || (tracing == TRACING_UNKNOWN) || (p == NULL)) {
+        return;
+    }
+    // most of the freed blocks weren't sampled, don't take the lock for them
+    if (__atomic_load_n(&live.filter[filter_idx(p)], __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+
+    TRACE_LOCK();
+    if (tracing != TRACING_STOPPED && live_remove(p)) {
+        const record_head_t head = {
+            .type = RECORD_FREE,
+            .value = timestamp(),
+        };
+        uint8_t record[sizeof(head) + sizeof(void *)];
+        memcpy(record, &head, sizeof(head));
+        memcpy(record + sizeof(head), &p, sizeof(void *));
+        stream_write(record, sizeof(record));
+        total_frees++;
+    }
+    TRACE_UNLOCK();
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+
+/* The heap functions of the linux target call these hooks, as they can't be wrapped */
+
+__attribute__((noinline)) void heap_trace_sampling_alloc_hook(void *ptr, size_t size)
+{
+    if (!sample_allocation(ptr, size)) {
+        return;
+    }
+    heap_trace_record_t rec = {
+        .address = ptr,
+        .ccount = timestamp(),
+        .size = size,
+        .freed = false,
+    };
+#if STACK_DEPTH > 0
+    // skip this hook and the heap function calling it
+    void *frames[STACK_DEPTH + 2];
+    const int depth = backtrace(frames, STACK_DEPTH + 2);
+    for (int i = 2; i < depth; i++) {
+        rec.alloced_by[i - 2] = frames[i];
+    }
+#endif
+    record_allocation(&rec);
+}
+
+void heap_trace_sampling_free_hook(void *ptr)
+{
+    record_free(ptr, NULL);
+}
+
+#else
+
+#define SAMPLE_ALLOCATION(p, size) sample_allocation(p, size)
+#define TRACE_FREE_CALL_STACK 0
+
+#include "heap_trace.inc"
+
+#endif
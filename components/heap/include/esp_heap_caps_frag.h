@@ -0,0 +1,190 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of size classes of the free block histogram
+ *
+ * The classes are powers of two, like the first level classes of the TLSF allocator:
+ * class 0 holds the free blocks smaller than 32 bytes, class i (0 < i < 15) the free blocks
+ * of 2^(i+4) to 2^(i+5)-1 bytes, and class 15 the free blocks of 512 KiB or more.
+ */
+#define HEAP_CAPS_FRAG_SIZE_CLASSES 16
+
+/**
+ * @brief Fragmentation metrics of the heaps with given capabilities, filled by heap_caps_get_frag_info
+ */
+typedef struct {
+    size_t total_free_bytes;        ///< Sum of the sizes of the free blocks
+    size_t largest_free_block;      ///< Size of the largest free block
+    size_t free_blocks;             ///< Number of free blocks
+    size_t free_blocks_by_class[HEAP_CAPS_FRAG_SIZE_CLASSES];  ///< Number of free blocks of each size class
+    size_t free_bytes_by_class[HEAP_CAPS_FRAG_SIZE_CLASSES];   ///< Sum of the sizes of the free blocks of each size class
+    uint32_t fragmentation;         ///< External fragmentation index in per mille: 1000 * (1 - largest_free_block / total_free_bytes).
+                                    ///< 0 when all the free memory is in one block, close to 1000 when it is scattered in small blocks.
+} heap_caps_frag_info_t;
+
+/**
+ * @brief Get the fragmentation metrics of the heaps with the given capabilities
+ *
+ * The free blocks of all the heaps with the given capabilities are walked with multi_heap_walk.
+ * The metrics are computed on the heap blocks: the free objects of the pools
+ * (see esp_heap_caps_pool.h) are not free heap blocks.
+ *
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory
+ * @param[out] info Metrics of the heaps
+ */
+void heap_caps_get_frag_info(uint32_t caps, heap_caps_frag_info_t *info);
+
+/**
+ * @brief Number of samples kept by a fragmentation trend
+ */
+#define HEAP_CAPS_FRAG_TREND_SAMPLES 16
+
+/**
+ * @brief Sample of the fragmentation metrics, part of a fragmentation trend
+ */
+typedef struct {
+    uint32_t timestamp;             ///< Time of the sample, in the unit chosen by the application
+    uint32_t fragmentation;         ///< External fragmentation index, in per mille
+    size_t total_free_bytes;        ///< Sum of the sizes of the free blocks
+    size_t largest_free_block;      ///< Size of the largest free block
+} heap_caps_frag_sample_t;
+
+/**
+ * @brief Last samples of the fragmentation metrics of the heaps with given capabilities
+ *
+ * The application owns the trend and must zero-initialize it, then adds a sample
+ * periodically with heap_caps_frag_trend_sample. Only the last HEAP_CAPS_FRAG_TREND_SAMPLES
+ * samples are kept.
+ */
+typedef struct {
+    heap_caps_frag_sample_t samples[HEAP_CAPS_FRAG_TREND_SAMPLES];  ///< Samples, oldest first once the buffer wrapped around at 'next'
+    size_t count;                   ///< Number of valid samples
+    size_t next;                    ///< Index of the next sample written
+} heap_caps_frag_trend_t;
+
+/**
+ * @brief Evolution of the fragmentation over the samples of a trend, filled by heap_caps_frag_trend_get
+ *
+ * The slopes are computed by linear regression over the samples, per 1000 units of the timestamps
+ * (per second if the timestamps are in milliseconds).
+ */
+typedef struct {
+    size_t samples;                     ///< Number of samples used
+    uint32_t duration;                  ///< Time between the oldest and the newest sample
+    int32_t fragmentation_slope;        ///< Change of the fragmentation index, in per mille per 1000 time units
+    int32_t largest_free_block_slope;   ///< Change of the largest free block, in bytes per 1000 time units
+    size_t min_largest_free_block;      ///< Smallest largest free block of the samples
+} heap_caps_frag_trend_info_t;
+
+/**
+ * @brief Add a sample of the fragmentation metrics of the heaps with the given capabilities to a trend
+ *
+ * @param trend Trend receiving the sample
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory
+ * @param timestamp Time of the sample, in any unit, increasing from one sample to the next
+ */
+void heap_caps_frag_trend_sample(heap_caps_frag_trend_t *trend, uint32_t caps, uint32_t timestamp);
+
+/**
+ * @brief Compute the evolution of the fragmentation over the samples of a trend
+ *
+ * @param trend Trend holding the samples
+ * @param[out] info Evolution of the fragmentation
+ *
+ * @return
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_ARG if a parameter is NULL
+ *  - ESP_ERR_INVALID_STATE if the trend has less than 2 samples or they all have the same timestamp
+ */
+esp_err_t heap_caps_frag_trend_get(const heap_caps_frag_trend_t *trend, heap_caps_frag_trend_info_t *info);
+
+/**
+ * @brief Handle of a movable block of memory
+ */
+typedef struct heap_caps_movable *heap_caps_movable_handle_t;
+
+/**
+ * @brief Allocate a block of memory which heap_caps_compact can move to another address
+ *
+ * The application doesn't keep the address of a movable block: it gets it with
+ * heap_caps_movable_lock each time it accesses the block, and gives it back with
+ * heap_caps_movable_unlock. A block is only moved while it is not locked.
+ *
+ * The handles are allocated from a pool of internal memory, so they don't fragment the heaps.
+ *
+ * @param size Size of the block, in bytes
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory, the block is only
+ *             moved to memory with the same capabilities
+ *
+ * @return Handle of the block, or NULL if there isn't enough memory
+ */
+heap_caps_movable_handle_t heap_caps_malloc_movable(size_t size, uint32_t caps);
+
+/**
+ * @brief Free a movable block of memory
+ *
+ * @param handle Handle of the block, NULL is ignored. The block must not be locked.
+ */
+void heap_caps_free_movable(heap_caps_movable_handle_t handle);
+
+/**
+ * @brief Lock a movable block of memory at its current address
+ *
+ * The block is not moved until it is unlocked as many times as it was locked.
+ *
+ * @param handle Handle of the block
+ *
+ * @return Address of the block, valid until the block is unlocked
+ */
+void *heap_caps_movable_lock(heap_caps_movable_handle_t handle);
+
+/**
+ * @brief Unlock a movable block of memory locked by heap_caps_movable_lock
+ *
+ * @param handle Handle of the block
+ */
+void heap_caps_movable_unlock(heap_caps_movable_handle_t handle);
+
+/**
+ * @brief Get the size of a movable block of memory
+ *
+ * @param handle Handle of the block
+ *
+ * @return Size requested when the block was allocated
+ */
+size_t heap_caps_movable_get_size(heap_caps_movable_handle_t handle);
+
+/**
+ * @brief Move the unlocked movable blocks to recover large contiguous free blocks
+ *
+ * The movable blocks in the heaps with the given capabilities are allocated again, and moved
+ * when the new block is in a heap the allocator prefers or at a lower address in the same heap.
+ * The free memory is thus gathered at the end of the heaps, where it merges into larger free
+ * blocks. Passes are made until no block moves.
+ *
+ * A block locked during its copy is not moved. The memory of a moved block is reallocated by
+ * the task calling this function, heap tracing and heap task tracking report it as such.
+ *
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory to compact
+ *
+ * @return Number of blocks moved
+ */
+size_t heap_caps_compact(uint32_t caps);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Handle of a pool of fixed-size objects
+ */
+typedef struct heap_caps_pool *heap_caps_pool_handle_t;
+
+/**
+ * @brief Statistics of a pool, filled by heap_caps_pool_get_info
+ */
+typedef struct {
+    size_t obj_size;                ///< Size of the objects of the pool
+    size_t total_objects;           ///< Number of objects the pool currently holds, free or allocated
+    size_t free_objects;            ///< Number of free objects
+    size_t minimum_free_objects;    ///< Lowest number of free objects since the pool was created
+    size_t max_objects;             ///< Number of objects the pool can grow to
+    size_t total_bytes;             ///< Memory currently taken by the pool from the heaps
+} heap_caps_pool_info_t;
+
+/**
+ * @brief Create a pool of objects of the same size, allocated from memory with the given capabilities
+ *
+ * Allocating an object from a pool and freeing it back doesn't take any lock, and the objects
+ * of a pool don't fragment the heaps. The pool also checks its objects against overflows and
+ * use after free according to the heap poisoning configuration.
+ *
+ * The pools are reported by heap_caps_print_heap_info, heap_caps_walk and heap_caps_check_integrity
+ * along with the heaps their memory is taken from.
+ *
+ * @param obj_size Size of the objects, in bytes
+ * @param count Number of objects of the pool
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory of the objects
+ *
+ * @return Handle of the pool, or NULL if there isn't enough memory or the pool would have more than 65535 objects
+ */
+heap_caps_pool_handle_t heap_caps_pool_create(size_t obj_size, size_t count, uint32_t caps);
+
+/**
+ * @brief Create a pool of objects of the same size, which grows when all its objects are allocated
+ *
+ * The pool starts with 'count' objects, and takes memory for 'count' more objects from the heaps
+ * each time it runs out of objects, until it holds 'max_count' objects. The memory of the pool
+ * is given back to the heaps when the pool is deleted.
+ *
+ * @param obj_size Size of the objects, in bytes
+ * @param count Number of objects the pool starts with and grows by
+ * @param max_count Maximum number of objects of the pool, rounded up to a multiple of 'count'
+ * @param caps Bitwise OR of MALLOC_CAP_* flags indicating the type of memory of the objects
+ *
+ * @return Handle of the pool, or NULL if there isn't enough memory or the pool would have more than 65535 objects
+ */
+heap_caps_pool_handle_t heap_caps_pool_create_growable(size_t obj_size, size_t count, size_t max_count, uint32_t caps);
+
+/**
+ * @brief Delete a pool and give its memory back to the heaps
+ *
+ * @note The objects still allocated from the pool are freed too, they must not be used anymore.
+ *
+ * @param pool Handle of the pool
+ */
+void heap_caps_pool_delete(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Allocate an object from a pool
+ *
+ * This function can be called from an ISR, unless the pool is growable.
+ *
+ * @param pool Handle of the pool
+ *
+ * @return Pointer to the object, aligned as memory returned by heap_caps_malloc, or NULL if all
+ *         objects are allocated and the pool can't grow
+ */
+void *heap_caps_pool_alloc(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Free an object allocated from a pool
+ *
+ * This function can be called from an ISR.
+ *
+ * @note The app will crash with an assertion failure if the pointer is not an allocated object of the pool.
+ *
+ * @param pool Handle of the pool
+ * @param obj Pointer to the object, as returned by heap_caps_pool_alloc
+ */
+void heap_caps_pool_free(heap_caps_pool_handle_t pool, void *obj);
+
+/**
+ * @brief Get the statistics of a pool
+ *
+ * @param pool Handle of the pool
+ * @param info Pointer to a structure filled with the statistics of the pool
+ */
+void heap_caps_pool_get_info(heap_caps_pool_handle_t pool, heap_caps_pool_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -87,6 +87,64 @@ esp_err_t heap_trace_init_standalone(heap_trace_record_t *record_buffer, size_t
  */
 esp_err_t heap_trace_init_tohost(void);
 
+/**
+ * @brief Configuration of heap tracing in sampling mode
+ */
+typedef struct {
+    size_t sampling_interval;   ///< Mean number of bytes allocated between two sampled allocations
+    size_t buffer_size;         ///< Size in bytes of the buffer holding the records until they are read
+    size_t max_live_samples;    ///< Maximum number of sampled allocations not freed yet whose free is recorded
+} heap_trace_sampling_config_t;
+
+/**
+ * @brief Default configuration of heap tracing in sampling mode
+ */
+#define HEAP_TRACE_SAMPLING_CONFIG_DEFAULT() { \
+    .sampling_interval = 64 * 1024, \
+    .buffer_size = 4096, \
+    .max_live_samples = 256, \
+}
+
+/**
+ * @brief Initialise heap tracing in sampling mode.
+ *
+ * This function must be called before any other heap tracing functions.
+ *
+ * In sampling mode, an allocation is sampled each time the number of bytes allocated since the
+ * previous sampled allocation reaches a random threshold, whose mean is the sampling interval.
+ * The call stack is only read for the sampled allocations, and the sampled allocations and their
+ * frees are written as records to a buffer, from which the application reads them with
+ * heap_trace_sampling_read() and sends them to the host (to a file, through app_trace, ...).
+ * The tool components/heap/tools/heap_trace_sampling_profile.py estimates from the records the
+ * number of bytes allocated and still in use by each call stack.
+ *
+ * The buffers are allocated from internal memory by this function. To free them, stop tracing
+ * and then call heap_trace_init_sampling(NULL).
+ *
+ * @param config Configuration of the sampling, or NULL to free the buffers
+ * @return
+ *  - ESP_ERR_INVALID_STATE Heap tracing is currently in progress.
+ *  - ESP_ERR_INVALID_ARG The sampling interval or one of the sizes is zero.
+ *  - ESP_ERR_NO_MEM The buffers can't be allocated.
+ *  - ESP_OK Heap tracing initialised successfully.
+ */
+esp_err_t heap_trace_init_sampling(const heap_trace_sampling_config_t *config);
+
+/**
+ * @brief Read the records written by heap tracing in sampling mode.
+ *
+ * The records are a stream of bytes, which can be read in parts of any size. heap_trace_start()
+ * discards the records not read yet and starts the stream again with a header.
+ *
+ * When the buffer is full, the new records are dropped and their number is written to the
+ * stream once there is room again, so the buffer should be read often enough.
+ *
+ * @param[out] buf Buffer receiving the records
+ * @param size Size of the buffer
+ * @return Number of bytes copied to the buffer, 0 if there is no record to read
+ */
+size_t heap_trace_sampling_read(void *buf, size_t size);
+
 /**
  * @brief Start heap tracing. All heap allocations & frees will be traced, until heap_trace_stop() is called.
  *
@@ -94,6 +152,9 @@ esp_err_t heap_trace_init_tohost(void);
  *
  * @note Calling this function while heap tracing is running will reset the heap trace state and continue tracing.
  *
+ * @note In sampling mode, heap_trace_init_sampling() must be called instead, and the mode is only reported
+ * by heap_trace_summary(): the frees of the sampled allocations are always recorded.
+ *
  * @param mode Mode for tracing.
  * - HEAP_TRACE_ALL means all heap allocations and frees are traced.
  * - HEAP_TRACE_LEAKS means only suspected memory leaks are traced. (When memory is freed, the record is removed from the trace buffer.)
@@ -149,6 +210,8 @@ esp_err_t heap_trace_resume(void);
  * @brief Return number of records in the heap trace buffer
  *
  * It is safe to call this function while heap tracing is running.
+ *
+ * In sampling mode, this is the number of sampled allocations not freed yet.
  */
 size_t heap_trace_get_count(void);
 
@@ -162,7 +225,8 @@ size_t heap_trace_get_count(void);
  * @param index Index (zero-based) of the record to return.
  * @param[out] record Record where the heap trace record will be copied.
  * @return
- * - ESP_ERR_NOT_SUPPORTED Project was compiled without heap tracing enabled in menuconfig.
+ * - ESP_ERR_NOT_SUPPORTED Project was compiled without heap tracing enabled in menuconfig, or heap tracing
+ *   is in sampling mode, whose records are read with heap_trace_sampling_read().
  * - ESP_ERR_INVALID_STATE Heap tracing was not initialised.
  * - ESP_ERR_INVALID_ARG Index is out of bounds for current heap trace record count.
  * - ESP_OK Record returned successfully.
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -11,9 +11,18 @@
 extern "C" {
 #endif
 
-void heap_caps_update_per_task_info_alloc(heap_t *heap, void *ptr, size_t size, uint32_t caps);
-void heap_caps_update_per_task_info_free(heap_t *heap, void *ptr);
-void heap_caps_update_per_task_info_realloc(heap_t *heap, void *old_ptr, void *new_ptr, size_t old_size, TaskHandle_t old_task, size_t new_size, uint32_t caps);
+/**
+ * @brief Give a heap its index in the per-task statistics, called when the heap is created.
+ */
+void heap_caps_task_tracking_register_heap(heap_t *heap);
+
+/**
+ * The functions below take the address of the block in the heap, where the block owner is
+ * stored, and set the block owner.
+ */
+void heap_caps_update_per_task_info_alloc(heap_t *heap, void *block, size_t size, uint32_t caps);
+void heap_caps_update_per_task_info_free(heap_t *heap, void *block);
+void heap_caps_update_per_task_info_realloc(heap_t *heap, void *old_owner, size_t old_size, void *new_block, size_t new_size, uint32_t caps);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "stdio.h"
+
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_frag.h"
+
+#define FRAG_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define HOLE_SIZE 256
+#define NUM_BLOCKS 32
+
+extern void set_leak_threshold(int threshold);
+
+TEST_CASE("fragmentation metrics are consistent with the heap information", "[heap][frag]")
+{
+    heap_caps_frag_info_t info;
+    heap_caps_get_frag_info(FRAG_CAPS, &info);
+
+    size_t blocks = 0;
+    size_t bytes = 0;
+    for (int i = 0; i < HEAP_CAPS_FRAG_SIZE_CLASSES; i++) {
+        blocks += info.free_blocks_by_class[i];
+        bytes += info.free_bytes_by_class[i];
+    }
+    TEST_ASSERT_EQUAL(info.free_blocks, blocks);
+    TEST_ASSERT_EQUAL(info.total_free_bytes, bytes);
+    TEST_ASSERT_GREATER_OR_EQUAL(heap_caps_get_largest_free_block(FRAG_CAPS), info.largest_free_block);
+    TEST_ASSERT_LESS_OR_EQUAL(info.total_free_bytes, info.largest_free_block);
+    TEST_ASSERT_LESS_THAN(1000, info.fragmentation);
+}
+
+TEST_CASE("fragmentation metrics count the holes left by freed blocks", "[heap][frag]")
+{
+    void *ptrs[NUM_BLOCKS];
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        ptrs[i] = heap_caps_malloc(HOLE_SIZE, FRAG_CAPS);
+        TEST_ASSERT_NOT_NULL(ptrs[i]);
+    }
+    heap_caps_frag_info_t before;
+    heap_caps_get_frag_info(FRAG_CAPS, &before);
+
+    for (int i = 0; i < NUM_BLOCKS; i += 2) {
+        heap_caps_free(ptrs[i]);
+    }
+    heap_caps_frag_info_t after;
+    heap_caps_get_frag_info(FRAG_CAPS, &after);
+    printf("free blocks %d -> %d, fragmentation %"PRIu32" -> %"PRIu32"\n",
+           before.free_blocks, after.free_blocks, before.fragmentation, after.fragmentation);
+
+    // most of the freed blocks can't merge with their neighbors
+    TEST_ASSERT_GREATER_OR_EQUAL(before.free_blocks + NUM_BLOCKS / 4, after.free_blocks);
+    TEST_ASSERT_GREATER_THAN(before.total_free_bytes, after.total_free_bytes);
+    TEST_ASSERT_GREATER_OR_EQUAL(before.fragmentation, after.fragmentation);
+
+    for (int i = 1; i < NUM_BLOCKS; i += 2) {
+        heap_caps_free(ptrs[i]);
+    }
+}
+
+TEST_CASE("fragmentation trend reports the evolution of the metrics", "[heap][frag]")
+{
+    heap_caps_frag_trend_t trend = { 0 };
+    heap_caps_frag_trend_info_t info;
+    void *ptrs[HEAP_CAPS_FRAG_TREND_SAMPLES + 2] = { 0 };
+
+    heap_caps_frag_trend_sample(&trend, FRAG_CAPS, 0);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_caps_frag_trend_get(&trend, &info));
+
+    // more samples than the trend keeps, each one with less free memory
+    for (int i = 0; i < HEAP_CAPS_FRAG_TREND_SAMPLES + 2; i++) {
+        ptrs[i] = heap_caps_malloc(4 * 1024, FRAG_CAPS);
+        TEST_ASSERT_NOT_NULL(ptrs[i]);
+        heap_caps_frag_trend_sample(&trend, FRAG_CAPS, (i + 1) * 100);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, heap_caps_frag_trend_get(&trend, &info));
+    TEST_ASSERT_EQUAL(HEAP_CAPS_FRAG_TREND_SAMPLES, info.samples);
+    TEST_ASSERT_EQUAL((HEAP_CAPS_FRAG_TREND_SAMPLES - 1) * 100, info.duration);
+    printf("largest free block slope %"PRId32" bytes per 1000, min %d\n", info.largest_free_block_slope, info.min_largest_free_block);
+
+    // allocating never makes the largest free block larger
+    TEST_ASSERT_LESS_OR_EQUAL(0, info.largest_free_block_slope);
+    size_t min_largest = SIZE_MAX;
+    for (int i = 0; i < HEAP_CAPS_FRAG_TREND_SAMPLES; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(1000, trend.samples[i].fragmentation);
+        if (trend.samples[i].largest_free_block < min_largest) {
+            min_largest = trend.samples[i].largest_free_block;
+        }
+    }
+    TEST_ASSERT_EQUAL(min_largest, info.min_largest_free_block);
+
+    for (int i = 0; i < HEAP_CAPS_FRAG_TREND_SAMPLES + 2; i++) {
+        heap_caps_free(ptrs[i]);
+    }
+}
+
+TEST_CASE("movable blocks keep their content when compacted", "[heap][frag]")
+{
+    heap_caps_movable_handle_t handles[NUM_BLOCKS];
+    void *addresses[NUM_BLOCKS];
+
+    // the pool of the handles is kept once created
+    set_leak_threshold(-1000);
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        handles[i] = heap_caps_malloc_movable(HOLE_SIZE, FRAG_CAPS);
+        TEST_ASSERT_NOT_NULL(handles[i]);
+        TEST_ASSERT_EQUAL(HOLE_SIZE, heap_caps_movable_get_size(handles[i]));
+        uint8_t *data = heap_caps_movable_lock(handles[i]);
+        memset(data, i, HOLE_SIZE);
+        addresses[i] = data;
+        heap_caps_movable_unlock(handles[i]);
+    }
+    // free one block out of two, the other blocks can move to the holes
+    for (int i = 0; i < NUM_BLOCKS; i += 2) {
+        heap_caps_free_movable(handles[i]);
+        handles[i] = NULL;
+    }
+
+    // a locked block is never moved
+    void *locked = heap_caps_movable_lock(handles[NUM_BLOCKS - 1]);
+
+    heap_caps_frag_info_t before;
+    heap_caps_get_frag_info(FRAG_CAPS, &before);
+    const size_t moved = heap_caps_compact(FRAG_CAPS);
+    heap_caps_frag_info_t after;
+    heap_caps_get_frag_info(FRAG_CAPS, &after);
+    printf("%d blocks moved, largest free block %d -> %d, fragmentation %"PRIu32" -> %"PRIu32"\n",
+           moved, before.largest_free_block, after.largest_free_block, before.fragmentation, after.fragmentation);
+
+    TEST_ASSERT_GREATER_THAN(0, moved);
+    TEST_ASSERT_EQUAL_PTR(locked, heap_caps_movable_lock(handles[NUM_BLOCKS - 1]));
+    heap_caps_movable_unlock(handles[NUM_BLOCKS - 1]);
+    heap_caps_movable_unlock(handles[NUM_BLOCKS - 1]);
+
+    size_t moved_found = 0;
+    for (int i = 1; i < NUM_BLOCKS; i += 2) {
+        uint8_t *data = heap_caps_movable_lock(handles[i]);
+        TEST_ASSERT_TRUE(heap_caps_check_integrity_addr((intptr_t)data, true));
+        TEST_ASSERT_EACH_EQUAL_HEX8(i, data, HOLE_SIZE);
+        if (data != addresses[i]) {
+            moved_found++;
+        }
+        heap_caps_movable_unlock(handles[i]);
+        heap_caps_free_movable(handles[i]);
+    }
+    // a block may move more than once, one pass after the other
+    TEST_ASSERT_GREATER_THAN(0, moved_found);
+    TEST_ASSERT_GREATER_OR_EQUAL(moved_found, moved);
+}
@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <string.h>
+#include "unity.h"
+#include "stdio.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
+#include "esp_memory_utils.h"
+
+#define POOL_OBJ_SIZE 24
+#define POOL_COUNT 8
+
+TEST_CASE("pool allocates objects with the requested capabilities", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(POOL_OBJ_SIZE, POOL_COUNT, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    void *objs[POOL_COUNT];
+    for (int i = 0; i < POOL_COUNT; i++) {
+        objs[i] = heap_caps_pool_alloc(pool);
+        TEST_ASSERT_NOT_NULL(objs[i]);
+        TEST_ASSERT_EQUAL(0, (intptr_t)objs[i] % sizeof(void *));
+        TEST_ASSERT_TRUE(esp_ptr_internal(objs[i]));
+        memset(objs[i], i, POOL_OBJ_SIZE);
+    }
+    TEST_ASSERT_NULL(heap_caps_pool_alloc(pool));
+
+    heap_caps_pool_info_t info;
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(POOL_OBJ_SIZE, info.obj_size);
+    TEST_ASSERT_EQUAL(POOL_COUNT, info.total_objects);
+    TEST_ASSERT_EQUAL(0, info.free_objects);
+    TEST_ASSERT_EQUAL(0, info.minimum_free_objects);
+    TEST_ASSERT_EQUAL(POOL_COUNT, info.max_objects);
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        heap_caps_pool_free(pool, objs[i]);
+    }
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(POOL_COUNT, info.free_objects);
+    TEST_ASSERT_EQUAL(0, info.minimum_free_objects);
+    heap_caps_pool_delete(pool);
+}
+
+TEST_CASE("growable pool gives its memory back when deleted", "[heap][pool]")
+{
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    heap_caps_pool_handle_t pool = heap_caps_pool_create_growable(POOL_OBJ_SIZE, POOL_COUNT, 3 * POOL_COUNT, MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    void *objs[3 * POOL_COUNT];
+    for (int i = 0; i < 3 * POOL_COUNT; i++) {
+        objs[i] = heap_caps_pool_alloc(pool);
+        TEST_ASSERT_NOT_NULL(objs[i]);
+    }
+    TEST_ASSERT_NULL(heap_caps_pool_alloc(pool));
+
+    heap_caps_pool_info_t info;
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(3 * POOL_COUNT, info.total_objects);
+    TEST_ASSERT_GREATER_OR_EQUAL(3 * POOL_COUNT * POOL_OBJ_SIZE, info.total_bytes);
+
+    for (int i = 0; i < 3 * POOL_COUNT; i++) {
+        heap_caps_pool_free(pool, objs[i]);
+    }
+    heap_caps_pool_delete(pool);
+    TEST_ASSERT_EQUAL(free_before, heap_caps_get_free_size(MALLOC_CAP_8BIT));
+}
+
+static size_t s_walked_used;
+static size_t s_walked_free;
+
+static bool pool_walker(walker_heap_into_t heap_info, walker_block_info_t block_info, void *user_data)
+{
+    // the free blocks of the heaps of this size are counted too
+    if (block_info.size == POOL_OBJ_SIZE && (block_info.ptr == *(void **)user_data || !block_info.used)) {
+        if (block_info.used) {
+            s_walked_used++;
+        } else {
+            s_walked_free++;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("heap walker reports the objects of a pool", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(POOL_OBJ_SIZE, POOL_COUNT, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(pool);
+    void *obj = heap_caps_pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(obj);
+
+    s_walked_used = 0;
+    s_walked_free = 0;
+    heap_caps_walk(MALLOC_CAP_DEFAULT, pool_walker, &obj);
+    TEST_ASSERT_EQUAL(1, s_walked_used);
+    TEST_ASSERT_GREATER_OR_EQUAL(POOL_COUNT - 1, s_walked_free);
+
+    heap_caps_print_heap_info(MALLOC_CAP_DEFAULT);
+    heap_caps_pool_free(pool, obj);
+    heap_caps_pool_delete(pool);
+}
+
+#if defined(CONFIG_HEAP_POISONING_LIGHT) || defined(CONFIG_HEAP_POISONING_COMPREHENSIVE)
+TEST_CASE("pool object overflow is detected", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(POOL_OBJ_SIZE, POOL_COUNT, MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(pool);
+    uint8_t *obj = heap_caps_pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(obj);
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+
+    uint8_t saved = obj[POOL_OBJ_SIZE];
+    obj[POOL_OBJ_SIZE] = 0xaa;
+    TEST_ASSERT_FALSE(heap_caps_check_integrity_all(true));
+    obj[POOL_OBJ_SIZE] = saved;
+    TEST_ASSERT_TRUE(heap_caps_check_integrity_all(true));
+
+    heap_caps_pool_free(pool, obj);
+    heap_caps_pool_delete(pool);
+}
+#endif
+
+#define POOL_TASK_ITERATIONS 10000
+
+typedef struct {
+    heap_caps_pool_handle_t pool;
+    SemaphoreHandle_t done;
+    uint32_t marker;
+} pool_task_args_t;
+
+static void pool_task(void *arg)
+{
+    pool_task_args_t *args = (pool_task_args_t *)arg;
+    uint32_t *objs[POOL_COUNT / 2];
+    for (int i = 0; i < POOL_TASK_ITERATIONS; i++) {
+        for (int j = 0; j < POOL_COUNT / 2; j++) {
+            objs[j] = heap_caps_pool_alloc(args->pool);
+            TEST_ASSERT_NOT_NULL(objs[j]);
+            *objs[j] = args->marker;
+        }
+        for (int j = 0; j < POOL_COUNT / 2; j++) {
+            // an object allocated twice would have been overwritten by the other task
+            TEST_ASSERT_EQUAL_HEX32(args->marker, *objs[j]);
+            heap_caps_pool_free(args->pool, objs[j]);
+        }
+    }
+    xSemaphoreGive(args->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("pool is shared by tasks on both cores", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(POOL_OBJ_SIZE, POOL_COUNT, MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(pool);
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(portNUM_PROCESSORS, 0);
+    TEST_ASSERT_NOT_NULL(done);
+
+    pool_task_args_t args[portNUM_PROCESSORS];
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        args[core] = (pool_task_args_t) {
+            .pool = pool, .done = done, .marker = 0x5A5A0000 | core
+        };
+        xTaskCreatePinnedToCore(pool_task, "pool_task", 4096, &args[core], uxTaskPriorityGet(NULL), NULL, core);
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(done, pdMS_TO_TICKS(10000)));
+    }
+
+    heap_caps_pool_info_t info;
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(POOL_COUNT, info.free_objects);
+    vSemaphoreDelete(done);
+    heap_caps_pool_delete(pool);
+}
@@ -1,17 +1,20 @@
 /*
- * SPDX-FileCopyrightText: 2022-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
 #include "unity.h"
 #include "stdio.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <inttypes.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_heap_caps.h"
 #include "esp_heap_task_info.h"
+#include "esp_cpu.h"
 
 extern void set_leak_threshold(int threshold);
 
@@ -382,4 +385,106 @@ TEST_CASE("heap task tracking realloc with reused TaskHandle does not underflow
     vTaskDelete(dummy_task_handle);
 }
 
+
+#define NUM_LIVE_ALLOC_TASKS 4
+#define NUM_LIVE_ALLOCS_PER_TASK 250
+#define NUM_TIMED_ALLOCS 200
+#define NUM_TIMING_RUNS 5
+
+static TaskHandle_t s_timing_test_task;
+
+static void live_alloc_task(void *args)
+{
+    void **ptrs = (void **)args;
+    for (size_t i = 0; i < NUM_LIVE_ALLOCS_PER_TASK; i++) {
+        ptrs[i] = heap_caps_malloc(ALLOC_BYTES, MALLOC_CAP_DEFAULT);
+    }
+    xTaskNotifyGive(s_timing_test_task);
+
+    // wait for main to measure the timings, then free the memory
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (size_t i = 0; i < NUM_LIVE_ALLOCS_PER_TASK; i++) {
+        heap_caps_free(ptrs[i]);
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static uint32_t average_alloc_free_cycles(void)
+{
+    uint64_t cycles = 0;
+    for (size_t i = 0; i < NUM_TIMED_ALLOCS; i++) {
+        uint32_t cycles_before = esp_cpu_get_cycle_count();
+        void *ptr = heap_caps_malloc(ALLOC_BYTES, MALLOC_CAP_DEFAULT);
+        heap_caps_free(ptr);
+        cycles += esp_cpu_get_cycle_count() - cycles_before;
+        TEST_ASSERT_NOT_NULL(ptr);
+    }
+    return cycles / NUM_TIMED_ALLOCS;
+}
+
+static int compare_cycles(const void *a, const void *b)
+{
+    const uint32_t cycles_a = *(const uint32_t *)a;
+    const uint32_t cycles_b = *(const uint32_t *)b;
+    return (cycles_a > cycles_b) - (cycles_a < cycles_b);
+}
+
+/* The median of several runs, so a run disturbed by a cache miss or by another task doesn't count */
+static uint32_t median_alloc_free_cycles(void)
+{
+    uint32_t runs[NUM_TIMING_RUNS];
+    for (size_t i = 0; i < NUM_TIMING_RUNS; i++) {
+        runs[i] = average_alloc_free_cycles();
+    }
+    qsort(runs, NUM_TIMING_RUNS, sizeof(runs[0]), compare_cycles);
+    return runs[NUM_TIMING_RUNS / 2];
+}
+
+/* The statistics of the tasks are updated in constant time when allocating and freeing memory,
+ * so the time spent in malloc / free must not depend on the number of live allocations
+ * tracked for the other tasks and for the current task. The timings depend on the caches
+ * and on the other tasks, so the median of several runs is compared with a 2x margin.
+ */
+TEST_CASE("heap task tracking overhead does not grow with the number of live allocations", "[heap]")
+{
+    static void *ptrs[NUM_LIVE_ALLOC_TASKS][NUM_LIVE_ALLOCS_PER_TASK];
+    static void *own_ptrs[NUM_LIVE_ALLOCS_PER_TASK];
+    TaskHandle_t task_handles[NUM_LIVE_ALLOC_TASKS];
+
+    // the statistics of the tasks created by this test are kept after their deletion
+    set_leak_threshold(-5000);
+
+    // warm up, so the statistics of the current task are created before timing
+    heap_caps_free(heap_caps_malloc(ALLOC_BYTES, MALLOC_CAP_DEFAULT));
+    const uint32_t cycles_few_allocs = median_alloc_free_cycles();
+
+    s_timing_test_task = xTaskGetCurrentTaskHandle();
+    for (size_t i = 0; i < NUM_LIVE_ALLOC_TASKS; i++) {
+        xTaskCreate(&live_alloc_task, "live_alloc_task", 3072, ptrs[i], 5, &task_handles[i]);
+    }
+    for (size_t i = 0; i < NUM_LIVE_ALLOC_TASKS; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    for (size_t i = 0; i < NUM_LIVE_ALLOCS_PER_TASK; i++) {
+        own_ptrs[i] = heap_caps_malloc(ALLOC_BYTES, MALLOC_CAP_DEFAULT);
+        TEST_ASSERT_NOT_NULL(own_ptrs[i]);
+    }
+    const uint32_t cycles_many_allocs = median_alloc_free_cycles();
+
+    printf("malloc + free: %"PRIu32" cycles with few live allocations, %"PRIu32" cycles with %d live allocations\n",
+           cycles_few_allocs, cycles_many_allocs, (NUM_LIVE_ALLOC_TASKS + 1) * NUM_LIVE_ALLOCS_PER_TASK);
+    TEST_ASSERT_LESS_THAN_UINT32(cycles_few_allocs * 2, cycles_many_allocs);
+
+    for (size_t i = 0; i < NUM_LIVE_ALLOCS_PER_TASK; i++) {
+        heap_caps_free(own_ptrs[i]);
+    }
+    for (size_t i = 0; i < NUM_LIVE_ALLOC_TASKS; i++) {
+        xTaskNotifyGive(task_handles[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+    for (size_t i = 0; i < NUM_LIVE_ALLOC_TASKS; i++) {
+        vTaskDelete(task_handles[i]);
+    }
+}
+
 #endif // CONFIG_HEAP_TASK_TRACKING
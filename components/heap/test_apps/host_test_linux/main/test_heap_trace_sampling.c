@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "sdkconfig.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_trace.h"
+#include "unity.h"
+
+#if CONFIG_HEAP_TRACING_SAMPLING
+
+#define ALLOC_COUNT 1000
+#define ALLOC_SIZE 100
+
+/* Records read from the stream, see heap_trace_sampling.c for their format */
+typedef struct {
+    bool has_header;
+    uint32_t sampling_interval;
+    size_t allocs;
+    size_t frees;
+    size_t lost;
+    size_t alloc_bytes;
+    void *alloc_addresses[ALLOC_COUNT];
+    void *free_addresses[ALLOC_COUNT];
+} parsed_stream_t;
+
+static void parse_stream(parsed_stream_t *parsed)
+{
+    static uint8_t data[256 * 1024];
+    size_t len = 0;
+    size_t read;
+    // read by odd sizes, the records can be split anywhere
+    while ((read = heap_trace_sampling_read(data + len, MIN(77, sizeof(data) - len))) != 0) {
+        len += read;
+    }
+
+    memset(parsed, 0, sizeof(*parsed));
+    size_t pos = 0;
+    while (pos < len) {
+        const uint8_t type = data[pos];
+        const uint8_t count = data[pos + 1];
+        uint32_t value;
+        memcpy(&value, &data[pos + 4], sizeof(value));
+        pos += 8;
+        void *address = NULL;
+        switch (type) {
+        case 0:
+            TEST_ASSERT_EQUAL(sizeof(void *), data[pos - 6]);
+            TEST_ASSERT_EQUAL_HEX32(0x50535448, value);
+            memcpy(&parsed->sampling_interval, &data[pos], sizeof(uint32_t));
+            parsed->has_header = true;
+            pos += 8;
+            break;
+        case 1: {
+            uint32_t size;
+            memcpy(&address, &data[pos], sizeof(void *));
+            memcpy(&size, &data[pos + sizeof(void *)], sizeof(size));
+            TEST_ASSERT_LESS_OR_EQUAL(CONFIG_HEAP_TRACING_STACK_DEPTH, count);
+            pos += sizeof(void *) + sizeof(size) + count * sizeof(void *);
+            if (parsed->allocs < ALLOC_COUNT) {
+                parsed->alloc_addresses[parsed->allocs] = address;
+            }
+            parsed->allocs++;
+            parsed->alloc_bytes += size;
+            break;
+        }
+        case 2:
+            memcpy(&address, &data[pos], sizeof(void *));
+            pos += sizeof(void *);
+            if (parsed->frees < ALLOC_COUNT) {
+                parsed->free_addresses[parsed->frees] = address;
+            }
+            parsed->frees++;
+            break;
+        case 3:
+            parsed->lost += value;
+            break;
+        default:
+            TEST_FAIL_MESSAGE("unknown record type");
+        }
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+}
+
+static void start_sampling(size_t sampling_interval, size_t buffer_size)
+{
+    heap_trace_sampling_config_t config = HEAP_TRACE_SAMPLING_CONFIG_DEFAULT();
+    config.sampling_interval = sampling_interval;
+    config.buffer_size = buffer_size;
+    config.max_live_samples = ALLOC_COUNT;
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_init_sampling(&config));
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_start(HEAP_TRACE_LEAKS));
+}
+
+static void stop_sampling(void)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_stop());
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_init_sampling(NULL));
+}
+
+TEST_CASE("sampling with a small interval records each allocation and its free", "[heap-trace-sampling]")
+{
+    static parsed_stream_t parsed;
+    static void *ptrs[ALLOC_COUNT];
+    start_sampling(1, 128 * 1024);
+
+    for (int i = 0; i < ALLOC_COUNT; i++) {
+        ptrs[i] = heap_caps_malloc(ALLOC_SIZE, MALLOC_CAP_DEFAULT);
+        TEST_ASSERT_NOT_NULL(ptrs[i]);
+    }
+    for (int i = 0; i < ALLOC_COUNT; i += 2) {
+        heap_caps_free(ptrs[i]);
+    }
+    TEST_ASSERT_EQUAL(ALLOC_COUNT / 2, heap_trace_get_count());
+
+    heap_trace_summary_t summary;
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_summary(&summary));
+    TEST_ASSERT_EQUAL(ALLOC_COUNT, summary.total_allocations);
+    TEST_ASSERT_EQUAL(ALLOC_COUNT / 2, summary.total_frees);
+    TEST_ASSERT_FALSE(summary.has_overflowed);
+
+    heap_trace_record_t record;
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, heap_trace_get(0, &record));
+
+    parse_stream(&parsed);
+    TEST_ASSERT_TRUE(parsed.has_header);
+    TEST_ASSERT_EQUAL(1, parsed.sampling_interval);
+    TEST_ASSERT_EQUAL(ALLOC_COUNT, parsed.allocs);
+    TEST_ASSERT_EQUAL(ALLOC_COUNT * ALLOC_SIZE, parsed.alloc_bytes);
+    TEST_ASSERT_EQUAL(ALLOC_COUNT / 2, parsed.frees);
+    TEST_ASSERT_EQUAL(0, parsed.lost);
+    for (int i = 0; i < ALLOC_COUNT; i++) {
+        TEST_ASSERT_EQUAL_PTR(ptrs[i], parsed.alloc_addresses[i]);
+    }
+    for (int i = 0; i < ALLOC_COUNT / 2; i++) {
+        TEST_ASSERT_EQUAL_PTR(ptrs[2 * i], parsed.free_addresses[i]);
+    }
+
+    stop_sampling();
+    for (int i = 1; i < ALLOC_COUNT; i += 2) {
+        heap_caps_free(ptrs[i]);
+    }
+}
+
+TEST_CASE("sampling records allocations in proportion to the allocated bytes", "[heap-trace-sampling]")
+{
+    static parsed_stream_t parsed;
+    const size_t interval = 1024;
+    const int rounds = 100;
+    start_sampling(interval, 256 * 1024);
+
+    for (int round = 0; round < rounds; round++) {
+        void *ptrs[ALLOC_COUNT / 10];
+        for (int i = 0; i < ALLOC_COUNT / 10; i++) {
+            ptrs[i] = heap_caps_malloc(ALLOC_SIZE, MALLOC_CAP_DEFAULT);
+            TEST_ASSERT_NOT_NULL(ptrs[i]);
+        }
+        for (int i = 0; i < ALLOC_COUNT / 10; i++) {
+            heap_caps_free(ptrs[i]);
+        }
+    }
+
+    // about 1 sample every 'interval' bytes
+    const size_t expected = rounds * (ALLOC_COUNT / 10) * ALLOC_SIZE / interval;
+    parse_stream(&parsed);
+    printf("%zu allocations sampled, %zu expected\n", parsed.allocs, expected);
+    TEST_ASSERT_GREATER_THAN(expected * 3 / 4, parsed.allocs);
+    TEST_ASSERT_LESS_THAN(expected * 5 / 4, parsed.allocs);
+    TEST_ASSERT_EQUAL(parsed.allocs, parsed.frees);
+    TEST_ASSERT_EQUAL(0, heap_trace_get_count());
+
+    stop_sampling();
+}
+
+TEST_CASE("sampling reports the records dropped when the buffer is full", "[heap-trace-sampling]")
+{
+    static parsed_stream_t parsed;
+    start_sampling(1, 256);
+
+    for (int i = 0; i < 100; i++) {
+        heap_caps_free(heap_caps_malloc(ALLOC_SIZE, MALLOC_CAP_DEFAULT));
+    }
+    parse_stream(&parsed);
+    TEST_ASSERT_TRUE(parsed.has_header);
+    TEST_ASSERT_LESS_THAN(100, parsed.allocs);
+
+    // the number of records dropped is written once there is room again
+    heap_caps_free(heap_caps_malloc(ALLOC_SIZE, MALLOC_CAP_DEFAULT));
+    parse_stream(&parsed);
+    TEST_ASSERT_GREATER_THAN(0, parsed.lost);
+    TEST_ASSERT_EQUAL(1, parsed.allocs);
+    TEST_ASSERT_EQUAL(1, parsed.frees);
+
+    heap_trace_summary_t summary;
+    TEST_ASSERT_EQUAL(ESP_OK, heap_trace_summary(&summary));
+    TEST_ASSERT_TRUE(summary.has_overflowed);
+    heap_trace_dump();
+
+    stop_sampling();
+}
+
+TEST_CASE("sampling mode can't be initialised while tracing", "[heap-trace-sampling]")
+{
+    heap_trace_sampling_config_t config = HEAP_TRACE_SAMPLING_CONFIG_DEFAULT();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_trace_start(HEAP_TRACE_ALL));
+    config.sampling_interval = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, heap_trace_init_sampling(&config));
+
+    start_sampling(1024, 1024);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_trace_init_sampling(&config));
+    stop_sampling();
+}
+
+#endif // CONFIG_HEAP_TRACING_SAMPLING
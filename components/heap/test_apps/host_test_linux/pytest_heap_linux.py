@@ -1,4 +1,4 @@
-# SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Unlicense OR CC0-1.0
 import pytest
 from pytest_embedded import Dut
@@ -6,6 +6,7 @@ from pytest_embedded_idf.utils import idf_parametrize
 
 
 @pytest.mark.host_test
+@pytest.mark.parametrize('config', ['default', 'trace_sampling'], indirect=True)
 @idf_parametrize('target', ['linux'], indirect=['target'])
 def test_heap_linux(dut: Dut) -> None:
     dut.run_all_single_board_cases(timeout=60)
@@ -0,0 +1,217 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "multi_heap.h"
+
+/* The core cache is not available on Linux, use its default configuration */
+#define CONFIG_HEAP_CORE_CACHE_MAX_SIZE 64
+#define CONFIG_HEAP_CORE_CACHE_DEPTH 8
+#include "../heap_caps_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST_CASE("heap cache size classes", "[heap_cache]")
+{
+    CHECK(heap_cache_alloc_class(0) == HEAP_CACHE_CLASSES);
+    CHECK(heap_cache_alloc_class(1) == 0);
+    CHECK(heap_cache_alloc_class(8) == 0);
+    CHECK(heap_cache_alloc_class(9) == 1);
+    CHECK(heap_cache_alloc_class(64) == HEAP_CACHE_CLASSES - 1);
+    CHECK(heap_cache_alloc_class(65) == HEAP_CACHE_CLASSES);
+
+    CHECK(heap_cache_free_class(7) == HEAP_CACHE_CLASSES);
+    CHECK(heap_cache_free_class(8) == 0);
+    CHECK(heap_cache_free_class(15) == 0);
+    CHECK(heap_cache_free_class(71) == HEAP_CACHE_CLASSES - 1);
+    CHECK(heap_cache_free_class(72) == HEAP_CACHE_CLASSES);
+
+    // a block freed to a class can serve any allocation from this class
+    for (size_t size = 1; size <= CONFIG_HEAP_CORE_CACHE_MAX_SIZE; size++) {
+        size_t cls = heap_cache_alloc_class(size);
+        CHECK(heap_cache_class_size(cls) >= size);
+        CHECK(heap_cache_free_class(heap_cache_class_size(cls)) == cls);
+    }
+}
+
+TEST_CASE("heap cache push, pop and take", "[heap_cache]")
+{
+    heap_cache_t cache = {};
+    int blocks[HEAP_CACHE_DEPTH];
+
+    CHECK(heap_cache_pop(&cache, 1) == NULL);
+    for (int i = 0; i < HEAP_CACHE_DEPTH; i++) {
+        CHECK(heap_cache_push(&cache, 1, &blocks[i]));
+    }
+    CHECK_FALSE(heap_cache_push(&cache, 1, &blocks[0]));
+    CHECK(heap_cache_contains(&cache, 1, &blocks[3]));
+    CHECK_FALSE(heap_cache_contains(&cache, 2, &blocks[3]));
+
+    // the oldest blocks are taken, the newest ones are popped
+    void *taken[HEAP_CACHE_BATCH];
+    CHECK(heap_cache_take(&cache, 1, taken, HEAP_CACHE_BATCH) == HEAP_CACHE_BATCH);
+    CHECK(taken[0] == &blocks[0]);
+    CHECK(taken[HEAP_CACHE_BATCH - 1] == &blocks[HEAP_CACHE_BATCH - 1]);
+    CHECK(cache.count[1] == HEAP_CACHE_DEPTH - HEAP_CACHE_BATCH);
+    CHECK(heap_cache_pop(&cache, 1) == &blocks[HEAP_CACHE_DEPTH - 1]);
+    CHECK_FALSE(heap_cache_contains(&cache, 1, &blocks[0]));
+}
+
+/* Shared heap of the benchmark, the mutex plays the role of the heap spinlock */
+struct SharedHeap {
+    static const size_t SIZE = 1024 * 1024;
+    void *memory;
+    multi_heap_handle_t heap;
+    std::mutex lock;
+
+    SharedHeap()
+    {
+        memory = malloc(SIZE);
+        REQUIRE(memory != NULL);
+        heap = multi_heap_register(memory, SIZE);
+        REQUIRE(heap != NULL);
+    }
+
+    ~SharedHeap()
+    {
+        free(memory);
+    }
+};
+
+/* Same allocation and free paths as heap_caps_cache.c, for a single heap */
+struct ThreadCache {
+    SharedHeap &shared;
+    heap_cache_t cache = {};
+
+    ThreadCache(SharedHeap &shared) : shared(shared) { }
+
+    ~ThreadCache()
+    {
+        std::lock_guard<std::mutex> guard(shared.lock);
+        for (size_t cls = 0; cls < HEAP_CACHE_CLASSES; cls++) {
+            void *block;
+            while ((block = heap_cache_pop(&cache, cls)) != NULL) {
+                multi_heap_free(shared.heap, block);
+            }
+        }
+    }
+
+    void *malloc(size_t size)
+    {
+        size_t cls = heap_cache_alloc_class(size);
+        void *block = heap_cache_pop(&cache, cls);
+        if (block != NULL) {
+            return block;
+        }
+        void *blocks[HEAP_CACHE_BATCH];
+        size_t count = 0;
+        {
+            std::lock_guard<std::mutex> guard(shared.lock);
+            while (count < HEAP_CACHE_BATCH
+                    && (blocks[count] = multi_heap_malloc(shared.heap, heap_cache_class_size(cls))) != NULL) {
+                count++;
+            }
+        }
+        if (count == 0) {
+            return NULL;
+        }
+        for (size_t i = 0; i + 1 < count; i++) {
+            heap_cache_push(&cache, cls, blocks[i]);
+        }
+        return blocks[count - 1];
+    }
+
+    void free(void *block)
+    {
+        size_t cls = heap_cache_free_class(multi_heap_get_allocated_size(shared.heap, block));
+        assert(cls != HEAP_CACHE_CLASSES);
+        if (heap_cache_push(&cache, cls, block)) {
+            return;
+        }
+        void *drained[HEAP_CACHE_BATCH];
+        size_t count = heap_cache_take(&cache, cls, drained, HEAP_CACHE_BATCH);
+        heap_cache_push(&cache, cls, block);
+        std::lock_guard<std::mutex> guard(shared.lock);
+        for (size_t i = 0; i < count; i++) {
+            multi_heap_free(shared.heap, drained[i]);
+        }
+    }
+};
+
+static const int BENCH_ITERATIONS = 20000;
+static const int BENCH_BURST = 16;
+
+/* Each thread allocates bursts of small blocks of random sizes, then frees them.
+   Catch2 assertions are not thread-safe, the threads use assert() */
+template<typename Malloc, typename Free>
+static void run_bursts(unsigned seed, Malloc do_malloc, Free do_free)
+{
+    std::minstd_rand rand(seed);
+    void *blocks[BENCH_BURST];
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        for (int j = 0; j < BENCH_BURST; j++) {
+            blocks[j] = do_malloc(1 + rand() % CONFIG_HEAP_CORE_CACHE_MAX_SIZE);
+            assert(blocks[j] != NULL);
+        }
+        for (int j = 0; j < BENCH_BURST; j++) {
+            do_free(blocks[j]);
+        }
+    }
+}
+
+template<typename Worker>
+static double ns_per_malloc_free(int thread_count, Worker worker)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back(worker, t + 1);
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return (double)elapsed.count() / ((double)thread_count * BENCH_ITERATIONS * BENCH_BURST);
+}
+
+TEST_CASE("benchmark small allocations from several threads", "[heap_cache][perf]")
+{
+    const int thread_counts[] = { 1, 2, 4 };
+    for (int thread_count : thread_counts) {
+        SharedHeap shared;
+        const double locked = ns_per_malloc_free(thread_count, [&shared](unsigned seed) {
+            run_bursts(seed, [&shared](size_t size) {
+                std::lock_guard<std::mutex> guard(shared.lock);
+                return multi_heap_malloc(shared.heap, size);
+            }, [&shared](void *block) {
+                std::lock_guard<std::mutex> guard(shared.lock);
+                multi_heap_free(shared.heap, block);
+            });
+        });
+        const double cached = ns_per_malloc_free(thread_count, [&shared](unsigned seed) {
+            ThreadCache cache(shared);
+            run_bursts(seed, [&cache](size_t size) {
+                return cache.malloc(size);
+            }, [&cache](void *block) {
+                cache.free(block);
+            });
+        });
+        printf("malloc + free with %d threads: heap lock %.1f ns, thread cache %.1f ns\n", thread_count, locked, cached);
+        CHECK(locked > 0);
+        CHECK(cached > 0);
+
+        multi_heap_info_t info;
+        multi_heap_get_info(shared.heap, &info);
+        CHECK(info.allocated_blocks == 0);
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "multi_heap.h"
+
+#include "../heap_caps_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Pool with its chunks allocated from the libc heap, as done by heap_caps_pool.c */
+struct TestPool {
+    heap_pool_t pool;
+    std::vector<uint8_t *> chunks;
+
+    TestPool(size_t obj_size, size_t chunk_objects, size_t max_chunks) : chunks(max_chunks)
+    {
+        REQUIRE(heap_pool_init(&pool, chunks.data(), obj_size, chunk_objects, max_chunks));
+        REQUIRE(grow());
+    }
+
+    ~TestPool()
+    {
+        for (size_t chunk = 0; chunk < pool.chunk_count; chunk++) {
+            free(pool.chunks[chunk]);
+        }
+    }
+
+    bool grow()
+    {
+        if (pool.chunk_count == pool.max_chunks) {
+            return false;
+        }
+        uint8_t *mem = (uint8_t *)malloc(heap_pool_chunk_size(&pool));
+        REQUIRE(mem != NULL);
+        heap_pool_prepare_chunk(&pool, pool.chunk_count, mem);
+        heap_pool_publish_chunk(&pool, mem);
+        return true;
+    }
+};
+
+TEST_CASE("pool allocates each object once", "[heap_pool]")
+{
+    const size_t count = 16;
+    TestPool test(20, count, 1);
+    std::vector<void *> objs;
+
+    for (size_t i = 0; i < count; i++) {
+        void *obj = heap_pool_alloc(&test.pool);
+        REQUIRE(obj != NULL);
+        CHECK((uintptr_t)obj % sizeof(void *) == 0);
+        CHECK(heap_pool_index(&test.pool, obj) < count);
+        for (void *other : objs) {
+            CHECK(other != obj);
+        }
+        memset(obj, 0x55, 20);
+        objs.push_back(obj);
+    }
+    CHECK(heap_pool_alloc(&test.pool) == NULL);
+    CHECK(test.pool.free_count == 0);
+    CHECK(test.pool.min_free_count == 0);
+    CHECK(heap_pool_check(&test.pool, true));
+
+    CHECK(heap_pool_index(&test.pool, (uint8_t *)objs[0] + 1) == HEAP_POOL_MAX_OBJECTS);
+    CHECK(heap_pool_index(&test.pool, &count) == HEAP_POOL_MAX_OBJECTS);
+
+    for (void *obj : objs) {
+        CHECK(heap_pool_is_used(&test.pool, heap_pool_index(&test.pool, obj)));
+        heap_pool_free(&test.pool, obj);
+        CHECK_FALSE(heap_pool_is_used(&test.pool, heap_pool_index(&test.pool, obj)));
+    }
+    CHECK(test.pool.free_count == count);
+    // the last freed object is allocated first
+    CHECK(heap_pool_alloc(&test.pool) == objs.back());
+}
+
+TEST_CASE("pool grows by chunks", "[heap_pool]")
+{
+    TestPool test(8, 4, 3);
+    std::vector<void *> objs;
+
+    for (int chunk = 0; chunk < 3; chunk++) {
+        void *obj;
+        while ((obj = heap_pool_alloc(&test.pool)) != NULL) {
+            objs.push_back(obj);
+        }
+        CHECK(objs.size() == (size_t)(4 * (chunk + 1)));
+        CHECK(test.grow() == (chunk < 2));
+    }
+    for (size_t i = 0; i < objs.size(); i++) {
+        CHECK(heap_pool_index(&test.pool, objs[i]) != HEAP_POOL_MAX_OBJECTS);
+        heap_pool_free(&test.pool, objs[i]);
+    }
+    CHECK(test.pool.free_count == 12);
+    CHECK(heap_pool_check(&test.pool, true));
+}
+
+TEST_CASE("pool rejects too many objects", "[heap_pool]")
+{
+    heap_pool_t pool;
+    uint8_t *chunks[4];
+    CHECK_FALSE(heap_pool_init(&pool, chunks, 16, HEAP_POOL_MAX_OBJECTS / 4 + 1, 4));
+    CHECK_FALSE(heap_pool_init(&pool, chunks, 0, 16, 4));
+    CHECK(heap_pool_init(&pool, chunks, 16, HEAP_POOL_MAX_OBJECTS / 4, 4));
+}
+
+#ifdef MULTI_HEAP_POISONING
+TEST_CASE("pool detects an object overflow", "[heap_pool]")
+{
+    TestPool test(13, 4, 1);
+    uint8_t *obj = (uint8_t *)heap_pool_alloc(&test.pool);
+    REQUIRE(obj != NULL);
+    CHECK(heap_pool_check(&test.pool, false));
+
+    obj[13] ^= 0xff;
+    CHECK_FALSE(heap_pool_check(&test.pool, false));
+    obj[13] ^= 0xff;
+    CHECK(heap_pool_check(&test.pool, false));
+    heap_pool_free(&test.pool, obj);
+}
+#endif
+
+static const int BENCH_ITERATIONS = 50000;
+static const int BENCH_BURST = 8;
+static const size_t BENCH_OBJ_SIZE = 48;
+
+/* Each thread allocates bursts of objects, then frees them.
+   Catch2 assertions are not thread-safe, the threads use assert() */
+template<typename Alloc, typename Free>
+static void run_bursts(uintptr_t marker, Alloc do_alloc, Free do_free)
+{
+    uintptr_t *objs[BENCH_BURST];
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        for (int j = 0; j < BENCH_BURST; j++) {
+            objs[j] = (uintptr_t *)do_alloc();
+            assert(objs[j] != NULL);
+            *objs[j] = marker;
+        }
+        for (int j = 0; j < BENCH_BURST; j++) {
+            // an object allocated twice would have been overwritten by another thread
+            assert(*objs[j] == marker);
+            do_free(objs[j]);
+        }
+    }
+}
+
+template<typename Worker>
+static double ns_per_alloc_free(int thread_count, Worker worker)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back(worker, t + 1);
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return (double)elapsed.count() / ((double)thread_count * BENCH_ITERATIONS * BENCH_BURST);
+}
+
+TEST_CASE("benchmark pool against heap from several threads", "[heap_pool][perf]")
+{
+    const int thread_counts[] = { 1, 2, 4 };
+    for (int thread_count : thread_counts) {
+        const size_t heap_size = 256 * 1024;
+        void *memory = malloc(heap_size);
+        REQUIRE(memory != NULL);
+        multi_heap_handle_t heap = multi_heap_register(memory, heap_size);
+        REQUIRE(heap != NULL);
+        std::mutex heap_lock;
+        const double locked = ns_per_alloc_free(thread_count, [&](uintptr_t marker) {
+            run_bursts(marker, [&]() {
+                std::lock_guard<std::mutex> guard(heap_lock);
+                return multi_heap_malloc(heap, BENCH_OBJ_SIZE);
+            }, [&](void *obj) {
+                std::lock_guard<std::mutex> guard(heap_lock);
+                multi_heap_free(heap, obj);
+            });
+        });
+        free(memory);
+
+        TestPool test(BENCH_OBJ_SIZE, thread_count * BENCH_BURST, 1);
+        const double pooled = ns_per_alloc_free(thread_count, [&](uintptr_t marker) {
+            run_bursts(marker, [&]() {
+                return heap_pool_alloc(&test.pool);
+            }, [&](void *obj) {
+                heap_pool_free(&test.pool, obj);
+            });
+        });
+        printf("alloc + free with %d threads: heap lock %.1f ns, pool %.1f ns\n", thread_count, locked, pooled);
+        CHECK(locked > 0);
+        CHECK(pooled > 0);
+        CHECK(test.pool.free_count == (uint32_t)(thread_count * BENCH_BURST));
+        CHECK(heap_pool_check(&test.pool, true));
+    }
+}
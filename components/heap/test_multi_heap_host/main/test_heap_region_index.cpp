@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "multi_heap.h"
+
+#include "../heap_region_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+/* Registered heap, as heap_t of heap_private.h (which depends on the SoC memory layout) */
+typedef struct test_heap_ {
+    intptr_t start;
+    intptr_t end;
+    multi_heap_handle_t heap;
+    struct test_heap_ *next;
+} test_heap_t;
+
+static const size_t TEST_HEAP_SIZE = 16 * 1024;
+static const size_t TEST_MAX_HEAPS = 16;
+static const size_t TEST_BLOCKS_PER_HEAP = 64;
+static const int TEST_ROUNDS = 200;
+
+struct TestHeaps {
+    std::vector<test_heap_t> heaps;
+    test_heap_t *list;
+    std::vector<intptr_t> starts;
+    std::vector<test_heap_t *> sorted;
+
+    TestHeaps(size_t count) : heaps(count), list(NULL)
+    {
+        for (size_t i = 0; i < count; i++) {
+            void *buf = malloc(TEST_HEAP_SIZE);
+            REQUIRE(buf != NULL);
+            heaps[i].start = (intptr_t)buf;
+            heaps[i].end = (intptr_t)buf + TEST_HEAP_SIZE;
+            heaps[i].heap = multi_heap_register(buf, TEST_HEAP_SIZE);
+            REQUIRE(heaps[i].heap != NULL);
+            heaps[i].next = list;
+            list = &heaps[i];
+        }
+        for (test_heap_t &heap : heaps) {
+            sorted.push_back(&heap);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const test_heap_t *a, const test_heap_t *b) {
+            return a->start < b->start;
+        });
+        for (test_heap_t *heap : sorted) {
+            starts.push_back(heap->start);
+        }
+    }
+
+    ~TestHeaps()
+    {
+        for (test_heap_t &heap : heaps) {
+            free((void *)heap.start);
+        }
+    }
+
+    // Previous implementation of find_containing_heap(): walk through the list of heaps
+    test_heap_t *find_linear(void *ptr) const
+    {
+        intptr_t p = (intptr_t)ptr;
+        for (test_heap_t *heap = list; heap != NULL; heap = heap->next) {
+            if (p >= heap->start && p < heap->end) {
+                return heap;
+            }
+        }
+        return NULL;
+    }
+
+    test_heap_t *find_indexed(void *ptr) const
+    {
+        intptr_t p = (intptr_t)ptr;
+        size_t i = heap_region_index_search(starts.data(), starts.size(), p);
+        if (i == 0 || p >= sorted[i - 1]->end) {
+            return NULL;
+        }
+        return sorted[i - 1];
+    }
+};
+
+TEST_CASE("heap region index finds the containing heap", "[heap_region_index]")
+{
+    TestHeaps test(TEST_MAX_HEAPS);
+
+    CHECK(heap_region_index_search(NULL, 0, 0x1000) == 0);
+    for (const test_heap_t &heap : test.heaps) {
+        CHECK(test.find_indexed((void *)heap.start) == &heap);
+        CHECK(test.find_indexed((void *)(heap.start + TEST_HEAP_SIZE / 2)) == &heap);
+        CHECK(test.find_indexed((void *)(heap.end - 1)) == &heap);
+        CHECK(test.find_indexed((void *)(heap.start - 1)) == test.find_linear((void *)(heap.start - 1)));
+        CHECK(test.find_indexed((void *)heap.end) == test.find_linear((void *)heap.end));
+    }
+    CHECK(test.find_indexed((void *)(test.starts.front() - 1)) == NULL);
+    CHECK(test.find_indexed((void *)test.sorted.back()->end) == NULL);
+}
+
+/* Cost of freeing blocks spread over all the heaps, in random order, including the
+   lookup of the heap containing each block, as done by heap_caps_free() */
+template<typename Find>
+static double ns_per_free(TestHeaps &test, Find find)
+{
+    const size_t count = test.heaps.size() * TEST_BLOCKS_PER_HEAP;
+    std::vector<void *> blocks(count);
+    std::minstd_rand rand(count);
+    std::chrono::nanoseconds elapsed(0);
+    for (int round = 0; round < TEST_ROUNDS; round++) {
+        for (size_t i = 0; i < count; i++) {
+            blocks[i] = multi_heap_malloc(test.heaps[i % test.heaps.size()].heap, 32);
+            REQUIRE(blocks[i] != NULL);
+        }
+        std::shuffle(blocks.begin(), blocks.end(), rand);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            test_heap_t *heap = find(test, blocks[i]);
+            multi_heap_free(heap->heap, blocks[i]);
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    return (double)elapsed.count() / (count * TEST_ROUNDS);
+}
+
+TEST_CASE("benchmark free with 1, 4 and 16 registered heaps", "[heap_region_index][perf]")
+{
+    const size_t heap_counts[] = { 1, 4, TEST_MAX_HEAPS };
+    for (size_t heap_count : heap_counts) {
+        TestHeaps test(heap_count);
+        const double linear = ns_per_free(test, [](const TestHeaps &t, void *p) {
+            return t.find_linear(p);
+        });
+        const double indexed = ns_per_free(test, [](const TestHeaps &t, void *p) {
+            return t.find_indexed(p);
+        });
+        printf("free with %2zu heaps: linear lookup %.1f ns, indexed lookup %.1f ns\n", heap_count, linear, indexed);
+        CHECK(linear > 0);
+        CHECK(indexed > 0);
+    }
+}
@@ -0,0 +1,188 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""Build a heap profile from the records of heap tracing in sampling mode (CONFIG_HEAP_TRACING_SAMPLING).
+
+The application reads the records with heap_trace_sampling_read() and sends them to the host, to a file on the linux
+target or through app_trace on a chip. This tool reads these records and estimates, for each call stack, the number
+of bytes allocated and the number of bytes still in use at the end of the capture. A sampled allocation of 'size'
+bytes stands for size / (1 - exp(-size / interval)) bytes, as an allocation is sampled with this probability.
+
+Usage:
+    python heap_trace_sampling_profile.py capture.bin
+    python heap_trace_sampling_profile.py --elf build/app.elf --toolchain-prefix xtensa-esp32-elf- capture.bin
+"""
+
+from __future__ import annotations
+
+import argparse
+import math
+import struct
+import subprocess
+import sys
+from dataclasses import dataclass
+from dataclasses import field
+from typing import BinaryIO
+
+RECORD_HEADER = 0
+RECORD_ALLOC = 1
+RECORD_FREE = 2
+RECORD_LOST = 3
+STREAM_MAGIC = 0x50535448
+STREAM_VERSION = 1
+HEAD = struct.Struct('<BBHI')
+HEADER_PARAMS = struct.Struct('<II')
+
+
+class DecodeError(Exception):
+    pass
+
+
+@dataclass
+class CallSite:
+    callers: tuple[int, ...]
+    samples: int = 0
+    allocated_bytes: float = 0.0
+    live_samples: int = 0
+    live_bytes: float = 0.0
+
+
+@dataclass
+class Profile:
+    sampling_interval: int = 0
+    timestamp_freq: int = 0
+    lost_records: int = 0
+    unknown_frees: int = 0
+    sites: dict[tuple[int, ...], CallSite] = field(default_factory=dict)
+    # address of each sampled allocation not freed yet: call site and estimated bytes
+    live: dict[int, tuple[CallSite, float]] = field(default_factory=dict)
+
+    def weight(self, size: int) -> float:
+        if size == 0:
+            return 0.0
+        return size / -math.expm1(-size / self.sampling_interval)
+
+    def add_alloc(self, address: int, size: int, callers: tuple[int, ...]) -> None:
+        site = self.sites.setdefault(callers, CallSite(callers))
+        weight = self.weight(size)
+        site.samples += 1
+        site.allocated_bytes += weight
+        site.live_samples += 1
+        site.live_bytes += weight
+        self.live[address] = (site, weight)
+
+    def add_free(self, address: int) -> None:
+        entry = self.live.pop(address, None)
+        if entry is None:
+            self.unknown_frees += 1
+            return
+        site, weight = entry
+        site.live_samples -= 1
+        site.live_bytes -= weight
+
+
+def parse(stream: BinaryIO) -> Profile:
+    data = stream.read()
+    profile = Profile()
+    pointer: struct.Struct | None = None
+    pos = 0
+    while pos + HEAD.size <= len(data):
+        record_type, count, reserved, value = HEAD.unpack_from(data, pos)
+        pos += HEAD.size
+        if record_type == RECORD_HEADER:
+            version, pointer_size = count, reserved & 0xFF
+            if value != STREAM_MAGIC or version != STREAM_VERSION or pointer_size not in (4, 8):
+                raise DecodeError(f'invalid stream header at offset {pos - HEAD.size}')
+            pointer = struct.Struct('<I' if pointer_size == 4 else '<Q')
+            profile.sampling_interval, profile.timestamp_freq = HEADER_PARAMS.unpack_from(data, pos)
+            pos += HEADER_PARAMS.size
+            # tracing was started again, the previous samples are discarded
+            profile.sites.clear()
+            profile.live.clear()
+        elif pointer is None:
+            raise DecodeError('the stream does not start with a header')
+        elif record_type == RECORD_ALLOC:
+            (address,) = pointer.unpack_from(data, pos)
+            (size,) = struct.unpack_from('<I', data, pos + pointer.size)
+            pos += pointer.size + 4
+            callers = tuple(pointer.unpack_from(data, pos + i * pointer.size)[0] for i in range(count))
+            pos += count * pointer.size
+            profile.add_alloc(address, size, callers)
+        elif record_type == RECORD_FREE:
+            (address,) = pointer.unpack_from(data, pos)
+            pos += pointer.size
+            profile.add_free(address)
+        elif record_type == RECORD_LOST:
+            profile.lost_records += value
+        else:
+            raise DecodeError(f'unknown record type {record_type} at offset {pos - HEAD.size}')
+    return profile
+
+
+class Symbolizer:
+    """Resolves addresses to function and source location with addr2line."""
+
+    def __init__(self, elf: str | None, toolchain_prefix: str) -> None:
+        self.elf = elf
+        self.addr2line = f'{toolchain_prefix}addr2line'
+        self.cache: dict[int, str] = {}
+
+    def resolve(self, addresses: set[int]) -> None:
+        todo = sorted(addresses - self.cache.keys())
+        if not self.elf or not todo:
+            return
+        output = subprocess.run(
+            [self.addr2line, '-pfC', '-e', self.elf] + [hex(addr) for addr in todo],
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout.splitlines()
+        for addr, line in zip(todo, output):
+            self.cache[addr] = line.strip()
+
+    def name(self, address: int) -> str:
+        resolved = self.cache.get(address)
+        return f'0x{address:08x} {resolved}' if resolved else f'0x{address:08x}'
+
+
+def print_profile(profile: Profile, symbolizer: Symbolizer, top: int, sort_key: str) -> None:
+    sites = sorted(profile.sites.values(), key=lambda site: getattr(site, sort_key), reverse=True)[:top]
+    symbolizer.resolve({addr for site in sites for addr in site.callers})
+
+    total_live = sum(site.live_bytes for site in profile.sites.values())
+    total_allocated = sum(site.allocated_bytes for site in profile.sites.values())
+    print(f'Sampling interval: {profile.sampling_interval} bytes')
+    print(f'Estimated bytes in use: {total_live:.0f}, allocated: {total_allocated:.0f}')
+    if profile.lost_records:
+        print(f'(NB: {profile.lost_records} records were dropped, the estimates are incomplete.)')
+    print()
+    for site in sites:
+        print(
+            f'{site.live_bytes:12.0f} bytes in use ({site.live_samples} samples), '
+            f'{site.allocated_bytes:.0f} bytes allocated ({site.samples} samples)'
+        )
+        for address in site.callers or (0,):
+            print(f'    {symbolizer.name(address)}')
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', type=argparse.FileType('rb'), help='records read by heap_trace_sampling_read()')
+    parser.add_argument('--elf', help='ELF file of the application, to resolve the call stacks')
+    parser.add_argument('--toolchain-prefix', default='', help='prefix of addr2line, e.g. xtensa-esp32-elf-')
+    parser.add_argument('--top', type=int, default=20, help='number of call stacks to print')
+    parser.add_argument(
+        '--sort', choices=['live', 'allocated'], default='live', help='sort by bytes in use or bytes allocated'
+    )
+    args = parser.parse_args()
+
+    try:
+        profile = parse(args.capture)
+    except DecodeError as e:
+        print(f'error: {e}', file=sys.stderr)
+        return 1
+    print_profile(profile, Symbolizer(args.elf, args.toolchain_prefix), args.top, f'{args.sort}_bytes')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std;
+
+static const char *TEST_TAG = "test";
+
+// Binary packages are written with esp_rom_output_tx_one_char(), which outputs to stdout on Linux
+class StdoutCapture {
+public:
+    StdoutCapture()
+    {
+        fflush(stdout);
+        file = tmpfile();
+        saved_fd = dup(STDOUT_FILENO);
+        dup2(fileno(file), STDOUT_FILENO);
+    }
+
+    ~StdoutCapture()
+    {
+        restore();
+        fclose(file);
+    }
+
+    vector<uint8_t> get()
+    {
+        restore();
+        vector<uint8_t> data(ftell(file));
+        rewind(file);
+        data.resize(fread(data.data(), 1, data.size(), file));
+        return data;
+    }
+
+private:
+    void restore()
+    {
+        if (saved_fd >= 0) {
+            fflush(stdout);
+            dup2(saved_fd, STDOUT_FILENO);
+            close(saved_fd);
+            saved_fd = -1;
+        }
+    }
+
+    FILE *file;
+    int saved_fd;
+};
+
+static uint8_t crc8(const vector<uint8_t> &data, size_t len)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static bool contains(const vector<uint8_t> &data, const vector<uint8_t> &part)
+{
+    return search(data.begin(), data.end(), part.begin(), part.end()) != data.end();
+}
+
+static bool contains(const vector<uint8_t> &data, const char *str)
+{
+    return contains(data, vector<uint8_t>(str, str + strlen(str)));
+}
+
+TEST_CASE("binary log outputs the format string and raw arguments instead of the message")
+{
+    esp_log_level_set("*", ESP_LOG_VERBOSE);
+    StdoutCapture capture;
+    ESP_LOGI(TEST_TAG, "value %d of %s", 42, "answer");
+    vector<uint8_t> pkg = capture.get();
+
+    REQUIRE(pkg.size() > 3);
+    CHECK(pkg[0] == 0x02); // application
+    const uint16_t control = pkg[1] << 8 | pkg[2];
+    CHECK((control & 0x3FF) == pkg.size());
+    CHECK(((control >> 10) & 0x07) == ESP_LOG_INFO);
+    CHECK(crc8(pkg, pkg.size() - 1) == pkg.back());
+
+    // the format string is not present in the ELF file on Linux, so it is embedded as is, not formatted
+    CHECK(contains(pkg, "value %d of %s"));
+    CHECK_FALSE(contains(pkg, "value 42"));
+    CHECK(contains(pkg, vector<uint8_t> {0x00, 0x00, 0x00, 42}));
+    CHECK(contains(pkg, "answer"));
+    esp_log_level_set("*", ESP_LOG_INFO);
+}
+
+TEST_CASE("binary log outputs the bytes of a logged buffer")
+{
+    const uint8_t buffer[] = {0xde, 0xad, 0xbe, 0xef};
+    esp_log_level_set("*", ESP_LOG_VERBOSE);
+    StdoutCapture capture;
+    ESP_LOG_BUFFER_HEX(TEST_TAG, buffer, sizeof(buffer));
+    vector<uint8_t> pkg = capture.get();
+
+    REQUIRE(pkg.size() > 3);
+    CHECK((pkg[1] << 8 | pkg[2]) % 1024 == pkg.size());
+    CHECK(crc8(pkg, pkg.size() - 1) == pkg.back());
+    CHECK(contains(pkg, "__ESP_BUFFER_HEX_FORMAT__"));
+    CHECK(contains(pkg, vector<uint8_t>(buffer, buffer + sizeof(buffer))));
+    esp_log_level_set("*", ESP_LOG_INFO);
+}
@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdio>
+#include <cstdarg>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std;
+
+static const char *PERF_TAG = "perf";
+static const int LOG_CALLS = 100000;
+static const int PERF_TAGS = 150;
+static const int PERF_TAG_LEN = 12;
+
+#if CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE
+static const char *TAG_LEVEL_IMPL = "hash table";
+#elif CONFIG_LOG_TAG_LEVEL_IMPL_CACHE_AND_LINKED_LIST
+static const char *TAG_LEVEL_IMPL = "cache and linked list";
+#elif CONFIG_LOG_TAG_LEVEL_IMPL_LINKED_LIST
+static const char *TAG_LEVEL_IMPL = "linked list";
+#else
+static const char *TAG_LEVEL_IMPL = "none";
+#endif
+
+#if CONFIG_LOG_MODE_BINARY
+static const char *MODE = "binary";
+static int s_saved_fd;
+static int s_null_fd;
+#else
+static const char *MODE = "text";
+static vprintf_like_t s_original_vprintf;
+
+// Renders the message as the console output would, but doesn't write it
+static int render_vprintf(const char *format, va_list args)
+{
+    static char buf[256];
+    return vsnprintf(buf, sizeof(buf), format, args);
+}
+#endif
+
+// The text mode formats the message with vsnprintf(), the binary mode outputs the format string address
+// and the raw arguments. The output itself is discarded in both modes, to compare only the cost on the chip side.
+static void discard_output_begin(void)
+{
+#if CONFIG_LOG_MODE_BINARY
+    fflush(stdout);
+    s_saved_fd = dup(STDOUT_FILENO);
+    s_null_fd = open("/dev/null", O_WRONLY);
+    dup2(s_null_fd, STDOUT_FILENO);
+#else
+    s_original_vprintf = esp_log_set_vprintf(render_vprintf);
+#endif
+}
+
+static void discard_output_end(void)
+{
+#if CONFIG_LOG_MODE_BINARY
+    fflush(stdout);
+    dup2(s_saved_fd, STDOUT_FILENO);
+    close(s_saved_fd);
+    close(s_null_fd);
+#else
+    esp_log_set_vprintf(s_original_vprintf);
+#endif
+}
+
+static double ns_per_call(esp_log_level_t tag_level)
+{
+    esp_log_level_set(PERF_TAG, tag_level);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < LOG_CALLS; i++) {
+        ESP_LOGI(PERF_TAG, "counter %d, state %s, value 0x%08x", i, "running", (unsigned)i * 7);
+    }
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    return (double)elapsed.count() / LOG_CALLS;
+}
+
+// Logs the tags round-robin, with the WARN (enabled) or the INFO level
+static double ns_per_call_many_tags(const char (*tags)[PERF_TAG_LEN], bool enabled)
+{
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < LOG_CALLS; i++) {
+        const char *tag = tags[i % PERF_TAGS];
+        if (enabled) {
+            ESP_LOGW(tag, "counter %d", i);
+        } else {
+            ESP_LOGI(tag, "counter %d", i);
+        }
+    }
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    return (double)elapsed.count() / LOG_CALLS;
+}
+
+TEST_CASE("benchmark cost of a log call", "[log][perf]")
+{
+    discard_output_begin();
+    const double enabled = ns_per_call(ESP_LOG_VERBOSE);
+    const double suppressed = ns_per_call(ESP_LOG_WARN);
+    discard_output_end();
+    esp_log_level_set(PERF_TAG, ESP_LOG_INFO);
+
+    printf("log call (%s mode): enabled %.1f ns, suppressed %.1f ns\n", MODE, enabled, suppressed);
+    CHECK(enabled > 0);
+    CHECK(suppressed < enabled);
+}
+
+TEST_CASE("benchmark tag level lookup with many tags", "[log][perf]")
+{
+    // Stable addresses, as the tags of an application with many components, half of them with their own level
+    static char tags[PERF_TAGS][PERF_TAG_LEN];
+    for (int i = 0; i < PERF_TAGS; i++) {
+        snprintf(tags[i], PERF_TAG_LEN, "comp_%d", i);
+        if (i % 2 == 0) {
+            esp_log_level_set(tags[i], ESP_LOG_WARN);
+        }
+    }
+
+    discard_output_begin();
+    ns_per_call_many_tags(tags, false); // warm up the tag level lookup
+    const double enabled = ns_per_call_many_tags(tags, true);
+    const double half_suppressed = ns_per_call_many_tags(tags, false);
+    discard_output_end();
+    esp_log_level_set("*", ESP_LOG_INFO);
+
+    printf("log call with %d tags (%s): enabled %.1f ns, half suppressed %.1f ns\n",
+           PERF_TAGS, TAG_LEVEL_IMPL, enabled, half_suppressed);
+    CHECK(enabled > 0);
+    CHECK(half_suppressed > 0);
+}
@@ -7,6 +7,8 @@
    CONDITIONS OF ANY KIND, either express or implied.
 */
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <regex>
 #include <iostream>
 #include "esp_rom_sys.h"
@@ -222,6 +224,52 @@ TEST_CASE("changing log level")
     ESP_LOGI(TEST_TAG, "must indeed be printed");
     CHECK(regex_search(fix.get_print_buffer_string(), test_print) == true);
 }
+
+#if CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE || CONFIG_LOG_TAG_LEVEL_IMPL_LINKED_LIST
+// The cache only updates the first cached address of a tag
+TEST_CASE("changing log level of a tag with several addresses")
+{
+    PrintFixture fix(ESP_LOG_INFO);
+    // the same tag, defined in different source files
+    static const char tag_a[] = "multi";
+    static const char tag_b[] = "multi";
+    REQUIRE(tag_a != tag_b);
+
+    // the tag levels are looked up once before the change
+    ESP_LOGI(tag_a, "must indeed be printed");
+    ESP_LOGI(tag_b, "must indeed be printed");
+    CHECK(fix.get_print_buffer_string().size() != 0);
+
+    fix.reset_buffer();
+    esp_log_level_set("multi", ESP_LOG_WARN);
+    CHECK(esp_log_level_get(tag_a) == ESP_LOG_WARN);
+    CHECK(esp_log_level_get(tag_b) == ESP_LOG_WARN);
+
+    ESP_LOGI(tag_a, "must not be printed");
+    ESP_LOGI(tag_b, "must not be printed");
+    CHECK(fix.get_print_buffer_string().size() == 0);
+
+    esp_log_level_set("*", ESP_LOG_DEBUG);
+    CHECK(esp_log_level_get(tag_a) == ESP_LOG_DEBUG);
+    CHECK(esp_log_level_get(tag_b) == ESP_LOG_DEBUG);
+}
+
+TEST_CASE("changing log level of a tag whose logged string was freed")
+{
+    PrintFixture fix(ESP_LOG_INFO);
+    char *tag = strdup("freed");
+    REQUIRE(tag != nullptr);
+    ESP_LOGI(tag, "must indeed be printed");
+    CHECK(fix.get_print_buffer_string().size() != 0);
+    free(tag);
+
+    // the string at the recorded address of the tag must not be read anymore
+    esp_log_level_set("freed", ESP_LOG_WARN);
+    CHECK(esp_log_level_get("freed") == ESP_LOG_WARN);
+    esp_log_level_set("*", ESP_LOG_DEBUG);
+    CHECK(esp_log_level_get("freed") == ESP_LOG_DEBUG);
+}
+#endif
 #endif // CONFIG_LOG_DYNAMIC_LEVEL_CONTROL
 
 TEST_CASE("log buffer")
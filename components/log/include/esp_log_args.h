@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -207,6 +207,17 @@ extern "C++" {
         constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
     };
 
+    // Arrays, such as string literals, are passed to esp_log() as pointers
+    template <size_t N>
+    struct EspLogArgType<char[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
+    template <size_t N>
+    struct EspLogArgType<uint8_t[N]> {
+        constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_POINTER;
+    };
+
     template <>
     struct EspLogArgType<long long int> {
         constexpr static unsigned long long log_type = ESP_LOG_ARGS_TYPE_64BITS;
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statistics of the asynchronous log output, summed over all cores.
+ */
+typedef struct {
+    uint32_t written;       /**< Number of buffered records written to the log output */
+    uint32_t dropped;       /**< Number of records dropped because the buffer of their core was full */
+    uint32_t peak_used;     /**< Highest number of bytes used in the buffer of a core */
+} esp_log_async_stats_t;
+
+/**
+ * @brief Wait until all buffered log records are written.
+ *
+ * The records are written by the calling task, along with the background task. Does nothing when called
+ * from a constrained environment (ISR, cache disabled, scheduler not running).
+ *
+ * @note Available when CONFIG_LOG_ASYNC is enabled.
+ */
+void esp_log_async_flush(void);
+
+/**
+ * @brief Get the statistics of the asynchronous log output.
+ *
+ * @note Available when CONFIG_LOG_ASYNC is enabled.
+ *
+ * @param[out] stats Statistics, must not be NULL.
+ */
+void esp_log_async_get_stats(esp_log_async_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
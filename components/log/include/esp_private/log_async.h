@@ -0,0 +1,27 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <stdbool.h>
+#include "log_message.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Buffer log message for the background task.
+ *
+ * @param message Pointer to log message structure, logged from task context.
+ * @return
+ *      - true if the message was buffered or dropped.
+ *      - false if the message must be written synchronously.
+ */
+bool esp_log_async_write(esp_log_msg_t *message);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,10 +1,12 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_log_config.h"
 #include "log_message.h"
 
@@ -19,6 +21,18 @@ extern "C" {
  */
 void esp_log_format(esp_log_msg_t *message);
 
+/**
+ * @brief Format log message into a buffer.
+ *
+ * The text is truncated to fit the buffer. A truncated message still ends with the line end if formatting is required.
+ *
+ * @param message Pointer to log message structure.
+ * @param buf     Buffer to write the text to, it is not null-terminated.
+ * @param size    Size of the buffer.
+ * @return Length of the text written to the buffer.
+ */
+size_t esp_log_format_to_buffer(esp_log_msg_t *message, char *buf, size_t size);
+
 #if ESP_LOG_MODE_BINARY_EN
 /**
  * @brief Format log message in binary mode.
@@ -26,6 +40,16 @@ void esp_log_format(esp_log_msg_t *message);
  * @param message Pointer to log message structure.
  */
 void esp_log_format_binary(esp_log_msg_t *message);
+
+/**
+ * @brief Encode log message in binary mode into a buffer.
+ *
+ * @param message Pointer to log message structure.
+ * @param buf     Buffer to write the package to.
+ * @param size    Size of the buffer.
+ * @return Length of the package, 0 if it doesn't fit the buffer.
+ */
+size_t esp_log_format_binary_to_buffer(esp_log_msg_t *message, uint8_t *buf, size_t size);
 #endif // ESP_LOG_MODE_BINARY_EN
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -18,6 +18,7 @@
 #include "esp_private/log_print.h"
 #include "esp_private/log_message.h"
 #include "esp_private/log_format.h"
+#include "esp_private/log_async.h"
 #include "esp_log_write.h"
 #include "esp_rom_sys.h"
 #include "sdkconfig.h"
@@ -67,10 +68,17 @@ void __attribute__((optimize("-O3"))) esp_log_va(esp_log_config_t config, const
         if (config.opts.binary_mode) {
             message.arg_types = va_arg(message.args, const char *);
         }
-        esp_log_format_binary(&message);
+#endif // ESP_LOG_MODE_BINARY_EN
+#if CONFIG_LOG_ASYNC && !NON_OS_BUILD
+        if (!esp_log_async_write(&message))
+#endif
+        {
+#if ESP_LOG_MODE_BINARY_EN
+            esp_log_format_binary(&message);
 #else
-        esp_log_format(&message);
+            esp_log_format(&message);
 #endif // ESP_LOG_MODE_BINARY_EN
+        }
         va_end(message.args);
     }
 #endif // ESP_LOG_VERSION == 2
@@ -68,23 +68,24 @@ typedef struct {
     bool buffer_hexdump_log;
     int buffer_len;
     bool len_calculation_stage;
+    uint8_t *out_buf;       /**< Buffer receiving the package, NULL to output it directly */
+    unsigned out_pos;
 } pkg_info_t;
 
 extern const char __ESP_BUFFER_HEX_FORMAT__[];
 extern const char __ESP_BUFFER_CHAR_FORMAT__[];
 extern const char __ESP_BUFFER_HEXDUMP_FORMAT__[];
 
+// CRC8 (polynomial 0x07) of each 4-bit value, to update the checksum a nibble at a time instead of a bit at a time
+static const uint8_t s_crc8_nibble[16] = {
+    0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+};
+
 void update_crc8(uint8_t data, pkg_info_t *pkg_info)
 {
-    uint8_t crc = pkg_info->crc;
-    crc ^= data;
-    for (uint8_t i = 0; i < 8; i++) {
-        if (crc & 0x80) {
-            crc = (crc << 1) ^ 0x07;
-        } else {
-            crc <<= 1;
-        }
-    }
+    uint8_t crc = pkg_info->crc ^ data;
+    crc = (uint8_t)(crc << 4) ^ s_crc8_nibble[crc >> 4];
+    crc = (uint8_t)(crc << 4) ^ s_crc8_nibble[crc >> 4];
     pkg_info->crc = crc;
 }
 
@@ -113,7 +114,11 @@ static unsigned output(const void *src, unsigned length, pkg_info_t *pkg_info)
     for (unsigned i = 0; i < length; i++) {
         uint8_t data = ((uint8_t *)src)[length - 1 - i];
         if (pkg_info->len_calculation_stage == false) {
-            esp_rom_output_tx_one_char(data);
+            if (pkg_info->out_buf) {
+                pkg_info->out_buf[pkg_info->out_pos++] = data;
+            } else {
+                esp_rom_output_tx_one_char(data);
+            }
             update_crc8(data, pkg_info);
         }
     }
@@ -264,41 +269,69 @@ Embedded string:
 [0, 1] bytes - (10 bits) negative length of the string = 1 - len(str). 0xFFFC = len is 5, 0xFDD6 = len is 555. Max is 1023.
 next bytes - string
 */
-void esp_log_format_binary(esp_log_msg_t *message)
+static void output_package(esp_log_msg_t *message, unsigned pkg_len, pkg_info_t *pkg_info)
 {
-    assert(message != NULL);
-
-    if (!message->config.opts.constrained_env) {
-        esp_log_impl_lock();
-    }
-
-    pkg_info_t pkg_info = {
-        .crc = 0,
-        .buffer_hex_log = message->format == __ESP_BUFFER_HEX_FORMAT__,
-        .buffer_char_log = message->format == __ESP_BUFFER_CHAR_FORMAT__,
-        .buffer_hexdump_log = message->format == __ESP_BUFFER_HEXDUMP_FORMAT__,
-        .buffer_len = BUFFER_LEN_NOT_SET,
-        .len_calculation_stage = false,
-    };
-
     // Output control byte
     control_t control = {
         .opts = {
-            .pkg_len = calc_pkg_len(message, &pkg_info),
+            .pkg_len = pkg_len,
             .log_level = message->config.opts.log_level,
             .time_64bits = (message->timestamp >> 32) != 0,
             .version = 0,
         },
         .app_identifier = APP_TYPE,
     };
-    output(&control, sizeof(control), &pkg_info);
-    output_pointer(message->format, &pkg_info);
-    output_pointer(message->tag, &pkg_info);
-    output(&message->timestamp, (control.opts.time_64bits) ? sizeof(uint64_t) : sizeof(uint32_t), &pkg_info);
-    output_arguments(message, message->args, &pkg_info);
-    output(&pkg_info.crc, sizeof(pkg_info.crc), &pkg_info);
+    output(&control, sizeof(control), pkg_info);
+    output_pointer(message->format, pkg_info);
+    output_pointer(message->tag, pkg_info);
+    output(&message->timestamp, (control.opts.time_64bits) ? sizeof(uint64_t) : sizeof(uint32_t), pkg_info);
+    output_arguments(message, message->args, pkg_info);
+    output(&pkg_info->crc, sizeof(pkg_info->crc), pkg_info);
+}
+
+static void init_pkg_info(esp_log_msg_t *message, uint8_t *out_buf, pkg_info_t *pkg_info)
+{
+    *pkg_info = (pkg_info_t) {
+        .crc = 0,
+        .buffer_hex_log = message->format == __ESP_BUFFER_HEX_FORMAT__,
+        .buffer_char_log = message->format == __ESP_BUFFER_CHAR_FORMAT__,
+        .buffer_hexdump_log = message->format == __ESP_BUFFER_HEXDUMP_FORMAT__,
+        .buffer_len = BUFFER_LEN_NOT_SET,
+        .len_calculation_stage = false,
+        .out_buf = out_buf,
+        .out_pos = 0,
+    };
+}
+
+void esp_log_format_binary(esp_log_msg_t *message)
+{
+    assert(message != NULL);
+
+    if (!message->config.opts.constrained_env) {
+        esp_log_impl_lock();
+    }
+
+    pkg_info_t pkg_info;
+    init_pkg_info(message, NULL, &pkg_info);
+    output_package(message, calc_pkg_len(message, &pkg_info), &pkg_info);
 
     if (!message->config.opts.constrained_env) {
         esp_log_impl_unlock();
     }
 }
+
+#if CONFIG_LOG_ASYNC
+size_t esp_log_format_binary_to_buffer(esp_log_msg_t *message, uint8_t *buf, size_t size)
+{
+    assert(message != NULL && buf != NULL);
+
+    pkg_info_t pkg_info;
+    init_pkg_info(message, buf, &pkg_info);
+    unsigned pkg_len = calc_pkg_len(message, &pkg_info);
+    if (pkg_len > size) {
+        return 0;
+    }
+    output_package(message, pkg_len, &pkg_info);
+    return pkg_info.out_pos;
+}
+#endif // CONFIG_LOG_ASYNC
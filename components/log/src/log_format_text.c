@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2025-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -7,6 +7,8 @@
 #include <stdbool.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/param.h>
 #include "esp_log_config.h"
 #include "esp_log_level.h"
 #include "esp_log_color.h"
@@ -75,3 +77,41 @@ void esp_log_format(esp_log_msg_t *message)
 #endif
     }
 }
+
+#if CONFIG_LOG_ASYNC
+static size_t advance(size_t pos, int written, size_t size)
+{
+    // snprintf() keeps the last byte for the null terminator, which is not needed in the buffer
+    return (written > 0) ? MIN(pos + written, size - 1) : pos;
+}
+
+size_t esp_log_format_to_buffer(esp_log_msg_t *message, char *buf, size_t size)
+{
+    size_t pos = 0;
+    const char *end = "";
+    if (message->config.opts.require_formatting) {
+        message->config.opts.dis_color |= !ESP_LOG_SUPPORT_COLOR || (s_lvl_color[message->config.opts.log_level][0] == '\0');
+        char timestamp_buffer[32] = { 0 };
+        if (!message->config.opts.dis_timestamp) {
+            esp_log_timestamp_str(message->config.opts.constrained_env, message->timestamp, timestamp_buffer);
+        }
+        pos = advance(pos, snprintf(buf, size, "%s%c %s%s%s%s%s",
+                                    (!message->config.opts.dis_color) ? s_lvl_color[message->config.opts.log_level] : "",
+                                    s_lvl_name[message->config.opts.log_level],
+                                    (!message->config.opts.dis_timestamp) ? "(" : "",
+                                    timestamp_buffer,
+                                    (!message->config.opts.dis_timestamp) ? ") " : "",
+                                    (message->tag) ? message->tag : "",
+                                    (message->tag) ? ": " : ""), size);
+        end = (message->config.opts.dis_color) ? "\n" : LOG_RESET_COLOR"\n";
+    }
+
+    pos = advance(pos, vsnprintf(buf + pos, size - pos, message->format, message->args), size);
+
+    // a truncated message keeps its line end
+    size_t end_len = strlen(end);
+    pos = MIN(pos, size - end_len);
+    memcpy(buf + pos, end, end_len);
+    return pos + end_len;
+}
+#endif // CONFIG_LOG_ASYNC
@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file implements the log tag levels with two open-addressing hash tables.
+ *
+ * The name table holds a copy of the tags given to esp_log_level_set() and of
+ * the tags recorded in the address table, with their hash and their level, or
+ * "default level" for the tags without one. It is accessed with the log lock
+ * taken and grows as tags are added.
+ *
+ * The address table maps the address of a tag, as passed to the log calls, to
+ * its copy in the name table and its level. The string at the address itself is
+ * only read when the address is recorded, as it may be freed or reused later.
+ * The table has a fixed size (CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE_SIZE) and
+ * entries are never removed, so it is read without the log lock: an entry is
+ * published by storing the tag address last, and the level of an entry is a
+ * single byte, updated in place by esp_log_level_set(). A tag logged for the
+ * first time, or whose address doesn't fit in the table anymore, is looked up in
+ * the name table.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log_level.h"
+#include "esp_assert.h"
+#include "log_hash_table.h"
+#include "sdkconfig.h"
+
+ESP_STATIC_ASSERT((CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE_SIZE & (CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE_SIZE - 1)) == 0,
+                  "Size of the tag hash table must be a power of 2");
+
+#define ADDR_TABLE_SIZE     (CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE_SIZE)
+#define ADDR_TABLE_BITS     (__builtin_ctz(ADDR_TABLE_SIZE))
+// Addresses are not added beyond this count, to keep probe sequences short
+#define ADDR_TABLE_MAX_USED (ADDR_TABLE_SIZE * 3 / 4)
+#define NAME_TABLE_MIN_SIZE (16)
+#define LEVEL_DEFAULT       (0xFF) // the tag has no level of its own
+
+typedef struct {
+    const char *tag;    // address of the tag, NULL if the entry is free
+    const char *name;   // copy of the tag string in the name table
+    uint8_t level;      // esp_log_level_t or LEVEL_DEFAULT
+} addr_entry_t;
+
+typedef struct {
+    char *tag;          // copy of the tag string, NULL if the entry is free
+    uint32_t hash;
+    uint8_t level;      // esp_log_level_t or LEVEL_DEFAULT
+} name_entry_t;
+
+static addr_entry_t s_addr_table[ADDR_TABLE_SIZE];
+static uint32_t s_addr_count;
+static name_entry_t *s_name_table;
+static uint32_t s_name_table_size;
+static uint32_t s_name_count;
+
+static inline uint32_t hash_addr(const char *tag)
+{
+    // Fibonacci hashing, the top bits are the best mixed
+    return ((uint32_t)((uintptr_t)tag >> 2) * 2654435761u) >> (32 - ADDR_TABLE_BITS);
+}
+
+static inline uint32_t hash_name(const char *tag)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*tag) {
+        hash = (hash ^ (uint8_t) * tag++) * 16777619u;
+    }
+    return hash;
+}
+
+static name_entry_t *find_name(const char *tag, uint32_t hash)
+{
+    if (s_name_table == NULL) {
+        return NULL;
+    }
+    const uint32_t mask = s_name_table_size - 1;
+    for (uint32_t i = hash & mask; s_name_table[i].tag != NULL; i = (i + 1) & mask) {
+        if (s_name_table[i].hash == hash && strcmp(s_name_table[i].tag, tag) == 0) {
+            return &s_name_table[i];
+        }
+    }
+    return NULL;
+}
+
+static name_entry_t *insert_name(name_entry_t *table, uint32_t size, char *tag, uint32_t hash, uint8_t level)
+{
+    const uint32_t mask = size - 1;
+    uint32_t i = hash & mask;
+    while (table[i].tag != NULL) {
+        i = (i + 1) & mask;
+    }
+    table[i] = (name_entry_t) {
+        .tag = tag,
+        .hash = hash,
+        .level = level,
+    };
+    return &table[i];
+}
+
+static bool grow_name_table(void)
+{
+    uint32_t new_size = s_name_table ? s_name_table_size * 2 : NAME_TABLE_MIN_SIZE;
+    name_entry_t *new_table = calloc(new_size, sizeof(name_entry_t));
+    if (new_table == NULL) {
+        return false;
+    }
+    for (uint32_t i = 0; i < s_name_table_size; i++) {
+        if (s_name_table[i].tag != NULL) {
+            insert_name(new_table, new_size, s_name_table[i].tag, s_name_table[i].hash, s_name_table[i].level);
+        }
+    }
+    free(s_name_table);
+    s_name_table = new_table;
+    s_name_table_size = new_size;
+    return true;
+}
+
+static name_entry_t *add_name(const char *tag, uint32_t hash, uint8_t level)
+{
+    // keep the load factor at 3/4 at most, so that a free entry ends every probe sequence
+    if ((s_name_count + 1) * 4 > s_name_table_size * 3 && !grow_name_table()) {
+        return NULL;
+    }
+    size_t tag_len = strlen(tag) + 1;
+    char *tag_copy = malloc(tag_len);
+    if (tag_copy == NULL) {
+        return NULL;
+    }
+    memcpy(tag_copy, tag, tag_len);
+    s_name_count++;
+    return insert_name(s_name_table, s_name_table_size, tag_copy, hash, level);
+}
+
+static void add_addr(const char *tag, const name_entry_t *name)
+{
+    const uint32_t mask = ADDR_TABLE_SIZE - 1;
+    uint32_t i = hash_addr(tag);
+    for (const char *entry_tag; (entry_tag = s_addr_table[i].tag) != NULL; i = (i + 1) & mask) {
+        if (entry_tag == tag) {
+            return;
+        }
+    }
+    if (s_addr_count >= ADDR_TABLE_MAX_USED) {
+        return;
+    }
+    s_addr_table[i].name = name->tag;
+    s_addr_table[i].level = name->level;
+    // publish the entry once it is complete
+    __atomic_store_n(&s_addr_table[i].tag, tag, __ATOMIC_RELEASE);
+    s_addr_count++;
+}
+
+bool esp_log_hash_table_get_cached_level(const char *tag, esp_log_level_t *level)
+{
+    const uint32_t mask = ADDR_TABLE_SIZE - 1;
+    uint32_t i = hash_addr(tag);
+    for (uint32_t probes = 0; probes < ADDR_TABLE_SIZE; probes++, i = (i + 1) & mask) {
+        const char *entry_tag = __atomic_load_n(&s_addr_table[i].tag, __ATOMIC_ACQUIRE);
+        if (entry_tag == tag) {
+            uint8_t entry_level = __atomic_load_n(&s_addr_table[i].level, __ATOMIC_RELAXED);
+            *level = (entry_level == LEVEL_DEFAULT) ? esp_log_get_default_level() : (esp_log_level_t) entry_level;
+            return true;
+        }
+        if (entry_tag == NULL) {
+            break;
+        }
+    }
+    return false;
+}
+
+bool esp_log_hash_table_get_level(const char *tag, esp_log_level_t *level)
+{
+    uint32_t hash = hash_name(tag);
+    name_entry_t *entry = find_name(tag, hash);
+    if (entry == NULL && s_addr_count < ADDR_TABLE_MAX_USED) {
+        // the address is only recorded along with a copy of the tag, to be updated by esp_log_level_set()
+        entry = add_name(tag, hash, LEVEL_DEFAULT);
+    }
+    if (entry == NULL) {
+        return false;
+    }
+    add_addr(tag, entry);
+    if (entry->level == LEVEL_DEFAULT) {
+        return false;
+    }
+    *level = (esp_log_level_t) entry->level;
+    return true;
+}
+
+bool esp_log_hash_table_set_level(const char *tag, esp_log_level_t level)
+{
+    uint32_t hash = hash_name(tag);
+    name_entry_t *entry = find_name(tag, hash);
+    if (entry != NULL) {
+        entry->level = level;
+    } else if ((entry = add_name(tag, hash, level)) == NULL) {
+        return false;
+    }
+    // The same tag may be logged with several addresses (one per source file), update all of them
+    for (uint32_t i = 0; i < ADDR_TABLE_SIZE; i++) {
+        if (s_addr_table[i].tag != NULL && s_addr_table[i].name == entry->tag) {
+            __atomic_store_n(&s_addr_table[i].level, (uint8_t) level, __ATOMIC_RELAXED);
+        }
+    }
+    return true;
+}
+
+void esp_log_hash_table_clean(void)
+{
+    // the copies of the tags stay in the table, the recorded addresses refer to them
+    for (uint32_t i = 0; i < s_name_table_size; i++) {
+        s_name_table[i].level = LEVEL_DEFAULT;
+    }
+    // the addresses stay in the table for the lock-free lookups, with the default level
+    for (uint32_t i = 0; i < ADDR_TABLE_SIZE; i++) {
+        __atomic_store_n(&s_addr_table[i].level, LEVEL_DEFAULT, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <stdbool.h>
+#include "esp_log_level.h"
+
+/**
+ * @brief Get the log level for a log tag by the address of the tag, without
+ * taking the log lock.
+ *
+ * Only the tags which were already looked up with esp_log_hash_table_get_level()
+ * are found. A tag without its own log level gets the default log level.
+ *
+ * @param tag   The log tag for which to retrieve the log level.
+ * @param level Pointer to a variable where the retrieved log level will be
+ * stored.
+ * @return true  if the address of the tag was found,
+ *         false otherwise, then esp_log_hash_table_get_level() must be called
+ *         with the log lock taken.
+ */
+bool esp_log_hash_table_get_cached_level(const char *tag, esp_log_level_t *level);
+
+/**
+ * @brief Get the log level for a log tag by the name of the tag.
+ *
+ * The address of the tag is recorded along with a copy of the tag and its log
+ * level (or the default log level), so that the next lookups of this tag by esp_log_hash_table_get_cached_level()
+ * don't need the log lock. Must be called with the log lock taken.
+ *
+ * @param tag   The log tag for which to retrieve the log level.
+ * @param level Pointer to a variable where the retrieved log level will be
+ * stored. It is not changed if the tag has no log level of its own.
+ * @return true  if the tag has its own log level,
+ *         false otherwise.
+ */
+bool esp_log_hash_table_get_level(const char *tag, esp_log_level_t *level);
+
+/**
+ * @brief Set the log level for a log tag.
+ *
+ * The recorded addresses of this tag get the new log level, the lock-free lookups
+ * see it immediately. Must be called with the log lock taken.
+ *
+ * @param tag   The log tag for which to set the log level.
+ * @param level The log level to be set for the specified log tag.
+ * @return true   If the log level was successfully set or updated,
+ *         false  Otherwise (no memory to store the tag).
+ */
+bool esp_log_hash_table_set_level(const char *tag, esp_log_level_t level);
+
+/**
+ * @brief Remove the log levels of all tags, so that all tags get the default
+ * log level.
+ *
+ * Must be called with the log lock taken.
+ */
+void esp_log_hash_table_clean(void);
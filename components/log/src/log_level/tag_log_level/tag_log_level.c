@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -18,6 +18,10 @@
 #include "linked_list/log_linked_list.h"
 #endif
 
+#if CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE
+#include "hash_table/log_hash_table.h"
+#endif
+
 #if CONFIG_LOG_TAG_LEVEL_CACHE_ARRAY || CONFIG_LOG_TAG_LEVEL_CACHE_BINARY_MIN_HEAP
 #define CACHE_ENABLED 1
 #include "cache/log_cache.h"
@@ -37,6 +41,15 @@ static inline void log_level_set(const char *tag, esp_log_level_t level)
         return;
     }
     esp_log_impl_lock();
+#if CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE
+    // for wildcard tag, remove the levels of all tags
+    if (strcmp(tag, "*") == 0) {
+        esp_log_set_default_level(level);
+        esp_log_hash_table_clean();
+    } else {
+        esp_log_hash_table_set_level(tag, level);
+    }
+#else
     // for wildcard tag, remove all linked list items and clear the cache
     if (strcmp(tag, "*") == 0) {
         esp_log_set_default_level(level);
@@ -52,6 +65,7 @@ static inline void log_level_set(const char *tag, esp_log_level_t level)
         }
 #endif
     }
+#endif // !CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE
     esp_log_impl_unlock();
 }
 
@@ -61,6 +75,12 @@ static esp_log_level_t log_level_get(const char *tag, bool timeout)
     if (tag == NULL) {
         return level_for_tag;
     }
+#if CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE
+    // tags logged before are found without the lock
+    if (esp_log_hash_table_get_cached_level(tag, &level_for_tag)) {
+        return level_for_tag;
+    }
+#endif
     if (timeout) {
         if (esp_log_impl_lock_timeout() == false) {
             return ESP_LOG_NONE;
@@ -68,7 +88,9 @@ static esp_log_level_t log_level_get(const char *tag, bool timeout)
     } else {
         esp_log_impl_lock();
     }
-#if CACHE_ENABLED
+#if CONFIG_LOG_TAG_LEVEL_IMPL_HASH_TABLE
+    esp_log_hash_table_get_level(tag, &level_for_tag);
+#elif CACHE_ENABLED
     bool cache_miss = !esp_log_cache_get_level(tag, &level_for_tag);
     if (cache_miss) {
         esp_log_linked_list_get_level(tag, &level_for_tag);
@@ -0,0 +1,285 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_cpu.h"
+#include "esp_compiler.h"
+#include "esp_rom_serial_output.h"
+#include "esp_log.h"
+#include "esp_log_async.h"
+#include "esp_private/log_async.h"
+#include "esp_private/log_format.h"
+#include "esp_private/log_lock.h"
+#include "esp_private/log_util.h"
+#include "sdkconfig.h"
+
+/*
+ * Each core has a ring buffer of records. Any task logging on a core reserves space for its record by advancing
+ * the head of the ring with a compare-and-swap, writes the record and marks it committed. A task moved to another
+ * core between picking the ring and reserving still reserves safely, only the contention is higher.
+ *
+ * The background task is the only consumer. It writes the committed records in the order they were reserved,
+ * zeroes them and advances the tail. A record reserved but not committed yet, as its task was preempted,
+ * stops the draining of that ring until it is committed.
+ *
+ * Free space is always zeroed, so that a record header reserved at any offset reads as not committed.
+ */
+
+#define RECORD_ALIGN            (4)
+#define ALIGN_UP(len)           (((len) + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1))
+#define RING_SIZE               (CONFIG_LOG_ASYNC_BUFFER_SIZE & ~(RECORD_ALIGN - 1))
+// Positions run over twice the ring size, so that a full ring is told apart from an empty one
+#define POS_RANGE               (2 * RING_SIZE)
+// Records are limited to half of the ring, so that one always fits in an empty ring, even after padding its end
+#define RECORD_MAX_LEN          MIN(ALIGN_UP(sizeof(record_hdr_t) + CONFIG_LOG_ASYNC_MAX_RECORD_LEN), RING_SIZE / 2)
+#define RECORD_DATA_MAX_LEN     (RECORD_MAX_LEN - sizeof(record_hdr_t))
+#define RECORD_LEN(data_len)    ALIGN_UP(sizeof(record_hdr_t) + (data_len))
+
+typedef enum {
+    RECORD_TEXT = 1,
+    RECORD_BINARY,
+    RECORD_PADDING,     /*!< Fills the end of the ring when the next record doesn't fit there */
+} record_type_t;
+
+typedef struct {
+    uint16_t data_len;  /*!< Length of the data following the header, the record is padded to RECORD_ALIGN */
+    uint8_t type;       /*!< Type of the record, see record_type_t */
+    uint8_t committed;  /*!< Set once the record is complete */
+} record_hdr_t;
+
+typedef struct {
+    uint32_t head;      /*!< Position up to which the producers reserved space */
+    uint32_t tail;      /*!< Position up to which the background task consumed records */
+    uint32_t written;
+    uint32_t dropped;
+    uint32_t peak_used;
+    uint8_t buf[RING_SIZE] __attribute__((aligned(RECORD_ALIGN)));
+} log_ring_t;
+
+static const char *TAG = "log_async";
+
+static log_ring_t s_rings[portNUM_PROCESSORS];
+static uint32_t s_task_started;
+static TaskHandle_t s_task;
+static StaticTask_t s_task_buf;
+static StackType_t s_task_stack[CONFIG_LOG_ASYNC_TASK_STACK_SIZE];
+// Serializes the draining between the background task and esp_log_async_flush()
+static SemaphoreHandle_t s_drain_mutex;
+static StaticSemaphore_t s_drain_mutex_buf;
+
+static inline uint32_t ring_used(uint32_t head, uint32_t tail)
+{
+    return (head + POS_RANGE - tail) % POS_RANGE;
+}
+
+static inline uint32_t ring_advance(uint32_t pos, uint32_t len)
+{
+    return (pos + len) % POS_RANGE;
+}
+
+static record_hdr_t *ring_reserve(log_ring_t *ring, uint32_t len)
+{
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint32_t offset;
+    uint32_t padding;
+    uint32_t used;
+    do {
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        offset = head % RING_SIZE;
+        padding = (RING_SIZE - offset < len) ? RING_SIZE - offset : 0;
+        used = ring_used(head, tail) + padding + len;
+        if (used > RING_SIZE) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&ring->head, &head, ring_advance(head, padding + len), true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    uint32_t peak = __atomic_load_n(&ring->peak_used, __ATOMIC_RELAXED);
+    while (used > peak && !__atomic_compare_exchange_n(&ring->peak_used, &peak, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    if (padding) {
+        record_hdr_t *pad = (record_hdr_t *)&ring->buf[offset];
+        pad->data_len = padding - sizeof(record_hdr_t);
+        pad->type = RECORD_PADDING;
+        __atomic_store_n(&pad->committed, 1, __ATOMIC_RELEASE);
+        offset = 0;
+    }
+    return (record_hdr_t *)&ring->buf[offset];
+}
+
+static void print_text(const char *format, ...)
+{
+    extern vprintf_like_t esp_log_vprint_func;
+    va_list args;
+    va_start(args, format);
+    esp_log_vprint_func(format, args);
+    va_end(args);
+}
+
+static void write_record(const record_hdr_t *record)
+{
+    const uint8_t *data = (const uint8_t *)(record + 1);
+    if (record->type == RECORD_TEXT) {
+        print_text("%.*s", (int)record->data_len, (const char *)data);
+    } else {
+        esp_log_impl_lock();
+        for (size_t i = 0; i < record->data_len; i++) {
+            esp_rom_output_tx_one_char(data[i]);
+        }
+        esp_log_impl_unlock();
+    }
+}
+
+static bool drain_ring(log_ring_t *ring)
+{
+    uint32_t tail = ring->tail;
+    while (tail != __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        record_hdr_t *record = (record_hdr_t *)&ring->buf[tail % RING_SIZE];
+        if (!__atomic_load_n(&record->committed, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        uint32_t len = RECORD_LEN(record->data_len);
+        if (record->type != RECORD_PADDING) {
+            write_record(record);
+            __atomic_add_fetch(&ring->written, 1, __ATOMIC_RELAXED);
+        }
+        memset(record, 0, len);
+        tail = ring_advance(tail, len);
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    return true;
+}
+
+static bool drain_all(void)
+{
+    bool empty = true;
+    xSemaphoreTake(s_drain_mutex, portMAX_DELAY);
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        empty &= drain_ring(&s_rings[i]);
+    }
+    xSemaphoreGive(s_drain_mutex);
+    return empty;
+}
+
+static uint32_t get_dropped(void)
+{
+    uint32_t dropped = 0;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        dropped += __atomic_load_n(&s_rings[i].dropped, __ATOMIC_RELAXED);
+    }
+    return dropped;
+}
+
+static void drain_task(void *arg)
+{
+    uint32_t reported_dropped = 0;
+    while (1) {
+        drain_all();
+        uint32_t dropped = get_dropped();
+        if (dropped != reported_dropped) {
+            ESP_LOGW(TAG, "%" PRIu32 " log records dropped", dropped - reported_dropped);
+            reported_dropped = dropped;
+        }
+        // each committed record notifies the task
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void start_task(void)
+{
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&s_task_started, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return;
+    }
+    s_drain_mutex = xSemaphoreCreateMutexStatic(&s_drain_mutex_buf);
+    TaskHandle_t task = xTaskCreateStatic(drain_task, "log_async", CONFIG_LOG_ASYNC_TASK_STACK_SIZE, NULL,
+                                          CONFIG_LOG_ASYNC_TASK_PRIORITY, s_task_stack, &s_task_buf);
+    __atomic_store_n(&s_task, task, __ATOMIC_RELEASE);
+}
+
+bool esp_log_async_write(esp_log_msg_t *message)
+{
+    if (message->config.opts.constrained_env) {
+        return false;
+    }
+    if (unlikely(__atomic_load_n(&s_task_started, __ATOMIC_ACQUIRE) == 0)) {
+        start_task();
+    }
+
+    uint8_t data[RECORD_DATA_MAX_LEN];
+#if CONFIG_LOG_MODE_BINARY_EN
+    const uint8_t type = RECORD_BINARY;
+    size_t len = esp_log_format_binary_to_buffer(message, data, sizeof(data));
+    if (len == 0) {
+        // too long for a record, the arguments are not consumed yet
+        return false;
+    }
+#else
+    const uint8_t type = RECORD_TEXT;
+    size_t len = esp_log_format_to_buffer(message, (char *)data, sizeof(data));
+#endif
+
+    log_ring_t *ring = &s_rings[esp_cpu_get_core_id()];
+    record_hdr_t *record;
+    while ((record = ring_reserve(ring, RECORD_LEN(len))) == NULL) {
+#if CONFIG_LOG_ASYNC_OVERFLOW_BLOCK
+        TaskHandle_t task = __atomic_load_n(&s_task, __ATOMIC_ACQUIRE);
+        if (task != NULL && task != xTaskGetCurrentTaskHandle()) {
+            xTaskNotifyGive(task);
+            vTaskDelay(1);
+            continue;
+        }
+#endif
+        __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+    record->data_len = len;
+    record->type = type;
+    memcpy(record + 1, data, len);
+    __atomic_store_n(&record->committed, 1, __ATOMIC_RELEASE);
+
+    TaskHandle_t task = __atomic_load_n(&s_task, __ATOMIC_ACQUIRE);
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+void esp_log_async_flush(void)
+{
+    if (esp_log_util_is_constrained()) {
+        return;
+    }
+    start_task();
+    while (__atomic_load_n(&s_task, __ATOMIC_ACQUIRE) == NULL) {
+        vTaskDelay(1);
+    }
+    while (!drain_all()) {
+        // a preempted task still writes its record
+        vTaskDelay(1);
+    }
+}
+
+void esp_log_async_get_stats(esp_log_async_stats_t *stats)
+{
+    assert(stats != NULL);
+    *stats = (esp_log_async_stats_t) {
+        0
+    };
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        stats->written += __atomic_load_n(&s_rings[i].written, __ATOMIC_RELAXED);
+        stats->dropped += __atomic_load_n(&s_rings[i].dropped, __ATOMIC_RELAXED);
+        stats->peak_used = MAX(stats->peak_used, __atomic_load_n(&s_rings[i].peak_used, __ATOMIC_RELAXED));
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_log_async.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "sdkconfig.h"
+
+#if CONFIG_LOG_ASYNC && CONFIG_LOG_MODE_TEXT
+
+static const char *TAG = "log_async";
+
+static int s_lines;
+static int s_last_index;
+static bool s_in_order;
+static uint32_t s_output_delay_us;
+
+static int capture_vprintf(const char *format, va_list args)
+{
+    char line[CONFIG_LOG_ASYNC_MAX_RECORD_LEN + 1];
+    int len = vsnprintf(line, sizeof(line), format, args);
+    const char *msg = strstr(line, "async msg ");
+    if (msg != NULL) {
+        int index = atoi(msg + strlen("async msg "));
+        s_in_order &= index > s_last_index;
+        s_last_index = index;
+        s_lines++;
+    }
+    // emulates a slow output such as UART
+    esp_rom_delay_us(s_output_delay_us);
+    return len;
+}
+
+static void reset_capture(void)
+{
+    s_lines = 0;
+    s_last_index = -1;
+    s_in_order = true;
+    s_output_delay_us = 0;
+}
+
+TEST_CASE("async log writes the records of a task in order", "[log][async]")
+{
+    const int COUNT = 100;
+    esp_log_async_flush();
+    esp_log_async_stats_t before;
+    esp_log_async_get_stats(&before);
+    reset_capture();
+    vprintf_like_t original = esp_log_set_vprintf(capture_vprintf);
+
+    for (int i = 0; i < COUNT; i++) {
+        ESP_LOGI(TAG, "async msg %d", i);
+        // leave time to the background task, so that no record is dropped
+        vTaskDelay(1);
+    }
+    esp_log_async_flush();
+    esp_log_set_vprintf(original);
+
+    esp_log_async_stats_t stats;
+    esp_log_async_get_stats(&stats);
+    TEST_ASSERT_EQUAL(COUNT, s_lines);
+    TEST_ASSERT_TRUE(s_in_order);
+    TEST_ASSERT_EQUAL(before.dropped, stats.dropped);
+    TEST_ASSERT_GREATER_OR_EQUAL(before.written + COUNT, stats.written);
+    TEST_ASSERT_GREATER_THAN(0, stats.peak_used);
+}
+
+TEST_CASE("async log accounts for every record of a burst", "[log][async]")
+{
+    // The burst is logged faster than the output takes the records, so that the buffer overflows.
+    const int COUNT = 2 * CONFIG_LOG_ASYNC_BUFFER_SIZE / 32;
+    esp_log_async_flush();
+    esp_log_async_stats_t before;
+    esp_log_async_get_stats(&before);
+    reset_capture();
+    s_output_delay_us = 1000;
+    vprintf_like_t original = esp_log_set_vprintf(capture_vprintf);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < COUNT; i++) {
+        ESP_LOGI(TAG, "async msg %d", i);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    esp_log_async_flush();
+    esp_log_set_vprintf(original);
+
+    esp_log_async_stats_t stats;
+    esp_log_async_get_stats(&stats);
+    const uint32_t dropped = stats.dropped - before.dropped;
+    printf("%d records logged in %" PRIi64 " us, %" PRIu32 " dropped, peak use %" PRIu32 " bytes\n",
+           COUNT, elapsed, dropped, stats.peak_used);
+    TEST_ASSERT_TRUE(s_in_order);
+    TEST_ASSERT_EQUAL(COUNT, s_lines + dropped);
+#if CONFIG_LOG_ASYNC_OVERFLOW_DROP
+    TEST_ASSERT_GREATER_THAN(0, dropped);
+#else
+    TEST_ASSERT_EQUAL(0, dropped);
+#endif
+}
+
+#endif // CONFIG_LOG_ASYNC && CONFIG_LOG_MODE_TEXT
@@ -12,6 +12,8 @@ from pytest_embedded_idf.utils import idf_parametrize
         'default',
         'v2_constrained_env_safe',
         'v2_constrained_env_unsafe',
+        'v2_async',
+        'v2_async_block',
     ],
     indirect=True,
 )
@@ -0,0 +1,292 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""Render binary log output (CONFIG_LOG_MODE_BINARY) as text.
+
+In binary log mode the chip does not format messages. Each log call outputs a package holding the address of the
+format string (or the string itself when it is not present in the ELF file), the tag, the timestamp and the raw
+argument words. This tool reads the packages from a capture file or stdin and renders them using the ELF file.
+Bytes which are not part of a valid package (ROM output, text logs of a constrained environment) pass through.
+
+Usage:
+    python log_binary_decoder.py build/app.elf --bootloader-elf build/bootloader/bootloader.elf capture.bin
+    ./build/app.elf | python log_binary_decoder.py build/app.elf   # linux target
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import struct
+import sys
+from dataclasses import dataclass
+from typing import BinaryIO
+
+CONTROL_LEN = 3
+CRC_LEN = 1
+MIN_PKG_LEN = CONTROL_LEN + 2 * 2 + 4 + CRC_LEN
+APP_BOOTLOADER = 0x01
+APP_APPLICATION = 0x02
+# Embedded strings start with their negative length (1 - len) on 16 bits, the length is at most 10 bits
+EMBEDDED_STR_MARKER = 0xFC
+LEVEL_NAMES = {1: 'E', 2: 'W', 3: 'I', 4: 'D', 5: 'V'}
+BYTES_PER_LINE = 16
+BUFFER_HEX_FORMAT = '__ESP_BUFFER_HEX_FORMAT__'
+BUFFER_CHAR_FORMAT = '__ESP_BUFFER_CHAR_FORMAT__'
+BUFFER_HEXDUMP_FORMAT = '__ESP_BUFFER_HEXDUMP_FORMAT__'
+
+# Conversion specification of printf, the same subset as handled by the chip
+FORMAT_SPEC = re.compile(
+    r'%(?P<flags>[-+ #0]*)(?P<width>\d+)?(?:\.(?P<precision>\d+))?(?P<length>hh|h|ll|l|z|j|t|L)?(?P<conv>[%a-zA-Z])'
+)
+
+
+class DecodeError(Exception):
+    pass
+
+
+def crc8(data: bytes) -> int:
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+class ElfStrings:
+    """Reads strings from the sections of an ELF file by their address."""
+
+    def __init__(self, path: str) -> None:
+        from elftools.elf.elffile import ELFFile
+
+        self.sections: list[tuple[int, bytes]] = []
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            self.ptr_size = 8 if elf.elfclass == 64 else 4
+            for section in elf.iter_sections():
+                if section['sh_addr'] != 0 and section['sh_type'] != 'SHT_NOBITS':
+                    self.sections.append((section['sh_addr'], section.data()))
+                elif section.name.startswith('.noload'):
+                    # not loaded to the chip, but the ELF file keeps it at its link address
+                    self.sections.append((section['sh_addr'], section.data()))
+
+    def read(self, addr: int, length: int | None = None) -> bytes | None:
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                offset = addr - base
+                if length is not None:
+                    return data[offset : offset + length]
+                end = data.find(b'\0', offset)
+                return data[offset : end if end >= 0 else len(data)]
+        return None
+
+
+class Package:
+    """Reads the fields of one package, in the order the chip outputs them (big-endian)."""
+
+    def __init__(self, data: bytes, elf: ElfStrings | None, ptr_size: int) -> None:
+        self.data = data
+        self.pos = CONTROL_LEN
+        self.elf = elf
+        self.ptr_size = ptr_size
+
+    def read_uint(self, size: int) -> int:
+        if self.pos + size > len(self.data) - CRC_LEN:
+            raise DecodeError('package too short')
+        value = int.from_bytes(self.data[self.pos : self.pos + size], 'big')
+        self.pos += size
+        return value
+
+    def read_string(self, length: int | None = None) -> bytes:
+        if self.pos >= len(self.data) - CRC_LEN:
+            raise DecodeError('package too short')
+        if self.data[self.pos] >= EMBEDDED_STR_MARKER:
+            encoded_len = 1 - struct.unpack('>h', self.data[self.pos : self.pos + 2])[0]
+            self.pos += 2
+            value = self.data[self.pos : self.pos + encoded_len]
+            self.pos += encoded_len
+            # strings shorter than 2 bytes are padded with zeros
+            return value[:length] if length is not None else value.rstrip(b'\0')
+        addr = self.read_uint(self.ptr_size)
+        if addr == 0:
+            return b'(null)'
+        value = self.elf.read(addr, length) if self.elf else None
+        if value is None:
+            return f'<string at 0x{addr:x} not found in ELF>'.encode()
+        return value
+
+
+@dataclass
+class Record:
+    app: int
+    level: int
+    tag: str
+    timestamp: int
+    lines: list[str]
+
+    def __str__(self) -> str:
+        prefix = f'{LEVEL_NAMES.get(self.level, "?")} ({self.timestamp}) {self.tag}: '
+        return '\n'.join(prefix + line for line in self.lines)
+
+
+def arg_size(conv: str, length: str | None) -> int:
+    if conv in 'fFeEgGaA':
+        return 8
+    return 8 if length == 'll' else 4
+
+
+def to_signed(value: int, size: int) -> int:
+    bits = size * 8
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def render_format(fmt: str, pkg: Package) -> str:
+    out = []
+    last = 0
+    for spec in FORMAT_SPEC.finditer(fmt):
+        out.append(fmt[last : spec.start()])
+        last = spec.end()
+        conv = spec.group('conv')
+        if conv == '%':
+            out.append('%')
+            continue
+        py_spec = '%' + spec.group('flags') + (spec.group('width') or '')
+        if spec.group('precision') is not None:
+            py_spec += '.' + spec.group('precision')
+        if conv in 'sS':
+            out.append((py_spec + 's') % pkg.read_string().decode(errors='replace'))
+            continue
+        size = arg_size(conv, spec.group('length'))
+        value = pkg.read_uint(size)
+        if conv in 'di':
+            out.append((py_spec + 'd') % to_signed(value, size))
+        elif conv in 'uxXo':
+            out.append((py_spec + conv.replace('u', 'd')) % value)
+        elif conv == 'c':
+            out.append((py_spec + 'c') % chr(value & 0xFF))
+        elif conv == 'p':
+            out.append((py_spec + 's') % f'0x{value:x}')
+        elif conv in 'fFeEgGaA':
+            number = struct.unpack('<d', value.to_bytes(8, 'little'))[0]
+            out.append((py_spec + conv.replace('a', 'e').replace('A', 'E')) % number)
+        else:
+            out.append((py_spec + 'd') % value)
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+def render_buffer(fmt: str, pkg: Package) -> list[str]:
+    length = pkg.read_uint(4)
+    data = pkg.read_string(length)
+    address = pkg.read_uint(4)
+    lines = []
+    for offset in range(0, len(data), BYTES_PER_LINE):
+        chunk = data[offset : offset + BYTES_PER_LINE]
+        if fmt.startswith(BUFFER_HEX_FORMAT):
+            lines.append(' '.join(f'{b:02x}' for b in chunk))
+        elif fmt.startswith(BUFFER_CHAR_FORMAT):
+            lines.append(chunk.decode(errors='replace'))
+        else:
+            hex_part = ''
+            for i in range(BYTES_PER_LINE):
+                hex_part += (' ' if i % 8 == 0 else '') + (f' {chunk[i]:02x}' if i < len(chunk) else '   ')
+            text = ''.join(chr(b) if 32 <= b <= 126 else '.' for b in chunk)
+            lines.append(f'0x{address + offset:08x} {hex_part}  |{text}|')
+    return lines
+
+
+def decode_package(data: bytes, elf: ElfStrings | None, ptr_size: int) -> Record:
+    app = data[0]
+    control = int.from_bytes(data[1:3], 'big')
+    level = (control >> 10) & 0x07
+    time_64bits = (control >> 13) & 0x01
+    pkg = Package(data, elf, ptr_size)
+    fmt = pkg.read_string().decode(errors='replace')
+    tag = pkg.read_string().decode(errors='replace')
+    timestamp = pkg.read_uint(8 if time_64bits else 4)
+    if fmt.startswith((BUFFER_HEX_FORMAT, BUFFER_CHAR_FORMAT, BUFFER_HEXDUMP_FORMAT)):
+        lines = render_buffer(fmt, pkg)
+    else:
+        lines = render_format(fmt, pkg).rstrip('\n').split('\n')
+    return Record(app, level, tag, timestamp, lines)
+
+
+def find_package(data: bytes, start: int) -> tuple[int, int, int]:
+    """Looks for the first package with a valid length and checksum from start.
+
+    Returns its position and length, or the length of data and 0 if there is none. The third value is the position
+    of the first package which may still be incomplete, the bytes from there must be kept for the next read.
+    """
+    incomplete = len(data)
+    for pos in range(start, len(data)):
+        if data[pos] not in (APP_BOOTLOADER, APP_APPLICATION):
+            continue
+        if pos + CONTROL_LEN > len(data):
+            return len(data), 0, min(incomplete, pos)
+        pkg_len = int.from_bytes(data[pos + 1 : pos + 3], 'big') & 0x3FF
+        version = data[pos + 1] >> 6
+        if version != 0 or pkg_len < MIN_PKG_LEN:
+            continue
+        if pos + pkg_len > len(data):
+            incomplete = min(incomplete, pos)
+            continue
+        if crc8(data[pos : pos + pkg_len - CRC_LEN]) == data[pos + pkg_len - CRC_LEN]:
+            return pos, pkg_len, incomplete
+    return len(data), 0, incomplete
+
+
+def decode_stream(
+    data: bytes, elfs: dict[int, ElfStrings | None], ptr_size: int, out: BinaryIO, final: bool = False
+) -> int:
+    """Writes the decoded records and the bytes in between, returns the number of bytes to keep for the next read."""
+    pos = 0
+    while True:
+        start, pkg_len, incomplete = find_package(data, pos)
+        if incomplete < start and not final:
+            # a package may begin before the one found, wait for more data to tell
+            out.write(data[pos:incomplete])
+            return len(data) - incomplete
+        out.write(data[pos:start])
+        if pkg_len == 0:
+            return 0
+        elf = elfs.get(data[start])
+        try:
+            record = decode_package(data[start : start + pkg_len], elf, elf.ptr_size if elf else ptr_size)
+            out.write(f'{record}\n'.encode())
+        except DecodeError as e:
+            out.write(f'<undecodable package: {e}>\n'.encode())
+        pos = start + pkg_len
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description='Render binary log output as text')
+    parser.add_argument('elf', help='ELF file of the application')
+    parser.add_argument('--bootloader-elf', help='ELF file of the bootloader')
+    parser.add_argument('--ptr-size', type=int, default=4, help='Size of a pointer when no ELF file matches')
+    parser.add_argument('input', nargs='?', help='Captured log output, stdin by default')
+    args = parser.parse_args()
+
+    elfs: dict[int, ElfStrings | None] = {
+        APP_APPLICATION: ElfStrings(args.elf),
+        APP_BOOTLOADER: ElfStrings(args.bootloader_elf) if args.bootloader_elf else None,
+    }
+    src = open(args.input, 'rb') if args.input else sys.stdin.buffer
+    out = sys.stdout.buffer
+    pending = b''
+    try:
+        while True:
+            chunk = src.read1(4096) if hasattr(src, 'read1') else src.read(4096)
+            if not chunk:
+                break
+            pending += chunk
+            keep = decode_stream(pending, elfs, args.ptr_size, out)
+            pending = pending[len(pending) - keep :]
+            out.flush()
+        decode_stream(pending, elfs, args.ptr_size, out, final=True)
+    finally:
+        if src is not sys.stdin.buffer:
+            src.close()
+
+
+if __name__ == '__main__':
+    main()
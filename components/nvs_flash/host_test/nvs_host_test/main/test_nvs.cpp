@@ -20,6 +20,11 @@
 #include <random>
 #include <cmath>
 #include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <thread>
 #include "test_fixtures.hpp"
 #include "spi_flash_mmap.h"
 
@@ -28,6 +33,7 @@ using namespace std;
 #define TEST_DEFAULT_PARTITION_NAME "nvs"               // Default partition name used in the tests - 10 sectors
 #define TEST_SECONDARY_PARTITION_NAME "nvs_sec"         // Secondary partition name used in the tests - 10 sectors
 #define TEST_3SEC_PARTITION_NAME "nvs_3sec"             // Partition used in the space constrained tests - 3 sectors
+#define TEST_LARGE_PARTITION_NAME "nvs_large"           // Partition used in the benchmarks scaling with page count - 32 sectors
 
 #define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
 #define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
@@ -5521,6 +5527,225 @@ TEST_CASE("nvs multiple write with same key float then double", "[nvs]")
     TEST_ESP_OK(nvs_flash_deinit_partition(TEST_3SEC_PARTITION_NAME));
 }
 
+TEST_CASE("benchmark item lookup latency vs page count", "[nvs][perf]")
+{
+    // Benchmark fills storages of growing size with U32 items spread over all pages and measures the average
+    // time needed to read every item back. Without CONFIG_NVS_KEY_INDEX, every lookup asks the pages one by one,
+    // so the latency grows with the page count. With the storage-wide index, only the page holding the item is asked.
+
+    const uint32_t sectorCounts[] = {4, 8, 16, 32};
+    const size_t READ_ROUNDS = 10;
+
+    for (uint32_t sectors : sectorCounts) {
+        NVSPartitionTestHelper h(TEST_LARGE_PARTITION_NAME);
+        REQUIRE(h.get_sectors() >= sectors);
+
+        nvs::Storage storage(&h);
+        REQUIRE(storage.init(0, sectors) == ESP_OK);
+        uint8_t ns;
+        REQUIRE(storage.createOrOpenNamespace("bench", true, ns) == ESP_OK);
+
+        // leave one page for the namespace entry and one spare page
+        const size_t itemCount = (sectors - 2) * nvs::Page::ENTRY_COUNT;
+        char key[16];
+        for (size_t i = 0; i < itemCount; ++i) {
+            snprintf(key, sizeof(key), "key_%zu", i);
+            REQUIRE(storage.writeItem(ns, key, static_cast<uint32_t>(i), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+        }
+
+        NVSPartitionTestHelper::clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < READ_ROUNDS; ++round) {
+            for (size_t i = 0; i < itemCount; ++i) {
+                uint32_t value;
+                snprintf(key, sizeof(key), "key_%zu", i);
+                REQUIRE(storage.readItem(ns, key, value) == ESP_OK);
+                REQUIRE(value == i);
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        const size_t reads = READ_ROUNDS * itemCount;
+
+        s_perf << "Lookup of " << itemCount << " items in " << sectors << " sectors: " << elapsed / reads << " ns/read, "
+               << NVSPartitionTestHelper::get_read_ops() / reads << " flash reads/read" << std::endl;
+    }
+}
+
+TEST_CASE("benchmark write latency percentiles with and without incremental gc", "[nvs][perf]")
+{
+    // Benchmark updates a set of U32 keys round robin and records the flash time spent by each write.
+    // Without the incremental garbage collection, every write which runs out of pages reclaims a page itself,
+    // including the sector erase. With it, one collection step is done between the writes, as an idle task would do,
+    // and the time spent in the steps is reported separately.
+
+    const uint32_t SECTORS = 4;
+    const size_t KEY_COUNT = 20;
+    const size_t WRITE_COUNT = 4000;
+    const size_t GC_STEP_ENTRIES = 8;
+
+    for (int useGc = 0; useGc < 2; ++useGc) {
+        NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+        nvs::Storage storage(&h);
+        REQUIRE(storage.init(0, SECTORS) == ESP_OK);
+        uint8_t ns;
+        REQUIRE(storage.createOrOpenNamespace("bench", true, ns) == ESP_OK);
+
+        std::vector<size_t> latencies;
+        latencies.reserve(WRITE_COUNT);
+        size_t gcTime = 0;
+        size_t writeErases = 0;
+        char key[16];
+        NVSPartitionTestHelper::clear_stats();
+        for (size_t i = 0; i < WRITE_COUNT; ++i) {
+            snprintf(key, sizeof(key), "key_%zu", i % KEY_COUNT);
+            size_t start = NVSPartitionTestHelper::get_total_time();
+            size_t erases = NVSPartitionTestHelper::get_erase_ops();
+            REQUIRE(storage.writeItem(ns, key, static_cast<uint32_t>(i), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+            latencies.push_back(NVSPartitionTestHelper::get_total_time() - start);
+            writeErases += NVSPartitionTestHelper::get_erase_ops() - erases;
+
+            if (useGc) {
+                bool pending;
+                start = NVSPartitionTestHelper::get_total_time();
+                REQUIRE(storage.gcStep(GC_STEP_ENTRIES, pending) == ESP_OK);
+                gcTime += NVSPartitionTestHelper::get_total_time() - start;
+            }
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](size_t p) {
+            return latencies[(latencies.size() - 1) * p / 1000];
+        };
+        s_perf << "Write latency of " << WRITE_COUNT << " updates " << (useGc ? "with" : "without") << " incremental gc: p50="
+               << percentile(500) << " us p99=" << percentile(990) << " us p99.9=" << percentile(999) << " us max=" << latencies.back()
+               << " us, " << writeErases << " erases in writes, " << gcTime << " us in gc steps" << std::endl;
+
+        if (useGc) {
+            CHECK(writeErases == 0);
+        }
+    }
+}
+
+TEST_CASE("benchmark storage init time vs partition size", "[nvs][perf]")
+{
+    // Benchmark fills storages of growing size with U32 items and measures the flash time spent by Storage::init
+    // to load them again. The pages are loaded through the sector read cache, so that each pass of the init
+    // reads the item headers of a page with one flash read.
+
+    const uint32_t sectorCounts[] = {4, 8, 16, 32};
+
+    for (uint32_t sectors : sectorCounts) {
+        NVSPartitionTestHelper h(TEST_LARGE_PARTITION_NAME);
+        REQUIRE(h.get_sectors() >= sectors);
+
+        size_t itemCount;
+        {
+            nvs::Storage storage(&h);
+            REQUIRE(storage.init(0, sectors) == ESP_OK);
+            uint8_t ns;
+            REQUIRE(storage.createOrOpenNamespace("bench", true, ns) == ESP_OK);
+
+            // leave one page for the namespace entry and one spare page
+            itemCount = (sectors - 2) * nvs::Page::ENTRY_COUNT;
+            char key[16];
+            for (size_t i = 0; i < itemCount; ++i) {
+                snprintf(key, sizeof(key), "key_%zu", i);
+                REQUIRE(storage.writeItem(ns, key, static_cast<uint32_t>(i), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+            }
+        }
+
+        nvs::Storage storage(&h);
+        NVSPartitionTestHelper::clear_stats();
+        REQUIRE(storage.init(0, sectors) == ESP_OK);
+        s_perf << "Time to init storage with " << itemCount << " items in " << sectors << " sectors: "
+               << NVSPartitionTestHelper::get_total_time() << " us (" << NVSPartitionTestHelper::get_read_ops() << "R "
+               << NVSPartitionTestHelper::get_read_bytes() << "Rb)" << std::endl;
+
+        uint8_t ns;
+        REQUIRE(storage.createOrOpenNamespace("bench", false, ns) == ESP_OK);
+        uint32_t value;
+        REQUIRE(storage.readItem(ns, "key_0", value) == ESP_OK);
+        CHECK(value == 0);
+    }
+}
+
+TEST_CASE("benchmark read throughput with concurrent readers and a writer", "[nvs][perf]")
+{
+    // Benchmark runs N threads reading U32 items of a storage while one thread keeps updating another item,
+    // for a fixed time, and reports the reads done per second. Reads take the storage lock shared, so that they
+    // only wait for the writer. For comparison, the same load is run with reads taking the lock exclusively,
+    // as all accesses did when a single lock guarded every storage.
+
+    const size_t readerCounts[] = {1, 2, 4};
+    const size_t KEY_COUNT = 32;
+    const auto DURATION = std::chrono::milliseconds(200);
+
+    for (int shared = 0; shared < 2; ++shared) {
+        for (size_t readers : readerCounts) {
+            NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+            nvs::Storage storage(&h);
+            REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+            uint8_t ns;
+            REQUIRE(storage.createOrOpenNamespace("bench", true, ns) == ESP_OK);
+            char key[16];
+            for (size_t i = 0; i < KEY_COUNT; ++i) {
+                snprintf(key, sizeof(key), "key_%zu", i);
+                REQUIRE(storage.writeItem(ns, key, static_cast<uint32_t>(i), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+            }
+
+            const auto readMode = shared ? nvs::StorageAccess::Mode::READ : nvs::StorageAccess::Mode::WRITE;
+            auto enter = [&](nvs::StorageAccess& access) {
+                {
+                    nvs::Lock lock;
+                    access.attach(&storage);
+                }
+                access.acquire();
+            };
+
+            std::atomic<bool> done{false};
+            std::atomic<size_t> reads{0};
+            std::atomic<size_t> failures{0};
+            std::vector<std::thread> threads;
+            for (size_t r = 0; r < readers; ++r) {
+                threads.emplace_back([&, r]() {
+                    char readKey[16];
+                    size_t count = 0;
+                    for (size_t i = r; !done.load(std::memory_order_relaxed); ++i) {
+                        nvs::StorageAccess access(readMode);
+                        enter(access);
+                        uint32_t value;
+                        snprintf(readKey, sizeof(readKey), "key_%zu", i % KEY_COUNT);
+                        if (storage.readItem(ns, readKey, value) != ESP_OK || value != i % KEY_COUNT) {
+                            ++failures;
+                        }
+                        ++count;
+                    }
+                    reads += count;
+                });
+            }
+            threads.emplace_back([&]() {
+                for (uint32_t i = 0; !done.load(std::memory_order_relaxed); ++i) {
+                    nvs::StorageAccess access(nvs::StorageAccess::Mode::WRITE);
+                    enter(access);
+                    if (storage.writeItem(ns, "counter", i, TEST_DEFAULT_PURGE_AFTER_ERASE) != ESP_OK) {
+                        ++failures;
+                    }
+                }
+            });
+
+            std::this_thread::sleep_for(DURATION);
+            done = true;
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            CHECK(failures.load() == 0);
+
+            s_perf << "Read throughput with " << readers << " readers and 1 writer, " << (shared ? "shared" : "exclusive")
+                   << " reads: " << reads.load() * 1000 / DURATION.count() << " reads/s" << std::endl;
+        }
+    }
+}
+
 // Add new tests above
 // This test has to be the final one
 
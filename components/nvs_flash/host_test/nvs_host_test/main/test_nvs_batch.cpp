@@ -0,0 +1,309 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs.h"                            // for nvs C API
+#include "nvs_flash.h"                      // for nvs_flash_init_partition
+#include "nvs_batch.hpp"                    // for Batch class
+#include "nvs_page.hpp"                     // for Page class
+#include "nvs_storage.hpp"                  // for Storage class
+#include "test_fixtures.hpp"                // for test fixtures
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_3SEC_PARTITION_NAME "nvs_3sec"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+#define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
+#define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
+
+static const size_t BATCH_KEY_COUNT = 10;
+static const char BATCH_STR_KEY[] = "str";
+static const char BATCH_BLOB_KEY[] = "blob";
+
+// Stages a set of values that differ for every generation
+static void stage_batch(nvs::Batch& batch, uint32_t generation)
+{
+    for (size_t i = 0; i < BATCH_KEY_COUNT; ++i) {
+        string key = "key_" + to_string(i);
+        uint32_t value = generation * 1000 + i;
+        REQUIRE(batch.set(nvs::ItemType::U32, key.c_str(), &value, sizeof(value)) == ESP_OK);
+    }
+    string str = "string of generation " + to_string(generation);
+    REQUIRE(batch.set(nvs::ItemType::SZ, BATCH_STR_KEY, str.c_str(), str.size() + 1) == ESP_OK);
+    uint8_t blob[100];
+    std::fill_n(blob, sizeof(blob), static_cast<uint8_t>(generation));
+    REQUIRE(batch.set(nvs::ItemType::BLOB, BATCH_BLOB_KEY, blob, sizeof(blob)) == ESP_OK);
+}
+
+// Returns the generation of the values stored, or -1 if the values are of mixed generations
+static int stored_generation(nvs::Storage& storage, uint8_t ns)
+{
+    uint32_t value;
+    if (storage.readItem(ns, "key_0", value) != ESP_OK) {
+        return -1;
+    }
+    const uint32_t generation = value / 1000;
+
+    for (size_t i = 0; i < BATCH_KEY_COUNT; ++i) {
+        string key = "key_" + to_string(i);
+        if (storage.readItem(ns, key.c_str(), value) != ESP_OK || value != generation * 1000 + i) {
+            return -1;
+        }
+    }
+    char str[64];
+    string expectedStr = "string of generation " + to_string(generation);
+    if (storage.readItem(ns, nvs::ItemType::SZ, BATCH_STR_KEY, str, sizeof(str)) != ESP_OK || expectedStr != str) {
+        return -1;
+    }
+    uint8_t blob[100];
+    if (storage.readItem(ns, nvs::ItemType::BLOB, BATCH_BLOB_KEY, blob, sizeof(blob)) != ESP_OK) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(blob); ++i) {
+        if (blob[i] != static_cast<uint8_t>(generation)) {
+            return -1;
+        }
+    }
+    return static_cast<int>(generation);
+}
+
+// Number of entries the values of one generation occupy, i.e. if there are no leftovers of other generations
+static size_t generation_entry_count(uint32_t generation)
+{
+    string str = "string of generation " + to_string(generation);
+    size_t strEntries = 1 + (str.size() + 1 + nvs::Page::ENTRY_SIZE - 1) / nvs::Page::ENTRY_SIZE;
+    size_t blobEntries = 1 + (100 + nvs::Page::ENTRY_SIZE - 1) / nvs::Page::ENTRY_SIZE + 1;
+    return BATCH_KEY_COUNT + strEntries + blobEntries;
+}
+
+TEST_CASE("batch replaces all values at once", "[nvs_batch]")
+{
+    // TC verifies that the values of a batch are written and replace the previous ones.
+    // It verifies that:
+    // - values written by single writes and by previous batches are replaced, regardless of their datatype
+    //   (of the same datatype in the legacy mode)
+    // - no entries of the previous values are left behind, also after reinit
+    // - values which are staged twice are written once, with the last value staged
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("batch", true, ns) == ESP_OK);
+
+    // previous values written one by one, some of them with different datatypes than the batch uses
+    // unless values of other datatypes are kept in the legacy mode
+    for (size_t i = 0; i < BATCH_KEY_COUNT; ++i) {
+        string key = "key_" + to_string(i);
+#ifndef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+        if (i % 2) {
+            REQUIRE(storage.writeItem(ns, key.c_str(), static_cast<uint8_t>(i), purgeAfterErase) == ESP_OK);
+            continue;
+        }
+#endif
+        REQUIRE(storage.writeItem(ns, key.c_str(), static_cast<uint32_t>(i), purgeAfterErase) == ESP_OK);
+    }
+#ifndef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+    REQUIRE(storage.writeItem(ns, nvs::ItemType::SZ, BATCH_BLOB_KEY, "blob as string", 15, purgeAfterErase) == ESP_OK);
+#endif
+
+    for (uint32_t generation = 1; generation < 40; ++generation) {
+        nvs::Batch batch;
+        uint32_t dummy = 0;
+        REQUIRE(batch.set(nvs::ItemType::U32, "key_0", &dummy, sizeof(dummy)) == ESP_OK);
+        stage_batch(batch, generation);
+        CHECK(batch.size() == BATCH_KEY_COUNT + 2);
+        CHECK(batch.getEntryCount() == generation_entry_count(generation));
+
+        REQUIRE(storage.writeBatch(ns, batch, purgeAfterErase) == ESP_OK);
+        CHECK(stored_generation(storage, ns) == static_cast<int>(generation));
+
+        size_t usedEntries;
+        REQUIRE(storage.calcEntriesInNamespace(ns, usedEntries) == ESP_OK);
+        CHECK(usedEntries == generation_entry_count(generation));
+    }
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, h.get_sectors()) == ESP_OK);
+    CHECK(stored_generation(reloaded, ns) == 39);
+    size_t usedEntries;
+    REQUIRE(reloaded.calcEntriesInNamespace(ns, usedEntries) == ESP_OK);
+    CHECK(usedEntries == generation_entry_count(39));
+}
+
+TEST_CASE("batch is rejected if it doesn't fit into a page", "[nvs_batch]")
+{
+    // TC verifies that a batch larger than a page is rejected without changing the stored values
+    // and that values which can't be written as a part of a batch are refused when they are staged.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("batch", true, ns) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "key_0", static_cast<uint32_t>(1), purgeAfterErase) == ESP_OK);
+
+    nvs::Batch batch;
+    uint8_t blob[nvs::Page::CHUNK_MAX_SIZE + 1] = {};
+    CHECK(batch.set(nvs::ItemType::BLOB, "blob", blob, sizeof(blob)) == ESP_ERR_NVS_VALUE_TOO_LONG);
+    CHECK(batch.set(nvs::ItemType::U32, "key_with_too_long_name", blob, sizeof(uint32_t)) == ESP_ERR_NVS_KEY_TOO_LONG);
+    CHECK(batch.empty());
+
+    REQUIRE(batch.set(nvs::ItemType::BLOB, "blob", blob, 3000) == ESP_OK);
+    for (uint32_t i = 0; i < 40; ++i) {
+        string key = "key_" + to_string(i);
+        REQUIRE(batch.set(nvs::ItemType::U32, key.c_str(), &i, sizeof(i)) == ESP_OK);
+    }
+    CHECK(batch.getEntryCount() >= nvs::Page::ENTRY_COUNT);
+    CHECK(storage.writeBatch(ns, batch, purgeAfterErase) == ESP_ERR_NVS_NOT_ENOUGH_SPACE);
+
+    uint32_t value;
+    REQUIRE(storage.readItem(ns, "key_0", value) == ESP_OK);
+    CHECK(value == 1);
+    CHECK(storage.readItem(ns, "key_1", value) == ESP_ERR_NVS_NOT_FOUND);
+}
+
+TEST_CASE("batch is all-or-nothing on power loss", "[nvs_batch]")
+{
+    // TC verifies that a power loss at any point of writing a batch leaves either all the previous values or
+    // all the new values after reinit, without any leftovers of the other generation.
+    // The power-off is emulated at gradually increasing points of the batch write, until the write succeeds.
+
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    bool done = false;
+
+    for (size_t errDelay = 0; !done; ++errDelay) {
+        INFO(errDelay);
+        NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+        uint8_t ns;
+        {
+            nvs::Storage storage(&h);
+            REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+            REQUIRE(storage.createOrOpenNamespace("batch", true, ns) == ESP_OK);
+
+            nvs::Batch previous;
+            stage_batch(previous, 1);
+            REQUIRE(storage.writeBatch(ns, previous, purgeAfterErase) == ESP_OK);
+
+            // move the next batch to another page, so that the previous values are spread over two pages
+            for (size_t i = 0; i < nvs::Page::ENTRY_COUNT - 30; ++i) {
+                REQUIRE(storage.writeItem(ns, "filler", static_cast<uint32_t>(i), purgeAfterErase) == ESP_OK);
+            }
+            uint32_t value = 5000;
+            REQUIRE(storage.writeItem(ns, "key_3", value, purgeAfterErase) == ESP_OK);
+            REQUIRE(storage.writeItem(ns, "key_3", static_cast<uint32_t>(1003), purgeAfterErase) == ESP_OK);
+
+            nvs::Batch batch;
+            stage_batch(batch, 2);
+            NVSPartitionTestHelper::fail_after(errDelay, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+            done = (storage.writeBatch(ns, batch, purgeAfterErase) == ESP_OK);
+            NVSPartitionTestHelper::fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        }
+
+        nvs::Storage reloaded(&h);
+        REQUIRE(reloaded.init(0, h.get_sectors()) == ESP_OK);
+        int generation = stored_generation(reloaded, ns);
+        if (done) {
+            CHECK(generation == 2);
+        }
+        REQUIRE((generation == 1 || generation == 2));
+
+        size_t usedEntries;
+        REQUIRE(reloaded.calcEntriesInNamespace(ns, usedEntries) == ESP_OK);
+        CHECK(usedEntries == generation_entry_count(generation) + 1);
+    }
+}
+
+TEST_CASE("nvs batch api stages values until commit", "[nvs_batch]")
+{
+    // TC verifies the batch functions of the C API.
+    // It verifies that:
+    // - values can be staged only while a batch is open
+    // - the regular set and erase functions write and erase the entries directly while a batch is open
+    // - staged values are not visible before commit and are visible after commit
+    // - values of an aborted batch are discarded
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_3SEC_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_3SEC_PARTITION_NAME));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_3SEC_PARTITION_NAME, "namespace1", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "cal_a", 1));
+    TEST_ESP_OK(nvs_set_u8(handle, "cal_f", 9));
+
+    TEST_ESP_ERR(nvs_batch_set_u32(handle, "cal_a", 2), ESP_ERR_INVALID_STATE);
+    TEST_ESP_ERR(nvs_batch_commit(handle), ESP_ERR_INVALID_STATE);
+    TEST_ESP_ERR(nvs_batch_abort(handle), ESP_ERR_INVALID_STATE);
+
+    TEST_ESP_OK(nvs_batch_begin(handle));
+    TEST_ESP_ERR(nvs_batch_begin(handle), ESP_ERR_INVALID_STATE);
+    TEST_ESP_OK(nvs_batch_set_u32(handle, "cal_a", 2));
+    TEST_ESP_OK(nvs_batch_set_i16(handle, "cal_b", -3));
+    TEST_ESP_OK(nvs_batch_set_str(handle, "cal_c", "calibrated"));
+    const uint8_t blob[] = {1, 2, 3, 4, 5};
+    TEST_ESP_OK(nvs_batch_set_blob(handle, "cal_d", blob, sizeof(blob)));
+    // the regular set functions don't stage the values
+    TEST_ESP_OK(nvs_set_u8(handle, "cal_e", 7));
+    // neither do the erase functions
+    TEST_ESP_OK(nvs_erase_key(handle, "cal_f"));
+
+    uint32_t a;
+    int16_t b;
+    uint8_t e;
+    uint8_t f;
+    TEST_ESP_OK(nvs_get_u32(handle, "cal_a", &a));
+    CHECK(a == 1);
+    TEST_ESP_ERR(nvs_get_i16(handle, "cal_b", &b), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_OK(nvs_get_u8(handle, "cal_e", &e));
+    CHECK(e == 7);
+    TEST_ESP_ERR(nvs_get_u8(handle, "cal_f", &f), ESP_ERR_NVS_NOT_FOUND);
+
+    TEST_ESP_OK(nvs_batch_commit(handle));
+
+    TEST_ESP_OK(nvs_get_u32(handle, "cal_a", &a));
+    CHECK(a == 2);
+    TEST_ESP_OK(nvs_get_i16(handle, "cal_b", &b));
+    CHECK(b == -3);
+    char str[16];
+    size_t len = sizeof(str);
+    TEST_ESP_OK(nvs_get_str(handle, "cal_c", str, &len));
+    CHECK(strcmp(str, "calibrated") == 0);
+    uint8_t readBlob[sizeof(blob)];
+    len = sizeof(readBlob);
+    TEST_ESP_OK(nvs_get_blob(handle, "cal_d", readBlob, &len));
+    CHECK(memcmp(readBlob, blob, sizeof(blob)) == 0);
+    TEST_ESP_OK(nvs_get_u8(handle, "cal_e", &e));
+    CHECK(e == 7);
+
+    TEST_ESP_OK(nvs_batch_begin(handle));
+    TEST_ESP_OK(nvs_batch_set_u32(handle, "cal_a", 3));
+    TEST_ESP_OK(nvs_set_u8(handle, "cal_e", 8));
+    TEST_ESP_OK(nvs_batch_abort(handle));
+    TEST_ESP_OK(nvs_get_u32(handle, "cal_a", &a));
+    CHECK(a == 2);
+    TEST_ESP_OK(nvs_get_u8(handle, "cal_e", &e));
+    CHECK(e == 8);
+
+    // a staged value is committed even if its key was erased after it was staged
+    TEST_ESP_OK(nvs_batch_begin(handle));
+    TEST_ESP_OK(nvs_batch_set_u32(handle, "cal_a", 4));
+    TEST_ESP_OK(nvs_erase_all(handle));
+    TEST_ESP_ERR(nvs_get_u8(handle, "cal_e", &e), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_OK(nvs_batch_commit(handle));
+    TEST_ESP_OK(nvs_get_u32(handle, "cal_a", &a));
+    CHECK(a == 4);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_3SEC_PARTITION_NAME));
+}
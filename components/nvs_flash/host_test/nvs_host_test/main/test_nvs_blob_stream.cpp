@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs.h"                            // for nvs C API
+#include "nvs_flash.h"                      // for nvs_flash_init_partition
+#include "nvs_storage.hpp"                  // for Storage class
+#include "nvs_partition_manager.hpp"        // for NVSPartitionManager
+#include "test_fixtures.hpp"                // for test fixtures
+#include <vector>
+#include <random>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_3SEC_PARTITION_NAME "nvs_3sec"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+#define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
+#define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
+
+// Collects the pieces passed to the callback and checks that they come in order.
+struct StreamCollector {
+    vector<uint8_t> data;
+    size_t calls = 0;
+    size_t maxPiece = 0;
+    bool ordered = true;
+    size_t failAfter = SIZE_MAX;
+};
+
+static esp_err_t collect_piece(const void* data, size_t offset, size_t length, void* arg)
+{
+    StreamCollector* collector = static_cast<StreamCollector*>(arg);
+    if (collector->calls == collector->failAfter) {
+        return ESP_ERR_NO_MEM;
+    }
+    collector->ordered = collector->ordered && (offset == collector->data.size());
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    collector->data.insert(collector->data.end(), bytes, bytes + length);
+    collector->calls++;
+    collector->maxPiece = max(collector->maxPiece, length);
+    return ESP_OK;
+}
+
+static vector<uint8_t> make_blob(size_t size)
+{
+    mt19937 gen(static_cast<uint32_t>(size));
+    vector<uint8_t> blob(size);
+    for (auto& b : blob) {
+        b = static_cast<uint8_t>(gen());
+    }
+    return blob;
+}
+
+TEST_CASE("multi-page blob can be read as a stream", "[nvs_blob_stream]")
+{
+    // TC verifies that a blob spanning several pages is handed to the callback in order, in pieces limited
+    // to the stream buffer size, and that an error returned by the callback stops the read.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("stream", true, ns) == ESP_OK);
+
+    const vector<uint8_t> blob = make_blob(3 * nvs::Page::CHUNK_MAX_SIZE + 123);
+    REQUIRE(storage.writeItem(ns, nvs::ItemType::BLOB, "bundle", blob.data(), blob.size(), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+
+    StreamCollector collector;
+    REQUIRE(storage.readBlobStream(ns, "bundle", 0, blob.size(), collect_piece, &collector) == ESP_OK);
+    CHECK(collector.ordered);
+    CHECK(collector.data == blob);
+    CHECK(collector.maxPiece <= nvs::Page::STREAM_BUFFER_SIZE);
+    CHECK(collector.calls >= blob.size() / nvs::Page::STREAM_BUFFER_SIZE);
+
+    StreamCollector failing;
+    failing.failAfter = 3;
+    CHECK(storage.readBlobStream(ns, "bundle", 0, blob.size(), collect_piece, &failing) == ESP_ERR_NO_MEM);
+    CHECK(failing.calls == 3);
+
+    // the value is still intact after the aborted read
+    StreamCollector again;
+    REQUIRE(storage.readBlobStream(ns, "bundle", 0, blob.size(), collect_piece, &again) == ESP_OK);
+    CHECK(again.data == blob);
+
+    CHECK(storage.readBlobStream(ns, "missing", 0, 1, collect_piece, &again) == ESP_ERR_NVS_NOT_FOUND);
+}
+
+TEST_CASE("blob range read returns the requested bytes", "[nvs_blob_stream]")
+{
+    // TC verifies that any range of a multi-page blob can be read by offset. It verifies that:
+    // - ranges within a chunk, crossing chunk boundaries and covering the whole blob return the right bytes
+    // - chunks outside of the range are not read from flash
+    // - ranges exceeding the blob are refused
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("stream", true, ns) == ESP_OK);
+
+    const vector<uint8_t> blob = make_blob(4 * nvs::Page::CHUNK_MAX_SIZE);
+    REQUIRE(storage.writeItem(ns, nvs::ItemType::BLOB, "bundle", blob.data(), blob.size(), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+
+    const size_t chunk = nvs::Page::CHUNK_MAX_SIZE;
+    const pair<size_t, size_t> ranges[] = {
+        {0, 1}, {5, 100}, {chunk - 10, 20}, {chunk, chunk}, {chunk / 2, 2 * chunk}, {blob.size() - 1, 1}, {0, blob.size()}, {17, 0}
+    };
+    for (auto range : ranges) {
+        vector<uint8_t> out(range.second + 1, 0xee);
+        REQUIRE(storage.readBlobRange(ns, "bundle", range.first, out.data(), range.second) == ESP_OK);
+        CHECK(equal(out.begin(), out.begin() + range.second, blob.begin() + range.first));
+        CHECK(out[range.second] == 0xee);
+    }
+
+    // a range inside of the last chunk doesn't read the other chunks
+    const size_t chunkEntries = (chunk + nvs::Page::ENTRY_SIZE - 1) / nvs::Page::ENTRY_SIZE;
+    uint8_t byte;
+    NVSPartitionTestHelper::clear_stats();
+    REQUIRE(storage.readBlobRange(ns, "bundle", blob.size() - 1, &byte, 1) == ESP_OK);
+    CHECK(byte == blob.back());
+    CHECK(NVSPartitionTestHelper::get_read_bytes() < 2 * chunkEntries * nvs::Page::ENTRY_SIZE);
+
+    uint8_t out[8];
+    CHECK(storage.readBlobRange(ns, "bundle", blob.size() - 4, out, sizeof(out)) == ESP_ERR_NVS_INVALID_LENGTH);
+    CHECK(storage.readBlobRange(ns, "bundle", blob.size() + 1, out, 0) == ESP_ERR_NVS_INVALID_LENGTH);
+    CHECK(storage.readBlobRange(ns, "bundle", SIZE_MAX, out, 2) == ESP_ERR_NVS_INVALID_LENGTH);
+}
+
+TEST_CASE("nvs_get_blob_stream and nvs_get_blob_range read blobs without a full size buffer", "[nvs_blob_stream]")
+{
+    // TC verifies the streaming and range read functions of the C API.
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "stream", NVS_READWRITE, &handle));
+
+    const vector<uint8_t> blob = make_blob(10000);
+    TEST_ESP_OK(nvs_set_blob(handle, "bundle", blob.data(), blob.size()));
+    TEST_ESP_OK(nvs_set_u8(handle, "small", 1));
+
+    StreamCollector collector;
+    TEST_ESP_OK(nvs_get_blob_stream(handle, "bundle", collect_piece, &collector));
+    CHECK(collector.ordered);
+    CHECK(collector.data == blob);
+
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "bundle", nullptr, nullptr), ESP_ERR_INVALID_ARG);
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "missing", collect_piece, &collector), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "small", collect_piece, &collector), ESP_ERR_NVS_NOT_FOUND);
+
+    uint8_t out[300];
+    TEST_ESP_OK(nvs_get_blob_range(handle, "bundle", 3900, out, sizeof(out)));
+    CHECK(equal(out, out + sizeof(out), blob.begin() + 3900));
+    TEST_ESP_ERR(nvs_get_blob_range(handle, "bundle", 9900, out, sizeof(out)), ESP_ERR_NVS_INVALID_LENGTH);
+    TEST_ESP_ERR(nvs_get_blob_range(handle, "bundle", 0, nullptr, 1), ESP_ERR_INVALID_ARG);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+}
+
+TEST_CASE("nvs_get_blob_range reports a blob with a dropped chunk", "[nvs_blob_stream]")
+{
+    // TC verifies that reading a blob whose chunk is missing through the C API, which shares the storage lock,
+    // returns ESP_ERR_NVS_NOT_FOUND instead of failing an assertion.
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "stream", NVS_READWRITE, &handle));
+    const vector<uint8_t> blob = make_blob(10000);
+    TEST_ESP_OK(nvs_set_blob(handle, "bundle", blob.data(), blob.size()));
+
+    // Drop a chunk of the blob, leaving its index in place
+    nvs::Storage* storage = nvs::NVSPartitionManager::get_instance()->lookup_storage_from_name(TEST_DEFAULT_PARTITION_NAME);
+    REQUIRE(storage != nullptr);
+    uint8_t ns;
+    TEST_ESP_OK(storage->createOrOpenNamespace("stream", false, ns));
+    TEST_ESP_OK(storage->eraseItem(ns, nvs::ItemType::BLOB_DATA, "bundle", TEST_DEFAULT_PURGE_AFTER_ERASE));
+
+    uint8_t out[300];
+    TEST_ESP_ERR(nvs_get_blob_range(handle, "bundle", 9000, out, sizeof(out)), ESP_ERR_NVS_NOT_FOUND);
+
+    StreamCollector collector;
+    TEST_ESP_ERR(nvs_get_blob_stream(handle, "bundle", collect_piece, &collector), ESP_ERR_NVS_NOT_FOUND);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+}
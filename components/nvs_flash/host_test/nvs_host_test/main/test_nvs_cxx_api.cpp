@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -195,3 +195,40 @@ TEST_CASE("NVSHandleSimple CXX api read/write blob", "[nvs cxx]")
 
     nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME);
 }
+
+TEST_CASE("NVSHandleSimple CXX api batch stages only the batch set values", "[nvs cxx]")
+{
+    // TC verifies that the values set with the batch set functions are staged until the batch is committed,
+    // while the regular set functions write the values directly.
+
+    esp_err_t result;
+    shared_ptr<nvs::NVSHandle> handle;
+
+    REQUIRE(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME) == ESP_OK);
+    REQUIRE(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME) == ESP_OK);
+
+    handle = nvs::open_nvs_handle_from_partition(TEST_DEFAULT_PARTITION_NAME, "test_ns", NVS_READWRITE, &result);
+    CHECK(result == ESP_OK);
+    REQUIRE(handle);
+
+    CHECK(handle->batch_set_item("staged", static_cast<uint32_t>(1)) == ESP_ERR_INVALID_STATE);
+    REQUIRE(handle->begin_batch() == ESP_OK);
+    CHECK(handle->batch_set_item("staged", static_cast<uint32_t>(1)) == ESP_OK);
+    CHECK(handle->batch_set_string("staged_str", "staged") == ESP_OK);
+    CHECK(handle->set_item("direct", static_cast<uint32_t>(2)) == ESP_OK);
+
+    uint32_t value;
+    CHECK(handle->get_item("staged", value) == ESP_ERR_NVS_NOT_FOUND);
+    REQUIRE(handle->get_item("direct", value) == ESP_OK);
+    CHECK(value == 2);
+
+    REQUIRE(handle->commit_batch() == ESP_OK);
+    REQUIRE(handle->get_item("staged", value) == ESP_OK);
+    CHECK(value == 1);
+    char read_buffer[16];
+    REQUIRE(handle->get_string("staged_str", read_buffer, sizeof(read_buffer)) == ESP_OK);
+    CHECK(string(read_buffer) == "staged");
+
+    handle.reset();
+    nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME);
+}
@@ -0,0 +1,235 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs.h"                            // for nvs C API
+#include "nvs_flash.h"                      // for nvs_flash_init_partition
+#include "nvs_storage.hpp"                  // for Storage class
+#include "test_fixtures.hpp"                // for test fixtures
+#include <string>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_3SEC_PARTITION_NAME "nvs_3sec"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+#define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
+#define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
+
+static const uint32_t GC_TEST_SECTORS = 4;
+static const size_t GC_TEST_KEYS = 20;
+static const size_t GC_TEST_STATIC_KEYS = 60;
+
+static void write_value(nvs::Storage& storage, uint8_t ns, uint32_t value)
+{
+    string key = "key_" + to_string(value % GC_TEST_KEYS);
+    REQUIRE(storage.writeItem(ns, key.c_str(), value, TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+}
+
+// Writes keys which are never updated between the updated ones, so that the pages keep some valid entries
+// which have to be moved when the pages are reclaimed.
+static uint32_t write_static_keys(nvs::Storage& storage, uint8_t ns)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < GC_TEST_STATIC_KEYS; ++i) {
+        string key = "static_" + to_string(i);
+        REQUIRE(storage.writeItem(ns, key.c_str(), i, TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+        for (size_t j = 0; j < 3; ++j) {
+            write_value(storage, ns, value++);
+        }
+    }
+    return value;
+}
+
+// Updates the keys round robin until a write had to reclaim a page, so that only the reserve page is free.
+static uint32_t write_until_reclaim(nvs::Storage& storage, uint8_t ns, uint32_t value)
+{
+    NVSPartitionTestHelper::clear_stats();
+    while (NVSPartitionTestHelper::get_erase_ops() == 0) {
+        write_value(storage, ns, value++);
+    }
+    return value;
+}
+
+// Checks that every key holds its latest value and that there is no other item left in the namespace.
+static void check_values(nvs::Storage& storage, uint8_t ns, uint32_t nextValue)
+{
+    uint32_t stored;
+    for (uint32_t i = 0; i < GC_TEST_STATIC_KEYS; ++i) {
+        string key = "static_" + to_string(i);
+        REQUIRE(storage.readItem(ns, key.c_str(), stored) == ESP_OK);
+        CHECK(stored == i);
+    }
+    for (uint32_t value = nextValue - GC_TEST_KEYS; value < nextValue; ++value) {
+        string key = "key_" + to_string(value % GC_TEST_KEYS);
+        REQUIRE(storage.readItem(ns, key.c_str(), stored) == ESP_OK);
+        CHECK(stored == value);
+    }
+    size_t usedEntries;
+    REQUIRE(storage.calcEntriesInNamespace(ns, usedEntries) == ESP_OK);
+    CHECK(usedEntries == GC_TEST_KEYS + GC_TEST_STATIC_KEYS);
+}
+
+TEST_CASE("incremental gc prepares an erased page ahead of writes", "[nvs_gc]")
+{
+    // TC verifies that stepping the incremental garbage collection reclaims a page while the storage is idle.
+    // It verifies that:
+    // - each step moves at most the requested number of entries, the page erase is done by a step of its own
+    // - there is nothing left to do once two pages are free
+    // - a whole page of writes following the collection doesn't need to erase any page
+    // - all values survive the collection and a reload
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const size_t STEP_ENTRIES = 4;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, GC_TEST_SECTORS) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("gc", true, ns) == ESP_OK);
+
+    uint32_t value = write_until_reclaim(storage, ns, write_static_keys(storage, ns));
+
+    NVSPartitionTestHelper::clear_stats();
+    bool pending = true;
+    size_t steps = 0;
+    while (pending) {
+        size_t writeOps = NVSPartitionTestHelper::get_write_ops();
+        size_t eraseOps = NVSPartitionTestHelper::get_erase_ops();
+        REQUIRE(storage.gcStep(STEP_ENTRIES, pending) == ESP_OK);
+        if (NVSPartitionTestHelper::get_erase_ops() != eraseOps) {
+            CHECK(NVSPartitionTestHelper::get_write_ops() == writeOps);
+        }
+        ++steps;
+        REQUIRE(steps < nvs::Page::ENTRY_COUNT);
+    }
+    CHECK(NVSPartitionTestHelper::get_erase_ops() == 1);
+    CHECK(steps > 1);
+    check_values(storage, ns, value);
+
+    // two pages are free now, another step doesn't touch the flash
+    NVSPartitionTestHelper::clear_stats();
+    REQUIRE(storage.gcStep(STEP_ENTRIES, pending) == ESP_OK);
+    CHECK_FALSE(pending);
+    CHECK(NVSPartitionTestHelper::get_write_ops() == 0);
+    CHECK(NVSPartitionTestHelper::get_erase_ops() == 0);
+
+    NVSPartitionTestHelper::clear_stats();
+    for (size_t i = 0; i < nvs::Page::ENTRY_COUNT; ++i) {
+        write_value(storage, ns, value++);
+    }
+    CHECK(NVSPartitionTestHelper::get_erase_ops() == 0);
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, GC_TEST_SECTORS) == ESP_OK);
+    check_values(reloaded, ns, value);
+}
+
+TEST_CASE("page being collected incrementally is finished by a write running out of pages", "[nvs_gc]")
+{
+    // TC verifies that a page partially emptied by the incremental garbage collection is reclaimed by a regular write
+    // which needs a new page before the collection finished, and that no value is lost or duplicated.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, GC_TEST_SECTORS) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("gc", true, ns) == ESP_OK);
+
+    uint32_t value = write_until_reclaim(storage, ns, write_static_keys(storage, ns));
+
+    bool pending;
+    REQUIRE(storage.gcStep(1, pending) == ESP_OK);
+    REQUIRE(pending);
+
+    // fill the current page, so that the collection can't continue and the next page has to be reclaimed
+    value = write_until_reclaim(storage, ns, value);
+    check_values(storage, ns, value);
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, GC_TEST_SECTORS) == ESP_OK);
+    check_values(reloaded, ns, value);
+}
+
+TEST_CASE("incremental gc recovers from power loss at any point", "[nvs_gc]")
+{
+    // TC verifies that a power loss at any point of the incremental garbage collection leaves every key
+    // with its latest value and without duplicates after reinit.
+    // The power-off is emulated at gradually increasing points of the collection, until it finishes.
+
+    bool done = false;
+
+    for (size_t errDelay = 0; !done; ++errDelay) {
+        INFO(errDelay);
+        NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+        uint8_t ns;
+        uint32_t value;
+        {
+            nvs::Storage storage(&h);
+            REQUIRE(storage.init(0, GC_TEST_SECTORS) == ESP_OK);
+            REQUIRE(storage.createOrOpenNamespace("gc", true, ns) == ESP_OK);
+            value = write_until_reclaim(storage, ns, write_static_keys(storage, ns));
+
+            NVSPartitionTestHelper::fail_after(errDelay, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+            bool pending = true;
+            esp_err_t err = ESP_OK;
+            while (pending && err == ESP_OK) {
+                err = storage.gcStep(3, pending);
+            }
+            done = (err == ESP_OK);
+            NVSPartitionTestHelper::fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        }
+
+        nvs::Storage reloaded(&h);
+        REQUIRE(reloaded.init(0, GC_TEST_SECTORS) == ESP_OK);
+        check_values(reloaded, ns, value);
+
+        // the partition is still usable after the recovery
+        for (size_t i = 0; i < 2 * nvs::Page::ENTRY_COUNT; ++i) {
+            write_value(reloaded, ns, value++);
+        }
+        check_values(reloaded, ns, value);
+    }
+}
+
+TEST_CASE("nvs_gc_step checks its arguments and reports pending work", "[nvs_gc]")
+{
+    // TC verifies the garbage collection function of the C API.
+
+    TEST_ESP_ERR(nvs_gc_step("no_such_partition", 8, nullptr), ESP_ERR_NVS_NOT_INITIALIZED);
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_3SEC_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_3SEC_PARTITION_NAME));
+
+    bool pending = true;
+    TEST_ESP_ERR(nvs_gc_step(TEST_3SEC_PARTITION_NAME, 0, &pending), ESP_ERR_INVALID_ARG);
+
+    // freshly erased partition has nothing to collect
+    TEST_ESP_OK(nvs_gc_step(TEST_3SEC_PARTITION_NAME, 8, &pending));
+    CHECK_FALSE(pending);
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_3SEC_PARTITION_NAME, "gc", NVS_READWRITE, &handle));
+    for (uint32_t i = 0; i < 2 * nvs::Page::ENTRY_COUNT; ++i) {
+        TEST_ESP_OK(nvs_set_u32(handle, "counter", i));
+    }
+
+    size_t steps = 0;
+    do {
+        TEST_ESP_OK(nvs_gc_step(TEST_3SEC_PARTITION_NAME, 8, &pending));
+        ++steps;
+    } while (pending && steps < nvs::Page::ENTRY_COUNT);
+    CHECK_FALSE(pending);
+    TEST_ESP_OK(nvs_gc_step(TEST_3SEC_PARTITION_NAME, 8, nullptr));
+
+    uint32_t value;
+    TEST_ESP_OK(nvs_get_u32(handle, "counter", &value));
+    CHECK(value == 2 * nvs::Page::ENTRY_COUNT - 1);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_3SEC_PARTITION_NAME));
+}
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs_key_index.hpp"                // for KeyIndex class
+#include "nvs_page.hpp"                     // for Page class
+#include "nvs_storage.hpp"                  // for Storage class
+#include "test_fixtures.hpp"                // for test fixtures
+#include <string>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+TEST_CASE("key index finds all pages holding a hash", "[nvs_key_index]")
+{
+    // TC verifies the basic operations of the KeyIndex.
+    // It verifies that:
+    // - an item inserted for two pages is reported for both pages, each page only once
+    // - erasing one of the nodes leaves the other one reachable
+    // - erasing a node which is not present fails
+
+    nvs::KeyIndex index;
+    nvs::Page pages[2];
+    nvs::Page* found[4];
+
+    const uint32_t hash = nvs::KeyIndex::calculateHash(nvs::Item(1, nvs::ItemType::U32, 1, "key"));
+
+    REQUIRE(index.insert(hash, &pages[0], 3) == ESP_OK);
+    REQUIRE(index.insert(hash, &pages[0], 7) == ESP_OK);
+    REQUIRE(index.insert(hash, &pages[1], 0) == ESP_OK);
+    CHECK(index.size() == 3);
+
+    REQUIRE(index.findPages(hash, found, 4) == 2);
+    CHECK(((found[0] == &pages[0] && found[1] == &pages[1]) || (found[0] == &pages[1] && found[1] == &pages[0])));
+
+    CHECK(index.erase(hash, &pages[1], 0));
+    CHECK_FALSE(index.erase(hash, &pages[1], 0));
+    REQUIRE(index.findPages(hash, found, 4) == 1);
+    CHECK(found[0] == &pages[0]);
+
+    index.clear();
+    CHECK(index.size() == 0);
+    CHECK(index.findPages(hash, found, 4) == 0);
+}
+
+TEST_CASE("key index keeps probe sequences intact when erasing", "[nvs_key_index]")
+{
+    // TC verifies that the KeyIndex grows and that removing nodes from the middle of colliding
+    // probe sequences doesn't make the remaining nodes unreachable.
+
+    nvs::KeyIndex index;
+    nvs::Page page;
+    nvs::Page* found[1];
+    const size_t ITEM_COUNT = 500;
+    uint32_t hashes[ITEM_COUNT];
+
+    for (size_t i = 0; i < ITEM_COUNT; ++i) {
+        // Use few distinct low bits so that many nodes collide into the same probe sequences
+        hashes[i] = static_cast<uint32_t>(((i * 2654435761u) & 0xfff000) | (i % 4));
+        REQUIRE(index.insert(hashes[i], &page, i % nvs::Page::ENTRY_COUNT) == ESP_OK);
+    }
+    CHECK(index.size() == ITEM_COUNT);
+    CHECK(index.capacity() * 3 >= index.size() * 4);
+
+    for (size_t i = 0; i < ITEM_COUNT; i += 2) {
+        REQUIRE(index.erase(hashes[i], &page, i % nvs::Page::ENTRY_COUNT));
+    }
+    for (size_t i = 1; i < ITEM_COUNT; i += 2) {
+        CHECK(index.findPages(hashes[i], found, 1) == 1);
+    }
+    CHECK(index.size() == ITEM_COUNT / 2);
+}
+
+TEST_CASE("key index follows items across page reclaim and reinit", "[nvs_key_index]")
+{
+    // TC verifies that the items stay reachable when the pages holding them are reclaimed,
+    // i.e. that the storage-wide index (if enabled) is kept up to date by the pages.
+    // It rewrites a set of keys until every page of the partition has been reclaimed several times
+    // and then reads all keys back, both from the running storage and after a new init.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    const size_t KEY_COUNT = 150;
+    const size_t ROUNDS = 20;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("index", true, ns) == ESP_OK);
+
+    for (size_t round = 0; round < ROUNDS; ++round) {
+        for (size_t i = 0; i < KEY_COUNT; ++i) {
+            string key = "key_" + to_string(i);
+            REQUIRE(storage.writeItem(ns, key.c_str(), static_cast<uint32_t>(round * KEY_COUNT + i), purgeAfterErase) == ESP_OK);
+        }
+        // Remove some keys in every round so that erased entries are left behind
+        for (size_t i = round % 5; i < KEY_COUNT; i += 5) {
+            string key = "key_" + to_string(i);
+            REQUIRE(storage.eraseItem(ns, key.c_str(), purgeAfterErase) == ESP_OK);
+        }
+    }
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, h.get_sectors()) == ESP_OK);
+
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        string key = "key_" + to_string(i);
+        uint32_t value;
+        bool erased = (i % 5) == ((ROUNDS - 1) % 5);
+        uint32_t expected = static_cast<uint32_t>((ROUNDS - 1) * KEY_COUNT + i);
+        if (erased) {
+            CHECK(storage.readItem(ns, key.c_str(), value) == ESP_ERR_NVS_NOT_FOUND);
+            CHECK(reloaded.readItem(ns, key.c_str(), value) == ESP_ERR_NVS_NOT_FOUND);
+        } else {
+            REQUIRE(storage.readItem(ns, key.c_str(), value) == ESP_OK);
+            CHECK(value == expected);
+            REQUIRE(reloaded.readItem(ns, key.c_str(), value) == ESP_OK);
+            CHECK(value == expected);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs.h"                            // for nvs_get_arena_stats
+#include "nvs_memory_management.hpp"        // for MemoryArena class
+#include "nvs_item_hash_list.hpp"           // for HashList class
+#include "nvs_storage.hpp"                  // for Storage class
+#include "test_fixtures.hpp"                // for test fixtures
+#include "sdkconfig.h"
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+#define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
+#define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
+
+TEST_CASE("nvs_get_arena_stats checks its argument", "[nvs_memory_arena]")
+{
+    TEST_ESP_ERR(nvs_get_arena_stats(nullptr), ESP_ERR_INVALID_ARG);
+
+    nvs_arena_stats_t stats;
+#ifdef NVS_MEMORY_ARENA
+    TEST_ESP_OK(nvs_get_arena_stats(&stats));
+#else
+    TEST_ESP_ERR(nvs_get_arena_stats(&stats), ESP_ERR_NOT_SUPPORTED);
+#endif
+}
+
+#ifdef NVS_MEMORY_ARENA
+
+TEST_CASE("memory arena serves hash list blocks from the reserved slots", "[nvs_memory_arena]")
+{
+    // TC verifies that:
+    // - reserving adds slots for the maximum number of hash list blocks of the pages
+    // - allocations fitting a slot don't fall back to the heap and are counted in the used and peak size
+    // - unreserving returns the unused slots
+
+    const size_t PAGES = 3;
+    nvs_arena_stats_t before;
+    nvs::MemoryArena::getStats(before);
+
+    TEST_ESP_OK(nvs::MemoryArena::reserve(PAGES));
+    nvs_arena_stats_t stats;
+    nvs::MemoryArena::getStats(stats);
+    const size_t blockCount = PAGES * nvs::HashList::maxBlockCount(nvs::Page::ENTRY_COUNT);
+    CHECK(stats.total_size - before.total_size >= blockCount * nvs::HashList::BLOCK_SIZE);
+
+    void* blocks[PAGES * nvs::Page::ENTRY_COUNT];
+    for (size_t i = 0; i < blockCount; ++i) {
+        blocks[i] = nvs::MemoryArena::allocate(nvs::HashList::BLOCK_SIZE);
+        REQUIRE(blocks[i] != nullptr);
+    }
+    nvs::MemoryArena::getStats(stats);
+    CHECK(stats.heap_fallbacks == before.heap_fallbacks);
+    CHECK(stats.used_size - before.used_size == blockCount * nvs::HashList::BLOCK_SIZE);
+    CHECK(stats.peak_used_size >= stats.used_size);
+
+    for (size_t i = 0; i < blockCount; ++i) {
+        nvs::MemoryArena::release(blocks[i]);
+    }
+    nvs::MemoryArena::getStats(stats);
+    CHECK(stats.used_size == before.used_size);
+
+    // larger than any slot, always from the heap
+    void* large = nvs::MemoryArena::allocate(4 * nvs::HashList::BLOCK_SIZE);
+    REQUIRE(large != nullptr);
+    nvs::MemoryArena::release(large);
+
+    nvs::MemoryArena::unreserve(PAGES);
+    nvs::MemoryArena::getStats(stats);
+    CHECK(stats.total_size == before.total_size);
+}
+
+TEST_CASE("memory arena holds the structures of a full partition", "[nvs_memory_arena]")
+{
+    // TC verifies that filling an initialized partition with items doesn't make the hash lists fall back to the heap
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const uint32_t SECTORS = 5;
+    TEST_ESP_OK(nvs::MemoryArena::reserve(SECTORS));
+    nvs_arena_stats_t before;
+    nvs::MemoryArena::getStats(before);
+    {
+        nvs::Storage storage(&h);
+        REQUIRE(storage.init(0, SECTORS) == ESP_OK);
+        uint8_t ns;
+        REQUIRE(storage.createOrOpenNamespace("arena", true, ns) == ESP_OK);
+        char key[16];
+        for (size_t i = 0; i < (SECTORS - 2) * nvs::Page::ENTRY_COUNT; ++i) {
+            snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+            REQUIRE(storage.writeItem(ns, key, static_cast<uint32_t>(i), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+        }
+        nvs_arena_stats_t stats;
+        nvs::MemoryArena::getStats(stats);
+        CHECK(stats.used_size > before.used_size);
+        // no allocation fell back to the heap, the counter covers the whole test run
+        CHECK(stats.heap_fallbacks == before.heap_fallbacks);
+    }
+    nvs_arena_stats_t stats;
+    nvs::MemoryArena::getStats(stats);
+    CHECK(stats.heap_fallbacks == before.heap_fallbacks);
+    CHECK(stats.used_size == before.used_size);
+    CHECK(stats.peak_used_size > before.used_size);
+    nvs::MemoryArena::unreserve(SECTORS);
+}
+
+#endif // NVS_MEMORY_ARENA
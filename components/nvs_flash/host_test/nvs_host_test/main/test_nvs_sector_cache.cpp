@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs_constants.h"                  // for NVS_CONST_PAGE_SIZE
+#include "nvs_sector_cache.hpp"             // for SectorCache class
+#include "nvs_storage.hpp"                  // for Storage class
+#include "test_fixtures.hpp"                // for test fixtures
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+TEST_CASE("sector cache serves repeated reads of a sector and drops it on write", "[nvs_sector_cache]")
+{
+    // TC verifies that the sector cache:
+    // - reads the page header with the entry state table and the entry area with one flash read each
+    // - forwards reads crossing the cached regions and all reads while disabled
+    // - returns the new content after a write or erase of the cached sector
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const size_t SEC = NVS_CONST_PAGE_SIZE;
+    uint8_t pattern[SEC];
+    for (size_t i = 0; i < SEC; ++i) {
+        pattern[i] = static_cast<uint8_t>(i * 7);
+    }
+    REQUIRE(h.write_raw(SEC, pattern, SEC) == ESP_OK);
+
+    nvs::SectorCache cache(&h);
+    REQUIRE(cache.enable() == ESP_OK);
+
+    uint8_t buf[nvs::Page::ENTRY_SIZE];
+    NVSPartitionTestHelper::clear_stats();
+    for (size_t offset = NVS_CONST_PAGE_ENTRY_DATA_OFFSET; offset < SEC; offset += sizeof(buf)) {
+        REQUIRE(cache.read(SEC + offset, buf, sizeof(buf)) == ESP_OK);
+        CHECK(memcmp(buf, pattern + offset, sizeof(buf)) == 0);
+    }
+    REQUIRE(cache.read_raw(SEC, buf, sizeof(buf)) == ESP_OK);
+    CHECK(memcmp(buf, pattern, sizeof(buf)) == 0);
+    REQUIRE(cache.read_raw(SEC + NVS_CONST_PAGE_ENTRY_TABLE_OFFSET, buf, sizeof(buf)) == ESP_OK);
+    CHECK(memcmp(buf, pattern + NVS_CONST_PAGE_ENTRY_TABLE_OFFSET, sizeof(buf)) == 0);
+    CHECK(NVSPartitionTestHelper::get_read_ops() == 2);
+
+    // the header is read unencrypted, read() of the same range is not served from the raw content
+    NVSPartitionTestHelper::clear_stats();
+    REQUIRE(cache.read(SEC, buf, sizeof(buf)) == ESP_OK);
+    CHECK(NVSPartitionTestHelper::get_read_ops() == 1);
+
+    // write into the cached sector
+    const uint8_t zeros[4] = {};
+    REQUIRE(cache.write_raw(SEC + 2 * NVS_CONST_PAGE_ENTRY_DATA_OFFSET, zeros, sizeof(zeros)) == ESP_OK);
+    REQUIRE(cache.read(SEC + 2 * NVS_CONST_PAGE_ENTRY_DATA_OFFSET, buf, sizeof(buf)) == ESP_OK);
+    CHECK(memcmp(buf, zeros, sizeof(zeros)) == 0);
+
+    // erase of the cached sector
+    REQUIRE(cache.erase_range(SEC, SEC) == ESP_OK);
+    REQUIRE(cache.read_raw(SEC, buf, sizeof(buf)) == ESP_OK);
+    CHECK(all_of(buf, buf + sizeof(buf), [](uint8_t b) { return b == 0xff; }));
+
+    cache.disable();
+    NVSPartitionTestHelper::clear_stats();
+    REQUIRE(cache.read_raw(SEC, buf, sizeof(buf)) == ESP_OK);
+    REQUIRE(cache.read_raw(SEC, buf, sizeof(buf)) == ESP_OK);
+    CHECK(NVSPartitionTestHelper::get_read_ops() == 2);
+}
+
+TEST_CASE("storage init reads each page with a few flash reads", "[nvs_sector_cache]")
+{
+    // TC verifies that loading a storage full of items doesn't read the items one by one,
+    // and that the items written after the reload go to flash.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const uint32_t SECTORS = 5;
+    const size_t ITEM_COUNT = (SECTORS - 2) * nvs::Page::ENTRY_COUNT;
+    uint8_t ns;
+    {
+        nvs::Storage storage(&h);
+        REQUIRE(storage.init(0, SECTORS) == ESP_OK);
+        REQUIRE(storage.createOrOpenNamespace("cache", true, ns) == ESP_OK);
+        char key[16];
+        for (size_t i = 0; i < ITEM_COUNT; ++i) {
+            snprintf(key, sizeof(key), "key_%u", static_cast<unsigned>(i));
+            REQUIRE(storage.writeItem(ns, key, static_cast<uint32_t>(i), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+        }
+    }
+
+    nvs::Storage storage(&h);
+    NVSPartitionTestHelper::clear_stats();
+    REQUIRE(storage.init(0, SECTORS) == ESP_OK);
+    CHECK(NVSPartitionTestHelper::get_read_ops() < 8 * SECTORS);
+
+    REQUIRE(storage.writeItem(ns, "key_0", static_cast<uint32_t>(ITEM_COUNT), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, SECTORS) == ESP_OK);
+    uint32_t value;
+    REQUIRE(reloaded.readItem(ns, "key_0", value) == ESP_OK);
+    CHECK(value == ITEM_COUNT);
+    REQUIRE(reloaded.readItem(ns, "key_1", value) == ESP_OK);
+    CHECK(value == 1);
+}
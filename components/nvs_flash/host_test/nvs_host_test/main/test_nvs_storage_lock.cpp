@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs.h"                            // for nvs C API
+#include "nvs_flash.h"                      // for nvs_flash_init_partition
+#include "nvs_platform.hpp"                 // for Lock and StorageLock classes
+#include "nvs_storage.hpp"                  // for Storage and StorageAccess classes
+#include "test_fixtures.hpp"                // for test fixtures
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_3SEC_PARTITION_NAME "nvs_3sec"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+#define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
+#define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
+
+// Enters the storage the way the API functions do: register under the global lock, take the storage lock without it
+static void enter_storage(nvs::StorageAccess& access, nvs::Storage* storage)
+{
+    {
+        nvs::Lock lock;
+        access.attach(storage);
+    }
+    access.acquire();
+}
+
+TEST_CASE("readers of a storage see consistent values while a writer updates them", "[nvs_storage_lock]")
+{
+    // TC verifies that several threads reading a storage under the shared lock, while another thread updates two keys
+    // under the exclusive lock, never observe one key updated without the other.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const size_t READERS = 4;
+    const uint32_t WRITE_COUNT = 500;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("lock", true, ns) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "first", static_cast<uint32_t>(0), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "second", static_cast<uint32_t>(0), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+
+    atomic<bool> done{false};
+    atomic<size_t> mismatches{0};
+    atomic<size_t> failures{0};
+    atomic<size_t> reads{0};
+
+    vector<thread> readers;
+    for (size_t i = 0; i < READERS; ++i) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                nvs::StorageAccess access(nvs::StorageAccess::Mode::READ);
+                enter_storage(access, &storage);
+                uint32_t first, second;
+                if (storage.readItem(ns, "first", first) != ESP_OK || storage.readItem(ns, "second", second) != ESP_OK) {
+                    ++failures;
+                } else if (first != second) {
+                    ++mismatches;
+                }
+                ++reads;
+            }
+        });
+    }
+
+    // let the readers in before the updates start
+    while (reads.load() < READERS) {
+        this_thread::yield();
+    }
+    for (uint32_t i = 1; i <= WRITE_COUNT; ++i) {
+        {
+            nvs::StorageAccess access(nvs::StorageAccess::Mode::WRITE);
+            enter_storage(access, &storage);
+            REQUIRE(storage.writeItem(ns, "first", i, TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+            REQUIRE(storage.writeItem(ns, "second", i, TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+        }
+        this_thread::yield();
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(failures.load() == 0);
+    CHECK(mismatches.load() == 0);
+
+    uint32_t value;
+    TEST_ESP_OK(storage.readItem(ns, "second", value));
+    CHECK(value == WRITE_COUNT);
+}
+
+TEST_CASE("writer holding one storage doesn't block readers of another", "[nvs_storage_lock]")
+{
+    // TC verifies that the storage locks are independent: a reader of a storage completes while another storage is
+    // held exclusively, and a reader of the held storage waits until the writer is done.
+
+    NVSPartitionTestHelper h1(TEST_DEFAULT_PARTITION_NAME);
+    NVSPartitionTestHelper h2(TEST_3SEC_PARTITION_NAME);
+
+    nvs::Storage held(&h1);
+    REQUIRE(held.init(0, h1.get_sectors()) == ESP_OK);
+    nvs::Storage other(&h2);
+    REQUIRE(other.init(0, h2.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(other.createOrOpenNamespace("lock", true, ns) == ESP_OK);
+    REQUIRE(other.writeItem(ns, "value", static_cast<uint32_t>(42), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+
+    auto writer = make_unique<nvs::StorageAccess>(nvs::StorageAccess::Mode::WRITE);
+    enter_storage(*writer, &held);
+
+    auto otherRead = async(launch::async, [&]() {
+        nvs::StorageAccess access(nvs::StorageAccess::Mode::READ);
+        enter_storage(access, &other);
+        uint32_t value = 0;
+        other.readItem(ns, "value", value);
+        return value;
+    });
+    REQUIRE(otherRead.wait_for(chrono::seconds(5)) == future_status::ready);
+    CHECK(otherRead.get() == 42);
+
+    auto heldRead = async(launch::async, [&]() {
+        nvs::StorageAccess access(nvs::StorageAccess::Mode::READ);
+        enter_storage(access, &held);
+    });
+    CHECK(heldRead.wait_for(chrono::milliseconds(50)) == future_status::timeout);
+
+    writer.reset();
+    CHECK(heldRead.wait_for(chrono::seconds(5)) == future_status::ready);
+}
+
+TEST_CASE("read access shares the storage lock while writes are cached", "[nvs_storage_lock]")
+{
+    // TC verifies that a read access shares the lock with other readers, also if the write cache holds values,
+    // as reads are answered from the cache without flushing it.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("lock", true, ns) == ESP_OK);
+
+    REQUIRE(storage.setWriteCache(4, 0) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "cached", static_cast<uint32_t>(1), TEST_DEFAULT_PURGE_AFTER_ERASE) == ESP_OK);
+    {
+        nvs::StorageAccess access(nvs::StorageAccess::Mode::READ);
+        enter_storage(access, &storage);
+        CHECK(storage.getLock().isShared());
+        uint32_t value;
+        TEST_ESP_OK(storage.readItem(ns, "cached", value));
+        CHECK(value == 1);
+        nvs_stats_t stats;
+        TEST_ESP_OK(storage.fillStats(stats));
+    }
+    nvs_cache_stats_t cacheStats;
+    storage.fillCacheStats(cacheStats);
+    CHECK(cacheStats.pending_count == 1);
+
+    // all accesses are done, so deinitialization doesn't wait
+    {
+        nvs::Lock lock;
+        CHECK_FALSE(storage.getLock().hasUsers());
+    }
+}
+
+static esp_err_t close_other_handle(const void* data, size_t offset, size_t length, void* arg)
+{
+    nvs_close(*static_cast<nvs_handle_t*>(arg));
+    return ESP_OK;
+}
+
+TEST_CASE("closing a handle only waits for the calls using that handle", "[nvs_storage_lock]")
+{
+    // TC verifies that nvs_close() doesn't wait for a call in progress on another handle of the same storage. The
+    // callback of a blob read closes the second handle while the read is still a user of the storage.
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_DEFAULT_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_DEFAULT_PARTITION_NAME));
+
+    nvs_handle_t reader;
+    nvs_handle_t other;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "close", NVS_READWRITE, &reader));
+    TEST_ESP_OK(nvs_open_from_partition(TEST_DEFAULT_PARTITION_NAME, "close", NVS_READONLY, &other));
+
+    const uint8_t blob[64] = {1, 2, 3};
+    TEST_ESP_OK(nvs_set_blob(reader, "blob", blob, sizeof(blob)));
+    TEST_ESP_OK(nvs_get_blob_stream(reader, "blob", close_other_handle, &other));
+
+    size_t length;
+    TEST_ESP_ERR(nvs_get_blob(other, "blob", nullptr, &length), ESP_ERR_NVS_INVALID_HANDLE);
+    TEST_ESP_OK(nvs_get_blob(reader, "blob", nullptr, &length));
+
+    nvs_close(reader);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_DEFAULT_PARTITION_NAME));
+}
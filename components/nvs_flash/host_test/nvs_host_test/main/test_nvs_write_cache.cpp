@@ -0,0 +1,317 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <catch2/catch_test_macros.hpp>     // for Catch2 test macros
+#include "nvs.h"                            // for nvs C API
+#include "nvs_flash.h"                      // for nvs_flash_init_partition
+#include "nvs_storage.hpp"                  // for Storage class
+#include "test_fixtures.hpp"                // for test fixtures
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+#define TEST_DEFAULT_PARTITION_NAME "nvs"
+#define TEST_3SEC_PARTITION_NAME "nvs_3sec"
+#define TEST_DEFAULT_PURGE_AFTER_ERASE true        // erase with purge after erase
+
+#define TEST_ESP_ERR(rc, res) CHECK((rc) == (res))
+#define TEST_ESP_OK(rc) CHECK((rc) == ESP_OK)
+
+TEST_CASE("write cache coalesces repeated writes of a key", "[nvs_write_cache]")
+{
+    // TC verifies that repeated writes of a key are held in the cache and written to flash once, when flushed.
+    // It verifies that:
+    // - the cached value is returned by reads without accessing flash
+    // - nothing is written to flash before the flush
+    // - the statistics count the coalesced writes, the read hits and the flushed values
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    const uint32_t WRITE_COUNT = 1000;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("cache", true, ns) == ESP_OK);
+    REQUIRE(storage.setWriteCache(4, 0) == ESP_OK);
+
+    NVSPartitionTestHelper::clear_stats();
+    for (uint32_t i = 0; i < WRITE_COUNT; ++i) {
+        REQUIRE(storage.writeItem(ns, "counter", i, purgeAfterErase) == ESP_OK);
+        uint32_t value;
+        REQUIRE(storage.readItem(ns, "counter", value) == ESP_OK);
+        CHECK(value == i);
+    }
+    CHECK(NVSPartitionTestHelper::get_write_ops() == 0);
+
+    nvs_cache_stats_t stats;
+    storage.fillCacheStats(stats);
+    CHECK(stats.hit_count == WRITE_COUNT);
+    CHECK(stats.coalesced_count == WRITE_COUNT - 1);
+    CHECK(stats.flush_count == 0);
+    CHECK(stats.pending_count == 1);
+
+    REQUIRE(storage.flushWriteCache() == ESP_OK);
+    CHECK(NVSPartitionTestHelper::get_write_ops() > 0);
+    storage.fillCacheStats(stats);
+    CHECK(stats.flush_count == 1);
+    CHECK(stats.flushed_bytes == sizeof(uint32_t));
+    CHECK(stats.pending_count == 0);
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, h.get_sectors()) == ESP_OK);
+    uint32_t value;
+    REQUIRE(reloaded.readItem(ns, "counter", value) == ESP_OK);
+    CHECK(value == WRITE_COUNT - 1);
+}
+
+TEST_CASE("write cache checks the age of the cached values when a value is set", "[nvs_write_cache]")
+{
+    // TC verifies that the age limit of the cache is checked when a value is set, not in the background.
+    // It verifies that a value older than the limit stays in the cache until the next write,
+    // which then flushes all the cached values.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+    const uint32_t FLUSH_ON_WRITE_AGE_MS = 10;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("cache", true, ns) == ESP_OK);
+    REQUIRE(storage.setWriteCache(4, FLUSH_ON_WRITE_AGE_MS) == ESP_OK);
+
+    REQUIRE(storage.writeItem(ns, "counter", static_cast<uint32_t>(1), purgeAfterErase) == ESP_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2 * FLUSH_ON_WRITE_AGE_MS));
+
+    nvs_cache_stats_t stats;
+    storage.fillCacheStats(stats);
+    CHECK(stats.flush_count == 0);
+    CHECK(stats.pending_count == 1);
+
+    REQUIRE(storage.writeItem(ns, "other", static_cast<uint32_t>(2), purgeAfterErase) == ESP_OK);
+    storage.fillCacheStats(stats);
+    CHECK(stats.flush_count == 2);
+    CHECK(stats.pending_count == 0);
+}
+
+TEST_CASE("write cache flushes the least recently written value when full", "[nvs_write_cache]")
+{
+    // TC verifies that a full cache makes room for a new key by writing the least recently written value to flash,
+    // and that only the values flushed so far are found on flash by a new Storage instance.
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("cache", true, ns) == ESP_OK);
+    REQUIRE(storage.setWriteCache(2, 0) == ESP_OK);
+
+    REQUIRE(storage.writeItem(ns, "a", static_cast<uint16_t>(1), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "b", static_cast<uint16_t>(2), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "a", static_cast<uint16_t>(3), purgeAfterErase) == ESP_OK);
+    // "b" is the least recently written one
+    REQUIRE(storage.writeItem(ns, "c", static_cast<uint16_t>(4), purgeAfterErase) == ESP_OK);
+
+    nvs_cache_stats_t stats;
+    storage.fillCacheStats(stats);
+    CHECK(stats.flush_count == 1);
+    CHECK(stats.pending_count == 2);
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, h.get_sectors()) == ESP_OK);
+    uint16_t value;
+    CHECK(reloaded.readItem(ns, "a", value) == ESP_ERR_NVS_NOT_FOUND);
+    REQUIRE(reloaded.readItem(ns, "b", value) == ESP_OK);
+    CHECK(value == 2);
+    CHECK(reloaded.readItem(ns, "c", value) == ESP_ERR_NVS_NOT_FOUND);
+}
+
+TEST_CASE("write cache keeps the order of cached and direct operations", "[nvs_write_cache]")
+{
+    // TC verifies that operations bypassing the cache see the values held in the cache.
+    // It verifies that:
+    // - a string written for a key held in the cache is written after the cached value
+    // - erasing a key held in the cache erases both the cached value and the older value on flash
+    // - erasing a namespace drops its cached values
+    // - disabling the cache writes the values held in it
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns1, ns2;
+    REQUIRE(storage.createOrOpenNamespace("cache1", true, ns1) == ESP_OK);
+    REQUIRE(storage.createOrOpenNamespace("cache2", true, ns2) == ESP_OK);
+    REQUIRE(storage.setWriteCache(8, 0) == ESP_OK);
+
+    REQUIRE(storage.writeItem(ns1, "key", static_cast<uint32_t>(1), purgeAfterErase) == ESP_OK);
+    nvs::ItemType datatype;
+    REQUIRE(storage.findKey(ns1, "key", &datatype) == ESP_OK);
+    CHECK(datatype == nvs::ItemType::U32);
+    REQUIRE(storage.writeItem(ns1, nvs::ItemType::SZ, "key", "text", 5, purgeAfterErase) == ESP_OK);
+    char str[8];
+    uint32_t value;
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+    // the cached value is written before the string and remains the active value of the key
+    REQUIRE(storage.readItem(ns1, "key", value) == ESP_OK);
+    CHECK(value == 1);
+#else
+    REQUIRE(storage.readItem(ns1, nvs::ItemType::SZ, "key", str, sizeof(str)) == ESP_OK);
+    CHECK(string(str) == "text");
+    REQUIRE(storage.findKey(ns1, "key", &datatype) == ESP_OK);
+    CHECK(datatype == nvs::ItemType::SZ);
+#endif
+
+    REQUIRE(storage.writeItem(ns1, "counter", static_cast<uint32_t>(1), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.flushWriteCache() == ESP_OK);
+    REQUIRE(storage.writeItem(ns1, "counter", static_cast<uint32_t>(2), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.eraseItem(ns1, "counter", purgeAfterErase) == ESP_OK);
+    CHECK(storage.readItem(ns1, "counter", value) == ESP_ERR_NVS_NOT_FOUND);
+    // a key which is only held in the cache can be erased as well
+    REQUIRE(storage.writeItem(ns1, "fresh", static_cast<uint32_t>(3), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.eraseItem(ns1, "fresh", purgeAfterErase) == ESP_OK);
+    CHECK(storage.eraseItem(ns1, "fresh", purgeAfterErase) == ESP_ERR_NVS_NOT_FOUND);
+
+    REQUIRE(storage.writeItem(ns2, "dropped", static_cast<uint32_t>(4), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.writeItem(ns1, "kept", static_cast<uint32_t>(5), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.eraseNamespace(ns2, purgeAfterErase) == ESP_OK);
+    CHECK(storage.readItem(ns2, "dropped", value) == ESP_ERR_NVS_NOT_FOUND);
+
+    REQUIRE(storage.setWriteCache(0, 0) == ESP_OK);
+    nvs_cache_stats_t stats;
+    storage.fillCacheStats(stats);
+    CHECK(stats.pending_count == 0);
+
+    nvs::Storage reloaded(&h);
+    REQUIRE(reloaded.init(0, h.get_sectors()) == ESP_OK);
+    CHECK(reloaded.readItem(ns1, "counter", value) == ESP_ERR_NVS_NOT_FOUND);
+    CHECK(reloaded.readItem(ns1, "fresh", value) == ESP_ERR_NVS_NOT_FOUND);
+    CHECK(reloaded.readItem(ns2, "dropped", value) == ESP_ERR_NVS_NOT_FOUND);
+    REQUIRE(reloaded.readItem(ns1, "kept", value) == ESP_OK);
+    CHECK(value == 5);
+#ifndef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+    REQUIRE(reloaded.readItem(ns1, nvs::ItemType::SZ, "key", str, sizeof(str)) == ESP_OK);
+    CHECK(string(str) == "text");
+#endif
+}
+
+TEST_CASE("write cache answers reads, statistics and iteration without flushing", "[nvs_write_cache]")
+{
+    // TC verifies that the functions reading the storage count the values held in the cache as if they were flushed,
+    // and leave them in the cache.
+    // It verifies that:
+    // - a cached value hides the older value of the key on flash, and reads of another datatype don't find it
+    // - the statistics are the same before and after the flush
+    // - iteration returns every key once, with the datatype of the cached value
+
+    NVSPartitionTestHelper h(TEST_DEFAULT_PARTITION_NAME);
+    const bool purgeAfterErase = TEST_DEFAULT_PURGE_AFTER_ERASE;
+
+    nvs::Storage storage(&h);
+    REQUIRE(storage.init(0, h.get_sectors()) == ESP_OK);
+    uint8_t ns;
+    REQUIRE(storage.createOrOpenNamespace("cache", true, ns) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "flashed", static_cast<uint32_t>(1), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.setWriteCache(4, 0) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "flashed", static_cast<uint32_t>(2), purgeAfterErase) == ESP_OK);
+    REQUIRE(storage.writeItem(ns, "fresh", static_cast<uint16_t>(3), purgeAfterErase) == ESP_OK);
+
+    uint32_t value;
+    REQUIRE(storage.readItem(ns, "flashed", value) == ESP_OK);
+    CHECK(value == 2);
+    uint8_t narrow;
+    CHECK(storage.readItem(ns, "fresh", narrow) == ESP_ERR_NVS_NOT_FOUND);
+    CHECK(storage.readItem(ns, nvs::ItemType::U16, "fresh", &narrow, sizeof(narrow)) == ESP_ERR_NVS_TYPE_MISMATCH);
+    size_t dataSize;
+    REQUIRE(storage.getItemDataSize(ns, nvs::ItemType::U16, "fresh", dataSize) == ESP_OK);
+    CHECK(dataSize == sizeof(uint16_t));
+
+    nvs_stats_t cachedStats;
+    REQUIRE(storage.fillStats(cachedStats) == ESP_OK);
+    size_t usedEntries;
+    REQUIRE(storage.calcEntriesInNamespace(ns, usedEntries) == ESP_OK);
+    CHECK(usedEntries == 2);
+
+    nvs_opaque_iterator_t it = {};
+    it.storage = &storage;
+    it.type = NVS_TYPE_ANY;
+    size_t found = 0;
+    for (bool entryFound = storage.findEntryNs(&it, ns); entryFound; entryFound = storage.nextEntry(&it)) {
+        string key(it.entry_info.key);
+        if (key == "flashed") {
+            CHECK(it.entry_info.type == NVS_TYPE_U32);
+        } else {
+            CHECK(key == "fresh");
+            CHECK(it.entry_info.type == NVS_TYPE_U16);
+        }
+        ++found;
+    }
+    CHECK(found == 2);
+
+    nvs_cache_stats_t stats;
+    storage.fillCacheStats(stats);
+    CHECK(stats.flush_count == 0);
+    CHECK(stats.pending_count == 2);
+
+    REQUIRE(storage.flushWriteCache() == ESP_OK);
+    nvs_stats_t flushedStats;
+    REQUIRE(storage.fillStats(flushedStats) == ESP_OK);
+    CHECK(flushedStats.used_entries == cachedStats.used_entries);
+    CHECK(flushedStats.free_entries == cachedStats.free_entries);
+    CHECK(flushedStats.available_entries == cachedStats.available_entries);
+    REQUIRE(storage.calcEntriesInNamespace(ns, usedEntries) == ESP_OK);
+    CHECK(usedEntries == 2);
+}
+
+TEST_CASE("nvs api write cache is flushed by commit", "[nvs_write_cache]")
+{
+    // TC verifies the write cache functions of the C API.
+    // It verifies that the values set while the cache is enabled are written by nvs_commit
+    // and by deinitialization of the partition, and that the statistics are reported.
+
+    TEST_ESP_OK(nvs_flash_erase_partition(TEST_3SEC_PARTITION_NAME));
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_3SEC_PARTITION_NAME));
+
+    nvs_write_cache_config_t config = {};
+    config.max_entries = 4;
+    TEST_ESP_ERR(nvs_set_write_cache(TEST_3SEC_PARTITION_NAME, nullptr), ESP_ERR_INVALID_ARG);
+    TEST_ESP_OK(nvs_set_write_cache(TEST_3SEC_PARTITION_NAME, &config));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open_from_partition(TEST_3SEC_PARTITION_NAME, "namespace1", NVS_READWRITE, &handle));
+    for (uint32_t i = 0; i < 100; ++i) {
+        TEST_ESP_OK(nvs_set_u32(handle, "counter", i));
+    }
+
+    nvs_cache_stats_t stats;
+    TEST_ESP_ERR(nvs_get_cache_stats(TEST_3SEC_PARTITION_NAME, nullptr), ESP_ERR_INVALID_ARG);
+    TEST_ESP_OK(nvs_get_cache_stats(TEST_3SEC_PARTITION_NAME, &stats));
+    CHECK(stats.coalesced_count == 99);
+    CHECK(stats.pending_count == 1);
+
+    TEST_ESP_OK(nvs_commit(handle));
+    TEST_ESP_OK(nvs_get_cache_stats(TEST_3SEC_PARTITION_NAME, &stats));
+    CHECK(stats.flush_count == 1);
+    CHECK(stats.pending_count == 0);
+
+    TEST_ESP_OK(nvs_set_u32(handle, "counter", 1000));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_3SEC_PARTITION_NAME));
+
+    TEST_ESP_OK(nvs_flash_init_partition(TEST_3SEC_PARTITION_NAME));
+    TEST_ESP_OK(nvs_open_from_partition(TEST_3SEC_PARTITION_NAME, "namespace1", NVS_READONLY, &handle));
+    uint32_t value;
+    TEST_ESP_OK(nvs_get_u32(handle, "counter", &value));
+    CHECK(value == 1000);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(TEST_3SEC_PARTITION_NAME));
+}
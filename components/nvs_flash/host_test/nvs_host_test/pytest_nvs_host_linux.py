@@ -1,4 +1,4 @@
-# SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-FileCopyrightText: 2023-2026 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Unlicense OR CC0-1.0
 import pytest
 from pytest_embedded import Dut
@@ -12,6 +12,8 @@ from pytest_embedded_idf.utils import idf_parametrize
         'default_set_key',
         'legacy_set_key',
         'esp_blockdev',
+        'key_index',
+        'memory_arena',
     ],
     indirect=True,
 )
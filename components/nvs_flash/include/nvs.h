@@ -543,6 +543,73 @@ esp_err_t nvs_get_str (nvs_handle_t handle, const char* key, char* out_value, si
 esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length);
 /**@}*/
 
+/**
+ * @brief      Callback receiving the data of a blob read by \c nvs_get_blob_stream
+ *
+ * @param[in]  data    Piece of the blob data. Only valid until the callback returns.
+ * @param[in]  offset  Offset of the piece within the blob.
+ * @param[in]  length  Length of the piece, at most a few hundred bytes.
+ * @param[in]  arg     Argument passed to \c nvs_get_blob_stream.
+ *
+ * @return     ESP_OK to continue reading, any other value stops the read and is returned by \c nvs_get_blob_stream.
+ */
+typedef esp_err_t (*nvs_blob_read_cb_t)(const void *data, size_t offset, size_t length, void *arg);
+
+/**
+ * @brief      Read blob value for given key piece by piece
+ *
+ * Unlike \c nvs_get_blob, this function doesn't need a buffer as large as the blob. The data is read from flash
+ * into a small buffer on the stack and handed to the callback in order of increasing offset, so that large blobs,
+ * e.g. certificate bundles, can be parsed or copied elsewhere while they are read.
+ *
+ * The CRC of each chunk of the blob is checked after the callback has received its data. If it doesn't match,
+ * the function returns an error, and the data received so far has to be discarded.
+ *
+ * The callback is called with NVS locked, it must not call other NVS functions.
+ *
+ * @param[in]  handle    Handle obtained from nvs_open function.
+ * @param[in]  key       Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[in]  callback  Function receiving the data.
+ * @param[in]  arg       Argument passed to callback.
+ *
+ * @return
+ *             - ESP_OK if the whole value was read successfully
+ *             - ESP_FAIL if there is an internal error; most likely due to corrupted
+ *               NVS partition (only if NVS assertion checks are disabled)
+ *             - ESP_ERR_NVS_NOT_FOUND if the requested key doesn't exist, or the data is corrupted
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_INVALID_NAME if key name doesn't satisfy constraints
+ *             - ESP_ERR_INVALID_ARG if callback is NULL
+ *             - the error returned by callback
+ */
+esp_err_t nvs_get_blob_stream(nvs_handle_t handle, const char* key, nvs_blob_read_cb_t callback, void* arg);
+
+/**
+ * @brief      Read a part of blob value for given key
+ *
+ * Reads length bytes of the blob starting at offset. Only the chunks of the blob overlapping with the range
+ * are read from flash. Use \c nvs_get_blob with out_value set to NULL to get the size of the blob.
+ *
+ * In case of any error, the content of out_value is undefined.
+ *
+ * @param[in]  handle     Handle obtained from nvs_open function.
+ * @param[in]  key        Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[in]  offset     Offset of the first byte to read.
+ * @param[out] out_value  Buffer of at least length bytes.
+ * @param[in]  length     Number of bytes to read.
+ *
+ * @return
+ *             - ESP_OK if the range was read successfully
+ *             - ESP_FAIL if there is an internal error; most likely due to corrupted
+ *               NVS partition (only if NVS assertion checks are disabled)
+ *             - ESP_ERR_NVS_NOT_FOUND if the requested key doesn't exist, or the data is corrupted
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_INVALID_NAME if key name doesn't satisfy constraints
+ *             - ESP_ERR_NVS_INVALID_LENGTH if the range exceeds the size of the blob
+ *             - ESP_ERR_INVALID_ARG if out_value is NULL and length is not 0
+ */
+esp_err_t nvs_get_blob_range(nvs_handle_t handle, const char* key, size_t offset, void* out_value, size_t length);
+
 /**
  * @brief      Lookup key-value pair with given key name.
  *
@@ -625,6 +692,8 @@ esp_err_t nvs_purge_all(nvs_handle_t handle);
  * After setting any values, nvs_commit() must be called to ensure changes are written
  * to non-volatile storage. Individual implementations may write to storage at other times,
  * but this is not guaranteed.
+ * If the write-back cache is enabled for the partition (see \c nvs_set_write_cache), all values
+ * held in the cache are written, including those set through other handles.
  *
  * @param[in]  handle  Storage handle obtained with nvs_open.
  *                     Handles that were opened read only cannot be used.
@@ -636,6 +705,163 @@ esp_err_t nvs_purge_all(nvs_handle_t handle);
  */
 esp_err_t nvs_commit(nvs_handle_t handle);
 
+/**
+ * @brief      Start a batch of writes
+ *
+ * Values set with the nvs_batch_set_* functions until \c nvs_batch_commit is called are only
+ * staged in RAM. \c nvs_batch_commit then writes all of them at once: they are marked as written
+ * with a single update of the entry state table, and if power goes off during the commit, either
+ * all or none of the new values are present after re-initialization of nvs.
+ *
+ * The staged values are not visible to the nvs_get_* functions before the batch is committed.
+ * Staging a key which is already part of the batch replaces the staged value.
+ * While a batch is open, the nvs_set_* functions still write the values directly, and \c nvs_erase_key
+ * and \c nvs_erase_all still erase the entries directly. They don't affect the staged values, which are
+ * written by \c nvs_batch_commit even if their keys were erased in the meantime.
+ *
+ * All items of a batch, including the entries holding the data of strings and blobs, are written to
+ * a single page, so the batch may occupy at most 125 entries. See \c nvs_get_stats .
+ *
+ * @param[in]  handle  Handle obtained from nvs_open function.
+ *                     Handles that were opened read only cannot be used.
+ *
+ * @return
+ *             - ESP_OK if the batch was started successfully
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_READ_ONLY if storage handle was opened as read only
+ *             - ESP_ERR_INVALID_STATE if a batch has already been started for this handle
+ */
+esp_err_t nvs_batch_begin(nvs_handle_t handle);
+
+/**@{*/
+/**
+ * @brief      stage int8_t value for given key in the batch
+ *
+ * The value is written to storage by \c nvs_batch_commit, see \c nvs_batch_begin .
+ *
+ * @param[in]  handle  Handle obtained from nvs_open function, with a batch started by \c nvs_batch_begin .
+ * @param[in]  key     Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[in]  value   The value to set.
+ *
+ * @return
+ *             - ESP_OK if value was staged successfully
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_INVALID_STATE if no batch has been started for this handle
+ *             - ESP_ERR_NVS_KEY_TOO_LONG if key name is too long
+ *             - ESP_ERR_NO_MEM if memory could not be allocated to stage the value
+ */
+esp_err_t nvs_batch_set_i8 (nvs_handle_t handle, const char* key, int8_t value);
+
+/**
+ * @brief      stage uint8_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_u8 (nvs_handle_t handle, const char* key, uint8_t value);
+
+/**
+ * @brief      stage int16_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_i16 (nvs_handle_t handle, const char* key, int16_t value);
+
+/**
+ * @brief      stage uint16_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_u16 (nvs_handle_t handle, const char* key, uint16_t value);
+
+/**
+ * @brief      stage int32_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_i32 (nvs_handle_t handle, const char* key, int32_t value);
+
+/**
+ * @brief      stage uint32_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_u32 (nvs_handle_t handle, const char* key, uint32_t value);
+
+/**
+ * @brief      stage int64_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_i64 (nvs_handle_t handle, const char* key, int64_t value);
+
+/**
+ * @brief      stage uint64_t value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ */
+esp_err_t nvs_batch_set_u64 (nvs_handle_t handle, const char* key, uint64_t value);
+
+/**
+ * @brief      stage string for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ * The string, including the zero terminator, is limited to 4000 bytes.
+ *
+ * @return
+ *             - ESP_ERR_NVS_VALUE_TOO_LONG if the string value is too long
+ *             - For other return values, see \c nvs_batch_set_i8
+ */
+esp_err_t nvs_batch_set_str (nvs_handle_t handle, const char* key, const char* value);
+/**@}*/
+
+/**
+ * @brief       stage variable length binary value for given key in the batch
+ *
+ * This function is the same as \c nvs_batch_set_i8 except for the data type.
+ * As the batch is written to a single page, the blob is limited to 4000 bytes.
+ *
+ * @return
+ *             - ESP_ERR_NVS_VALUE_TOO_LONG if the value is too long
+ *             - For other return values, see \c nvs_batch_set_i8
+ */
+esp_err_t nvs_batch_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length);
+
+/**
+ * @brief      Write all values staged in the batch to non-volatile storage
+ *
+ * The batch is closed whether the values were written or not.
+ * Values which are equal to the stored ones are not written again.
+ *
+ * @param[in]  handle  Handle obtained from nvs_open function, with a batch started by \c nvs_batch_begin .
+ *
+ * @return
+ *             - ESP_OK if all values were written successfully
+ *             - ESP_FAIL if there is an internal error; most likely due to corrupted
+ *               NVS partition (only if NVS assertion checks are disabled)
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_INVALID_STATE if no batch has been started for this handle
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if there is not enough space in the
+ *               underlying storage to save the values, or if they don't fit into a single page
+ *             - ESP_ERR_NVS_REMOVE_FAILED if the values weren't updated because flash
+ *               write operation has failed. The values were written however, and
+ *               update will be finished after re-initialization of nvs, provided that
+ *               flash operation doesn't fail again.
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_batch_commit(nvs_handle_t handle);
+
+/**
+ * @brief      Discard all values staged in the batch and close the batch
+ *
+ * @param[in]  handle  Handle obtained from nvs_open function, with a batch started by \c nvs_batch_begin .
+ *
+ * @return
+ *             - ESP_OK if the batch was discarded
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_INVALID_STATE if no batch has been started for this handle
+ */
+esp_err_t nvs_batch_abort(nvs_handle_t handle);
+
 /**
  * @brief      Close the storage handle and free any allocated resources
  *
@@ -695,6 +921,33 @@ typedef struct {
  */
 esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
 
+/**
+ * @note Usage of the NVS memory arena, see CONFIG_NVS_MEMORY_ARENA.
+ */
+typedef struct {
+    size_t total_size;        /**< Bytes of all slots of the arena. */
+    size_t used_size;         /**< Bytes of the slots currently in use. */
+    size_t peak_used_size;    /**< Highest value of used_size since the arena was created. */
+    size_t heap_fallbacks;    /**< Number of allocations fitting a slot which were served by the heap as no slot was free. */
+} nvs_arena_stats_t;
+
+/**
+ * @brief      Fill structure nvs_arena_stats_t. It provides info about RAM used by NVS from its memory arena.
+ *
+ * With CONFIG_NVS_MEMORY_ARENA enabled, the objects NVS allocates while running, like the hash list blocks
+ * of the pages, are taken from an arena of fixed size slots. The slots are reserved when a partition is
+ * initialized, according to its number of pages. The peak usage and the number of allocations which fell back
+ * to the heap tell whether the arena is large enough for the application.
+ *
+ * @param[out]  arena_stats Returns filled structure nvs_arena_stats_t.
+ *
+ * @return
+ *             - ESP_OK if the structure has been filled.
+ *             - ESP_ERR_INVALID_ARG if arena_stats is equal to NULL.
+ *             - ESP_ERR_NOT_SUPPORTED if CONFIG_NVS_MEMORY_ARENA is disabled.
+ */
+esp_err_t nvs_get_arena_stats(nvs_arena_stats_t *arena_stats);
+
 /**
  * @brief      Calculate all entries in a namespace.
  *
@@ -735,6 +988,119 @@ esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
  */
 esp_err_t nvs_get_used_entry_count(nvs_handle_t handle, size_t* used_entries);
 
+/**
+ * @note Configuration of the write-back cache of a NVS partition.
+ */
+typedef struct {
+    size_t max_entries;             /**< Maximum number of values held in the cache. 0 disables the cache. */
+    uint32_t flush_on_write_age_ms; /**< Age after which the cached values are written to flash. It is checked when
+                                         a value is set, not by a timer. 0 means no age limit. */
+} nvs_write_cache_config_t;
+
+/**
+ * @note Statistics of the write-back cache of a NVS partition.
+ */
+typedef struct {
+    size_t hit_count;         /**< Number of reads served from the cache. */
+    size_t coalesced_count;   /**< Number of writes which replaced a value not written to flash yet. */
+    size_t flush_count;       /**< Number of values written from the cache to flash. */
+    size_t flushed_bytes;     /**< Number of data bytes written from the cache to flash. */
+    size_t pending_count;     /**< Number of values held in the cache, not written to flash yet. */
+} nvs_cache_stats_t;
+
+/**
+ * @brief      Configure the write-back cache of a partition
+ *
+ * The write-back cache keeps the values of integer and floating point keys set with the nvs_set_* functions in RAM and
+ * writes them to flash later, so that a key which is updated repeatedly costs a single flash write
+ * instead of one per update. It is useful for counters and similar frequently updated values.
+ * Strings and blobs are always written directly.
+ *
+ * Values held in the cache are written to flash:
+ * - by \c nvs_commit, called on any handle of the partition
+ * - when the cache is full, the least recently written value is written to make room for a new one
+ * - when a value is set and the oldest value in the cache is older than flush_on_write_age_ms
+ * - when the partition is deinitialized or the cache is reconfigured
+ *
+ * Values held in the cache are lost if power goes off before they are written, and errors
+ * of the deferred flash writes are reported by the function triggering the write, e.g. by \c nvs_commit .
+ * Reading functions, including the ones enumerating the entries of the partition like \c nvs_entry_find and
+ * \c nvs_get_stats, return the cached values without writing them. Iterators return them after the values on flash.
+ *
+ * The age of the cached values is only checked when a value is set, there is no timer writing them in the background.
+ * A value which is not followed by other writes stays in RAM until one of the other conditions occurs, so call
+ * \c nvs_commit when it must reach flash.
+ *
+ * The cache is disabled by default.
+ *
+ * @param[in]   part_name   Partition name NVS in the partition table.
+ *                          If pass a NULL than will use NVS_DEFAULT_PART_NAME ("nvs").
+ * @param[in]   config      Configuration of the cache, max_entries set to 0 disables the cache.
+ *
+ * @return
+ *             - ESP_OK if the cache was configured successfully
+ *             - ESP_ERR_NVS_NOT_INITIALIZED if the storage driver is not initialized
+ *             - ESP_ERR_INVALID_ARG if config is equal to NULL
+ *             - other error codes from the underlying storage driver, if the values held in the cache
+ *               couldn't be written. The cache keeps its previous configuration in this case.
+ */
+esp_err_t nvs_set_write_cache(const char *part_name, const nvs_write_cache_config_t *config);
+
+/**
+ * @brief      Fill structure nvs_cache_stats_t with the statistics of the write-back cache of a partition
+ *
+ * The statistics are accumulated since the partition was initialized.
+ *
+ * @param[in]   part_name   Partition name NVS in the partition table.
+ *                          If pass a NULL than will use NVS_DEFAULT_PART_NAME ("nvs").
+ * @param[out]  cache_stats Returns filled structure nvs_cache_stats_t.
+ *
+ * @return
+ *             - ESP_OK if the statistics were filled successfully
+ *             - ESP_ERR_NVS_NOT_INITIALIZED if the storage driver is not initialized
+ *             - ESP_ERR_INVALID_ARG if cache_stats is equal to NULL
+ */
+esp_err_t nvs_get_cache_stats(const char *part_name, nvs_cache_stats_t *cache_stats);
+
+/**
+ * @brief      Do one step of the incremental garbage collection of a partition
+ *
+ * When a page runs full and only the reserve page is left free, the next write has to reclaim the space of erased
+ * entries first: it moves the valid entries of a page to the reserve page and erases the page. The write then takes
+ * considerably longer than usual, mostly due to the erase of the flash sector.
+ *
+ * This function does the same work ahead of time, in steps of bounded duration, so that an erased page
+ * is ready when the next one is needed. Each step either moves up to max_entries entries from the page being reclaimed
+ * to the current page, or erases the emptied page, which takes one sector erase.
+ * It can be called from a low priority task while the application is idle, for example:
+ *
+ * \code{c}
+ *  bool pending = true;
+ *  while (pending && nvs_gc_step(NULL, 16, &pending) == ESP_OK) {
+ *      vTaskDelay(1);
+ *  }
+ * \endcode
+ *
+ * Collection is only done while fewer than two pages are free and there is a page with erased entries, whose
+ * valid entries fit into the current page. Otherwise the function returns without writing anything.
+ * The pages keep their on-flash format, if power goes off during a step, the partition is recovered
+ * the same way as after an interrupted write.
+ *
+ * @param[in]   part_name   Partition name NVS in the partition table.
+ *                          If pass a NULL than will use NVS_DEFAULT_PART_NAME ("nvs").
+ * @param[in]   max_entries Maximum number of entries moved in this step, must be greater than 0.
+ *                          At least one item is moved, even if it spans more entries.
+ * @param[out]  pending     Optional, set to true if calling the function again would do more work.
+ *
+ * @return
+ *             - ESP_OK if the step was done, or there is nothing to do
+ *             - ESP_ERR_NVS_NOT_INITIALIZED if the storage driver is not initialized
+ *             - ESP_ERR_NVS_READ_ONLY if the partition is read only
+ *             - ESP_ERR_INVALID_ARG if max_entries is 0
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_gc_step(const char *part_name, size_t max_entries, bool *pending);
+
 /**
  * @brief       Create an iterator to enumerate NVS entries based on one or more parameters
  *
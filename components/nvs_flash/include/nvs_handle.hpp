@@ -171,6 +171,20 @@ public:
     virtual esp_err_t get_string(const char *key, char* out_str, size_t len) = 0;
     virtual esp_err_t get_blob(const char *key, void* out_blob, size_t len) = 0;
 
+    /**
+     * @brief Reads a blob piece by piece, without a buffer for the whole blob.
+     *
+     * @note compare to \ref nvs_get_blob_stream in nvs.h
+     */
+    virtual esp_err_t get_blob_stream(const char *key, nvs_blob_read_cb_t callback, void *arg) = 0;
+
+    /**
+     * @brief Reads len bytes of a blob starting at offset.
+     *
+     * @note compare to \ref nvs_get_blob_range in nvs.h
+     */
+    virtual esp_err_t get_blob_range(const char *key, size_t offset, void* out_blob, size_t len) = 0;
+
     /**
      * @brief Look up the size of an entry's data.
      *
@@ -224,6 +238,70 @@ public:
      */
     virtual esp_err_t commit() = 0;
 
+    /**
+     * @brief Starts a batch of writes.
+     *
+     * Until \ref commit_batch or \ref abort_batch is called, the values set with \ref batch_set_item,
+     * \ref batch_set_string and \ref batch_set_blob are only staged. \ref commit_batch then writes them at once,
+     * and if power goes off during the commit, either all or none of the new values are present after
+     * re-initialization. Staged values are not visible to the get functions. The other set and erase functions
+     * still write and erase the entries directly, without affecting the staged values.
+     *
+     * @return
+     *             - ESP_OK if the batch was started successfully
+     *             - ESP_ERR_NVS_INVALID_HANDLE if the handle has been invalidated
+     *             - ESP_ERR_NVS_READ_ONLY if storage handle was opened as read only
+     *             - ESP_ERR_INVALID_STATE if a batch has already been started
+     *
+     * @note compare to \ref nvs_batch_begin in nvs.h
+     */
+    virtual esp_err_t begin_batch() = 0;
+
+    /**
+     * @brief Stages a value for the given key in the batch started by \ref begin_batch.
+     *
+     * The value is written by \ref commit_batch. Staging a key which is already part of the batch replaces the
+     * staged value.
+     *
+     * @return
+     *             - ESP_OK if the value was staged successfully
+     *             - ESP_ERR_NVS_INVALID_HANDLE if the handle has been invalidated
+     *             - ESP_ERR_INVALID_STATE if no batch has been started
+     *             - ESP_ERR_NO_MEM if the memory for the staged value couldn't be allocated
+     *
+     * @note compare to \ref nvs_batch_set_i8 in nvs.h
+     */
+    template<typename T>
+    esp_err_t batch_set_item(const char *key, T value);
+
+    /**
+     * @brief Stages a string for the given key in the batch, see \ref batch_set_item.
+     *
+     * @note compare to \ref nvs_batch_set_str in nvs.h
+     */
+    virtual esp_err_t batch_set_string(const char *key, const char* value) = 0;
+
+    /**
+     * @brief Stages a blob for the given key in the batch, see \ref batch_set_item.
+     *
+     * @note compare to \ref nvs_batch_set_blob in nvs.h
+     */
+    virtual esp_err_t batch_set_blob(const char *key, const void* blob, size_t len) = 0;
+
+    /**
+     * @brief Writes all values staged since \ref begin_batch and closes the batch.
+     *
+     * @note compare to \ref nvs_batch_commit in nvs.h
+     */
+    virtual esp_err_t commit_batch() = 0;
+
+    /**
+     * @brief Discards all values staged since \ref begin_batch and closes the batch.
+     *
+     * @note compare to \ref nvs_batch_abort in nvs.h
+     */
+    virtual esp_err_t abort_batch() = 0;
+
     /**
      * @brief      Calculate all entries in the scope of the handle.
      *
@@ -245,6 +323,8 @@ protected:
     virtual esp_err_t set_typed_item(ItemType datatype, const char *key, const void* data, size_t dataSize) = 0;
 
     virtual esp_err_t get_typed_item(ItemType datatype, const char *key, void* data, size_t dataSize) = 0;
+
+    virtual esp_err_t batch_set_typed_item(ItemType datatype, const char *key, const void* data, size_t dataSize) = 0;
 };
 
 /**
@@ -326,4 +406,9 @@ esp_err_t NVSHandle::get_item(const char *key, T &value) {
     return get_typed_item(itemTypeOf(value), key, &value, sizeof(value));
 }
 
+template<typename T>
+esp_err_t NVSHandle::batch_set_item(const char *key, T value) {
+    return batch_set_typed_item(itemTypeOf(value), key, &value, sizeof(value));
+}
+
 } // nvs
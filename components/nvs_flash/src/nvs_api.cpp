@@ -46,6 +46,8 @@ public:
     nvs::NVSHandleSimple *nvs_handle;
     nvs_handle_t mHandle;
     const char* handle_part_name;
+    // API calls in progress on the handle, see StorageAccess
+    std::atomic<uint32_t> mUsers{0};
 private:
     static uint32_t s_nvs_next_handle;
 };
@@ -64,12 +66,28 @@ static nvs::Storage* lookup_storage_from_name(const char *name)
     return NVSPartitionManager::get_instance()->lookup_storage_from_name(name);
 }
 
+// Looks up the storage under Lock, then takes the access to it with Lock released
+static nvs::Storage* lookup_storage_from_name(const char *name, StorageAccess& access)
+{
+    nvs::Storage* storage;
+    {
+        Lock lock;
+        storage = lookup_storage_from_name(name);
+        if (storage == nullptr) {
+            return nullptr;
+        }
+        access.attach(storage);
+    }
+    access.acquire();
+    return storage;
+}
+
 extern "C" void nvs_dump(const char *partName)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     nvs::Storage* pStorage;
 
-    pStorage = lookup_storage_from_name(partName);
+    pStorage = lookup_storage_from_name(partName, access);
     if (pStorage == nullptr) {
         return;
     }
@@ -79,6 +97,9 @@ extern "C" void nvs_dump(const char *partName)
 
 static esp_err_t close_handles_and_deinit(const char* part_name)
 {
+    // let the calls to the storage in other tasks finish before closing their handles
+    NVSPartitionManager::get_instance()->lookup_unused_storage_from_name(part_name);
+
     auto belongs_to_part = [=](NVSHandleEntry& e) -> bool {
         return strncmp(e.nvs_handle->get_partition_name(), part_name, NVS_PART_NAME_MAX_SIZE) == 0;
     };
@@ -281,15 +302,30 @@ extern "C" esp_err_t nvs_flash_deinit(void)
     return nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME);
 }
 
-static esp_err_t nvs_find_ns_handle(nvs_handle_t c_handle, NVSHandleSimple** handle)
+static NVSHandleEntry* nvs_find_handle_entry(nvs_handle_t c_handle)
 {
     auto it = find_if(begin(s_nvs_handles), end(s_nvs_handles), [=](NVSHandleEntry& e) -> bool {
         return e.mHandle == c_handle;
     });
     if (it == end(s_nvs_handles)) {
-        return ESP_ERR_NVS_INVALID_HANDLE;
+        return nullptr;
     }
-    *handle = it->nvs_handle;
+    return it;
+}
+
+// Looks up the handle under Lock, then takes the access to its storage with Lock released
+static esp_err_t nvs_find_ns_handle(nvs_handle_t c_handle, NVSHandleSimple** handle, StorageAccess& access)
+{
+    {
+        Lock lock;
+        NVSHandleEntry* entry = nvs_find_handle_entry(c_handle);
+        if (entry == nullptr) {
+            return ESP_ERR_NVS_INVALID_HANDLE;
+        }
+        *handle = entry->nvs_handle;
+        access.attach((*handle)->get_storage(), &entry->mUsers);
+    }
+    access.acquire();
     return ESP_OK;
 }
 
@@ -327,22 +363,24 @@ extern "C" void nvs_close(nvs_handle_t handle)
 {
     Lock lock;
     ESP_LOGD(TAG, "%s %d", __func__, static_cast<int>(handle));
-    auto it = find_if(begin(s_nvs_handles), end(s_nvs_handles), [=](NVSHandleEntry& e) -> bool {
-        return e.mHandle == handle;
-    });
-    if (it == end(s_nvs_handles)) {
+    NVSHandleEntry* entry = nvs_find_handle_entry(handle);
+    if (entry == nullptr) {
         return;
     }
-    s_nvs_handles.erase(it);
-    delete static_cast<NVSHandleEntry*>(it);
+    // no new calls find the handle once it is out of the list, let the ones using it in other tasks finish
+    s_nvs_handles.erase(entry);
+    while (entry->mUsers.load() > 0) {
+        Lock::yield();
+    }
+    delete entry;
 }
 
 extern "C" esp_err_t nvs_find_key(nvs_handle_t c_handle, const char* key, nvs_type_t* out_type)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     ESP_LOGD(TAG, "%s %s", __func__, key);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -358,10 +396,10 @@ extern "C" esp_err_t nvs_find_key(nvs_handle_t c_handle, const char* key, nvs_ty
 
 extern "C" esp_err_t nvs_erase_key(nvs_handle_t c_handle, const char* key)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s %s", __func__, key);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -371,10 +409,10 @@ extern "C" esp_err_t nvs_erase_key(nvs_handle_t c_handle, const char* key)
 
 extern "C" esp_err_t nvs_erase_all(nvs_handle_t c_handle)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s", __func__);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -384,10 +422,10 @@ extern "C" esp_err_t nvs_erase_all(nvs_handle_t c_handle)
 
 extern "C" esp_err_t nvs_purge_all(nvs_handle_t c_handle)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s", __func__);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -399,10 +437,10 @@ extern "C" esp_err_t nvs_purge_all(nvs_handle_t c_handle)
 template<typename T>
 static esp_err_t nvs_set(nvs_handle_t c_handle, const char* key, T value)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s %s %d %ld", __func__, key, static_cast<int>(sizeof(T)), static_cast<long int>(value));
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -460,10 +498,10 @@ extern "C" esp_err_t nvs_set_float (nvs_handle_t c_handle, const char* key, floa
     if (std::isnan(value)) {
         return ESP_ERR_INVALID_ARG;
     }
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s %s %f", __func__, key, static_cast<double>(value));
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -475,10 +513,10 @@ extern "C" esp_err_t nvs_set_double (nvs_handle_t c_handle, const char* key, dou
     if (std::isnan(value)) {
         return ESP_ERR_INVALID_ARG;
     }
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s %s %f", __func__, key, value);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -487,22 +525,134 @@ extern "C" esp_err_t nvs_set_double (nvs_handle_t c_handle, const char* key, dou
 
 extern "C" esp_err_t nvs_commit(nvs_handle_t c_handle)
 {
-    Lock lock;
-    // no-op for now, to be used when intermediate cache is added
+    StorageAccess access(StorageAccess::Mode::WRITE);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
     return handle->commit();
 }
 
+extern "C" esp_err_t nvs_batch_begin(nvs_handle_t c_handle)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    ESP_LOGD(TAG, "%s", __func__);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->begin_batch();
+}
+
+template<typename T>
+static esp_err_t nvs_batch_set(nvs_handle_t c_handle, const char* key, T value)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    ESP_LOGD(TAG, "%s %s %d %ld", __func__, key, static_cast<int>(sizeof(T)), static_cast<long int>(value));
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->batch_set_item(key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_i8  (nvs_handle_t handle, const char* key, int8_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_u8  (nvs_handle_t handle, const char* key, uint8_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_i16 (nvs_handle_t handle, const char* key, int16_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_u16 (nvs_handle_t handle, const char* key, uint16_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_i32 (nvs_handle_t handle, const char* key, int32_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_u32 (nvs_handle_t handle, const char* key, uint32_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_i64 (nvs_handle_t handle, const char* key, int64_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_u64 (nvs_handle_t handle, const char* key, uint64_t value)
+{
+    return nvs_batch_set(handle, key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_str(nvs_handle_t c_handle, const char* key, const char* value)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    ESP_LOGD(TAG, "%s %s %s", __func__, key, value);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->batch_set_string(key, value);
+}
+
+extern "C" esp_err_t nvs_batch_set_blob(nvs_handle_t c_handle, const char* key, const void* value, size_t length)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    ESP_LOGD(TAG, "%s %s %d", __func__, key, static_cast<int>(length));
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->batch_set_blob(key, value, length);
+}
+
+extern "C" esp_err_t nvs_batch_commit(nvs_handle_t c_handle)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    ESP_LOGD(TAG, "%s", __func__);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->commit_batch();
+}
+
+extern "C" esp_err_t nvs_batch_abort(nvs_handle_t c_handle)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    ESP_LOGD(TAG, "%s", __func__);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->abort_batch();
+}
+
 extern "C" esp_err_t nvs_set_str(nvs_handle_t c_handle, const char* key, const char* value)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s %s %s", __func__, key, value);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -511,10 +661,10 @@ extern "C" esp_err_t nvs_set_str(nvs_handle_t c_handle, const char* key, const c
 
 extern "C" esp_err_t nvs_set_blob(nvs_handle_t c_handle, const char* key, const void* value, size_t length)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
     ESP_LOGD(TAG, "%s %s %d", __func__, key, static_cast<int>(length));
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -525,10 +675,10 @@ extern "C" esp_err_t nvs_set_blob(nvs_handle_t c_handle, const char* key, const
 template<typename T>
 static esp_err_t nvs_get(nvs_handle_t c_handle, const char* key, T* out_value)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     ESP_LOGD(TAG, "%s %s %ld", __func__, key, static_cast<long int>(sizeof(T)));
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -587,10 +737,10 @@ extern "C" esp_err_t nvs_get_double (nvs_handle_t c_handle, const char* key, dou
 
 static esp_err_t nvs_get_str_or_blob(nvs_handle_t c_handle, nvs::ItemType type, const char* key, void* out_value, size_t* length)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     ESP_LOGD(TAG, "%s %s", __func__, key);
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -625,9 +775,43 @@ extern "C" esp_err_t nvs_get_blob(nvs_handle_t c_handle, const char* key, void*
     return nvs_get_str_or_blob(c_handle, nvs::ItemType::BLOB, key, out_value, length);
 }
 
+extern "C" esp_err_t nvs_get_blob_stream(nvs_handle_t c_handle, const char* key, nvs_blob_read_cb_t callback, void* arg)
+{
+    StorageAccess access(StorageAccess::Mode::READ);
+    ESP_LOGD(TAG, "%s %s", __func__, key);
+    if (callback == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return handle->get_blob_stream(key, callback, arg);
+}
+
+extern "C" esp_err_t nvs_get_blob_range(nvs_handle_t c_handle, const char* key, size_t offset, void* out_value, size_t length)
+{
+    StorageAccess access(StorageAccess::Mode::READ);
+    ESP_LOGD(TAG, "%s %s %d %d", __func__, key, static_cast<int>(offset), static_cast<int>(length));
+    if (out_value == nullptr && length > 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return handle->get_blob_range(key, offset, out_value, length);
+}
+
 extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     nvs::Storage* pStorage;
 
     if (nvs_stats == nullptr) {
@@ -639,7 +823,7 @@ extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats
     nvs_stats->available_entries = 0;
     nvs_stats->namespace_count   = 0;
 
-    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name);
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name, access);
     if (pStorage == nullptr) {
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
@@ -651,16 +835,86 @@ extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats
     return pStorage->fillStats(*nvs_stats);
 }
 
+extern "C" esp_err_t nvs_get_arena_stats(nvs_arena_stats_t* arena_stats)
+{
+    if (arena_stats == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#ifdef NVS_MEMORY_ARENA
+    nvs::MemoryArena::getStats(*arena_stats);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+extern "C" esp_err_t nvs_set_write_cache(const char* part_name, const nvs_write_cache_config_t* config)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    nvs::Storage* pStorage;
+
+    if (config == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name, access);
+    if (pStorage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    return pStorage->setWriteCache(config->max_entries, config->flush_on_write_age_ms);
+}
+
+extern "C" esp_err_t nvs_get_cache_stats(const char* part_name, nvs_cache_stats_t* cache_stats)
+{
+    StorageAccess access(StorageAccess::Mode::READ);
+    nvs::Storage* pStorage;
+
+    if (cache_stats == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name, access);
+    if (pStorage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    pStorage->fillCacheStats(*cache_stats);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_gc_step(const char* part_name, size_t max_entries, bool* pending)
+{
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    nvs::Storage* pStorage;
+    bool morePending;
+
+    if (max_entries == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name, access);
+    if (pStorage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    esp_err_t err = pStorage->gcStep(max_entries, morePending);
+    if (pending != nullptr) {
+        *pending = morePending;
+    }
+    return err;
+}
+
 extern "C" esp_err_t nvs_get_used_entry_count(nvs_handle_t c_handle, size_t* used_entries)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     if(used_entries == nullptr){
         return ESP_ERR_INVALID_ARG;
     }
     *used_entries = 0;
 
     NVSHandleSimple *handle;
-    auto err = nvs_find_ns_handle(c_handle, &handle);
+    auto err = nvs_find_ns_handle(c_handle, &handle, access);
     if (err != ESP_OK) {
         return err;
     }
@@ -874,10 +1128,10 @@ extern "C" esp_err_t nvs_entry_find(const char *part_name, const char *namespace
         *output_iterator = nullptr;
         return lock_result;
     }
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     nvs::Storage *pStorage;
 
-    pStorage = lookup_storage_from_name(part_name);
+    pStorage = lookup_storage_from_name(part_name, access);
     if (pStorage == nullptr) {
         *output_iterator = nullptr;
         return ESP_ERR_NVS_NOT_FOUND;
@@ -912,11 +1166,11 @@ extern "C" esp_err_t nvs_entry_find_in_handle(nvs_handle_t handle, nvs_type_t ty
         return lock_result;
     }
 
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
     nvs::Storage *pStorage;
     NVSHandleSimple *handle_obj;
 
-    auto err = nvs_find_ns_handle(handle, &handle_obj);
+    auto err = nvs_find_ns_handle(handle, &handle_obj, access);
     if (err != ESP_OK) {
         *output_iterator = nullptr;
         return err;
@@ -946,7 +1200,12 @@ extern "C" esp_err_t nvs_entry_next(nvs_iterator_t *iterator)
         return ESP_ERR_INVALID_ARG;
     }
 
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    {
+        Lock lock;
+        access.attach((*iterator)->storage);
+    }
+    access.acquire();
 
     bool entryFound = (*iterator)->storage->nextEntry(*iterator);
     if (!entryFound) {
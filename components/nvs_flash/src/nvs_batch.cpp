@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_batch.hpp"
+#include "nvs_page.hpp"
+#include <cstring>
+
+namespace nvs
+{
+
+size_t BatchItem::getEntryCount() const
+{
+    if (!isVariableLengthType(mDatatype)) {
+        return 1;
+    }
+    size_t count = 1 + (mDataSize + Page::ENTRY_SIZE - 1) / Page::ENTRY_SIZE;
+    if (mDatatype == ItemType::BLOB) {
+        // blob index following the data chunk
+        ++count;
+    }
+    return count;
+}
+
+esp_err_t Batch::set(ItemType datatype, const char* key, const void* data, size_t dataSize)
+{
+    if (strlen(key) > Item::MAX_KEY_LENGTH) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    if (isVariableLengthType(datatype)) {
+        // the whole batch is written to one page, so a value can't be split into several chunks
+        if (dataSize > Page::CHUNK_MAX_SIZE) {
+            return ESP_ERR_NVS_VALUE_TOO_LONG;
+        }
+    } else if (dataSize > sizeof(BatchItem::mValue)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    BatchItem* item = new (std::nothrow) BatchItem;
+    if (!item) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (isVariableLengthType(datatype) && dataSize > 0) {
+        item->mBuffer = new (std::nothrow) uint8_t[dataSize];
+        if (!item->mBuffer) {
+            delete item;
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(item->mBuffer, data, dataSize);
+    } else {
+        memcpy(item->mValue, data, dataSize);
+    }
+    item->mDatatype = datatype;
+    item->mDataSize = dataSize;
+    strncpy(item->mKey, key, Item::MAX_KEY_LENGTH);
+
+    // the last value staged for a key wins
+    for (auto it = mItems.begin(); it != mItems.end(); ++it) {
+        if (strncmp(it->mKey, item->mKey, Item::MAX_KEY_LENGTH) == 0) {
+            mEntryCount -= it->getEntryCount();
+            mItems.erase(it);
+            delete static_cast<BatchItem*>(it);
+            break;
+        }
+    }
+
+    mItems.push_back(item);
+    mEntryCount += item->getEntryCount();
+    return ESP_OK;
+}
+
+} // namespace nvs
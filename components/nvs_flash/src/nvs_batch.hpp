@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "intrusive_list.h"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+/**
+ * One value staged in a Batch. Scalars are kept inline, strings and blobs in a buffer owned by the item.
+ */
+class BatchItem : public intrusive_list_node<BatchItem>, public ExceptionlessAllocatable
+{
+public:
+    BatchItem() : mDatatype(ItemType::ANY), mDataSize(0), mBuffer(nullptr)
+    {
+        std::fill_n(mKey, sizeof(mKey), 0);
+    }
+
+    ~BatchItem()
+    {
+        delete[] mBuffer;
+    }
+
+    const void* getData() const
+    {
+        return (mBuffer != nullptr) ? mBuffer : mValue;
+    }
+
+    /**
+     * Number of page entries the item occupies once written, a blob is stored as one data chunk plus its index.
+     */
+    size_t getEntryCount() const;
+
+    ItemType mDatatype;
+    char mKey[Item::MAX_KEY_LENGTH + 1];
+    size_t mDataSize;
+    uint8_t mValue[8];
+    uint8_t* mBuffer;
+};
+
+/**
+ * Values set through one handle between begin_batch() and commit_batch().
+ *
+ * The values are copied when they are staged, so the caller may reuse its buffers right away.
+ * Staging a key which is already part of the batch replaces the staged value, i.e. every key is written at most
+ * once per batch.
+ */
+class Batch
+{
+public:
+    typedef intrusive_list<BatchItem>::iterator iterator;
+
+    Batch() { }
+
+    ~Batch()
+    {
+        clear();
+    }
+
+    esp_err_t set(ItemType datatype, const char* key, const void* data, size_t dataSize);
+
+    void clear()
+    {
+        mItems.clearAndFreeNodes();
+        mEntryCount = 0;
+    }
+
+    bool empty() const
+    {
+        return mItems.empty();
+    }
+
+    size_t size() const
+    {
+        return mItems.size();
+    }
+
+    /**
+     * Number of page entries all staged items occupy once written, not counting the batch marker.
+     */
+    size_t getEntryCount() const
+    {
+        return mEntryCount;
+    }
+
+    iterator begin()
+    {
+        return mItems.begin();
+    }
+
+    iterator end()
+    {
+        return mItems.end();
+    }
+
+private:
+    Batch(const Batch& other);
+    const Batch& operator= (const Batch& rhs);
+
+    intrusive_list<BatchItem> mItems;
+    size_t mEntryCount = 0;
+}; // class Batch
+
+} // namespace nvs
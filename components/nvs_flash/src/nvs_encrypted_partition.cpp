@@ -55,8 +55,8 @@ esp_err_t NVSEncryptedPartition::init(nvs_sec_cfg_t* cfg)
 
 esp_err_t NVSEncryptedPartition::read(size_t src_offset, void* dst, size_t size)
 {
-    // Currently upper layer of NVS reads entries one by one even for variable size
-    // multi-entry data types. So length should always be equal to size of an entry.
+    // Data is written encrypted entry by entry, with the address of each entry as the data unit,
+    // so reads of several entries at once are decrypted entry by entry as well.
     // here we make sure that the size is really compliant with the minimal encryption block size.
     if (size % NVS_ENCRYPT_BLOCK_SIZE != 0) return ESP_ERR_INVALID_SIZE;
 
@@ -67,6 +67,8 @@ esp_err_t NVSEncryptedPartition::read(size_t src_offset, void* dst, size_t size)
     }
 
     // decrypt data
+    uint8_t entrySize = sizeof(Item);
+
     //sector num required as an arr by mbedtls. Should have been just uint64/32.
     uint8_t data_unit[NVS_ENCRYPT_BLOCK_SIZE];
 
@@ -74,12 +76,17 @@ esp_err_t NVSEncryptedPartition::read(size_t src_offset, void* dst, size_t size)
 
     memset(data_unit, 0, sizeof(data_unit));
 
-    memcpy(data_unit, &relAddr, sizeof(relAddr));
-
     uint8_t *destination = reinterpret_cast<uint8_t*>(dst);
 
-    if (XTS_FUNC(crypt_xts)(&mDctxt, XTS_MODE(DECRYPT), size, data_unit, destination, destination) != 0)  {
-        return ESP_ERR_NVS_XTS_DECR_FAILED;
+    for (size_t offset = 0; offset < size; offset += entrySize) {
+        uint32_t *addr_loc = (uint32_t*) &data_unit[0];
+
+        size_t unitSize = (size - offset < entrySize) ? size - offset : entrySize;
+
+        *addr_loc = relAddr + offset;
+        if (XTS_FUNC(crypt_xts)(&mDctxt, XTS_MODE(DECRYPT), unitSize, data_unit, destination + offset, destination + offset) != 0)  {
+            return ESP_ERR_NVS_XTS_DECR_FAILED;
+        }
     }
 
     return ESP_OK;
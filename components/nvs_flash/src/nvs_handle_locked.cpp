@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -14,70 +14,143 @@ NVSHandleLocked::~NVSHandleLocked() {
     delete handle;
 }
 
+void NVSHandleLocked::enter(StorageAccess& access) {
+    {
+        Lock lock;
+        // an invalidated handle reports the error itself, its storage is gone
+        if (!handle->is_valid()) {
+            return;
+        }
+        access.attach(handle->get_storage());
+    }
+    access.acquire();
+}
+
 esp_err_t NVSHandleLocked::set_string(const char *key, const char* str) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->set_string(key, str);
 }
 
 esp_err_t NVSHandleLocked::set_blob(const char *key, const void* blob, size_t len) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->set_blob(key, blob, len);
 }
 
 esp_err_t NVSHandleLocked::get_string(const char *key, char* out_str, size_t len) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
     return handle->get_string(key, out_str, len);
 }
 
 esp_err_t NVSHandleLocked::get_blob(const char *key, void* out_blob, size_t len) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
     return handle->get_blob(key, out_blob, len);
 }
 
+esp_err_t NVSHandleLocked::get_blob_stream(const char *key, nvs_blob_read_cb_t callback, void* arg) {
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
+    return handle->get_blob_stream(key, callback, arg);
+}
+
+esp_err_t NVSHandleLocked::get_blob_range(const char *key, size_t offset, void* out_blob, size_t len) {
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
+    return handle->get_blob_range(key, offset, out_blob, len);
+}
+
 esp_err_t NVSHandleLocked::get_item_size(ItemType datatype, const char *key, size_t &size) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
     return handle->get_item_size(datatype, key, size);
 }
 
 esp_err_t NVSHandleLocked::find_key(const char* key, nvs_type_t &nvstype)
 {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
     return handle->find_key(key, nvstype);
 }
 
 esp_err_t NVSHandleLocked::erase_item(const char* key) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->erase_item(key);
 }
 
 esp_err_t NVSHandleLocked::erase_all() {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->erase_all();
 }
 
 esp_err_t NVSHandleLocked::purge_all() {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->purge_all();
 }
 
 esp_err_t NVSHandleLocked::commit() {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->commit();
 }
 
+esp_err_t NVSHandleLocked::begin_batch() {
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
+    return handle->begin_batch();
+}
+
+esp_err_t NVSHandleLocked::batch_set_string(const char *key, const char* str) {
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
+    return handle->batch_set_string(key, str);
+}
+
+esp_err_t NVSHandleLocked::batch_set_blob(const char *key, const void* blob, size_t len) {
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
+    return handle->batch_set_blob(key, blob, len);
+}
+
+esp_err_t NVSHandleLocked::commit_batch() {
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
+    return handle->commit_batch();
+}
+
+esp_err_t NVSHandleLocked::abort_batch() {
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
+    return handle->abort_batch();
+}
+
 esp_err_t NVSHandleLocked::get_used_entry_count(size_t& usedEntries) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
     return handle->get_used_entry_count(usedEntries);
 }
 
 esp_err_t NVSHandleLocked::set_typed_item(ItemType datatype, const char *key, const void* data, size_t dataSize) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
     return handle->set_typed_item(datatype, key, data, dataSize);
 }
 
 esp_err_t NVSHandleLocked::get_typed_item(ItemType datatype, const char *key, void* data, size_t dataSize) {
-    Lock lock;
+    StorageAccess access(StorageAccess::Mode::READ);
+    enter(access);
     return handle->get_typed_item(datatype, key, data, dataSize);
 }
 
+esp_err_t NVSHandleLocked::batch_set_typed_item(ItemType datatype, const char *key, const void* data, size_t dataSize) {
+    StorageAccess access(StorageAccess::Mode::WRITE);
+    enter(access);
+    return handle->batch_set_typed_item(datatype, key, data, dataSize);
+}
+
 } // namespace nvs
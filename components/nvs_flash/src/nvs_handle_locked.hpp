@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -12,6 +12,9 @@ namespace nvs {
 /**
  * @brief A class which behaves the same as NVSHandleSimple, except that all public member functions are locked.
  *
+ * The functions hold the lock of the handle's storage, shared for the reads and exclusively for the writes, so that
+ * reads through several handles run concurrently and calls to different partitions don't wait for each other.
+ *
  * This class follows the decorator design pattern. The reason why we don't want locks in NVSHandleSimple is that
  * NVSHandleSimple can also be used by the C-API which locks its public functions already.
  * Thus, we avoid double-locking.
@@ -38,6 +41,10 @@ public:
 
     esp_err_t get_blob(const char *key, void* out_blob, size_t len) override;
 
+    esp_err_t get_blob_stream(const char *key, nvs_blob_read_cb_t callback, void* arg) override;
+
+    esp_err_t get_blob_range(const char *key, size_t offset, void* out_blob, size_t len) override;
+
     esp_err_t get_item_size(ItemType datatype, const char *key, size_t &size) override;
 
     esp_err_t find_key(const char* key, nvs_type_t &nvstype) override;
@@ -50,6 +57,16 @@ public:
 
     esp_err_t commit() override;
 
+    esp_err_t begin_batch() override;
+
+    esp_err_t batch_set_string(const char *key, const char* str) override;
+
+    esp_err_t batch_set_blob(const char *key, const void* blob, size_t len) override;
+
+    esp_err_t commit_batch() override;
+
+    esp_err_t abort_batch() override;
+
     esp_err_t get_used_entry_count(size_t& usedEntries) override;
 
 protected:
@@ -57,7 +74,12 @@ protected:
 
     esp_err_t get_typed_item(ItemType datatype, const char *key, void* data, size_t dataSize) override;
 
+    esp_err_t batch_set_typed_item(ItemType datatype, const char *key, const void* data, size_t dataSize) override;
+
 private:
+    // Takes the access to the storage of the handle, see StorageAccess
+    void enter(StorageAccess& access);
+
     NVSHandleSimple *handle;
 };
 
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -58,6 +58,26 @@ esp_err_t NVSHandleSimple::get_blob(const char *key, void* out_blob, size_t len)
     return mStoragePtr->readItem(mNsIndex, nvs::ItemType::BLOB, key, out_blob, len);
 }
 
+esp_err_t NVSHandleSimple::get_blob_stream(const char *key, nvs_blob_read_cb_t callback, void* arg)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    size_t size;
+    esp_err_t err = mStoragePtr->getItemDataSize(mNsIndex, nvs::ItemType::BLOB, key, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return mStoragePtr->readBlobStream(mNsIndex, key, 0, size, callback, arg);
+}
+
+esp_err_t NVSHandleSimple::get_blob_range(const char *key, size_t offset, void* out_blob, size_t len)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    return mStoragePtr->readBlobRange(mNsIndex, key, offset, out_blob, len);
+}
+
 esp_err_t NVSHandleSimple::get_item_size(ItemType datatype, const char *key, size_t &size)
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
@@ -110,6 +130,55 @@ esp_err_t NVSHandleSimple::commit()
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
 
+    return mStoragePtr->flushWriteCache();
+}
+
+esp_err_t NVSHandleSimple::begin_batch()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInBatch) return ESP_ERR_INVALID_STATE;
+
+    mInBatch = true;
+    return ESP_OK;
+}
+
+esp_err_t NVSHandleSimple::batch_set_typed_item(ItemType datatype, const char *key, const void* data, size_t dataSize)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInBatch) return ESP_ERR_INVALID_STATE;
+
+    return mBatch.set(datatype, key, data, dataSize);
+}
+
+esp_err_t NVSHandleSimple::batch_set_string(const char *key, const char* str)
+{
+    return batch_set_typed_item(nvs::ItemType::SZ, key, str, strlen(str) + 1);
+}
+
+esp_err_t NVSHandleSimple::batch_set_blob(const char *key, const void* blob, size_t len)
+{
+    return batch_set_typed_item(nvs::ItemType::BLOB, key, blob, len);
+}
+
+esp_err_t NVSHandleSimple::commit_batch()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInBatch) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err = mStoragePtr->writeBatch(mNsIndex, mBatch, mPurgeAfterErase);
+    mBatch.clear();
+    mInBatch = false;
+    return err;
+}
+
+esp_err_t NVSHandleSimple::abort_batch()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInBatch) return ESP_ERR_INVALID_STATE;
+
+    mBatch.clear();
+    mInBatch = false;
     return ESP_OK;
 }
 
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -49,6 +49,10 @@ public:
 
     esp_err_t get_blob(const char *key, void *out_blob, size_t len) override;
 
+    esp_err_t get_blob_stream(const char *key, nvs_blob_read_cb_t callback, void *arg) override;
+
+    esp_err_t get_blob_range(const char *key, size_t offset, void *out_blob, size_t len) override;
+
     esp_err_t get_item_size(ItemType datatype, const char *key, size_t &size) override;
 
     esp_err_t find_key(const char *key, nvs_type_t &nvstype) override;
@@ -61,6 +65,18 @@ public:
 
     esp_err_t commit() override;
 
+    esp_err_t begin_batch() override;
+
+    esp_err_t batch_set_typed_item(ItemType datatype, const char *key, const void *data, size_t dataSize) override;
+
+    esp_err_t batch_set_string(const char *key, const char *str) override;
+
+    esp_err_t batch_set_blob(const char *key, const void *blob, size_t len) override;
+
+    esp_err_t commit_batch() override;
+
+    esp_err_t abort_batch() override;
+
     esp_err_t get_used_entry_count(size_t &usedEntries) override;
 
     esp_err_t getItemDataSize(ItemType datatype, const char *key, size_t &dataSize);
@@ -81,6 +97,11 @@ public:
 
     Storage *get_storage() const;
 
+    bool is_valid() const
+    {
+        return valid;
+    }
+
 private:
     /**
      * The underlying storage's object.
@@ -108,6 +129,16 @@ private:
      * Upon opening, a handle is valid. It becomes invalid if the underlying storage is de-initialized.
      */
     uint8_t valid;
+
+    /**
+     * Whether a batch has been started on this handle, i.e. whether the batch set functions may stage values in mBatch.
+     */
+    bool mInBatch = false;
+
+    /**
+     * Values staged since begin_batch().
+     */
+    Batch mBatch;
 };
 
 } // nvs
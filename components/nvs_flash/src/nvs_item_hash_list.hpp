@@ -8,6 +8,7 @@
 #include "nvs.h"
 #include "nvs_types.hpp"
 #include "nvs_memory_management.hpp"
+#include "nvs_key_index.hpp"
 #include "intrusive_list.h"
 
 namespace nvs
@@ -24,6 +25,23 @@ public:
     size_t find(size_t start, const Item& item);
     void clear();
 
+    /**
+     * Attaches the storage-wide index which mirrors all insertions and removals of this list.
+     * The owner is the page this list belongs to.
+     */
+    void setKeyIndex(KeyIndex* keyIndex, Page* owner);
+
+    /**
+     * Number of blocks the list of a page allocates at most while entryCount entries are written to the page.
+     * Nodes are only appended and a block is freed once all of its nodes are erased.
+     */
+    static size_t maxBlockCount(size_t entryCount)
+    {
+        return (entryCount + HashListBlock::ENTRY_COUNT - 1) / HashListBlock::ENTRY_COUNT;
+    }
+
+    static const size_t BLOCK_SIZE = 128;
+
 private:
     HashList(const HashList& other);
     const HashList& operator= (const HashList& rhs);
@@ -48,7 +66,7 @@ protected:
     struct HashListBlock : public intrusive_list_node<HashList::HashListBlock>, public ExceptionlessAllocatable {
         HashListBlock();
 
-        static const size_t BYTE_SIZE = 128;
+        static const size_t BYTE_SIZE = BLOCK_SIZE;
         static const size_t ENTRY_COUNT = (BYTE_SIZE - sizeof(intrusive_list_node<HashListBlock>) - sizeof(size_t)) / 4;
 
         size_t mCount = 0;
@@ -57,6 +75,9 @@ protected:
 
     typedef intrusive_list<HashListBlock> TBlockList;
     TBlockList mBlockList;
+
+    KeyIndex* mKeyIndex = nullptr;
+    Page* mOwner = nullptr;
 }; // class HashList
 
 } // namespace nvs
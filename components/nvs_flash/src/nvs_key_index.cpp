@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_key_index.hpp"
+
+namespace nvs
+{
+
+KeyIndex::KeyIndex()
+{
+}
+
+KeyIndex::~KeyIndex()
+{
+    delete[] mNodes;
+}
+
+void KeyIndex::clear()
+{
+    delete[] mNodes;
+    mNodes = nullptr;
+    mCapacity = 0;
+    mCount = 0;
+}
+
+esp_err_t KeyIndex::grow()
+{
+    size_t newCapacity = (mCapacity == 0) ? MIN_CAPACITY : mCapacity * 2;
+    KeyIndexNode* newNodes = new (std::nothrow) KeyIndexNode[newCapacity];
+
+    if (!newNodes) return ESP_ERR_NO_MEM;
+
+    KeyIndexNode* oldNodes = mNodes;
+    size_t oldCapacity = mCapacity;
+    mNodes = newNodes;
+    mCapacity = newCapacity;
+
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (oldNodes[i].mPage == nullptr) {
+            continue;
+        }
+        size_t slot = slotOf(oldNodes[i].mHash);
+        while (mNodes[slot].mPage != nullptr) {
+            slot = (slot + 1) & (mCapacity - 1);
+        }
+        mNodes[slot] = oldNodes[i];
+    }
+
+    delete[] oldNodes;
+    return ESP_OK;
+}
+
+esp_err_t KeyIndex::insert(uint32_t hash, Page* page, size_t index)
+{
+    // keep the load factor below 3/4 so that probe sequences stay short
+    if ((mCount + 1) * 4 > mCapacity * 3) {
+        esp_err_t err = grow();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    size_t slot = slotOf(hash);
+    while (mNodes[slot].mPage != nullptr) {
+        slot = (slot + 1) & (mCapacity - 1);
+    }
+    mNodes[slot].mPage = page;
+    mNodes[slot].mIndex = (uint32_t) index;
+    mNodes[slot].mHash = hash;
+    ++mCount;
+    return ESP_OK;
+}
+
+bool KeyIndex::erase(uint32_t hash, const Page* page, size_t index)
+{
+    if (mCount == 0) {
+        return false;
+    }
+
+    size_t slot = slotOf(hash);
+    while (mNodes[slot].mPage != nullptr) {
+        if (mNodes[slot].mPage == page && mNodes[slot].mIndex == index && mNodes[slot].mHash == hash) {
+            break;
+        }
+        slot = (slot + 1) & (mCapacity - 1);
+    }
+    if (mNodes[slot].mPage == nullptr) {
+        // item hasn't been present in the index
+        return false;
+    }
+
+    // Shift the following nodes of the probe sequence back instead of leaving a tombstone,
+    // so that lookups never have to walk over deleted slots.
+    size_t hole = slot;
+    size_t next = (hole + 1) & (mCapacity - 1);
+    while (mNodes[next].mPage != nullptr) {
+        size_t home = slotOf(mNodes[next].mHash);
+        // the node may fill the hole only if its home slot is not cyclically within (hole, next]
+        bool canMove = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (canMove) {
+            mNodes[hole] = mNodes[next];
+            hole = next;
+        }
+        next = (next + 1) & (mCapacity - 1);
+    }
+    mNodes[hole] = KeyIndexNode();
+    --mCount;
+    return true;
+}
+
+size_t KeyIndex::findPages(uint32_t hash, Page** pages, size_t maxPages) const
+{
+    size_t found = 0;
+    if (mCount == 0) {
+        return found;
+    }
+
+    for (size_t slot = slotOf(hash); mNodes[slot].mPage != nullptr; slot = (slot + 1) & (mCapacity - 1)) {
+        if (mNodes[slot].mHash != hash) {
+            continue;
+        }
+        Page* page = mNodes[slot].mPage;
+        size_t stored = (found < maxPages) ? found : maxPages;
+        if (std::find(pages, pages + stored, page) != pages + stored) {
+            continue;
+        }
+        if (found < maxPages) {
+            pages[found] = page;
+        }
+        ++found;
+    }
+    return found;
+}
+
+} // namespace nvs
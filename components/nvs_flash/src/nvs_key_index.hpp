@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+class Page;
+
+/**
+ * Storage-wide index of the items held by all pages of one partition.
+ *
+ * Every node maps the 24-bit hash of <namespace index, key, chunk index> (the same hash the per-page HashList uses)
+ * to the page and the entry index the item starts at. Nodes live in a single open addressing table with linear
+ * probing, so the pages possibly holding a key are found without asking every page for it.
+ *
+ * The index is fed by the HashList of each page it is attached to, i.e. it follows every insertion and removal
+ * the pages do on write, erase, load and page reclaim. A hit is only a hint: hash collisions are resolved by
+ * Page::findItem on the candidate pages.
+ */
+class KeyIndex
+{
+public:
+    KeyIndex();
+    ~KeyIndex();
+
+    esp_err_t insert(uint32_t hash, Page* page, size_t index);
+    bool erase(uint32_t hash, const Page* page, size_t index);
+
+    /**
+     * Collects the distinct pages holding at least one item with the given hash.
+     *
+     * @return Total number of distinct pages found. If it is greater than maxPages, only the first maxPages
+     *         pages were stored to pages and the caller has to fall back to searching all pages.
+     */
+    size_t findPages(uint32_t hash, Page** pages, size_t maxPages) const;
+
+    void clear();
+
+    size_t size() const
+    {
+        return mCount;
+    }
+
+    size_t capacity() const
+    {
+        return mCapacity;
+    }
+
+    static uint32_t calculateHash(const Item& item)
+    {
+        return item.calculateCrc32WithoutValue() & 0xffffff;
+    }
+
+private:
+    KeyIndex(const KeyIndex& other);
+    const KeyIndex& operator= (const KeyIndex& rhs);
+
+protected:
+    struct KeyIndexNode : public ExceptionlessAllocatable {
+        KeyIndexNode() :
+            mPage(nullptr), mIndex(0xff), mHash(0)
+        {
+        }
+
+        Page* mPage;
+        uint32_t mIndex : 8;
+        uint32_t mHash  : 24;
+    };
+
+    static const size_t MIN_CAPACITY = 64;
+
+    size_t slotOf(uint32_t hash) const
+    {
+        return hash & (mCapacity - 1);
+    }
+
+    esp_err_t grow();
+
+    KeyIndexNode* mNodes = nullptr;
+    size_t mCapacity = 0;
+    size_t mCount = 0;
+}; // class KeyIndex
+
+} // namespace nvs
@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_memory_management.hpp"
+
+#ifdef NVS_MEMORY_ARENA
+
+#include "nvs_item_hash_list.hpp"
+#include "nvs_page.hpp"
+#include <cstdint>
+#ifdef LINUX_TARGET
+#include <mutex>
+#else
+#include <sys/lock.h>
+#endif
+
+namespace nvs
+{
+
+namespace
+{
+
+// Size classes of the slots; the largest one holds a hash list block
+const size_t SLOT_SIZES[] = {32, 64, HashList::BLOCK_SIZE};
+const size_t CLASS_COUNT = sizeof(SLOT_SIZES) / sizeof(SLOT_SIZES[0]);
+const size_t BLOCK_CLASS = CLASS_COUNT - 1;
+
+// Slots of each smaller class reserved per page and per partition, used by the namespace list,
+// the lists built while loading and writing blobs, the write-back cache and the batches
+const size_t SMALL_SLOTS_PER_PAGE = 1;
+const size_t SMALL_SLOTS_PER_PARTITION = 8;
+
+struct FreeSlot {
+    FreeSlot* mNext;
+};
+
+// Memory of the slots added by one reserve() call, the slots of each class are contiguous
+struct Region {
+    Region* mNext;
+    size_t mPageCount;
+    size_t mUsedCount;
+    uint8_t* mBegin[CLASS_COUNT];
+    size_t mCount[CLASS_COUNT];
+
+    uint8_t* end(size_t cls) const
+    {
+        return mBegin[cls] + mCount[cls] * SLOT_SIZES[cls];
+    }
+
+    bool contains(const void* obj, size_t& cls) const
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(obj);
+        for (cls = 0; cls < CLASS_COUNT; ++cls) {
+            if (p >= mBegin[cls] && p < end(cls)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+Region* sRegions = nullptr;
+FreeSlot* sFreeSlots[CLASS_COUNT] = {};
+size_t sReservedPages = 0;
+size_t sTotalSize = 0;
+size_t sUsedSize = 0;
+size_t sPeakUsedSize = 0;
+size_t sHeapFallbacks = 0;
+
+#ifdef LINUX_TARGET
+std::mutex sMutex;
+
+struct ArenaLock {
+    ArenaLock()
+    {
+        sMutex.lock();
+    }
+    ~ArenaLock()
+    {
+        sMutex.unlock();
+    }
+};
+#else
+// Not the NVS lock: objects are also allocated and freed with that one held
+_lock_t sLock = 0;
+
+struct ArenaLock {
+    ArenaLock()
+    {
+        _lock_acquire(&sLock);
+    }
+    ~ArenaLock()
+    {
+        _lock_release(&sLock);
+    }
+};
+#endif
+
+void* heapAllocate(size_t size)
+{
+#ifdef CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM
+    return heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT | MALLOC_CAP_SPIRAM,
+                                            MALLOC_CAP_DEFAULT | MALLOC_CAP_INTERNAL);
+#else
+    return std::malloc(size);
+#endif
+}
+
+void heapFree(void* obj)
+{
+#ifdef CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM
+    heap_caps_free(obj);
+#else
+    std::free(obj);
+#endif
+}
+
+Region* regionOf(const void* obj, size_t& cls)
+{
+    for (Region* region = sRegions; region != nullptr; region = region->mNext) {
+        if (region->contains(obj, cls)) {
+            return region;
+        }
+    }
+    return nullptr;
+}
+
+// Removes the slots of a region from the free lists and returns its memory to the heap
+void freeRegion(Region* region)
+{
+    for (size_t cls = 0; cls < CLASS_COUNT; ++cls) {
+        FreeSlot** link = &sFreeSlots[cls];
+        while (*link != nullptr) {
+            if (reinterpret_cast<uint8_t*>(*link) >= region->mBegin[cls] && reinterpret_cast<uint8_t*>(*link) < region->end(cls)) {
+                *link = (*link)->mNext;
+            } else {
+                link = &(*link)->mNext;
+            }
+        }
+        sTotalSize -= region->mCount[cls] * SLOT_SIZES[cls];
+    }
+    heapFree(region);
+}
+
+} // namespace
+
+void* MemoryArena::allocate(size_t size) noexcept
+{
+    if (size <= SLOT_SIZES[BLOCK_CLASS]) {
+        ArenaLock lock;
+        size_t cls = 0;
+        while (SLOT_SIZES[cls] < size) {
+            ++cls;
+        }
+        // a slot of a larger class is still better than the heap
+        for (; cls < CLASS_COUNT; ++cls) {
+            FreeSlot* slot = sFreeSlots[cls];
+            if (slot != nullptr) {
+                sFreeSlots[cls] = slot->mNext;
+                size_t slotCls;
+                regionOf(slot, slotCls)->mUsedCount++;
+                sUsedSize += SLOT_SIZES[cls];
+                if (sUsedSize > sPeakUsedSize) {
+                    sPeakUsedSize = sUsedSize;
+                }
+                return slot;
+            }
+        }
+        ++sHeapFallbacks;
+    }
+    return heapAllocate(size);
+}
+
+void MemoryArena::release(void* obj) noexcept
+{
+    if (obj == nullptr) {
+        return;
+    }
+    {
+        ArenaLock lock;
+        size_t cls;
+        Region* region = regionOf(obj, cls);
+        if (region != nullptr) {
+            FreeSlot* slot = static_cast<FreeSlot*>(obj);
+            slot->mNext = sFreeSlots[cls];
+            sFreeSlots[cls] = slot;
+            region->mUsedCount--;
+            sUsedSize -= SLOT_SIZES[cls];
+            return;
+        }
+    }
+    heapFree(obj);
+}
+
+esp_err_t MemoryArena::reserve(size_t pageCount) noexcept
+{
+    size_t count[CLASS_COUNT];
+    for (size_t cls = 0; cls < BLOCK_CLASS; ++cls) {
+        count[cls] = pageCount * SMALL_SLOTS_PER_PAGE + SMALL_SLOTS_PER_PARTITION;
+    }
+    count[BLOCK_CLASS] = pageCount * HashList::maxBlockCount(Page::ENTRY_COUNT);
+
+    // slot sizes are multiples of the header alignment, so every slot stays aligned
+    const size_t headerSize = (sizeof(Region) + SLOT_SIZES[0] - 1) / SLOT_SIZES[0] * SLOT_SIZES[0];
+    size_t size = headerSize;
+    for (size_t cls = 0; cls < CLASS_COUNT; ++cls) {
+        size += count[cls] * SLOT_SIZES[cls];
+    }
+    Region* region = static_cast<Region*>(heapAllocate(size));
+    if (region == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ArenaLock lock;
+    region->mPageCount = pageCount;
+    region->mUsedCount = 0;
+    uint8_t* slots = reinterpret_cast<uint8_t*>(region) + headerSize;
+    for (size_t cls = 0; cls < CLASS_COUNT; ++cls) {
+        region->mBegin[cls] = slots;
+        region->mCount[cls] = count[cls];
+        for (size_t i = count[cls]; i > 0; --i) {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(slots + (i - 1) * SLOT_SIZES[cls]);
+            slot->mNext = sFreeSlots[cls];
+            sFreeSlots[cls] = slot;
+        }
+        slots += count[cls] * SLOT_SIZES[cls];
+        sTotalSize += count[cls] * SLOT_SIZES[cls];
+    }
+    region->mNext = sRegions;
+    sRegions = region;
+    sReservedPages += pageCount;
+    return ESP_OK;
+}
+
+void MemoryArena::unreserve(size_t pageCount) noexcept
+{
+    ArenaLock lock;
+    sReservedPages = (pageCount < sReservedPages) ? sReservedPages - pageCount : 0;
+
+    size_t regionPages = 0;
+    for (Region* region = sRegions; region != nullptr; region = region->mNext) {
+        regionPages += region->mPageCount;
+    }
+
+    // free the unused regions as long as the remaining ones cover the partitions still initialized
+    Region** link = &sRegions;
+    while (*link != nullptr) {
+        Region* region = *link;
+        if (region->mUsedCount == 0 && regionPages - region->mPageCount >= sReservedPages) {
+            regionPages -= region->mPageCount;
+            *link = region->mNext;
+            freeRegion(region);
+        } else {
+            link = &region->mNext;
+        }
+    }
+}
+
+void MemoryArena::getStats(nvs_arena_stats_t &stats) noexcept
+{
+    ArenaLock lock;
+    stats.total_size = sTotalSize;
+    stats.used_size = sUsedSize;
+    stats.peak_used_size = sPeakUsedSize;
+    stats.heap_fallbacks = sHeapFallbacks;
+}
+
+} // namespace nvs
+
+#endif // NVS_MEMORY_ARENA
@@ -1,15 +1,76 @@
 /*
- * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2022-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 #pragma once
 
 #include <cstdlib>
+#include <new>
+#include "sdkconfig.h"                  // For CONFIG_NVS_MEMORY_ARENA
+#include "esp_err.h"
 #if !ESP_TEE_BUILD
 #include "esp_heap_caps.h"
 #endif
 
+#if defined(CONFIG_NVS_MEMORY_ARENA) && !ESP_TEE_BUILD
+#define NVS_MEMORY_ARENA 1
+
+#include "nvs.h"                        // For nvs_arena_stats_t
+
+namespace nvs {
+
+/**
+ * @brief Pool of fixed size slots for the objects allocated by NVS.
+ *
+ * NVS keeps allocating and freeing small objects while it runs, most of them hash list blocks, which follow
+ * the items written to and erased from each page. Taken from the general heap, they fragment it over time.
+ *
+ * The arena holds slots of a few size classes in blocks allocated up front. When a partition is initialized,
+ * the arena reserves enough slots for the number of pages of the partition, so that the hash lists of all pages
+ * can be filled without allocating from the heap. Allocations too large for a slot, like the page array,
+ * and allocations finding no free slot of their class are served by the heap.
+ *
+ * All functions are safe to be called from multiple tasks.
+ */
+class MemoryArena {
+public:
+    /**
+     * Allocates size bytes from the smallest slot class which fits, or from the heap.
+     *
+     * @return pointer to the memory, nullptr if it couldn't be allocated
+     */
+    static void *allocate(size_t size) noexcept;
+
+    /**
+     * Returns memory obtained from allocate(), either to its slot class or to the heap.
+     */
+    static void release(void *obj) noexcept;
+
+    /**
+     * Adds the slots needed by a partition of pageCount pages to the arena.
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - ESP_ERR_NO_MEM if the slots can't be allocated
+     */
+    static esp_err_t reserve(size_t pageCount) noexcept;
+
+    /**
+     * Removes the slots reserved for a partition of pageCount pages. The memory of the slots is returned to
+     * the heap as soon as none of them is in use anymore.
+     */
+    static void unreserve(size_t pageCount) noexcept;
+
+    /**
+     * Fills stats with the current and peak usage of the arena.
+     */
+    static void getStats(nvs_arena_stats_t &stats) noexcept;
+};
+
+} // namespace nvs
+#endif // CONFIG_NVS_MEMORY_ARENA
+
 /**
  * @brief Type that is only usable with new (std::nothrow) to avoid exceptions.
  *
@@ -46,7 +107,8 @@ struct ExceptionlessAllocatable {
     static void *operator new[]( std::size_t ) = delete;
 
     /**
-     * Simple implementation with malloc(). No exceptions are thrown if the allocation fails.
+     * Simple implementation with malloc(), or with the NVS memory arena if enabled. No exceptions are thrown
+     * if the allocation fails.
      * To use this operator, your type must inherit from this class and then allocate with:
      * @code{c}
      * new (std::nothrow) <YourType>;                           // default constructor
@@ -54,7 +116,9 @@ struct ExceptionlessAllocatable {
      * @endcode
      */
     void *operator new (size_t size, const std::nothrow_t&) noexcept {
-#ifdef CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM
+#ifdef NVS_MEMORY_ARENA
+        return nvs::MemoryArena::allocate(size);
+#elif defined(CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM)
         return heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT | MALLOC_CAP_SPIRAM,
                                                 MALLOC_CAP_DEFAULT | MALLOC_CAP_INTERNAL);
 #else
@@ -63,7 +127,9 @@ struct ExceptionlessAllocatable {
     }
 
     void *operator new [](size_t size, const std::nothrow_t&) noexcept {
-#ifdef CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM
+#ifdef NVS_MEMORY_ARENA
+        return nvs::MemoryArena::allocate(size);
+#elif defined(CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM)
         return heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT | MALLOC_CAP_SPIRAM,
                                                 MALLOC_CAP_DEFAULT | MALLOC_CAP_INTERNAL);
 #else
@@ -75,7 +141,9 @@ struct ExceptionlessAllocatable {
      * Use \c delete as normal. This operator will be called automatically instead of the global one from libstdc++.
      */
     void operator delete (void *obj) noexcept {
-#ifdef CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM
+#ifdef NVS_MEMORY_ARENA
+        return nvs::MemoryArena::release(obj);
+#elif defined(CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM)
         return heap_caps_free(obj);
 #else
         return std::free(obj);
@@ -83,7 +151,9 @@ struct ExceptionlessAllocatable {
     }
 
     void operator delete [](void *obj) noexcept {
-#ifdef CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM
+#ifdef NVS_MEMORY_ARENA
+        return nvs::MemoryArena::release(obj);
+#elif defined(CONFIG_NVS_ALLOCATE_CACHE_IN_SPIRAM)
         return heap_caps_free(obj);
 #else
         return std::free(obj);
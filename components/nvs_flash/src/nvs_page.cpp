@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -13,6 +13,8 @@
 
 namespace nvs {
 
+static const char* const BATCH_MARKER_KEY = "nvs.batch";
+
 Page::Page() : mPartition(nullptr) { }
 
 uint32_t Page::Header::calculateCrc32()
@@ -108,9 +110,12 @@ esp_err_t Page::writeEntry(const Item &item)
         return err;
     }
 
-    err = alterEntryState(mNextFreeEntry, EntryState::WRITTEN);
-    if (err != ESP_OK) {
-        return err;
+    // entries of an open batch are marked as written all at once by commitBatch()
+    if (mBatchBegin == INVALID_ENTRY) {
+        err = alterEntryState(mNextFreeEntry, EntryState::WRITTEN);
+        if (err != ESP_OK) {
+            return err;
+        }
     }
 
     if (mFirstUsedEntry == INVALID_ENTRY) {
@@ -139,9 +144,11 @@ esp_err_t Page::writeEntryData(const uint8_t* data, size_t size)
         mState = PageState::INVALID;
         return rc;
     }
-    auto err = alterEntryRangeState(mNextFreeEntry, mNextFreeEntry + count, EntryState::WRITTEN);
-    if (err != ESP_OK) {
-        return err;
+    if (mBatchBegin == INVALID_ENTRY) {
+        auto err = alterEntryRangeState(mNextFreeEntry, mNextFreeEntry + count, EntryState::WRITTEN);
+        if (err != ESP_OK) {
+            return err;
+        }
     }
     mUsedEntryCount += count;
     mNextFreeEntry += count;
@@ -248,6 +255,122 @@ esp_err_t Page::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, c
     return ESP_OK;
 }
 
+bool Page::isBatchMarker(const Item& item)
+{
+    return item.nsIndex == NS_INDEX
+           && item.datatype == ItemType::U8
+           && item.chunkIndex == BATCH_MARKER_CHUNK_INDEX
+           && item.data[0] == 0
+           && strncmp(item.key, BATCH_MARKER_KEY, Item::MAX_KEY_LENGTH) == 0;
+}
+
+bool Page::hasBatchMarker()
+{
+    size_t itemIndex = 0;
+    Item item;
+    return findItem(NS_INDEX, ItemType::U8, BATCH_MARKER_KEY, itemIndex, item, BATCH_MARKER_CHUNK_INDEX) == ESP_OK;
+}
+
+esp_err_t Page::beginBatch(size_t entryCount, size_t& markerIndex)
+{
+    esp_err_t err;
+
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    NVS_ASSERT_OR_RETURN(mBatchBegin == INVALID_ENTRY, ESP_FAIL);
+    NVS_ASSERT_OR_RETURN(entryCount > 0 && entryCount < ENTRY_COUNT, ESP_FAIL);
+
+    if (mState == PageState::UNINITIALIZED) {
+        err = initialize();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if (mState == PageState::FULL) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    if (mNextFreeEntry == INVALID_ENTRY || mNextFreeEntry + 1 + entryCount > ENTRY_COUNT) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    Item item(NS_INDEX, ItemType::U8, 1, BATCH_MARKER_KEY, BATCH_MARKER_CHUNK_INDEX);
+    item.data[0] = 0;
+    item.data[1] = static_cast<uint8_t>(entryCount);
+    item.crc32 = item.calculateCrc32();
+
+    err = mHashList.insert(item, mNextFreeEntry);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    markerIndex = mNextFreeEntry;
+    err = writeEntry(item);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    mBatchBegin = mNextFreeEntry;
+    return ESP_OK;
+}
+
+esp_err_t Page::commitBatch()
+{
+    NVS_ASSERT_OR_RETURN(mBatchBegin != INVALID_ENTRY, ESP_FAIL);
+
+    size_t begin = mBatchBegin;
+    mBatchBegin = INVALID_ENTRY;
+    if (mNextFreeEntry == begin) {
+        return ESP_OK;
+    }
+
+    auto err = alterEntryRangeState(begin, mNextFreeEntry, EntryState::WRITTEN);
+    if (err != ESP_OK) {
+        // the batch may be committed only partially, it will be discarded on the next load
+        mState = PageState::INVALID;
+        return err;
+    }
+    return ESP_OK;
+}
+
+esp_err_t Page::abortBatch()
+{
+    NVS_ASSERT_OR_RETURN(mBatchBegin != INVALID_ENTRY, ESP_FAIL);
+
+    size_t markerIndex = mBatchBegin - 1;
+    size_t begin = mBatchBegin;
+    mBatchBegin = INVALID_ENTRY;
+
+    if (mState == PageState::INVALID) {
+        // the batch will be discarded on the next load
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    if (mNextFreeEntry > begin) {
+        for (size_t i = begin; i < mNextFreeEntry; ++i) {
+            mHashList.erase(i);
+        }
+        auto err = alterEntryRangeState(begin, mNextFreeEntry, EntryState::ERASED);
+        if (err != ESP_OK) {
+            mState = PageState::INVALID;
+            return err;
+        }
+        mUsedEntryCount -= mNextFreeEntry - begin;
+        mErasedEntryCount += mNextFreeEntry - begin;
+        if (DEFAULT_PURGE_AFTER_ERASE) {
+            err = purgeEntryRange(begin, mNextFreeEntry);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+
+    return eraseEntryAndSpan(markerIndex, DEFAULT_PURGE_AFTER_ERASE);
+}
+
 // Reads the data entries of the variable length item.
 // The metadata entry is already read in the item object.
 // index is the index of the metadata entry on the page.
@@ -276,10 +399,70 @@ esp_err_t Page::readVariableLengthItemData(const Item& item, const size_t index,
         dst += willCopy;
     }
     if (Item::calculateCrc32(reinterpret_cast<uint8_t * >(data), item.varLength.dataSize) != item.varLength.dataCrc32) {
-        rc = eraseEntryAndSpan(index, DEFAULT_PURGE_AFTER_ERASE);
+        if (mayRepair()) {
+            rc = eraseEntryAndSpan(index, DEFAULT_PURGE_AFTER_ERASE);
+            if (rc != ESP_OK) {
+                return rc;
+            }
+        }
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t Page::readVariableLengthItemData(const Item& item, const size_t index, size_t begin, size_t end, size_t baseOffset,
+                                           nvs_blob_read_cb_t callback, void* arg)
+{
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    NVS_ASSERT_OR_RETURN(begin <= end && end <= item.varLength.dataSize, ESP_FAIL);
+
+    esp_err_t rc;
+    uint8_t buf[STREAM_BUFFER_SIZE];
+    uint32_t crc32 = 0xffffffff;
+    const size_t bufEntries = sizeof(buf) / ENTRY_SIZE;
+    size_t dataOffset = 0;
+    size_t left = item.varLength.dataSize;
+    const size_t dataEnd = index + item.span;
+    for (size_t i = index + 1; i < dataEnd;) {
+        size_t entries = std::min(bufEntries, dataEnd - i);
+        uint32_t phyAddr;
+        rc = getEntryAddress(i, &phyAddr);
         if (rc != ESP_OK) {
             return rc;
         }
+        const size_t readSize = entries * ENTRY_SIZE;
+        rc = mPartition->read(phyAddr, buf, readSize);
+        if (rc != ESP_OK) {
+            return rc;
+        }
+
+        size_t size = std::min(left, readSize);
+        crc32 = Item::calculateCrc32(buf, size, &crc32);
+
+        size_t from = std::max(begin, dataOffset);
+        size_t to = std::min(end, dataOffset + size);
+        if (from < to) {
+            rc = callback(buf + (from - dataOffset), baseOffset + from, to - from, arg);
+            if (rc != ESP_OK) {
+                return rc;
+            }
+        }
+
+        dataOffset += size;
+        left -= size;
+        i += entries;
+    }
+
+    if (crc32 != item.varLength.dataCrc32) {
+        if (mayRepair()) {
+            rc = eraseEntryAndSpan(index, DEFAULT_PURGE_AFTER_ERASE);
+            if (rc != ESP_OK) {
+                return rc;
+            }
+        }
         return ESP_ERR_NVS_NOT_FOUND;
     }
     return ESP_OK;
@@ -636,6 +819,71 @@ esp_err_t Page::copyItems(Page &other)
     return ESP_OK;
 }
 
+esp_err_t Page::moveItems(Page& other, size_t maxEntries, size_t& movedEntries)
+{
+    movedEntries = 0;
+
+    if (other.mState == PageState::UNINITIALIZED) {
+        auto err = other.initialize();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    Item entry;
+    esp_err_t err;
+
+    while (mFirstUsedEntry != INVALID_ENTRY) {
+        const size_t index = mFirstUsedEntry;
+        err = readEntry(index, entry);
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        size_t span = entry.span;
+        NVS_ASSERT_OR_RETURN(span > 0 && index + span <= ENTRY_COUNT, ESP_FAIL);
+
+        if (movedEntries > 0 && movedEntries + span > maxEntries) {
+            break;
+        }
+
+        if (other.mState != PageState::ACTIVE || other.mNextFreeEntry + span > ENTRY_COUNT) {
+            return ESP_ERR_NVS_PAGE_FULL;
+        }
+
+        err = other.mHashList.insert(entry, other.mNextFreeEntry);
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        err = other.writeEntry(entry);
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        for (size_t i = index + 1; i < index + span; ++i) {
+            err = readEntry(i, entry);
+            if (err != ESP_OK) {
+                return err;
+            }
+            err = other.writeEntry(entry);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+
+        // the whole page is erased once it is empty, so the data doesn't need to be purged
+        err = eraseEntryAndSpan(index, false);
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        movedEntries += span;
+    }
+
+    return ESP_OK;
+}
+
 esp_err_t Page::mLoadEntryTable()
 {
     // for states where we actually care about data in the page, read entry state table
@@ -683,6 +931,12 @@ esp_err_t Page::mLoadEntryTable()
             }
         }
 
+        err = discardUncommittedBatch();
+        if (err != ESP_OK) {
+            mState = PageState::INVALID;
+            return err;
+        }
+
         // however, if power failed after some data was written into the entry.
         // but before the entry state table was altered, the entry locacted via
         // entry state table may actually be half-written.
@@ -884,6 +1138,68 @@ esp_err_t Page::mLoadEntryTable()
     return ESP_OK;
 }
 
+// If power went off while a batch was written, the batch marker is the last entry marked as written
+// and at least the first entry of the batch itself is still marked as empty. The batch entries may be
+// programmed only partially and are not necessarily recognized as half-written entries one by one,
+// so the whole range recorded in the marker is erased, followed by the marker itself.
+esp_err_t Page::discardUncommittedBatch()
+{
+    if (mNextFreeEntry == INVALID_ENTRY || mNextFreeEntry == 0) {
+        return ESP_OK;
+    }
+
+    size_t markerIndex = mNextFreeEntry - 1;
+    EntryState state;
+    esp_err_t err = mEntryTable.get(markerIndex, &state);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (state != EntryState::WRITTEN) {
+        return ESP_OK;
+    }
+
+    Item item;
+    err = readEntry(markerIndex, item);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (!item.checkHeaderConsistency(markerIndex) || !isBatchMarker(item)) {
+        return ESP_OK;
+    }
+
+    size_t end = mNextFreeEntry + getBatchEntryCount(item);
+    if (end > ENTRY_COUNT) {
+        end = ENTRY_COUNT;
+    }
+    if (end > mNextFreeEntry) {
+        for (size_t i = mNextFreeEntry; i < end; ++i) {
+            err = mEntryTable.get(i, &state);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (state == EntryState::WRITTEN) {
+                --mUsedEntryCount;
+            }
+            if (state != EntryState::ERASED) {
+                ++mErasedEntryCount;
+            }
+        }
+        err = alterEntryRangeState(mNextFreeEntry, end, EntryState::ERASED);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (DEFAULT_PURGE_AFTER_ERASE) {
+            err = purgeEntryRange(mNextFreeEntry, end);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+        mNextFreeEntry = end;
+    }
+
+    return eraseEntryAndSpan(markerIndex, DEFAULT_PURGE_AFTER_ERASE);
+}
+
 esp_err_t Page::initialize()
 {
     NVS_ASSERT_OR_RETURN(mState == PageState::UNINITIALIZED, ESP_FAIL);
@@ -1057,11 +1373,16 @@ esp_err_t Page::findItem(uint8_t nsIndex, ItemType datatype, const char* key, si
 
         rc = readEntry(i, item);
         if (rc != ESP_OK) {
-            mState = PageState::INVALID;
+            if (mayRepair()) {
+                mState = PageState::INVALID;
+            }
             return rc;
         }
 
         if (!item.checkHeaderConsistency(i)) {
+            if (!mayRepair()) {
+                continue;
+            }
             rc = eraseEntryAndSpan(i, DEFAULT_PURGE_AFTER_ERASE);
             if (rc != ESP_OK) {
                 mState = PageState::INVALID;
@@ -1200,6 +1521,16 @@ esp_err_t Page::markFull()
     return alterPageState(PageState::FULL);
 }
 
+size_t Page::getFreeEntryCount() const
+{
+    if (mState == PageState::UNINITIALIZED) {
+        return ENTRY_COUNT;
+    } else if (mState != PageState::ACTIVE || mNextFreeEntry >= ENTRY_COUNT) {
+        return 0;
+    }
+    return ENTRY_COUNT - mNextFreeEntry;
+}
+
 size_t Page::getVarDataTailroom() const
 {
     if (mState == PageState::UNINITIALIZED) {
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -10,6 +10,7 @@
 #include "intrusive_list.h"
 #include "nvs_item_hash_list.hpp"
 #include "partition.hpp"
+#include "nvs_platform.hpp"
 
 namespace nvs
 {
@@ -36,6 +37,8 @@ public:
 
     static const size_t CHUNK_MAX_SIZE = ENTRY_SIZE * (ENTRY_COUNT - 1);
 
+    static const size_t STREAM_BUFFER_SIZE = ENTRY_SIZE * 8;
+
     static const uint8_t NS_INDEX = NVS_CONST_NS_INDEX;
     static const uint8_t NS_ANY = NVS_CONST_NS_ANY;
 
@@ -43,6 +46,10 @@ public:
 
     static const uint8_t NVS_VERSION = NVS_CONST_NVS_VERSION; // Decrement to upgrade
 
+    // Batch markers live in the namespace of namespaces. Namespace entries always use CHUNK_ANY and a non-zero
+    // value, so neither the hash nor the value of a marker can match a namespace entry.
+    static const uint8_t BATCH_MARKER_CHUNK_INDEX = 0;
+
     enum class PageState : uint32_t {
         // All bits set, default state after flash erase. Page has not been initialized yet.
         UNINITIALIZED = NVS_CONST_PAGE_STATE_UNINITIALIZED,
@@ -74,6 +81,16 @@ public:
 
     esp_err_t load(Partition *partition, uint32_t sectorNumber);
 
+    void setKeyIndex(KeyIndex* keyIndex)
+    {
+        mHashList.setKeyIndex(keyIndex, this);
+    }
+
+    void setLock(const StorageLock* lock)
+    {
+        mLock = lock;
+    }
+
     esp_err_t getSeqNumber(uint32_t& seqNumber) const;
 
     esp_err_t setSeqNumber(uint32_t seqNumber);
@@ -84,6 +101,18 @@ public:
 
     esp_err_t readVariableLengthItemData(const Item& item, const size_t index, void* data);
 
+    /**
+     * Reads the data of a variable length item in pieces of at most STREAM_BUFFER_SIZE bytes,
+     * without a buffer for the whole data.
+     *
+     * Bytes [begin, end) of the data are passed to callback, with their offset in the data increased by baseOffset.
+     * The whole data is read to check its CRC. If the CRC doesn't match, the item is erased and ESP_ERR_NVS_NOT_FOUND
+     * is returned, after the callback has received the data already. An error returned by callback stops the read
+     * and is returned.
+     */
+    esp_err_t readVariableLengthItemData(const Item& item, const size_t index, size_t begin, size_t end, size_t baseOffset,
+                                         nvs_blob_read_cb_t callback, void* arg);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
 
     esp_err_t cmpItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
@@ -133,12 +162,52 @@ public:
     }
     size_t getVarDataTailroom() const ;
 
+    size_t getFreeEntryCount() const;
+
+    /**
+     * Starts writing a batch of entryCount entries to this page.
+     *
+     * Writes a marker entry recording the size of the batch. Items written until commitBatch() is called
+     * are programmed to flash, but their entries are not marked as written in the entry state table yet.
+     * commitBatch() then marks all of them as written at once.
+     *
+     * If power goes off before the batch is committed, the whole batch is discarded when the page is loaded.
+     * If it goes off after the commit but before the marker was erased, Storage::init finishes the batch
+     * by erasing the values the batch replaced.
+     */
+    esp_err_t beginBatch(size_t entryCount, size_t& markerIndex);
+
+    esp_err_t commitBatch();
+
+    esp_err_t abortBatch();
+
+    static bool isBatchMarker(const Item& item);
+
+    bool hasBatchMarker();
+
+    static size_t getBatchEntryCount(const Item& marker)
+    {
+        return marker.data[1];
+    }
+
     esp_err_t markFull();
 
     esp_err_t markFreeing();
 
     esp_err_t copyItems(Page& other);
 
+    /**
+     * Moves items from the beginning of this page to the page other, erasing each item after its copy was written.
+     *
+     * Unlike copyItems(), the page doesn't need to be in FREEING state: moving an item is the same as writing
+     * a new value of it, so if power goes off between writing the copy and erasing the original,
+     * the duplicate is removed by the check PageManager::load does for the last written item.
+     *
+     * Stops before the item which would make movedEntries exceed maxEntries, but always moves at least one item.
+     * Returns ESP_ERR_NVS_PAGE_FULL if the next item doesn't fit into other.
+     */
+    esp_err_t moveItems(Page& other, size_t maxEntries, size_t& movedEntries);
+
     esp_err_t erase();
 
     void debugDump() const;
@@ -174,6 +243,8 @@ protected:
 
     esp_err_t mLoadEntryTable();
 
+    esp_err_t discardUncommittedBatch();
+
     esp_err_t initialize();
 
     esp_err_t alterEntryState(size_t index, EntryState state);
@@ -208,6 +279,16 @@ protected:
 
     static const char* pageStateToName(PageState ps);
 
+    /**
+     * Items found corrupted while reading are erased on the spot, except while the storage is read under a shared
+     * lock: other readers may walk the page at the same time. The item is skipped then, like an erased one,
+     * and erased by the next read or write that holds the lock exclusively.
+     */
+    bool mayRepair() const
+    {
+        return mLock == nullptr || !mLock->isShared();
+    }
+
 
 protected:
     uint32_t mBaseAddress = 0;
@@ -220,6 +301,7 @@ protected:
     size_t mFirstUsedEntry = INVALID_ENTRY;
     uint16_t mUsedEntryCount = 0;
     uint16_t mErasedEntryCount = 0;
+    size_t mBatchBegin = INVALID_ENTRY;
 
     /**
      * This hash list stores hashes of namespace index, key, and ChunkIndex for quick lookup when searching items.
@@ -228,6 +310,8 @@ protected:
 
     Partition *mPartition;
 
+    const StorageLock* mLock = nullptr;
+
     static const uint32_t HEADER_OFFSET = NVS_CONST_PAGE_HEADER_OFFSET;
     static const uint32_t ENTRY_TABLE_OFFSET = NVS_CONST_PAGE_ENTRY_TABLE_OFFSET;
     static const uint32_t ENTRY_DATA_OFFSET = NVS_CONST_PAGE_ENTRY_DATA_OFFSET;
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -9,7 +9,7 @@ using namespace std;
 
 namespace nvs
 {
-esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t sectorCount)
+esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t sectorCount, KeyIndex* keyIndex, const StorageLock* lock)
 {
     if (partition == nullptr) {
         return ESP_ERR_INVALID_ARG;
@@ -19,11 +19,15 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
     mPageCount = sectorCount;
     mPageList.clear();
     mFreePageList.clear();
+    mGcPage = nullptr;
     mPages.reset(new (nothrow) Page[sectorCount]);
 
     if (!mPages) return ESP_ERR_NO_MEM;
 
     for (uint32_t i = 0; i < sectorCount; ++i) {
+        // attach the index before loading so that it follows the recovery steps done during load as well
+        mPages[i].setKeyIndex(keyIndex);
+        mPages[i].setLock(lock);
         auto err = mPages[i].load(partition, baseSector + i);
         if (err != ESP_OK) {
             return err;
@@ -150,12 +154,19 @@ esp_err_t PageManager::requestNewPage()
     // find the page with the highest number of erased items
     TPageListIterator maxUnusedItemsPageIt;
     size_t maxUnusedItems = 0;
-    for (auto it = begin(); it != end(); ++it) {
+    if (mGcPage != nullptr) {
+        // finish the page the incremental reclaim has started with, it has been partially emptied already
+        maxUnusedItemsPageIt = TPageListIterator(mGcPage);
+        maxUnusedItems = Page::ENTRY_COUNT - mGcPage->getUsedEntryCount();
+        mGcPage = nullptr;
+    } else {
+        for (auto it = begin(); it != end(); ++it) {
 
-        auto unused =  Page::ENTRY_COUNT - it->getUsedEntryCount();
-        if (unused > maxUnusedItems) {
-            maxUnusedItemsPageIt = it;
-            maxUnusedItems = unused;
+            auto unused =  Page::ENTRY_COUNT - it->getUsedEntryCount();
+            if (unused > maxUnusedItems) {
+                maxUnusedItemsPageIt = it;
+                maxUnusedItems = unused;
+            }
         }
     }
 
@@ -202,6 +213,70 @@ esp_err_t PageManager::requestNewPage()
     return ESP_OK;
 }
 
+esp_err_t PageManager::gcStep(size_t maxEntries, bool& pending)
+{
+    pending = false;
+
+    if (mGcPage == nullptr) {
+        if (mFreePageList.size() >= GC_FREE_PAGE_TARGET) {
+            return ESP_OK;
+        }
+        mGcPage = findGcVictim();
+        if (mGcPage == nullptr) {
+            return ESP_OK;
+        }
+    }
+
+    Page* victim = mGcPage;
+    if (victim->getUsedEntryCount() == 0) {
+        auto err = victim->erase();
+        if (err != ESP_OK) {
+            return err;
+        }
+        mPageList.erase(TPageListIterator(victim));
+        mFreePageList.push_back(victim);
+        mGcPage = nullptr;
+        return ESP_OK;
+    }
+
+    size_t movedEntries;
+    auto err = victim->moveItems(back(), maxEntries, movedEntries);
+    if (err == ESP_ERR_NVS_PAGE_FULL) {
+        // the space the victim was picked for was taken by other writes meanwhile,
+        // the victim is reclaimed by the next requestNewPage()
+        return ESP_OK;
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    pending = true;
+    return ESP_OK;
+}
+
+Page* PageManager::findGcVictim()
+{
+    // the victim has to fit into the current page, moving its items must not require activating another page
+    Page* current = &back();
+    const size_t freeEntries = current->getFreeEntryCount();
+    Page* victim = nullptr;
+    size_t maxUnusedItems = 0;
+
+    for (auto it = begin(); it != end(); ++it) {
+        Page* p = it;
+        if (p == current || p->state() != Page::PageState::FULL || p->getUsedEntryCount() > freeEntries) {
+            continue;
+        }
+        auto unused = Page::ENTRY_COUNT - p->getUsedEntryCount();
+        // items of a batch which wasn't finished have to stay behind its marker, such a page is left to requestNewPage()
+        if (unused > maxUnusedItems && !p->hasBatchMarker()) {
+            victim = p;
+            maxUnusedItems = unused;
+        }
+    }
+    return victim;
+}
+
 esp_err_t PageManager::activatePage()
 {
     if (mFreePageList.empty()) {
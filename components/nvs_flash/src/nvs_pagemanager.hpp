@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2019-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2019-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -22,7 +22,7 @@ public:
 
     PageManager() {}
 
-    esp_err_t load(Partition *partition, uint32_t baseSector, uint32_t sectorCount);
+    esp_err_t load(Partition *partition, uint32_t baseSector, uint32_t sectorCount, KeyIndex* keyIndex = nullptr, const StorageLock* lock = nullptr);
 
     TPageListIterator begin()
     {
@@ -45,6 +45,19 @@ public:
 
     esp_err_t requestNewPage();
 
+    /**
+     * Does one step of the incremental page reclaim.
+     *
+     * requestNewPage() has to reclaim a page synchronously if only the reserve page is free. The incremental reclaim
+     * does the same work ahead of time in small steps, so that a page is ready to be activated without erasing.
+     * It runs while fewer than GC_FREE_PAGE_TARGET pages are free: a step moves up to maxEntries entries
+     * from a victim page to the current page, the step after the last one erases the victim and adds it
+     * to the free pages. The reserve page is never used by it.
+     *
+     * pending is set to true if another step would do more work.
+     */
+    esp_err_t gcStep(size_t maxEntries, bool& pending);
+
     esp_err_t fillStats(nvs_stats_t& nvsStats);
 
     uint32_t getBaseSector()
@@ -57,12 +70,18 @@ protected:
 
     esp_err_t activatePage();
 
+    Page* findGcVictim();
+
+    // the reserve page and a page which can be activated without erasing it
+    static const size_t GC_FREE_PAGE_TARGET = 2;
+
     TPageList mPageList;
     TPageList mFreePageList;
     std::unique_ptr<Page[]> mPages;
     uint32_t mBaseSector;
     uint32_t mPageCount;
     uint32_t mSeqNumber;
+    Page* mGcPage = nullptr;
 }; // class PageManager
 
 } // namespace nvs
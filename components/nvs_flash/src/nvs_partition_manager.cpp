@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -71,7 +71,8 @@ error:
 esp_err_t NVSPartitionManager::init_custom(Partition *partition, uint32_t baseSector, uint32_t sectorCount)
 {
     Storage* new_storage = nullptr;
-    Storage* storage = lookup_storage_from_name(partition->get_partition_name());
+    // if the storage is loaded again, let the calls to it in other tasks finish
+    Storage* storage = lookup_unused_storage_from_name(partition->get_partition_name());
     if (storage == nullptr) {
         new_storage = new (std::nothrow) Storage(partition);
 
@@ -91,12 +92,26 @@ esp_err_t NVSPartitionManager::init_custom(Partition *partition, uint32_t baseSe
         }
     }
 
+#ifdef NVS_MEMORY_ARENA
+    if (new_storage != nullptr) {
+        // the objects of the storage come from the arena, reserve them according to the partition size
+        esp_err_t err = MemoryArena::reserve(sectorCount);
+        if (err != ESP_OK) {
+            delete new_storage;
+            return err;
+        }
+    }
+#endif
+
     esp_err_t err = storage->init(baseSector, sectorCount);
     if (new_storage != nullptr) {
         if (err == ESP_OK) {
             nvs_storage_list.push_back(new_storage);
         } else {
             delete new_storage;
+#ifdef NVS_MEMORY_ARENA
+            MemoryArena::unreserve(sectorCount);
+#endif
         }
     }
     return err;
@@ -145,7 +160,8 @@ esp_err_t NVSPartitionManager::secure_init_partition(const char *part_name, nvs_
 
 esp_err_t NVSPartitionManager::deinit_partition(const char *partition_label)
 {
-    Storage* storage = lookup_storage_from_name(partition_label);
+    /* Let the calls to the storage in other tasks finish, no new ones start while the caller holds the lock */
+    Storage* storage = lookup_unused_storage_from_name(partition_label);
     if (!storage) {
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
@@ -158,9 +174,18 @@ esp_err_t NVSPartitionManager::deinit_partition(const char *partition_label)
         }
     }
 
+    /* Write the values held in the write-back cache, the partition is deinitialized even if it fails */
+    storage->flushWriteCache();
+
     /* Finally delete the storage and its partition */
     nvs_storage_list.erase(storage);
+#ifdef NVS_MEMORY_ARENA
+    uint32_t pageCount = storage->getPageCount();
+#endif
     delete storage;
+#ifdef NVS_MEMORY_ARENA
+    MemoryArena::unreserve(pageCount);
+#endif
 
     for (auto it = nvs_partition_list.begin(); it != nvs_partition_list.end(); ++it) {
         if (strcmp(it->get_partition_name(), partition_label) == 0) {
@@ -202,7 +227,13 @@ esp_err_t NVSPartitionManager::open_handle(const char *part_name,
     }
 
 
-    esp_err_t err = sHandle->createOrOpenNamespace(ns_name, WANTS_WRITE_MODE(open_mode), nsIndex);
+    esp_err_t err;
+    {
+        StorageAccess access(WANTS_WRITE_MODE(open_mode) ? StorageAccess::Mode::WRITE : StorageAccess::Mode::READ);
+        access.attach(sHandle);
+        access.acquire();
+        err = sHandle->createOrOpenNamespace(ns_name, WANTS_WRITE_MODE(open_mode), nsIndex);
+    }
     if (err != ESP_OK) {
         return err;
     }
@@ -246,4 +277,15 @@ Storage* NVSPartitionManager::lookup_storage_from_name(const char* name)
     return it;
 }
 
+Storage* NVSPartitionManager::lookup_unused_storage_from_name(const char* name)
+{
+    Storage* storage = lookup_storage_from_name(name);
+    while (storage != nullptr && storage->getLock().hasUsers()) {
+        // the users may need Lock to finish, and the storage may be deinitialized meanwhile
+        Lock::yield();
+        storage = lookup_storage_from_name(name);
+    }
+    return storage;
+}
+
 } // nvs
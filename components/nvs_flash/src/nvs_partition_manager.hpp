@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,6 +27,12 @@ public:
 
     Storage* lookup_storage_from_name(const char* name);
 
+    /**
+     * Looks up the storage once the calls to it in other tasks are done. Must be called with Lock held, which is
+     * released while waiting for them, and no new calls start until it is released again.
+     */
+    Storage* lookup_unused_storage_from_name(const char* name);
+
     esp_err_t open_handle(const char *part_name, const char *ns_name, nvs_open_mode_t open_mode, NVSHandleSimple** handle);
 
     esp_err_t close_handle(NVSHandleSimple* handle);
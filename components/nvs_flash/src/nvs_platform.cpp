@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -7,14 +7,78 @@
 
 using namespace nvs;
 
-#if LINUX_TARGET || ESP_TEE_BUILD
+#if ESP_TEE_BUILD
 Lock::Lock() {}
 Lock::~Lock() {}
 esp_err_t nvs::Lock::init() {return ESP_OK;}
 void Lock::uninit() {}
+void Lock::yield() {}
+
+StorageLock::StorageLock() {}
+StorageLock::~StorageLock() {}
+void StorageLock::lock() {}
+void StorageLock::unlock() {}
+void StorageLock::lockShared() {}
+void StorageLock::unlockShared() {}
+#elif LINUX_TARGET
+
+#include <thread>
+
+Lock::Lock()
+{
+    mMutex.lock();
+}
+
+Lock::~Lock()
+{
+    mMutex.unlock();
+}
+
+esp_err_t nvs::Lock::init() {return ESP_OK;}
+void Lock::uninit() {}
+
+void Lock::yield()
+{
+    mMutex.unlock();
+    std::this_thread::yield();
+    mMutex.lock();
+}
+
+std::mutex Lock::mMutex;
+
+StorageLock::StorageLock() {}
+StorageLock::~StorageLock() {}
+
+void StorageLock::lock()
+{
+    mTurnstile.lock();
+    mMutex.lock();
+}
+
+void StorageLock::unlock()
+{
+    mMutex.unlock();
+    mTurnstile.unlock();
+}
+
+void StorageLock::lockShared()
+{
+    // std::shared_mutex may prefer readers, pass the turnstile so that a waiting writer goes first
+    mTurnstile.lock();
+    mTurnstile.unlock();
+    mMutex.lock_shared();
+    ++mReaders;
+}
+
+void StorageLock::unlockShared()
+{
+    --mReaders;
+    mMutex.unlock_shared();
+}
 #else
 
 #include "sys/lock.h"
+#include "freertos/task.h"
 
 Lock::Lock()
 {
@@ -45,6 +109,64 @@ void Lock::uninit()
     }
 }
 
+void Lock::yield()
+{
+    _lock_release(&mSemaphore);
+    vTaskDelay(1);
+    _lock_acquire(&mSemaphore);
+}
+
 _lock_t Lock::mSemaphore = 0;
 
+StorageLock::StorageLock()
+{
+    mRoom = xSemaphoreCreateBinaryStatic(&mRoomBuffer);
+    xSemaphoreGive(mRoom);
+}
+
+StorageLock::~StorageLock()
+{
+    vSemaphoreDelete(mRoom);
+    if (mReadersLock) {
+        _lock_close(&mReadersLock);
+    }
+    if (mTurnstile) {
+        _lock_close(&mTurnstile);
+    }
+}
+
+void StorageLock::lock()
+{
+    _lock_acquire(&mTurnstile);
+    xSemaphoreTake(mRoom, portMAX_DELAY);
+}
+
+void StorageLock::unlock()
+{
+    xSemaphoreGive(mRoom);
+    _lock_release(&mTurnstile);
+}
+
+void StorageLock::lockShared()
+{
+    _lock_acquire(&mTurnstile);
+    _lock_release(&mTurnstile);
+
+    _lock_acquire(&mReadersLock);
+    if (mReaders.load() == 0) {
+        xSemaphoreTake(mRoom, portMAX_DELAY);
+    }
+    ++mReaders;
+    _lock_release(&mReadersLock);
+}
+
+void StorageLock::unlockShared()
+{
+    _lock_acquire(&mReadersLock);
+    if (--mReaders == 0) {
+        xSemaphoreGive(mRoom);
+    }
+    _lock_release(&mReadersLock);
+}
+
 #endif
@@ -1,13 +1,22 @@
 /*
- * SPDX-FileCopyrightText: 2015-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include "esp_err.h"
-#ifndef LINUX_TARGET
+#ifdef LINUX_TARGET
+#include <mutex>
+#include <shared_mutex>
+#else
 #include <sys/lock.h>
+#if !ESP_TEE_BUILD
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#endif
 #endif
 
 namespace nvs
@@ -19,9 +28,85 @@ namespace nvs
         ~Lock();
         static esp_err_t init();
         static void uninit();
-#ifndef LINUX_TARGET
+
+        /**
+         * Releases Lock, held by the caller, lets the other tasks run and takes Lock again. Whatever was looked up
+         * under Lock may have changed meanwhile.
+         */
+        static void yield();
     private:
+#ifdef LINUX_TARGET
+        static std::mutex mMutex;
+#else
         static _lock_t mSemaphore;
 #endif
     };
+
+    /**
+     * Reader/writer lock of one storage.
+     *
+     * Any number of readers or a single writer hold the lock at a time. A writer waiting for the lock keeps new readers
+     * from taking it, so that a steady stream of reads doesn't starve the writes.
+     *
+     * The API functions look up the storage under Lock and register as its users before releasing Lock, then take this
+     * lock. The user count keeps the storage alive while they wait: deinitialization only goes on once it sees no users
+     * with Lock held, so that no new ones register. It waits for them with Lock::yield(), as they may need Lock to
+     * finish.
+     */
+    class StorageLock
+    {
+    public:
+        StorageLock();
+        ~StorageLock();
+
+        void lock();
+        void unlock();
+        void lockShared();
+        void unlockShared();
+
+        /**
+         * Whether the lock is held by readers. Called by a holder of the lock, true means that the caller is one of
+         * possibly several readers and must not modify the storage.
+         */
+        bool isShared() const
+        {
+            return mReaders.load() > 0;
+        }
+
+        void addUser()
+        {
+            ++mUsers;
+        }
+
+        void removeUser()
+        {
+            --mUsers;
+        }
+
+        /**
+         * Whether some API calls are registered as users. Called with Lock held, no new users register until it is
+         * released.
+         */
+        bool hasUsers() const
+        {
+            return mUsers.load() > 0;
+        }
+
+    private:
+#ifdef LINUX_TARGET
+        // Held by a writer while it waits for and holds the lock, readers pass it on their way in
+        std::mutex mTurnstile;
+        std::shared_mutex mMutex;
+#elif !ESP_TEE_BUILD
+        // Held by a writer while it waits for and holds the lock, readers pass it on their way in
+        _lock_t mTurnstile = 0;
+        // Guards mReaders while the first reader takes or the last one gives mRoom
+        _lock_t mReadersLock = 0;
+        // Held by the writer or by the readers as a group, hence a semaphore without owner
+        SemaphoreHandle_t mRoom;
+        StaticSemaphore_t mRoomBuffer;
+#endif
+        std::atomic<uint32_t> mReaders{0};
+        std::atomic<uint32_t> mUsers{0};
+    };
 } // namespace nvs
@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_sector_cache.hpp"
+#include "nvs_constants.h"
+#include <cstring>
+#include <new>
+
+namespace nvs
+{
+
+SectorCache::~SectorCache()
+{
+    disable();
+}
+
+esp_err_t SectorCache::enable()
+{
+    if (mBuffer == nullptr) {
+        mBuffer = new (std::nothrow) uint8_t[NVS_CONST_PAGE_SIZE];
+        if (mBuffer == nullptr) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    mSectorAddress = INVALID_SECTOR;
+    return ESP_OK;
+}
+
+void SectorCache::disable()
+{
+    delete[] mBuffer;
+    mBuffer = nullptr;
+    mSectorAddress = INVALID_SECTOR;
+}
+
+bool SectorCache::readCached(size_t offset, void* dst, size_t size, size_t regionBegin, size_t regionEnd, bool raw, esp_err_t& err)
+{
+    if (mBuffer == nullptr) {
+        return false;
+    }
+    const size_t sectorAddress = offset - offset % NVS_CONST_PAGE_SIZE;
+    const size_t sectorOffset = offset - sectorAddress;
+    if (sectorOffset < regionBegin || sectorOffset + size > regionEnd) {
+        return false;
+    }
+
+    if (sectorAddress != mSectorAddress) {
+        mSectorAddress = sectorAddress;
+        mHeaderValid = false;
+        mEntriesValid = false;
+    }
+    bool& valid = raw ? mHeaderValid : mEntriesValid;
+    if (!valid) {
+        if (raw) {
+            err = mPartition->read_raw(sectorAddress + regionBegin, mBuffer + regionBegin, regionEnd - regionBegin);
+        } else {
+            err = mPartition->read(sectorAddress + regionBegin, mBuffer + regionBegin, regionEnd - regionBegin);
+        }
+        if (err != ESP_OK) {
+            return true;
+        }
+        valid = true;
+    }
+    memcpy(dst, mBuffer + sectorOffset, size);
+    err = ESP_OK;
+    return true;
+}
+
+void SectorCache::invalidate(size_t offset, size_t size)
+{
+    if (mSectorAddress != INVALID_SECTOR && offset < mSectorAddress + NVS_CONST_PAGE_SIZE && offset + size > mSectorAddress) {
+        mSectorAddress = INVALID_SECTOR;
+    }
+}
+
+const char *SectorCache::get_partition_name()
+{
+    return mPartition->get_partition_name();
+}
+
+esp_err_t SectorCache::read_raw(size_t src_offset, void* dst, size_t size)
+{
+    // page header and entry state table are stored unencrypted
+    esp_err_t err;
+    if (readCached(src_offset, dst, size, NVS_CONST_PAGE_HEADER_OFFSET, NVS_CONST_PAGE_ENTRY_DATA_OFFSET, true, err)) {
+        return err;
+    }
+    return mPartition->read_raw(src_offset, dst, size);
+}
+
+esp_err_t SectorCache::read(size_t src_offset, void* dst, size_t size)
+{
+    esp_err_t err;
+    if (readCached(src_offset, dst, size, NVS_CONST_PAGE_ENTRY_DATA_OFFSET, NVS_CONST_PAGE_SIZE, false, err)) {
+        return err;
+    }
+    return mPartition->read(src_offset, dst, size);
+}
+
+esp_err_t SectorCache::write_raw(size_t dst_offset, const void* src, size_t size)
+{
+    invalidate(dst_offset, size);
+    return mPartition->write_raw(dst_offset, src, size);
+}
+
+esp_err_t SectorCache::write(size_t dst_offset, const void* src, size_t size)
+{
+    invalidate(dst_offset, size);
+    return mPartition->write(dst_offset, src, size);
+}
+
+esp_err_t SectorCache::erase_range(size_t dst_offset, size_t size)
+{
+    invalidate(dst_offset, size);
+    return mPartition->erase_range(dst_offset, size);
+}
+
+uint32_t SectorCache::get_address()
+{
+    return mPartition->get_address();
+}
+
+uint32_t SectorCache::get_size()
+{
+    return mPartition->get_size();
+}
+
+bool SectorCache::get_readonly()
+{
+    return mPartition->get_readonly();
+}
+
+} // namespace nvs
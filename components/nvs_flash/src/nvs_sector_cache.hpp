@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include "partition.hpp"
+
+namespace nvs
+{
+
+/**
+ * Read cache of one sector, placed between the pages of a Storage and its partition.
+ *
+ * Loading the storage reads the item headers of every page several times: to rebuild the hash lists, to list
+ * the namespaces and to check the blobs. While the cache is enabled, the page header together with the entry state
+ * table and the entry area of a sector are each read with one flash read, the following reads of the same sector
+ * are served from RAM. Any write or erase touching the cached sector drops its content.
+ *
+ * While disabled, all operations are forwarded to the wrapped partition.
+ */
+class SectorCache : public Partition
+{
+public:
+    SectorCache(Partition* partition) : mPartition(partition) { }
+
+    ~SectorCache() override;
+
+    /**
+     * Allocates the sector buffer.
+     *
+     * @return
+     *      - ESP_OK on success
+     *      - ESP_ERR_NO_MEM if the buffer can't be allocated, the reads are forwarded in that case
+     */
+    esp_err_t enable();
+
+    /**
+     * Frees the sector buffer, the reads are forwarded afterwards.
+     */
+    void disable();
+
+    const char *get_partition_name() override;
+
+    esp_err_t read_raw(size_t src_offset, void* dst, size_t size) override;
+
+    esp_err_t read(size_t src_offset, void* dst, size_t size) override;
+
+    esp_err_t write_raw(size_t dst_offset, const void* src, size_t size) override;
+
+    esp_err_t write(size_t dst_offset, const void* src, size_t size) override;
+
+    esp_err_t erase_range(size_t dst_offset, size_t size) override;
+
+    uint32_t get_address() override;
+
+    uint32_t get_size() override;
+
+    bool get_readonly() override;
+
+protected:
+    // Copies the range from the buffer if it lies within [regionBegin, regionEnd) of a sector, reading the region first if needed
+    bool readCached(size_t offset, void* dst, size_t size, size_t regionBegin, size_t regionEnd, bool raw, esp_err_t& err);
+
+    void invalidate(size_t offset, size_t size);
+
+    static const size_t INVALID_SECTOR = SIZE_MAX;
+
+    Partition* mPartition;
+    uint8_t* mBuffer = nullptr;
+    size_t mSectorAddress = INVALID_SECTOR;
+    bool mHeaderValid = false;
+    bool mEntriesValid = false;
+};
+
+} // namespace nvs
@@ -182,7 +182,23 @@ void Storage::eraseOrphanDataBlobs(TBlobIndexList& blobIdxList)
 
 esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
 {
-    auto err = mPageManager.load(mPartition, baseSector, sectorCount);
+    // Loading reads the items of each page several times, the repeated reads are served from the sector cache.
+    // Without memory for the cache, the storage is loaded reading the flash directly.
+    mSectorCache.enable();
+    auto err = load(baseSector, sectorCount);
+    mSectorCache.disable();
+    return err;
+}
+
+esp_err_t Storage::load(uint32_t baseSector, uint32_t sectorCount)
+{
+#ifdef CONFIG_NVS_KEY_INDEX
+    // The index is rebuilt from scratch while the pages are loaded
+    mKeyIndex.clear();
+    auto err = mPageManager.load(&mSectorCache, baseSector, sectorCount, &mKeyIndex, &mLock);
+#else
+    auto err = mPageManager.load(&mSectorCache, baseSector, sectorCount, nullptr, &mLock);
+#endif
     if(err != ESP_OK) {
         mState = StorageState::INVALID;
         return err;
@@ -196,6 +212,19 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
         size_t itemIndex = 0;
         Item item;
         while(p.findItem(Page::NS_INDEX, ItemType::U8, nullptr, itemIndex, item) == ESP_OK) {
+            if(Page::isBatchMarker(item)) {
+                // power went off before the previous values of a committed batch were erased
+                if(!mPartition->get_readonly()) {
+                    err = finishBatch(p, itemIndex, item);
+                    if(err != ESP_OK) {
+                        mState = StorageState::INVALID;
+                        return err;
+                    }
+                }
+                itemIndex += item.span;
+                continue;
+            }
+
             NamespaceEntry* entry = new (std::nothrow) NamespaceEntry;
 
             if(!entry) {
@@ -256,6 +285,20 @@ bool Storage::isValid() const
 
 esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex)
 {
+#ifdef CONFIG_NVS_KEY_INDEX
+    // The index can resolve the same lookups as the per-page hash lists, i.e. those with known <ns, key, chunk index>.
+    // Only the pages holding an item with matching hash are asked, in the order of the page list.
+    if(nsIndex != Page::NS_ANY && key != nullptr && (datatype != ItemType::BLOB_DATA || chunkIdx != Page::CHUNK_ANY)) {
+        Page* candidates[MAX_KEY_INDEX_CANDIDATES];
+        uint32_t hash = KeyIndex::calculateHash(Item(nsIndex, datatype, 0, key, chunkIdx));
+        size_t count = mKeyIndex.findPages(hash, candidates, MAX_KEY_INDEX_CANDIDATES);
+        if(count <= MAX_KEY_INDEX_CANDIDATES) {
+            return findItemInPages(candidates, count, nsIndex, datatype, key, page, item, chunkIdx, chunkStart, itemIndex);
+        }
+        // too many pages share the hash, search all of them
+    }
+#endif
+
     for(auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         size_t tmpItemIndex = 0;
         auto err = it->findItem(nsIndex, datatype, key, tmpItemIndex, item, chunkIdx, chunkStart);
@@ -270,6 +313,36 @@ esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key,
     return ESP_ERR_NVS_NOT_FOUND;
 }
 
+#ifdef CONFIG_NVS_KEY_INDEX
+esp_err_t Storage::findItemInPages(Page** pages, size_t count, uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex)
+{
+    // Order the candidates the same way as the page list, i.e. by ascending sequence number
+    uint32_t seqNumbers[MAX_KEY_INDEX_CANDIDATES];
+    for(size_t i = 0; i < count; ++i) {
+        if(pages[i]->getSeqNumber(seqNumbers[i]) != ESP_OK) {
+            seqNumbers[i] = UINT32_MAX;
+        }
+        for(size_t j = i; j > 0 && seqNumbers[j - 1] > seqNumbers[j]; --j) {
+            std::swap(seqNumbers[j - 1], seqNumbers[j]);
+            std::swap(pages[j - 1], pages[j]);
+        }
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        size_t tmpItemIndex = 0;
+        auto err = pages[i]->findItem(nsIndex, datatype, key, tmpItemIndex, item, chunkIdx, chunkStart);
+        if(err == ESP_OK) {
+            page = pages[i];
+            if(itemIndex) {
+                *itemIndex = tmpItemIndex;
+            }
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+#endif // CONFIG_NVS_KEY_INDEX
+
 esp_err_t Storage::writeMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize, VerOffset chunkStart, const bool purgeAfterErase)
 {
     uint8_t chunkCount = 0;
@@ -387,28 +460,14 @@ esp_err_t Storage::writeMultiPageBlob(uint8_t nsIndex, const char* key, const vo
     return err;
 }
 
-// datatype BLOB is written as BLOB_INDEX and BLOB_DATA and is searched for previous value as BLOB_INDEX and/or BLOB
-// datatype BLOB_INDEX and BLOB_DATA are not supported as input parameters, the layer above should always use BLOB
-esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase)
+// Looks up the value which a write of the given datatype under <nsIndex, key> replaces.
+// findPage stays nullptr if there is no such value. matchedTypePageFound is set if the datatype representation of
+// the value found matches the new one, i.e. if the values can be compared.
+esp_err_t Storage::findPreviousItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &findPage, Item& item, size_t& itemIndex, bool& matchedTypePageFound)
 {
-    if(mState != StorageState::ACTIVE) {
-        return ESP_ERR_NVS_NOT_INITIALIZED;
-    }
-
-    // pointer to the page where the existing item was found
-    Page* findPage = nullptr;
-    // index of the item in the page where the existing item was found
-    size_t itemIndex = 0;
-    // page sequence number helping to detect whether the page with old value was relocated during the new write
-    uint32_t findPageSeqNumber = UINT32_MAX;
-
-    // indicates the datatype representation match between the old value and the new one
-    bool matchedTypePageFound = false;
-
-    // contains the item with the old value, if found
-    Item item;
-
     esp_err_t err = ESP_OK;
+    findPage = nullptr;
+    matchedTypePageFound = false;
 
     // Try to find existing item with the same key and namespace index
     // We are performing the findItem with datatype specified (it is not ANY) to ensure the hash list lookup is done.
@@ -431,12 +490,6 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
             err = findItem(nsIndex, ItemType::BLOB, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
             if(err == ESP_OK && findPage != nullptr) {
                 matchedTypePageFound = false;   // datatype does not match, we cannot extract chunkStart from the item
-
-                // keep the sequence number of the page where the item was found for later check of relocation
-                err = findPage->getSeqNumber(findPageSeqNumber);
-                if(err != ESP_OK) {
-                    return err;
-                }
             }
         }
 #endif
@@ -445,12 +498,6 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
         err = findItem(nsIndex, datatype, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
         if(err == ESP_OK && findPage != nullptr) {
             matchedTypePageFound = true;
-
-            // keep the sequence number of the page where the item was found for later check of relocation
-            err = findPage->getSeqNumber(findPageSeqNumber);
-            if(err != ESP_OK) {
-                return err;
-            }
         }
     }
 
@@ -461,17 +508,59 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
         // We should not find BLOB_DATA chunks as CHUNK_ANY is never used by the BLOB_DATA.
         err = findItem(nsIndex, nvs::ItemType::ANY, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
         if(err == ESP_OK && findPage != nullptr) {
-            // keep the sequence number of the page where the item was found for later check of relocation
-            err = findPage->getSeqNumber(findPageSeqNumber);
-            if(err != ESP_OK) {
-                return err;
-            }
             // item was found with the same key and namespace index but data type is different
             matchedTypePageFound = false;
         }
     }
 #endif
 
+    return err;
+}
+
+// datatype BLOB is written as BLOB_INDEX and BLOB_DATA and is searched for previous value as BLOB_INDEX and/or BLOB
+// datatype BLOB_INDEX and BLOB_DATA are not supported as input parameters, the layer above should always use BLOB
+esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    if(mWriteCache.isEnabled()) {
+        if(WriteCache::isCacheable(nsIndex, datatype)) {
+            return writeCachedItem(nsIndex, datatype, key, data, dataSize, purgeAfterErase);
+        }
+
+        // a value of the key held in the cache is older than the one written now
+        esp_err_t err = flushCachedKey(nsIndex, key);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
+    return writeItemToFlash(nsIndex, datatype, key, data, dataSize, purgeAfterErase);
+}
+
+esp_err_t Storage::writeItemToFlash(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    // pointer to the page where the existing item was found
+    Page* findPage = nullptr;
+    // index of the item in the page where the existing item was found
+    size_t itemIndex = 0;
+    // page sequence number helping to detect whether the page with old value was relocated during the new write
+    uint32_t findPageSeqNumber = UINT32_MAX;
+
+    // indicates the datatype representation match between the old value and the new one
+    bool matchedTypePageFound = false;
+
+    // contains the item with the old value, if found
+    Item item;
+
+    esp_err_t err = findPreviousItem(nsIndex, datatype, key, findPage, item, itemIndex, matchedTypePageFound);
+
     // Here the findPage is either nullptr or points to the page where the item was found.
     // The matchedTypePageFound is true if the old value item was found and its datatype representation matches the new one.
     // This flag is used to determine if the item should be checked for same value.
@@ -479,6 +568,14 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
         return err;
     }
 
+    if(findPage != nullptr) {
+        // keep the sequence number of the page where the item was found for later check of relocation
+        err = findPage->getSeqNumber(findPageSeqNumber);
+        if(err != ESP_OK) {
+            return err;
+        }
+    }
+
     // Handle value update
     if(datatype == ItemType::BLOB) {
         VerOffset prevStart,  nextStart;
@@ -607,6 +704,334 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
     return err;
 }
 
+// Values of primitive types are kept in the cache until the cache is flushed or the entry is evicted,
+// repeated writes of a key only replace the cached value.
+esp_err_t Storage::writeCachedItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase)
+{
+    if(strlen(key) > Item::MAX_KEY_LENGTH) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    if(dataSize > sizeof(WriteCacheEntry::mValue)) {
+        return ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+
+    esp_err_t err;
+    WriteCacheEntry* entry = mWriteCache.find(nsIndex, key);
+    if(entry != nullptr && entry->mDatatype != datatype) {
+        // keep the order of the writes if the datatype of the key changes
+        err = flushCacheEntry(entry);
+        if(err != ESP_OK) {
+            return err;
+        }
+        entry = nullptr;
+    }
+
+    if(entry != nullptr) {
+        ++mWriteCache.mCoalescedCount;
+        mWriteCache.touch(entry);
+    } else {
+        if(mWriteCache.isFull()) {
+            err = flushCacheEntry(mWriteCache.leastRecentlyUsed());
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+
+        entry = new (std::nothrow) WriteCacheEntry;
+        if(entry == nullptr) {
+            // no memory to hold the value, write it directly
+            return writeItemToFlash(nsIndex, datatype, key, data, dataSize, purgeAfterErase);
+        }
+        entry->mNsIndex = nsIndex;
+        entry->mDatatype = datatype;
+        strlcpy(entry->mKey, key, sizeof(entry->mKey));
+        entry->mDirtySince = esp_log_timestamp();
+        mWriteCache.push(entry);
+    }
+
+    memcpy(entry->mValue, data, dataSize);
+    entry->mDataSize = static_cast<uint8_t>(dataSize);
+    entry->mPurgeAfterErase = purgeAfterErase;
+
+    if(mWriteCache.isFlushDue(esp_log_timestamp())) {
+        return flushWriteCache();
+    }
+    return ESP_OK;
+}
+
+// If the value can't be written, it stays in the cache for the next attempt
+esp_err_t Storage::flushCacheEntry(WriteCacheEntry* entry)
+{
+    esp_err_t err = writeItemToFlash(entry->mNsIndex, entry->mDatatype, entry->mKey, entry->mValue, entry->mDataSize, entry->mPurgeAfterErase);
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    ++mWriteCache.mFlushCount;
+    mWriteCache.mFlushedBytes += entry->mDataSize;
+    mWriteCache.remove(entry);
+    return ESP_OK;
+}
+
+esp_err_t Storage::flushCachedKey(uint8_t nsIndex, const char* key)
+{
+    WriteCacheEntry* entry = mWriteCache.find(nsIndex, key);
+    if(entry == nullptr) {
+        return ESP_OK;
+    }
+    return flushCacheEntry(entry);
+}
+
+esp_err_t Storage::flushWriteCache()
+{
+    esp_err_t result = ESP_OK;
+
+    for(auto it = mWriteCache.begin(); it != mWriteCache.end();) {
+        WriteCacheEntry* entry = it;
+        ++it;
+        esp_err_t err = flushCacheEntry(entry);
+        if(err != ESP_OK && result == ESP_OK) {
+            result = err;
+        }
+    }
+    return result;
+}
+
+esp_err_t Storage::setWriteCache(size_t maxEntries, uint32_t flushOnWriteAgeMs)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    esp_err_t err = flushWriteCache();
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    mWriteCache.configure(maxEntries, flushOnWriteAgeMs);
+    return ESP_OK;
+}
+
+void Storage::fillCacheStats(nvs_cache_stats_t& cacheStats)
+{
+    mWriteCache.fillStats(cacheStats);
+}
+
+esp_err_t Storage::gcStep(size_t maxEntries, bool& pending)
+{
+    pending = false;
+
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    if(mPartition->get_readonly()) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+
+    return mPageManager.gcStep(maxEntries, pending);
+}
+
+// All values of the batch are written to the current page behind a batch marker and become visible at once,
+// when their entries are marked as written. Only then the values they replace are erased, followed by the marker.
+esp_err_t Storage::writeBatch(uint8_t nsIndex, Batch& batch, const bool purgeAfterErase)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    if(batch.empty()) {
+        return ESP_OK;
+    }
+
+    // values held in the cache are older than the batch and must not overwrite it later
+    // the batch together with its marker has to fit into a single page
+    const size_t maxEntryCount = batch.getEntryCount() + 1;
+    if(maxEntryCount > Page::ENTRY_COUNT) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    esp_err_t err;
+
+    // Make room first, so that no page is relocated between looking up the previous values and erasing them
+    while(getCurrentPage().getFreeEntryCount() < maxEntryCount) {
+        Page& page = getCurrentPage();
+        size_t freeEntries = page.getFreeEntryCount();
+        if(page.state() != Page::PageState::FULL) {
+            err = page.markFull();
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+        err = mPageManager.requestNewPage();
+        if(err != ESP_OK) {
+            return err;
+        }
+        if(getCurrentPage().getFreeEntryCount() <= freeEntries) {
+            // we are not improving
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+    }
+
+    std::unique_ptr<BatchPreviousItem[]> previous(new (std::nothrow) BatchPreviousItem[batch.size()]);
+    if(!previous) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t entryCount = 0;
+    size_t i = 0;
+    for(auto it = batch.begin(); it != batch.end(); ++it, ++i) {
+        BatchPreviousItem& prev = previous[i];
+        bool matchedTypePageFound;
+        err = findPreviousItem(nsIndex, it->mDatatype, it->mKey, prev.mPage, prev.mItem, prev.mItemIndex, matchedTypePageFound);
+        if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
+
+        // values which are not modified are not written again
+        if(it->mDatatype == ItemType::BLOB) {
+            if(matchedTypePageFound) {
+                if(cmpMultiPageBlob(nsIndex, it->mKey, it->getData(), it->mDataSize) == ESP_OK) {
+                    prev.mUnchanged = true;
+                    continue;
+                }
+                NVS_ASSERT_OR_RETURN(prev.mItem.blobIndex.chunkStart == VerOffset::VER_0_OFFSET ||
+                                     prev.mItem.blobIndex.chunkStart == VerOffset::VER_1_OFFSET, ESP_FAIL);
+                prev.mNextStart = (prev.mItem.blobIndex.chunkStart == VerOffset::VER_1_OFFSET) ?
+                                  VerOffset::VER_0_OFFSET : VerOffset::VER_1_OFFSET;
+            }
+        } else if(matchedTypePageFound &&
+                prev.mPage->cmpItem(nsIndex, it->mDatatype, it->mKey, it->getData(), it->mDataSize) == ESP_OK) {
+            prev.mUnchanged = true;
+            continue;
+        }
+        entryCount += it->getEntryCount();
+    }
+
+    if(entryCount == 0) {
+        return ESP_OK;
+    }
+
+    Page& page = getCurrentPage();
+    size_t markerIndex;
+    err = page.beginBatch(entryCount, markerIndex);
+    if(err != ESP_OK) {
+        NVS_ASSERT_OR_RETURN(err != ESP_ERR_NVS_PAGE_FULL, err);
+        return err;
+    }
+
+    i = 0;
+    for(auto it = batch.begin(); it != batch.end() && err == ESP_OK; ++it, ++i) {
+        const BatchPreviousItem& prev = previous[i];
+        if(prev.mUnchanged) {
+            continue;
+        }
+        if(it->mDatatype == ItemType::BLOB) {
+            // the blob is stored in the multi-page format, using a single data chunk
+            err = page.writeItem(nsIndex, ItemType::BLOB_DATA, it->mKey, it->getData(), it->mDataSize, static_cast<uint8_t>(prev.mNextStart));
+            if(err == ESP_OK) {
+                Item item;
+                std::fill_n(item.data, sizeof(item.data), 0xff);
+                item.blobIndex.dataSize = it->mDataSize;
+                item.blobIndex.chunkCount = 1;
+                item.blobIndex.chunkStart = prev.mNextStart;
+                err = page.writeItem(nsIndex, ItemType::BLOB_IDX, it->mKey, item.data, sizeof(item.data));
+            }
+        } else {
+            err = page.writeItem(nsIndex, it->mDatatype, it->mKey, it->getData(), it->mDataSize);
+        }
+    }
+
+    if(err != ESP_OK) {
+        page.abortBatch();
+        NVS_ASSERT_OR_RETURN(err != ESP_ERR_NVS_PAGE_FULL, err);
+        return err;
+    }
+
+    err = page.commitBatch();
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    // Delete previous values
+    esp_err_t eraseErr = ESP_OK;
+    i = 0;
+    for(auto it = batch.begin(); it != batch.end(); ++it, ++i) {
+        const BatchPreviousItem& prev = previous[i];
+        if(prev.mUnchanged || prev.mPage == nullptr) {
+            continue;
+        }
+        if(prev.mItem.datatype == ItemType::BLOB_IDX) {
+            err = eraseMultiPageBlob(nsIndex, it->mKey, purgeAfterErase, prev.mItem.blobIndex.chunkStart);
+        } else {
+            err = prev.mPage->eraseEntryAndSpan(prev.mItemIndex, purgeAfterErase);
+        }
+        if(err != ESP_OK) {
+            eraseErr = err;
+        }
+    }
+
+    if(eraseErr != ESP_OK) {
+        // The marker is kept, the batch is finished by the next init
+        return (eraseErr == ESP_ERR_FLASH_OP_FAIL) ? ESP_ERR_NVS_REMOVE_FAILED : eraseErr;
+    }
+
+    err = page.eraseEntryAndSpan(markerIndex, purgeAfterErase);
+    if(err == ESP_ERR_FLASH_OP_FAIL) {
+        return ESP_ERR_NVS_REMOVE_FAILED;
+    }
+
+#ifdef DEBUG_STORAGE
+    debugCheck();
+#endif
+    return err;
+}
+
+// Finishes a batch which was committed, but whose marker is still present, i.e. power went off while the values
+// replaced by the batch were being erased. All items with the same key written before the batch are erased.
+esp_err_t Storage::finishBatch(Page& page, size_t markerIndex, const Item& marker)
+{
+    const size_t end = markerIndex + 1 + Page::getBatchEntryCount(marker);
+    size_t itemIndex = markerIndex + 1;
+    Item item;
+    esp_err_t err;
+
+    while(page.findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK && itemIndex < end) {
+        // data chunks of the replaced blobs are left without their index and are removed as orphans
+        if(item.datatype != ItemType::BLOB_DATA) {
+            for(auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
+                Page* p = it;
+                size_t prevIndex = 0;
+                Item prevItem;
+                while(p->findItem(item.nsIndex, ItemType::ANY, item.key, prevIndex, prevItem) == ESP_OK) {
+                    if(p == &page && prevIndex >= markerIndex) {
+                        break;
+                    }
+                    bool replaced = (prevItem.datatype != ItemType::BLOB_DATA);
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+                    // values of different datatypes may coexist under the same key
+                    replaced = replaced && (prevItem.datatype == item.datatype ||
+                                            (item.datatype == ItemType::BLOB_IDX && prevItem.datatype == ItemType::BLOB));
+#endif
+                    if(replaced) {
+                        err = p->eraseEntryAndSpan(prevIndex, Page::DEFAULT_PURGE_AFTER_ERASE);
+                        if(err != ESP_OK) {
+                            return err;
+                        }
+                    }
+                    prevIndex += prevItem.span;
+                }
+                if(p == &page) {
+                    break;
+                }
+            }
+        }
+        itemIndex += item.span;
+    }
+
+    return page.eraseEntryAndSpan(markerIndex, Page::DEFAULT_PURGE_AFTER_ERASE);
+}
+
 esp_err_t Storage::createOrOpenNamespace(const char* nsName, bool canCreate, uint8_t& nsIndex)
 {
     if(mState != StorageState::ACTIVE) {
@@ -706,8 +1131,8 @@ esp_err_t Storage::readMultiPageBlob(uint8_t nsIndex, const char* key, void* dat
         offset += item.varLength.dataSize;
     }
 
-    if(err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH) {
-        // cleanup if a chunk is not found or the size is inconsistent
+    if((err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH) && !mLock.isShared()) {
+        // cleanup if a chunk is not found or the size is inconsistent, left to the next exclusive access when reading shared
         eraseMultiPageBlob(nsIndex, key, Page::DEFAULT_PURGE_AFTER_ERASE);
     }
 
@@ -716,6 +1141,100 @@ esp_err_t Storage::readMultiPageBlob(uint8_t nsIndex, const char* key, void* dat
     return err;
 }
 
+esp_err_t Storage::readBlobStream(uint8_t nsIndex, const char* key, size_t offset, size_t size, nvs_blob_read_cb_t callback, void* arg)
+{
+    if(mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    Item item;
+    Page* findPage = nullptr;
+    size_t itemIndex = 0;
+
+    auto err = findItem(nsIndex, ItemType::BLOB_IDX, key, findPage, item);
+    if(err == ESP_ERR_NVS_NOT_FOUND) {
+        // blob may be stored with earlier version format without index
+        err = findItem(nsIndex, ItemType::BLOB, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
+        if(err != ESP_OK) {
+            return err;
+        }
+        if(offset > item.varLength.dataSize || size > item.varLength.dataSize - offset) {
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        return findPage->readVariableLengthItemData(item, itemIndex, offset, offset + size, 0, callback, arg);
+    }
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    const size_t blobSize = item.blobIndex.dataSize;
+    if(offset > blobSize || size > blobSize - offset) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    uint8_t chunkCount = item.blobIndex.chunkCount;
+    VerOffset chunkStart = item.blobIndex.chunkStart;
+    const size_t end = offset + size;
+    size_t chunkOffset = 0;
+
+    for(uint8_t chunkNum = 0; chunkNum < chunkCount && chunkOffset < end; chunkNum++) {
+        err = findItem(nsIndex, ItemType::BLOB_DATA, key, findPage, item, static_cast<uint8_t> (chunkStart) + chunkNum, nvs::VerOffset::VER_ANY, &itemIndex);
+        if(err != ESP_OK) {
+            if(err == ESP_ERR_NVS_NOT_FOUND) {
+                break;
+            }
+            return err;
+        }
+
+        const size_t chunkSize = item.varLength.dataSize;
+        if(chunkSize > blobSize - chunkOffset) {
+            err = ESP_ERR_NVS_INVALID_LENGTH;
+            break;
+        }
+
+        if(chunkOffset + chunkSize > offset) {
+            size_t begin = std::max(offset, chunkOffset) - chunkOffset;
+            size_t chunkEnd = std::min(end, chunkOffset + chunkSize) - chunkOffset;
+            err = findPage->readVariableLengthItemData(item, itemIndex, begin, chunkEnd, chunkOffset, callback, arg);
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+
+        chunkOffset += chunkSize;
+    }
+
+    if(err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH) {
+        // cleanup if a chunk is not found or the size is inconsistent, left to the next exclusive access when reading shared
+        if(!mLock.isShared()) {
+            eraseMultiPageBlob(nsIndex, key, Page::DEFAULT_PURGE_AFTER_ERASE);
+        }
+        return err;
+    }
+
+    NVS_ASSERT_OR_RETURN(chunkOffset >= end, ESP_FAIL);
+
+    return err;
+}
+
+struct BlobRangeBuffer {
+    uint8_t* data;
+    size_t offset;
+};
+
+static esp_err_t copyBlobRange(const void* data, size_t offset, size_t size, void* arg)
+{
+    BlobRangeBuffer* buffer = static_cast<BlobRangeBuffer*>(arg);
+    memcpy(buffer->data + (offset - buffer->offset), data, size);
+    return ESP_OK;
+}
+
+esp_err_t Storage::readBlobRange(uint8_t nsIndex, const char* key, size_t offset, void* data, size_t size)
+{
+    BlobRangeBuffer buffer = {static_cast<uint8_t*>(data), offset};
+    return readBlobStream(nsIndex, key, offset, size, copyBlobRange, &buffer);
+}
+
 esp_err_t Storage::cmpMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize)
 {
     Item item;
@@ -778,6 +1297,20 @@ esp_err_t Storage::readItem(uint8_t nsIndex, ItemType datatype, const char* key,
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    WriteCacheEntry* entry = mWriteCache.find(nsIndex, key);
+    if(entry != nullptr && WriteCache::hides(entry, datatype)) {
+        if(entry->mDatatype != datatype) {
+            // the value on flash is replaced by the one of another datatype
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+        if(entry->mDataSize != dataSize) {
+            return ESP_ERR_NVS_TYPE_MISMATCH;
+        }
+        memcpy(data, entry->mValue, dataSize);
+        ++mWriteCache.mHitCount;
+        return ESP_OK;
+    }
+
     Item item;
     Page* findPage = nullptr;
     if(datatype == ItemType::BLOB) {
@@ -906,8 +1439,30 @@ esp_err_t Storage::eraseItem(uint8_t nsIndex, ItemType datatype, const char* key
     Page* findPage = nullptr;
     esp_err_t err = ESP_OK;
     size_t itemIndex = 0;
+    bool cachedValueDropped = false;
+
+    WriteCacheEntry* entry = mWriteCache.find(nsIndex, key);
+    if(entry != nullptr) {
+        if(datatype == ItemType::ANY || datatype == entry->mDatatype) {
+            // the cached value is never written, only the values already on flash have to be erased
+            mWriteCache.remove(entry);
+            cachedValueDropped = true;
+#ifndef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+            // a value of another datatype on flash would have been replaced by the cached one
+            datatype = ItemType::ANY;
+#endif
+        } else {
+            err = flushCacheEntry(entry);
+            if(err != ESP_OK) {
+                return err;
+            }
+        }
+    }
 
     err = findItem(nsIndex, datatype, key, findPage, item, Page::CHUNK_ANY, VerOffset::VER_ANY, &itemIndex);
+    if(err == ESP_ERR_NVS_NOT_FOUND && cachedValueDropped) {
+        return ESP_OK;
+    }
     if(err != ESP_OK) {
         return err;
     }
@@ -925,6 +1480,14 @@ esp_err_t Storage::eraseNamespace(uint8_t nsIndex, const bool purgeAfterErase)
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    for(auto it = mWriteCache.begin(); it != mWriteCache.end();) {
+        WriteCacheEntry* entry = it;
+        ++it;
+        if(entry->mNsIndex == nsIndex) {
+            mWriteCache.remove(entry);
+        }
+    }
+
     for(auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         while(true) {
             auto err = it->eraseItem(nsIndex, ItemType::ANY, nullptr, purgeAfterErase);
@@ -959,6 +1522,14 @@ esp_err_t Storage::findKey(const uint8_t nsIndex, const char* key, ItemType* dat
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    WriteCacheEntry* entry = mWriteCache.find(nsIndex, key);
+    if(entry != nullptr) {
+        if(datatype != nullptr) {
+            *datatype = entry->mDatatype;
+        }
+        return ESP_OK;
+    }
+
     Item item;
     Page* findPage = nullptr;
     auto err = findItem(nsIndex, ItemType::ANY, key, findPage, item);
@@ -979,9 +1550,18 @@ esp_err_t Storage::getItemDataSize(uint8_t nsIndex, ItemType datatype, const cha
         return ESP_ERR_NVS_NOT_INITIALIZED;
     }
 
+    WriteCacheEntry* entry = mWriteCache.find(nsIndex, key);
+    if(entry != nullptr && WriteCache::hides(entry, datatype)) {
+        if(entry->mDatatype != datatype) {
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+        dataSize = entry->mDataSize;
+        return ESP_OK;
+    }
+
     Item item;
     Page* findPage = nullptr;
-    esp_err_t err = ESP_OK;
+    esp_err_t err;
 
     // If requested datatype is BLOB, first try to find the item with datatype BLOB_IDX - new format
     // If not found, try to find the item with datatype BLOB - old format.
@@ -1037,10 +1617,55 @@ void Storage::debugCheck()
 }
 #endif //DEBUG_STORAGE
 
+// Values in the write cache are counted as if they were flushed: a new key takes one more entry,
+// a replaced value gives back the entries of the previous one.
+esp_err_t Storage::calcCachedEntries(uint8_t nsIndex, ptrdiff_t& cachedEntries)
+{
+    cachedEntries = 0;
+
+    for(auto entry = mWriteCache.begin(); entry != mWriteCache.end(); ++entry) {
+        if(nsIndex != Page::NS_ANY && entry->mNsIndex != nsIndex) {
+            continue;
+        }
+
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+        ItemType previousType = entry->mDatatype;
+#else
+        ItemType previousType = ItemType::ANY;
+#endif
+        Page* findPage = nullptr;
+        Item item;
+        esp_err_t err = findItem(entry->mNsIndex, previousType, entry->mKey, findPage, item);
+        if(err == ESP_ERR_NVS_NOT_FOUND) {
+            ++cachedEntries;
+        } else if(err != ESP_OK) {
+            return err;
+        } else {
+            cachedEntries += 1 - static_cast<ptrdiff_t>(item.span);
+        }
+    }
+    return ESP_OK;
+}
+
 esp_err_t Storage::fillStats(nvs_stats_t& nvsStats)
 {
     nvsStats.namespace_count = mNamespaces.size();
-    return mPageManager.fillStats(nvsStats);
+    esp_err_t err = mPageManager.fillStats(nvsStats);
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    ptrdiff_t cachedEntries;
+    err = calcCachedEntries(Page::NS_ANY, cachedEntries);
+    if(err != ESP_OK) {
+        return err;
+    }
+
+    // free entries are the ones not used on the active and full pages, see Page::calcEntries
+    nvsStats.used_entries += cachedEntries;
+    nvsStats.free_entries = (static_cast<ptrdiff_t>(nvsStats.free_entries) > cachedEntries) ? nvsStats.free_entries - cachedEntries : 0;
+    nvsStats.available_entries = (nvsStats.free_entries >= Page::ENTRY_COUNT) ? nvsStats.free_entries - Page::ENTRY_COUNT : 0;
+    return ESP_OK;
 }
 
 esp_err_t Storage::calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries)
@@ -1067,17 +1692,24 @@ esp_err_t Storage::calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries)
             if(itemIndex >= it->ENTRY_COUNT) break;
         }
     }
+
+    ptrdiff_t cachedEntries;
+    esp_err_t err = calcCachedEntries(nsIndex, cachedEntries);
+    if(err != ESP_OK) {
+        return err;
+    }
+    usedEntries += cachedEntries;
     return ESP_OK;
 }
 
-void Storage::fillEntryInfo(Item &item, nvs_entry_info_t &info)
+void Storage::fillEntryInfo(uint8_t nsIndex, ItemType datatype, const char* key, nvs_entry_info_t &info)
 {
-    info.type = static_cast<nvs_type_t>(item.datatype);
-    strncpy(info.key, item.key, sizeof(info.key) - 1);
+    info.type = static_cast<nvs_type_t>(datatype);
+    strncpy(info.key, key, sizeof(info.key) - 1);
     info.key[sizeof(info.key) - 1] = '\0';
 
     for(auto &name : mNamespaces) {
-        if(item.nsIndex == name.mIndex) {
+        if(nsIndex == name.mIndex) {
             strlcpy(info.namespace_name, name.mName, sizeof(info.namespace_name));
             break;
         }
@@ -1089,6 +1721,7 @@ bool Storage::findEntry(nvs_opaque_iterator_t* it, const char* namespace_name)
     it->entryIndex = 0;
     it->nsIndex = Page::NS_ANY;
     it->page = mPageManager.begin();
+    it->cacheIndex = 0;
 
     if(namespace_name != nullptr) {
         if(createOrOpenNamespace(namespace_name, false, it->nsIndex) != ESP_OK) {
@@ -1104,6 +1737,7 @@ bool Storage::findEntryNs(nvs_opaque_iterator_t* it, uint8_t nsIndex)
     it->entryIndex = 0;
     it->nsIndex = nsIndex;
     it->page = mPageManager.begin();
+    it->cacheIndex = 0;
 
     return nextEntry(it);
 }
@@ -1115,6 +1749,12 @@ inline bool isIterableItem(Item& item)
             item.datatype != ItemType::BLOB_IDX);
 }
 
+bool Storage::isHiddenByCache(const Item& item)
+{
+    WriteCacheEntry* entry = mWriteCache.find(item.nsIndex, item.key);
+    return entry != nullptr && WriteCache::hides(entry, item.datatype);
+}
+
 inline bool isMultipageBlob(Item& item)
 {
     return (item.datatype == ItemType::BLOB_DATA &&
@@ -1131,8 +1771,8 @@ bool Storage::nextEntry(nvs_opaque_iterator_t* it)
         do {
             err = page->findItem(it->nsIndex, (ItemType)it->type, nullptr, it->entryIndex, item);
             it->entryIndex += item.span;
-            if(err == ESP_OK && isIterableItem(item) && !isMultipageBlob(item)) {
-                fillEntryInfo(item, it->entry_info);
+            if(err == ESP_OK && isIterableItem(item) && !isMultipageBlob(item) && !isHiddenByCache(item)) {
+                fillEntryInfo(item.nsIndex, item.datatype, item.key, it->entry_info);
                 it->page = page;
                 return true;
             }
@@ -1140,10 +1780,63 @@ bool Storage::nextEntry(nvs_opaque_iterator_t* it)
 
         it->entryIndex = 0;
     }
+    it->page = mPageManager.end();
+
+    // values not flushed yet follow the ones on flash
+    size_t cacheIndex = 0;
+    for(auto entry = mWriteCache.begin(); entry != mWriteCache.end(); ++entry, ++cacheIndex) {
+        if(cacheIndex < it->cacheIndex) {
+            continue;
+        }
+        if((it->nsIndex == Page::NS_ANY || entry->mNsIndex == it->nsIndex)
+                && (it->type == NVS_TYPE_ANY || entry->mDatatype == static_cast<ItemType>(it->type))) {
+            fillEntryInfo(entry->mNsIndex, entry->mDatatype, entry->mKey, it->entry_info);
+            it->cacheIndex = cacheIndex + 1;
+            return true;
+        }
+    }
 
     return false;
 }
 
+StorageAccess::~StorageAccess()
+{
+    if(mStorage == nullptr) {
+        return;
+    }
+    if(mLocked) {
+        if(mMode == Mode::READ) {
+            mStorage->getLock().unlockShared();
+        } else {
+            mStorage->getLock().unlock();
+        }
+    }
+    mStorage->getLock().removeUser();
+    if(mHandleUsers != nullptr) {
+        --*mHandleUsers;
+    }
+}
+
+void StorageAccess::attach(Storage* storage, std::atomic<uint32_t>* handleUsers)
+{
+    mStorage = storage;
+    mStorage->getLock().addUser();
+    mHandleUsers = handleUsers;
+    if(mHandleUsers != nullptr) {
+        ++*mHandleUsers;
+    }
+}
+
+void StorageAccess::acquire()
+{
+    StorageLock& lock = mStorage->getLock();
+    if(mMode == Mode::READ) {
+        lock.lockShared();
+    } else {
+        lock.lock();
+    }
+    mLocked = true;
+}
 
 }
 
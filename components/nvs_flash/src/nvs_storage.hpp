@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2015-2025 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2015-2026 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -8,11 +8,17 @@
 #include <memory>
 #include <cstdlib>
 #include <unordered_map>
+#include "sdkconfig.h"                  // For CONFIG_NVS_KEY_INDEX
 #include "nvs.hpp"
 #include "nvs_types.hpp"
 #include "nvs_page.hpp"
 #include "nvs_pagemanager.hpp"
+#include "nvs_key_index.hpp"
+#include "nvs_batch.hpp"
+#include "nvs_write_cache.hpp"
+#include "nvs_sector_cache.hpp"
 #include "nvs_memory_management.hpp"
+#include "nvs_platform.hpp"
 #include "partition.hpp"
 
 //extern void dumpBytes(const uint8_t* data, size_t count);
@@ -54,10 +60,20 @@ class Storage : public intrusive_list_node<Storage>, public ExceptionlessAllocat
 
     typedef intrusive_list<BlobIndexNode> TBlobIndexList;
 
+    // Value replaced by an item of a batch
+    struct BatchPreviousItem : public ExceptionlessAllocatable {
+        public:
+            Page* mPage = nullptr;
+            size_t mItemIndex = 0;
+            Item mItem;
+            VerOffset mNextStart = VerOffset::VER_0_OFFSET;
+            bool mUnchanged = false;
+    };
+
 public:
     ~Storage();
 
-    Storage(Partition *partition) : mPartition(partition) {
+    Storage(Partition *partition) : mPartition(partition), mSectorCache(partition) {
         if (partition == nullptr) {
             abort();
         }
@@ -71,6 +87,8 @@ public:
 
     esp_err_t writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase);
 
+    esp_err_t writeBatch(uint8_t nsIndex, Batch& batch, const bool purgeAfterErase);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize);
 
     esp_err_t findKey(const uint8_t nsIndex, const char* key, ItemType* datatype);
@@ -115,10 +133,28 @@ public:
         return mPageManager.getBaseSector();
     }
 
+    uint32_t getPageCount()
+    {
+        return mPageManager.getPageCount();
+    }
+
+    StorageLock& getLock()
+    {
+        return mLock;
+    }
+
     esp_err_t writeMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize, VerOffset chunkStart, const bool purgeAfterErase);
 
     esp_err_t readMultiPageBlob(uint8_t nsIndex, const char* key, void* data, size_t dataSize);
 
+    /**
+     * Passes bytes [offset, offset + size) of a blob to callback, piece by piece, as they are read from flash.
+     * Chunks outside of the range are not read.
+     */
+    esp_err_t readBlobStream(uint8_t nsIndex, const char* key, size_t offset, size_t size, nvs_blob_read_cb_t callback, void* arg);
+
+    esp_err_t readBlobRange(uint8_t nsIndex, const char* key, size_t offset, void* data, size_t size);
+
     esp_err_t cmpMultiPageBlob(uint8_t nsIndex, const char* key, const void* data, size_t dataSize);
 
     esp_err_t eraseMultiPageBlob(uint8_t nsIndex, const char* key, const bool purgeAfterErase, VerOffset chunkStart = VerOffset::VER_ANY);
@@ -131,6 +167,18 @@ public:
 
     esp_err_t calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries);
 
+    /**
+     * Flushes the cache and applies the new limits. The age limit is only checked when a cached value is written,
+     * there is no timer flushing the cache in the background.
+     */
+    esp_err_t setWriteCache(size_t maxEntries, uint32_t flushOnWriteAgeMs);
+
+    esp_err_t flushWriteCache();
+
+    void fillCacheStats(nvs_cache_stats_t& cacheStats);
+
+    esp_err_t gcStep(size_t maxEntries, bool& pending);
+
     bool findEntry(nvs_opaque_iterator_t* it, const char* name);
 
     bool findEntryNs(nvs_opaque_iterator_t* it, uint8_t nsIndex);
@@ -146,25 +194,103 @@ protected:
 
     void clearNamespaces();
 
+    esp_err_t load(uint32_t baseSector, uint32_t sectorCount);
+
     esp_err_t populateBlobIndices(TBlobIndexList&);
 
     void eraseMismatchedBlobIndexes(TBlobIndexList&);
 
     void eraseOrphanDataBlobs(TBlobIndexList&);
 
-    void fillEntryInfo(Item &item, nvs_entry_info_t &info);
+    void fillEntryInfo(uint8_t nsIndex, ItemType datatype, const char* key, nvs_entry_info_t &info);
+
+    bool isHiddenByCache(const Item& item);
+
+    esp_err_t calcCachedEntries(uint8_t nsIndex, ptrdiff_t& cachedEntries);
+
+    esp_err_t writeItemToFlash(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase);
+
+    esp_err_t writeCachedItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, const bool purgeAfterErase);
+
+    esp_err_t flushCacheEntry(WriteCacheEntry* entry);
+
+    esp_err_t flushCachedKey(uint8_t nsIndex, const char* key);
+
+    esp_err_t findPreviousItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &findPage, Item& item, size_t& itemIndex, bool& matchedTypePageFound);
+
+    esp_err_t finishBatch(Page& page, size_t markerIndex, const Item& marker);
 
     esp_err_t findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx = Page::CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY, size_t* itemIndex = NULL);
 
+#ifdef CONFIG_NVS_KEY_INDEX
+    // Number of distinct pages sharing one key hash that are resolved via the index, more pages fall back to the full search
+    static const size_t MAX_KEY_INDEX_CANDIDATES = 8;
+
+    esp_err_t findItemInPages(Page** pages, size_t count, uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart, size_t* itemIndex);
+#endif
+
 protected:
     Partition *mPartition;
+    // The pages access the partition through the cache, declared before mPageManager as the pages refer to it
+    SectorCache mSectorCache;
     size_t mPageCount;
+    // Declared before mPageManager as the pages refer to it
+    StorageLock mLock;
+#ifdef CONFIG_NVS_KEY_INDEX
+    // Declared before mPageManager as the pages refer to it until they are destroyed
+    KeyIndex mKeyIndex;
+#endif
     PageManager mPageManager;
     TNamespaces mNamespaces;
+    WriteCache mWriteCache;
     CompressedEnumTable<bool, 1, 256> mNamespaceUsage;
     StorageState mState = StorageState::INVALID;
 };
 
+/**
+ * Access of an API call to a storage, i.e. a registration as user of the storage and the lock held on it.
+ *
+ * The global Lock protects the lists of storages and handles only. A call looks up the storage under Lock and
+ * registers with attach(), which keeps the storage from being deinitialized. After releasing Lock, acquire() takes
+ * the lock of the storage, shared for READ and exclusively for WRITE. A call waiting for one storage, e.g. behind
+ * a garbage collection, thus doesn't hold up the calls to other storages.
+ *
+ * The lock and the registration are released on destruction.
+ */
+class StorageAccess
+{
+public:
+    enum class Mode {
+        READ,
+        WRITE,
+    };
+
+    explicit StorageAccess(Mode mode) : mMode(mode) { }
+
+    StorageAccess(const StorageAccess&) = delete;
+
+    StorageAccess& operator=(const StorageAccess&) = delete;
+
+    ~StorageAccess();
+
+    /**
+     * Registers as user of the storage, and of the handle whose users are counted by handleUsers if given. Must be
+     * called with Lock held.
+     */
+    void attach(Storage* storage, std::atomic<uint32_t>* handleUsers = nullptr);
+
+    /**
+     * Takes the lock of the attached storage. May be called with or without Lock held.
+     */
+    void acquire();
+
+protected:
+    Storage* mStorage = nullptr;
+    std::atomic<uint32_t>* mHandleUsers = nullptr;
+    Mode mMode;
+    bool mLocked = false;
+};
+
 } // namespace nvs
 
 struct nvs_opaque_iterator_t
@@ -174,5 +300,6 @@ struct nvs_opaque_iterator_t
     size_t entryIndex;
     nvs::Storage *storage;
     intrusive_list<nvs::Page>::iterator page;
+    size_t cacheIndex; // position in the write cache, iterated once the pages are done
     nvs_entry_info_t entry_info;
 };
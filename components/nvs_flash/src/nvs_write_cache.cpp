@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "nvs_write_cache.hpp"
+#include "nvs_page.hpp"
+#include <cstring>
+
+namespace nvs
+{
+
+bool WriteCache::isCacheable(uint8_t nsIndex, ItemType datatype)
+{
+    // namespace entries are written once and have to be on flash before any item refers to them
+    return nsIndex != Page::NS_INDEX
+           && datatype != ItemType::ANY
+           && !isVariableLengthType(datatype)
+           && datatype != ItemType::BLOB_IDX;
+}
+
+bool WriteCache::hides(const WriteCacheEntry* entry, ItemType datatype)
+{
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+    // values of other datatypes are kept along with the written one
+    return entry->mDatatype == datatype;
+#else
+    (void) datatype;
+    return true;
+#endif
+}
+
+bool WriteCache::isFlushDue(uint32_t now)
+{
+    if (mFlushOnWriteAgeMs == 0) {
+        return false;
+    }
+    for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+        if (now - it->mDirtySince >= mFlushOnWriteAgeMs) {
+            return true;
+        }
+    }
+    return false;
+}
+
+WriteCacheEntry* WriteCache::find(uint8_t nsIndex, const char* key)
+{
+    for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+        if (it->mNsIndex == nsIndex && strncmp(it->mKey, key, Item::MAX_KEY_LENGTH) == 0) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+void WriteCache::touch(WriteCacheEntry* entry)
+{
+    mEntries.erase(entry);
+    mEntries.push_back(entry);
+}
+
+void WriteCache::remove(WriteCacheEntry* entry)
+{
+    mEntries.erase(entry);
+    delete entry;
+}
+
+void WriteCache::fillStats(nvs_cache_stats_t& stats) const
+{
+    stats.hit_count = mHitCount;
+    stats.coalesced_count = mCoalescedCount;
+    stats.flush_count = mFlushCount;
+    stats.flushed_bytes = mFlushedBytes;
+    stats.pending_count = mEntries.size();
+}
+
+} // namespace nvs
@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "intrusive_list.h"
+#include "nvs_memory_management.hpp"
+#include <atomic>
+
+namespace nvs
+{
+
+/**
+ * Value written through the write-back cache which hasn't been written to flash yet.
+ */
+class WriteCacheEntry : public intrusive_list_node<WriteCacheEntry>, public ExceptionlessAllocatable
+{
+public:
+    uint8_t mNsIndex;
+    ItemType mDatatype;
+    bool mPurgeAfterErase;
+    uint8_t mDataSize;
+    char mKey[Item::MAX_KEY_LENGTH + 1];
+    uint8_t mValue[8];
+    // time of the first write since the value was last flushed
+    uint32_t mDirtySince;
+};
+
+/**
+ * Write-back cache of one Storage.
+ *
+ * Holds the latest value of frequently updated keys in RAM, so that repeated writes to the same key
+ * cost one flash write per flush instead of one per write. Only primitive types are cached, strings and blobs
+ * are always written directly.
+ *
+ * Entries are kept in least recently used order, the front is flushed first if the cache runs full.
+ * The cache itself doesn't access flash, flushing the entries is done by the Storage.
+ */
+class WriteCache
+{
+public:
+    typedef intrusive_list<WriteCacheEntry>::iterator iterator;
+
+    ~WriteCache()
+    {
+        clear();
+    }
+
+    static bool isCacheable(uint8_t nsIndex, ItemType datatype);
+
+    /**
+     * Whether the value of the entry replaces a value of the datatype on flash once flushed,
+     * so that reads of the datatype are answered by the cache.
+     */
+    static bool hides(const WriteCacheEntry* entry, ItemType datatype);
+
+    void configure(size_t maxEntries, uint32_t flushOnWriteAgeMs)
+    {
+        mMaxEntries = maxEntries;
+        mFlushOnWriteAgeMs = flushOnWriteAgeMs;
+    }
+
+    bool isEnabled() const
+    {
+        return mMaxEntries > 0;
+    }
+
+    bool isFull() const
+    {
+        return mEntries.size() >= mMaxEntries;
+    }
+
+    /**
+     * Checks whether the oldest value not yet flushed has exceeded the configured age. Called when a value is written.
+     */
+    bool isFlushDue(uint32_t now);
+
+    WriteCacheEntry* find(uint8_t nsIndex, const char* key);
+
+    /**
+     * Marks the entry as most recently used.
+     */
+    void touch(WriteCacheEntry* entry);
+
+    void remove(WriteCacheEntry* entry);
+
+    void clear()
+    {
+        mEntries.clearAndFreeNodes();
+    }
+
+    WriteCacheEntry* leastRecentlyUsed()
+    {
+        return mEntries.empty() ? nullptr : &mEntries.front();
+    }
+
+    void push(WriteCacheEntry* entry)
+    {
+        mEntries.push_back(entry);
+    }
+
+    size_t size() const
+    {
+        return mEntries.size();
+    }
+
+    iterator begin()
+    {
+        return mEntries.begin();
+    }
+
+    iterator end()
+    {
+        return mEntries.end();
+    }
+
+    void fillStats(nvs_cache_stats_t& stats) const;
+
+    // reads hit the cache with the storage lock shared
+    std::atomic<size_t> mHitCount{0};
+    size_t mCoalescedCount = 0;
+    size_t mFlushCount = 0;
+    size_t mFlushedBytes = 0;
+
+protected:
+    intrusive_list<WriteCacheEntry> mEntries;
+    size_t mMaxEntries = 0;
+    uint32_t mFlushOnWriteAgeMs = 0;
+}; // class WriteCache
+
+} // namespace nvs
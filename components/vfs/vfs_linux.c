@@ -11,7 +11,7 @@
  * esp_vfs_* for registered FDs, and fall back to the cooperative syscall
  * layer for unregistered FDs (e.g. during early boot before VFS init).
  *
- * All kernel FDs created by open/pipe/socket/dup/accept are registered
+ * All kernel FDs created by open/pipe/socket/dup/accept/epoll_create1 are registered
  * with VFS via esp_vfs_register_fd_with_local_fd, so the application
  * only sees VFS-allocated FD numbers.  This eliminates FD collisions
  * between kernel FDs and VFS-internal FD allocations.
@@ -636,3 +636,33 @@ int poll(struct pollfd *fds, nfds_t nfds, int timeout)
 
     return ret;
 }
+
+#ifdef __linux__
+int epoll_create1(int flags)
+{
+    int kernel_fd = freertos_linux_coop_epoll_create1(flags);
+    return register_kernel_fd(kernel_fd);
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+    int kepfd = vfs_fd_to_kernel_fd(epfd);
+    if (kepfd < 0) {
+        return -1;
+    }
+    int kfd = vfs_fd_to_kernel_fd(fd);
+    if (kfd < 0) {
+        return -1;
+    }
+    return freertos_linux_coop_epoll_ctl(kepfd, op, kfd, event);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    int kepfd = vfs_fd_to_kernel_fd(epfd);
+    if (kepfd < 0) {
+        return -1;
+    }
+    return freertos_linux_coop_epoll_wait(kepfd, events, maxevents, timeout);
+}
+#endif // __linux__